@@ -38,6 +38,16 @@ namespace CE
 
 		TypeId GetTypeId() const { return mTypeId; }
 
+		/*
+		An estimate of the memory owned by this asset in bytes, including
+		the memory on the GPU. The AssetManager uses this to keep the loaded
+		assets within its memory budget.
+
+		The default only accounts for the size of the object itself,
+		override this if your asset owns any large buffers.
+		*/
+		virtual size_t GetMemoryUsage() const;
+
 		/*
 		Saves an asset to memory. AssetSaveInfo has
 		functionality in place to allow you to save
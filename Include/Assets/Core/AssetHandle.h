@@ -44,10 +44,15 @@ namespace CE
 		uint32 GetNumberOfSoftReferences() const;
 
 	protected:
+		friend class AssetManager;
+
 		void AssureNotNull() const;
 
 		bool IsA(TypeId type) const;
 
+		// See AssetManager::RequestLoad
+		void RequestLoad(float priority) const;
+
 		Internal::AssetInternal* mAssetInternal{};
 	};
 
@@ -125,6 +130,12 @@ namespace CE
 
 		const T* Get() const;
 
+		/**
+		 * \brief Never waits for the asset to be loaded. If the asset is not loaded yet,
+		 * a load is requested with the given priority and nullptr is returned. See AssetManager::RequestLoad.
+		 */
+		const T* TryGet(float priority = 0.0f) const;
+
 	private:
 		template<typename U, typename O, std::enable_if_t<std::is_convertible_v<U*, O*>, bool>>
 		friend AssetHandle<U> StaticAssetHandleCast(const AssetHandle<O>& other);
@@ -231,7 +242,15 @@ namespace CE
 	{
 		if (mAssetInternal != nullptr)
 		{
-			++mAssetInternal->mRefCounters[static_cast<int>(IndexOfCounter)];
+			const uint32 previousCount = mAssetInternal->mRefCounters[static_cast<int>(IndexOfCounter)]++;
+
+			if constexpr (IndexOfCounter == Internal::AssetInternal::RefCountType::Strong)
+			{
+				if (previousCount == 0)
+				{
+					mAssetInternal->OnFirstStrongReference();
+				}
+			}
 		}
 	}
 
@@ -240,7 +259,15 @@ namespace CE
 	{
 		if (mAssetInternal != nullptr)
 		{
-			--mAssetInternal->mRefCounters[static_cast<int>(IndexOfCounter)];
+			const uint32 newCount = --mAssetInternal->mRefCounters[static_cast<int>(IndexOfCounter)];
+
+			if constexpr (IndexOfCounter == Internal::AssetInternal::RefCountType::Strong)
+			{
+				if (newCount == 0)
+				{
+					mAssetInternal->UpdateResidency();
+				}
+			}
 		}
 	}
 
@@ -300,7 +327,7 @@ namespace CE
 			return nullptr;
 		}
 
-		mAssetInternal->mHasBeenDereferencedSinceGarbageCollect = true;
+		mAssetInternal->mHasBeenDereferencedSinceGarbageCollect.store(true, std::memory_order_relaxed);
 
 		if (!IsLoaded())
 		{
@@ -316,6 +343,25 @@ namespace CE
 		return reinterpret_cast<const T*>(mAssetInternal->mAsset.get());
 	}
 
+	template <typename T>
+	const T* AssetHandle<T>::TryGet(const float priority) const
+	{
+		if (mAssetInternal == nullptr)
+		{
+			return nullptr;
+		}
+
+		mAssetInternal->mHasBeenDereferencedSinceGarbageCollect.store(true, std::memory_order_relaxed);
+
+		if (!IsLoaded())
+		{
+			RequestLoad(priority);
+			return nullptr;
+		}
+
+		return reinterpret_cast<const T*>(mAssetInternal->mAsset.get());
+	}
+
 	template <typename T, typename O, std::enable_if_t<std::is_convertible_v<T*, O*>, bool>>
 	AssetHandle<T> StaticAssetHandleCast(const AssetHandle<O>& other)
 	{
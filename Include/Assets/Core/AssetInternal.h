@@ -1,5 +1,6 @@
 #pragma once
 #include <atomic>
+#include <mutex>
 
 #include "AssetFileMetaData.h"
 #include "Utilities/MemFunctions.h"
@@ -7,6 +8,7 @@
 namespace CE
 {
 	class Asset;
+	class AssetLoadInfo;
 }
 
 namespace CE::Internal
@@ -15,19 +17,88 @@ namespace CE::Internal
 	struct AssetInternal
 	{
 		AssetInternal(AssetFileMetaData&& metaData, const std::optional<std::filesystem::path>& path);
+		~AssetInternal();
 
+		// Loads the asset on the calling thread. If another thread is
+		// already loading this asset, waits for that thread to finish.
 		void Load();
 		void UnLoad();
 
+		// Unloads the asset, unless it is strongly referenced. The references are
+		// checked while holding mLoadMutex, so a handle that starts referencing
+		// the asset concurrently either prevents the unload or waits for it to
+		// finish, see OnFirstStrongReference. Returns whether it was unloaded.
+		bool UnLoadIfUnused();
+
+		// Same as Load, but called by the AssetManager when streaming
+		// in assets, so it does not count as a blocking load.
+		void Stream();
+
+		// Reads the file from disk, without constructing the asset yet.
+		// Used for assets that must be constructed on the main thread.
+		void PrepareLoad();
+
+		void SetLoadedAsset(std::unique_ptr<Asset, InPlaceDeleter<Asset, true>> asset);
+
+		bool IsLoaded() const { return mLoadState.load(std::memory_order_acquire) == LoadState::Loaded; }
+
+		// Called when the asset is no longer, or once again, strongly referenced.
+		// Keeps the AssetManager's memory usage and list of unused assets up to date.
+		void UpdateResidency();
+
+		// Called by the AssetHandles when the number of strong references rises from zero
+		void OnFirstStrongReference();
+
 		enum class RefCountType : bool { Strong, Weak };
 
-		std::array<uint32, 2> mRefCounters{};
+		enum class LoadState : uint8
+		{
+			Unloaded,
+
+			// A load was requested through the AssetManager, but no thread has started on it yet
+			Queued,
+
+			Loading,
+
+			// The file has been read, the asset will be constructed on the main thread
+			AwaitingMainThread,
+
+			Loaded
+		};
+
+		// Atomic, as handles may be copied and destroyed on the threads that are loading the assets.
+		std::array<std::atomic<uint32>, 2> mRefCounters{};
 
 		std::unique_ptr<Asset, InPlaceDeleter<Asset, true>> mAsset{};
 
+		std::atomic<LoadState> mLoadState{ LoadState::Unloaded };
+
+		// The highest priority this asset was requested with, while it was queued.
+		// Only accessed by the AssetManager, while holding its lock on the queue.
+		float mRequestedPriority{};
+
+		// Held while constructing the asset
+		std::mutex mLoadMutex{};
+
+		// Set by PrepareLoad
+		std::unique_ptr<AssetLoadInfo> mPreparedLoadInfo{};
+
+		// Only accessed by the AssetManager, while holding its lock on the residency.
+		// The assets that are loaded from file, but are not referenced, form a linked
+		// list, ordered from least to most recently used. See AssetManager::SetMemoryBudget.
+		AssetInternal* mPreviousUnused{};
+		AssetInternal* mNextUnused{};
+		bool mIsInUnusedList{};
+
+		// As reported by Asset::GetMemoryUsage, when the asset was loaded and when it was last used
+		size_t mMemoryUsage{};
+		bool mIsResident{};
+
 		AssetFileMetaData mMetaData;
 
-		bool mHasBeenDereferencedSinceGarbageCollect{};
+		// Set by the handles on any thread, and reset by the AssetManager during garbage collection.
+		// It is only a hint about which assets were used recently, so relaxed ordering is enough.
+		std::atomic<bool> mHasBeenDereferencedSinceGarbageCollect{};
 
 		// The .asset file. Is only nullopt if this
 		// asset was generated at runtime, and no path
@@ -37,5 +108,13 @@ namespace CE::Internal
 		// The .rename files that redirect to this asset.
 		std::vector<std::filesystem::path> mOldNames{};
 
+		// The number of times a thread had to wait for an asset to
+		// be loaded, because it was dereferenced before it was ready.
+		static inline std::atomic<uint32> sNumOfBlockingLoads{};
+
+	private:
+		// Expects mLoadMutex to be locked
+		void LoadImpl();
+		void UnLoadImpl();
 	};
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "AssetFileMetaData.h"
+#include "Utilities/MemoryMappedFile.h"
 
 namespace CE
 {
@@ -24,12 +25,27 @@ namespace CE
 
 		std::istream& GetStream() { return *mStream; }
 
+		// Returns all the bytes that have not yet been read from the stream, and moves the stream to the end.
+		// Files loaded through LoadFromFile are memory mapped, in which case the bytes are not copied.
+		// The bytes remain valid for as long as this AssetLoadInfo exists.
+		Span<const std::byte> GetRemainingBytes();
+
+		// Reads the rest of the file from disk on the calling thread, so that constructing
+		// the asset later on does not have to wait on the disk. Only has an effect on memory mapped files.
+		void Prefetch() const;
+
 		const AssetFileMetaData& GetMetaData() const { return *mMetaData; }
 
 	private:
 		// Returns true on succes
 		bool ConstructFromCurrentStream();
 
+		// Declared before the stream, as the stream may read from it
+		std::optional<MemoryMappedFile> mMappedFile{};
+
+		// Holds the remaining bytes if the stream was not memory mapped
+		std::string mRemainingBytes{};
+
 		std::unique_ptr<std::istream> mStream;
 		
 		friend class AssetManager;
@@ -68,6 +68,9 @@ namespace CE
 		void OnCollisionStay(World&, entt::entity, entt::entity, float, glm::vec2, glm::vec2);
 		void OnCollisionExit(World&, entt::entity, entt::entity, float, glm::vec2, glm::vec2);
 
+		static void OnTickBatch(World& world, Span<const entt::entity> owners, Span<EventTestingComponent> components, float dt);
+		static void OnFixedTickBatch(World& world, Span<const entt::entity> owners, Span<EventTestingComponent> components, float dt);
+
 		uint32 mNumOfConstructs{};
 		uint32 mNumOfDestructs{};
 		uint32 mNumOfBeginPlays{};
@@ -79,6 +82,10 @@ namespace CE
 		uint32 mNumOfCollisionStay{};
 		uint32 mNumOfCollisionExit{};
 
+		// Only incremented if the component was passed alongside its owner
+		uint32 mNumOfBatchedTicks{};
+		uint32 mNumOfBatchedFixedTicks{};
+
 	private:
 		friend ReflectAccess;
 		static MetaType Reflect();
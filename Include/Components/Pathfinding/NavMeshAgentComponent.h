@@ -22,6 +22,9 @@ namespace CE
 
 		std::vector<glm::vec2> mPath{};
 
+		// Used by the NavMeshPathingSystem to decide which agents need a new path the most
+		float mTimeSincePathWasUpdated{};
+
 		using TargetT = std::variant<std::monostate, glm::vec2, entt::entity>;
 		TargetT mTarget{};
 
@@ -12,23 +12,67 @@ namespace CE
 	class NavMeshComponent
 	{
 	public:
-		void GenerateNavMesh(const World& world);
-
-		bool WasGenerated() const { return mBVHWorld.has_value(); }
-
 		/**
 		 * \brief
-		 * Finds the quickest path from one point to another, by doing an AStarSearch on the nav mesh.
-		 * (which is then refined with the funnel algorithm)
-		 * \param startPos starting position
-		 * \param endPos ending position
-		 * \return Returns all the coordinates of the quickest path found as a vector of glm::vec2
+		 * Everything that is needed to find paths on a generated nav mesh.
+		 *
+		 * A snapshot is never modified after it was generated, regenerating the nav mesh creates a new one instead.
+		 * Whoever holds on to a snapshot can keep finding paths on it from any thread, even while the nav mesh is
+		 * being regenerated or the component is destroyed.
 		 */
+		class Snapshot
+		{
+		public:
+			/**
+			 * \brief
+			 * Finds the quickest path from one point to another, by doing an AStarSearch on the nav mesh.
+			 * (which is then refined with the funnel algorithm)
+			 * Paths between the same two triangles are cached, so only the first request does a search.
+			 * Can be called from multiple threads at once.
+			 * \param startPos starting position
+			 * \param endPos ending position
+			 * \return Returns all the coordinates of the quickest path found as a vector of glm::vec2
+			 */
+			[[nodiscard]] std::vector<glm::vec2> FindQuickestPath(glm::vec2 startPos, glm::vec2 endPos) const;
+
+			[[nodiscard]] const std::vector<TransformedPolygon>& GetPolygonDataNavMesh() const { return mPolygonDataNavMesh; }
+
+			[[nodiscard]] const Pathfinding::Graph& GetAStarGraph() const { return mAStarGraph; }
+
+		private:
+			friend NavMeshComponent;
+
+			/**
+			 * \brief Appends the middle of the edges shared by the triangles of the A* search's path to outPath.
+			 * \param nodes The A* search's quickest path
+			 */
+			void CleanupPathfinding(Span<const Pathfinding::NodeId> nodes, std::vector<glm::vec2>& outPath) const;
+
+			/// \brief The A* Graph object.
+			Pathfinding::Graph mAStarGraph{};
+
+			/// \brief The std::vector<PolygonPoints> that contains the triangles for the NavMesh after some CDT clean up.
+			std::vector<TransformedPolygon> mPolygonDataNavMesh;
+
+			/// \brief The paths found by FindQuickestPath, without the start and end position.
+			mutable Pathfinding::PathCache mPathCache{};
+
+			std::optional<World> mBVHWorld{};
+		};
+
+		void GenerateNavMesh(const World& world);
+
+		bool WasGenerated() const { return mSnapshot != nullptr; }
+
+		/// \brief Returns nullptr if the nav mesh was not generated yet
+		std::shared_ptr<const Snapshot> GetSnapshot() const { return mSnapshot; }
+
+		/// \brief See Snapshot::FindQuickestPath. Returns an empty path if the nav mesh was not generated yet.
 		[[nodiscard]] std::vector<glm::vec2> FindQuickestPath(glm::vec2 startPos, glm::vec2 endPos) const;
 
 		[[nodiscard]] const std::vector<TransformedPolygon>& GetCleanedPolygonList() const { return mCleanedPolygonList; }
 
-		[[nodiscard]] const std::vector<TransformedPolygon>& GetPolygonDataNavMesh() const { return mPolygonDataNavMesh; }
+		[[nodiscard]] const std::vector<TransformedPolygon>& GetPolygonDataNavMesh() const;
 
 		/// \brief DebugDrawNavMesh, draws the NavMesh in order to be able to debug it
 		/// \param world the current World in the scene
@@ -37,15 +81,11 @@ namespace CE
 		bool mNavMeshNeedsUpdate = true;
 
 	private:
-		/// \brief The A* Graph object.
-		Pathfinding::Graph mAStarGraph{};
+		std::shared_ptr<const Snapshot> mSnapshot{};
 
 		/// \brief The std::vector<PolygonPoints> that contains the walkable area. Only used for debugging.
 		std::vector<TransformedPolygon> mCleanedPolygonList;
 
-		/// \brief The std::vector<PolygonPoints> that contains the triangles for the NavMesh after some CDT clean up.
-		std::vector<TransformedPolygon> mPolygonDataNavMesh;
-
 		/**
 		 * \brief Load the info from the given file in order to create the navmesh properly
 		 * \return The walkable and obstacle areas
@@ -68,8 +108,9 @@ namespace CE
 		/**
 		 * \brief Triangulates the polygonList provided and sets up the dual graph between the nav mesh and the A* graph
 		 * \param polygonList The walkable area / CleanedPolygonList
+		 * \param snapshot The snapshot that receives the triangles and the A* graph
 		 */
-		void Triangulation(const std::vector<TransformedPolygon>& polygonList);
+		static void Triangulation(const std::vector<TransformedPolygon>& polygonList, Snapshot& snapshot);
 
 		/**
 		 * \brief Computes the shortest path within a list of triangles from the A* search function using funnel algorithm.
@@ -82,11 +123,6 @@ namespace CE
 		                                                     glm::vec2 start, glm::vec2 goal) const;
 		void UpdateNavMesh();
 
-		std::vector<glm::vec2> CleanupPathfinding(const std::vector<const Pathfinding::Node*>& nodes,
-		                                          glm::vec2 start, glm::vec2 goal) const;
-
-		std::optional<World> mBVHWorld{};
-
 		friend ReflectAccess;
 		static MetaType Reflect();
 		REFLECT_AT_START_UP(NavMeshComponent);
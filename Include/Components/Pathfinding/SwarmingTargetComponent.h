@@ -1,7 +1,6 @@
 #pragma once
 #include "Meta/MetaReflect.h"
-#include "Utilities/ASync.h"
-#include "Utilities/Geometry2d.h"
+#include "Utilities/FlowFieldEngine.h"
 
 namespace CE
 {
@@ -11,22 +10,11 @@ namespace CE
 		float mDesiredRadius = 150.0f;
 		int mNumberOfSmoothingSteps = 2;
 
-		struct FlowField
-		{
-			TransformedAABB GetCellBox(const int x, const int y) const
-			{
-				const glm::vec2 cellMin = glm::vec2{ static_cast<float>(x), static_cast<float>(y) } *mSpacing + mCellsTopLeftWorldPosition - glm::vec2{ mSpacing * .5f };
-				const glm::vec2 cellMax = cellMin + glm::vec2{ mSpacing };
-				return { cellMin, cellMax };
-			}
+		// The flow field towards this target for agents of this size class, or nullptr if it was not computed yet
+		const FlowFieldEngine::Field* GetFlowField(uint32 sizeClass) const { return mFlowFields[sizeClass].get(); }
 
-			glm::vec2 mCellsTopLeftWorldPosition{};
-			int mFlowFieldWidth{};
-			float mSpacing{};
-
-			std::vector<glm::vec2> mFlowField{};
-		};
-		FlowField mCurrent{};
+		// Assigned by the FlowFieldEngine, one for each size class of agents
+		std::array<std::shared_ptr<const FlowFieldEngine::Field>, FlowFieldEngine::sNumOfSizeClasses> mFlowFields{};
 
 	private:
 		friend ReflectAccess;
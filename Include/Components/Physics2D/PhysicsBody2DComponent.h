@@ -60,6 +60,43 @@ namespace CE
 		return layer == CollisionLayer::StaticObstacles || layer == CollisionLayer::Terrain;
 	}
 
+	/**
+	 * \brief The acceleration structure used to find the objects in a collision layer.
+	 */
+	enum class Broadphase : uint8
+	{
+		/**
+		 * \brief A BVH built using the surface area heuristic. Fast queries, but slow to rebuild.
+		 */
+		SurfaceAreaHeuristic,
+
+		/**
+		 * \brief A DynamicAABBTree, where objects are inserted, moved and removed incrementally.
+		 */
+		DynamicTree,
+
+		/**
+		 * \brief A SpatialHashGrid that is rebuilt every frame. Best for many moving objects of roughly the same size.
+		 */
+		SpatialHashGrid,
+	};
+
+	static constexpr Broadphase GetCollisionLayerBroadphase(CollisionLayer layer)
+	{
+		if (IsCollisionLayerStatic(layer))
+		{
+			return Broadphase::SurfaceAreaHeuristic;
+		}
+
+		// Mostly swarms of enemies, which all have a disk collider of the same size
+		if (layer == CollisionLayer::Character)
+		{
+			return Broadphase::SpatialHashGrid;
+		}
+
+		return Broadphase::DynamicTree;
+	}
+
 	struct CollisionRules
 	{
 #ifdef EDITOR
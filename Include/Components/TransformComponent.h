@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+
 #include "Meta/MetaReflect.h"
 #include "Utilities/Math.h"
 
@@ -46,6 +48,9 @@ namespace CE
 
 	/**
 	 * \brief A component that manages the position, scale and orientation of an entity.
+	 *
+	 * Changing the local transform only marks the world transform, and that of all the children, as out of date.
+	 * The world transform is recalculated when it is next requested, or when UpdateWorldTransforms is called.
 	 */
 	class TransformComponent
 	{
@@ -62,6 +67,15 @@ namespace CE
 
 		void OnConstruct(World& world, entt::entity owner);
 
+		/**
+		 * \brief Recalculates the world transform of every transform that is out of date.
+		 *
+		 * Parents are always updated before their children, and separate hierarchies are updated in parallel.
+		 * Only the hierarchies that were marked as out of date since the last call are visited.
+		 * Called by the world once per frame, and before systems that may read transforms are run in parallel.
+		 */
+		static void UpdateWorldTransforms(Registry& registry);
+
 		static glm::mat4 ToMatrix(glm::vec3 position, glm::vec3 scale, glm::quat orientation);
 		static std::tuple<glm::vec3, glm::vec3, glm::quat> FromMatrix(const glm::mat4& matrix);
 
@@ -184,18 +198,30 @@ namespace CE
 		void AttachChild(TransformComponent& child);
 		void DetachChild(TransformComponent& child);
 
-		void UpdateCachedWorldMatrix();
+		// Marks the world transform of this transform and all of its children as out of date
+		void MarkWorldDirty();
+		void MarkChildrenWorldDirty();
+
+		// Lets UpdateWorldTransforms know that this hierarchy needs to be visited. Only called on roots.
+		void AddToDirtyRoots();
+
+		// Recalculates the world transform if it is out of date, after doing the same for our parent.
+		// Safe to call from multiple threads at once, as long as no transform is being modified.
+		void ResolveWorld() const;
+
+		// Recalculates the world transform of this transform and any of its children that are out of date
+		void ResolveSubtree();
 
 		// We do not serialize the world
 		// matrix, so we require
-		// the archiver to call UpdateCachedWorldMatrix..
+		// the archiver to call MarkWorldDirty.
 		friend Archiver;
 
 
 		// We don't have custom setter/getter support yet.
 		// WorldDetails may inspect mLocalPosition and
-		// adjust its value without ever updating the world
-		// matrix. 
+		// adjust its value without ever marking the world
+		// transform as out of date.
 		friend WorldDetails;
 		friend Registry;
 
@@ -209,7 +235,31 @@ namespace CE
 		glm::quat mLocalOrientation = { 1.0f, 0.0f, 0.0f, 0.0f };
 		glm::vec3 mLocalScale = { 1.0f, 1.0f, 1.0f };
 
-		glm::mat4 mCachedWorldMatrix{ 1.0f };
+		mutable glm::mat4 mCachedWorldMatrix{ 1.0f };
+		mutable glm::quat mCachedWorldOrientation = { 1.0f, 0.0f, 0.0f, 0.0f };
+		mutable glm::vec3 mCachedWorldScale = { 1.0f, 1.0f, 1.0f };
+
+		enum class WorldState : uint8
+		{
+			UpToDate,
+			Dirty,
+			Resolving
+		};
+		mutable std::atomic<WorldState> mWorldState{ WorldState::UpToDate };
+
+		static constexpr uint32 sMinNumOfRootsPerBatch = 64;
+
+		// True if the world transform of any of our children, or their children, is out of date.
+		// Lets UpdateWorldTransforms skip entire hierarchies that have not changed. Atomic, as
+		// transforms in the same hierarchy may be marked as dirty from different threads.
+		std::atomic<bool> mHasDirtyDescendants{};
+
+		// Whether our owner is in Registry::mDirtyTransformRoots. Exchanged, so that
+		// only one thread adds the root when several mark its hierarchy as dirty.
+		std::atomic<bool> mIsInDirtyRoots{};
+
+		// Set in OnConstruct. The registry is never moved, so storing a pointer is safe.
+		Registry* mRegistry{};
 
 		// Storing a pointer is safe, as pointer stability has been enabled.
 		TransformComponent* mParent{};
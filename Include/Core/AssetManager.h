@@ -2,6 +2,7 @@
 #include "Core/EngineSubsystem.h"
 
 #include <forward_list>
+#include <shared_mutex>
 
 #include "Assets/Asset.h"
 #include "Assets/Core/AssetFileMetaData.h"
@@ -9,6 +10,8 @@
 #include "Assets/Core/AssetInternal.h"
 #include "Meta/MetaManager.h"
 
+struct AssetManagerUnitTestAccess;
+
 namespace CE
 {
 	template<typename T>
@@ -85,15 +88,90 @@ namespace CE
 		*/
 		void UnloadAllUnusedAssets();
 
+		/*
+		Sets the maximum amount of memory, in bytes, that the assets loaded from
+		file may use, as reported by Asset::GetMemoryUsage. Once the budget is
+		exceeded, EvictUnusedAssets unloads the assets that are no longer
+		referenced, starting with the one that was least recently used.
+
+		Assets that are still referenced are never unloaded, so the memory usage
+		can still exceed the budget. There is no budget by default.
+
+		Example:
+			// A server that runs for days on end
+			AssetManager::Get().SetMemoryBudget(512ull * 1024 * 1024);
+		*/
+		void SetMemoryBudget(std::optional<size_t> numOfBytes);
+		std::optional<size_t> GetMemoryBudget() const;
+
+		/*
+		The memory used by the loaded assets that were loaded from file.
+		*/
+		size_t GetMemoryUsage() const;
+
+		/*
+		Unloads the least recently used assets that are no longer referenced, until
+		the memory usage is within the budget, or until maxNumOfAssetsToUnload
+		assets were unloaded. Only the unreferenced assets are visited, so this is
+		cheap enough to be called every frame, which the engine does.
+		*/
+		void EvictUnusedAssets(uint32 maxNumOfAssetsToUnload = 16);
+
+		/*
+		Requests the asset to be loaded on a worker thread, so that the calling
+		thread does not have to wait for the file to be read and the asset
+		to be constructed.
+
+		Requests with a higher priority are loaded first. Requesting an asset
+		that is still queued with a higher priority moves it forward in the queue.
+		Does nothing if the asset is already loaded or being loaded.
+
+		Assets tagged with Props::sMustBeConstructedOnMainThreadTag are read from
+		disk on a worker thread, but are constructed in FinishStreamedLoads.
+
+		Dereferencing the asset through AssetHandle::Get before it is ready still
+		works, but blocks until the asset is loaded. Use AssetHandle::TryGet or
+		IsReady to avoid this.
+
+		Example:
+			for (const AssetHandle<StaticMesh>& mesh : meshesInNextRoom)
+			{
+				AssetManager::Get().RequestLoad(mesh, isPlayerNearDoor ? 1.0f : 0.0f);
+			}
+
+			// Some frames later
+			if (const StaticMesh* mesh = meshesInNextRoom[0].TryGet())
+			{
+				DoThing(*mesh);
+			}
+		*/
+		void RequestLoad(const AssetHandleBase& asset, float priority = 0.0f);
+
+		/*
+		Returns true if the asset is loaded, and can be dereferenced without blocking.
+		*/
+		bool IsReady(const AssetHandleBase& asset) const;
+
+		/*
+		Constructs the streamed assets that have to be constructed on the main
+		thread. Called once per frame by the engine.
+		*/
+		void FinishStreamedLoads();
+
+		/*
+		The number of times a thread had to wait for an asset to be loaded,
+		because it was dereferenced before it was streamed in.
+		*/
+		uint32 GetNumOfBlockingLoads() const;
+
 		template<typename AssetType>
 		class EachAssetIt
 		{
 		public:
 			using value_type = WeakAssetHandle<AssetType>;
-			using ContainerType = std::forward_list<Internal::AssetInternal>;
-			using UnderlyingIt = ContainerType::iterator;
+			using ContainerType = std::vector<Internal::AssetInternal*>;
 
-			EachAssetIt(UnderlyingIt&& it, ContainerType& container);
+			EachAssetIt(const ContainerType* container, size_t index);
 
 			decltype(auto) operator*() const;
 
@@ -102,22 +180,26 @@ namespace CE
 			EachAssetIt& operator++();
 			EachAssetIt operator++(int);
 
-			constexpr bool operator==(const EachAssetIt& b) const;
-			constexpr bool operator!=(const EachAssetIt& b) const;
+			bool operator==(const EachAssetIt& b) const;
+			bool operator!=(const EachAssetIt& b) const;
 
 		private:
-			void IncrementUntilTypeMatches();
+			bool IsAtEnd() const { return mContainer == nullptr || mIndex >= mContainer->size(); }
 
-			UnderlyingIt mIt;
-			std::reference_wrapper<ContainerType> mContainer;
+			// An index, rather than an iterator, so that assets can be added while iterating
+			const ContainerType* mContainer{};
+			size_t mIndex{};
 		};
 
 		/*
-		Returns all the assets of the given type
+		Returns all the assets of the given type, including those of a derived type.
+		Only visits the matching assets, not every asset.
 		*/
 		template<typename T = Asset>
 		IterableRange<EachAssetIt<T>> GetAllAssets();
 
+		IterableRange<EachAssetIt<Asset>> GetAllAssets(TypeId typeId);
+
 		/*
 		Rename the asset
 
@@ -189,7 +271,79 @@ namespace CE
 		template<typename T>
 		friend class EachAssetT;
 
+		friend AssetManagerUnitTestAccess;
+
+		struct LoadRequest
+		{
+			float mPriority{};
+
+			// Requests with the same priority are loaded in the order they were made
+			uint64 mRequestIndex{};
+
+			// Keeps the asset from being unloaded or deleted while it is queued
+			AssetHandle<> mAsset{};
+		};
+
+		static bool HasLowerPriority(const LoadRequest& lhs, const LoadRequest& rhs);
+
+		// Loads the request with the highest priority. Executed on the worker threads.
+		void StreamNextRequest();
+
+		friend struct Internal::AssetInternal;
+
+		// Updates the memory usage and the least recently used list, after the asset was
+		// loaded, unloaded, or is no longer or once again strongly referenced. The asset is
+		// only measured if canMeasure, which requires that no other thread is (un)loading it.
+		void UpdateResidency(Internal::AssetInternal& asset, bool canMeasure);
+
+		// Expects mResidencyMutex to be locked
+		void AddToUnusedList(Internal::AssetInternal& asset);
+		void RemoveFromUnusedList(Internal::AssetInternal& asset);
+
+		// Removes and returns the least recently used asset, or nullptr if there
+		// are no unused assets. Expects mResidencyMutex to be locked.
+		Internal::AssetInternal* PopLeastRecentlyUsed();
+
+		std::mutex mStreamingMutex{};
+
+		// A max heap, ordered by HasLowerPriority
+		std::vector<LoadRequest> mLoadRequests{};
+		uint64 mNumOfRequestsMade{};
+
+		std::vector<AssetHandle<>> mAwaitingMainThread{};
+
+		// The number of scheduled jobs that have not yet finished
+		std::atomic<uint32> mNumOfStreamingJobs{};
+
+		mutable std::mutex mResidencyMutex{};
+		Internal::AssetInternal* mLeastRecentlyUsed{};
+		Internal::AssetInternal* mMostRecentlyUsed{};
+		size_t mMemoryUsage{};
+		std::optional<size_t> mMemoryBudget{};
+
+		/*
+		Guards mAssets, mAssetsByType and mLookUp, as well as the names and classes
+		in the metadata of the assets. Worker threads look up assets by name while
+		streaming, for example when an asset being loaded deserializes its AssetHandles,
+		while the main thread may be adding, renaming or deleting assets.
+
+		Lookups take the mutex shared, anything that adds, renames or removes an asset
+		takes it exclusively. Assets are never destroyed while they are referenced,
+		so the pointer a lookup returns remains valid once the mutex is released.
+		*/
+		mutable std::shared_mutex mAssetsMutex{};
+
 		std::forward_list<Internal::AssetInternal> mAssets{};
+
+		// For every type, the assets of that type or of a type derived from it.
+		// Lets GetAllAssets<T> visit only the matching assets.
+		std::unordered_map<TypeId, std::vector<Internal::AssetInternal*>> mAssetsByType{};
+
+		// Expects mAssetsMutex to be locked exclusively
+		void AddToTypeIndex(Internal::AssetInternal& asset);
+		void RemoveFromTypeIndex(const Internal::AssetInternal& asset);
+
+		const std::vector<Internal::AssetInternal*>* TryGetAssetsOfType(TypeId typeId) const;
 		std::unordered_map<Name::HashType, std::reference_wrapper<Internal::AssetInternal>> mLookUp{};
 
 		Internal::AssetInternal* TryGetAssetInternal(Name key, TypeId typeId);
@@ -200,15 +354,20 @@ namespace CE
 	};
 
 	template <typename AssetType>
-	constexpr bool AssetManager::EachAssetIt<AssetType>::operator==(const EachAssetIt& b) const
+	bool AssetManager::EachAssetIt<AssetType>::operator==(const EachAssetIt& b) const
 	{
-		return mIt == b.mIt;
+		// The end is wherever the container ends at the time of comparing
+		if (IsAtEnd() || b.IsAtEnd())
+		{
+			return IsAtEnd() == b.IsAtEnd();
+		}
+		return mContainer == b.mContainer && mIndex == b.mIndex;
 	}
 
 	template <typename AssetType>
-	constexpr bool AssetManager::EachAssetIt<AssetType>::operator!=(const EachAssetIt& b) const
+	bool AssetManager::EachAssetIt<AssetType>::operator!=(const EachAssetIt& b) const
 	{
-		return mIt != b.mIt;
+		return !(*this == b);
 	}
 
 	template<typename T>
@@ -224,23 +383,16 @@ namespace CE
 	}
 
 	template <typename AssetType>
-	AssetManager::EachAssetIt<AssetType>::EachAssetIt(UnderlyingIt&& it, ContainerType& container) :
-		mIt(std::move(it)),
-		mContainer(container)
+	AssetManager::EachAssetIt<AssetType>::EachAssetIt(const ContainerType* container, const size_t index) :
+		mContainer(container),
+		mIndex(index)
 	{
-		// Not really a traditional iterator i suppose,
-		// but good enough for our purposes.
-		if (mIt == mContainer.get().begin()
-			&& !mIt->mMetaData.GetClass().IsDerivedFrom<AssetType>())
-		{
-			IncrementUntilTypeMatches();
-		}
 	}
 
 	template <typename AssetType>
 	decltype(auto) AssetManager::EachAssetIt<AssetType>::operator*() const
 	{
-		return WeakAssetHandle<AssetType>{ &*mIt };
+		return WeakAssetHandle<AssetType>{ (*mContainer)[mIndex] };
 	}
 
 	template <typename AssetType>
@@ -252,7 +404,7 @@ namespace CE
 	template <typename AssetType>
 	AssetManager::EachAssetIt<AssetType>& AssetManager::EachAssetIt<AssetType>::operator++()
 	{
-		IncrementUntilTypeMatches();
+		++mIndex;
 		return *this;
 	}
 
@@ -262,27 +414,11 @@ namespace CE
 		EachAssetIt tmp = *this; ++(*this); return tmp;
 	}
 
-	template <typename AssetType>
-	void AssetManager::EachAssetIt<AssetType>::IncrementUntilTypeMatches()
-	{
-		if constexpr (std::is_same_v<Asset, AssetType>)
-		{
-			++mIt;
-		}
-		else
-		{
-			do
-			{
-				++mIt;
-			} while (mIt != mContainer.get().end()
-				&& !mIt->mMetaData.GetClass().IsDerivedFrom<AssetType>());
-		}
-	}
-
 	template <typename T>
 	IterableRange<AssetManager::EachAssetIt<T>> AssetManager::GetAllAssets()
 	{
-		return { { mAssets.begin(), mAssets }, { mAssets.end(), mAssets } };
+		const std::vector<Internal::AssetInternal*>* const assets = TryGetAssetsOfType(MakeTypeId<T>());
+		return { { assets, 0 }, { assets, assets == nullptr ? 0 : assets->size() } };
 	}
 
 	template <typename T>
@@ -292,7 +428,7 @@ namespace CE
 
 		if (internalAsset != nullptr)
 		{
-			internalAsset->mAsset = MakeUniqueInPlace<T, Asset>(std::move(generatedAsset));
+			internalAsset->SetLoadedAsset(MakeUniqueInPlace<T, Asset>(std::move(generatedAsset)));
 		}
 
 		return { internalAsset };
@@ -4,25 +4,17 @@
 #include "Core/EngineSubsystem.h"
 
 #include "Scripting/ScriptErrors.h"
+#include "Scripting/ScriptBytecode.h"
+#include "Scripting/ScriptProfiler.h"
 #include "Utilities/Expected.h"
 #include "Meta/MetaAny.h"
 #include "Meta/MetaFunc.h"
 
 namespace CE
 {
-	// Profiling scripts comes at a performance cost,
-	// so we only enable it when we need to.
-	// #define SCRIPT_PROFILING
-
 	class Script;
 	class ScriptField;
 	class ScriptFunc;
-	class ScriptNode; 
-	class FunctionEntryScriptNode; 
-	class WhileLoopScriptNode;
-	class ForLoopScriptNode;
-	class ScriptPin;
-	class ScriptLink;
 	class MetaAny;
 
 	class VirtualMachine :
@@ -58,11 +50,8 @@ namespace CE
 		a ScriptFunc compiles into a function on this metaType. These can be called.
 		This function can only be called if the script function compiled succesfully.
 
-		FirstNode:
-			will be the entryNode on impure functions and the return node on pure functions.
-
-		entryNode:
-			may be nullptr, if and only if the function is pure and does not have any parameters (besides the implicit 'this' parameters)
+		bytecode:
+			the result of CompileScriptFunction for this function.
 
 		Example:
 			So if you have a script called "Printer" with a function "PrintHelloWorld",
@@ -73,7 +62,19 @@ namespace CE
 
 			FuncResult result = printerFunc->Invoke({});
 		*/
-		FuncResult ExecuteScriptFunction(MetaFunc::DynamicArgs args, MetaFunc::RVOBuffer rvoBuffer, const ScriptFunc& func, const ScriptNode& firstNode, const FunctionEntryScriptNode* entryNode);
+		FuncResult ExecuteScriptFunction(MetaFunc::DynamicArgs args, MetaFunc::RVOBuffer rvoBuffer, const ScriptFunc& func, const ScriptBytecode& bytecode);
+
+		/*
+		Lowers the function into bytecode, which can then be passed to ExecuteScriptFunction.
+
+		The bytecode is owned by the virtual machine, and is destroyed
+		during the next call to ClearCompilationResult.
+		*/
+		const ScriptBytecode& CompileScriptFunction(const ScriptFunc& func);
+
+		// Profiling is disabled by default, and can be enabled at any time
+		ScriptProfiler& GetProfiler() { return mProfiler; }
+		const ScriptProfiler& GetProfiler() const { return mProfiler; }
 
 	private:
 		void PrintCompileErrors() const;
@@ -81,12 +82,7 @@ namespace CE
 		// When we recompile, we first have to clean up the result of the previous compilation
 		static void DestroyAllTypesCreatedThroughScripts();
 
-#ifdef SCRIPT_PROFILING
-		// The first string is the name of the script,
-		// the second string is the function name.
-		// float represents the number of seconds spend in the function
-		std::unordered_map<std::string, float> mNumOfSecondsSpentEachFunction{};
-#endif // SCRIPT_PROFILING
+		ScriptProfiler mProfiler{};
 
 		static constexpr uint32 sMaxNumOfNodesToExecutePerFunctionBeforeGivingUp = 10'000;
 		static constexpr uint32 sMaxStackSize = 1 << 16;
@@ -95,16 +91,20 @@ namespace CE
 		char* mStackPtr = &mStack[0];
 
 		std::vector<ScriptError> mErrorsFromLastCompilation{};
+		std::vector<std::unique_ptr<ScriptBytecode>> mCompiledFunctions{};
 		bool mIsCompiled{};
 
 		struct VMContext
 		{
-			VMContext(const ScriptFunc& func);
+			VMContext(const ScriptFunc& func, const ScriptBytecode& bytecode);
 			~VMContext();
 
 			const ScriptFunc& mFunc;
+			const ScriptBytecode& mBytecode;
 			MetaAny* mThis{};
-			uint32 mNumOfImpureNodesExecutedAtTimeOfCaching{1};
+
+			// Pure nodes are executed again if an impure node was executed after their value was cached
+			uint32 mNumOfImpureNodesExecuted{ 1 };
 
 			// VirtualMachine::mStackPtr  at the time of this object's construction.
 			// used to roll back the stack
@@ -114,50 +114,44 @@ namespace CE
 			{
 				void* mData{};
 				uint32 mNumOfImpureNodesExecutedAtTimeOfCaching{ std::numeric_limits<uint32>::max() };
-				uint32 mTypeInfoFlags{};
+
+				// Whether mData points to a value in the frame that has yet to be destructed
+				bool mNeedsToBeDestructed{};
 			};
+
+			// One for each slot in the bytecode
 			CachedValue* mCachedValues{};
 
-			// If we are in a for or while loop and there is no next node,
-			// we fall back to the node at the top of this stack
+			// The values owned by the slots
+			char* mFrame{};
 
-			struct ForLoopInfo
-			{
-				std::reference_wrapper<const ForLoopScriptNode> mNode;
-			};
+			// Used to pass the inputs of a node to the function
+			MetaAny* mInputs{};
 
-			struct WhileLoopInfo
+			struct LoopInfo
 			{
-				std::reference_wrapper<const WhileLoopScriptNode> mNode;
+				uint32 mLoop{};
+				uint32 mContinueAt{};
 			};
 
-			std::vector<std::variant<WhileLoopInfo, ForLoopInfo>> mControlNodesToFallBackTo{};
+			// If the flow ends while we are in a for or while loop,
+			// we continue at the loop at the top of this stack
+			std::vector<LoopInfo> mLoops{};
 		};
 		friend VMContext;
 
 		void* StackAllocate(uint32 numOfBytes, uint32 alignment);
 
-		const ScriptNode* GetNextNodeToExecute(VMContext& context, const ScriptNode& current);
-
-		template<typename T = MetaAny>
-		T GetValueToPassAsInput(VMContext& context, const ScriptPin& pinToPassInputInto);
-
-		template<>
-		MetaAny GetValueToPassAsInput(VMContext& context, const ScriptPin& pinToPassInputInto);
-
-		void AllocateForCache(VMContext& context, VMContext::CachedValue& cachedValue, const ScriptPin& pin, TypeInfo typeInfo);
-
-		static bool DoesCacheValueNeedToBeFreed(VMContext::CachedValue& cachedValue);
+		MetaAny GetInput(VMContext& context, uint32 operandIndex);
 
-		void FreeCachedValue(VMContext::CachedValue& cachedValue, const MetaType& pinType);
+		template<typename T>
+		T GetInput(VMContext& context, uint32 operandIndex);
 
-		VMContext::CachedValue& FindCachedValue(VMContext& context, PinId pinId);
+		// Destructs the previous value, and points the cached value to the slot's space in the frame
+		static void PrepareOutput(VMContext& context, uint32 slotIndex);
 
-		// Will execute the node. If it has a return value, the value will be cached. A pointer to the cached value is then returned.
-		VMContext::CachedValue* ExecuteNode(VMContext& context, const ScriptNode& node);
+		void ExecuteCall(VMContext& context, const ScriptBytecode::Call& call);
 
-		VMContext::WhileLoopInfo& BeginLoop(VMContext& context, VMContext::WhileLoopInfo&& loopInfo);
-		VMContext::ForLoopInfo& BeginLoop(VMContext& context, VMContext::ForLoopInfo&& loopInfo);
-		void EndLoop(VMContext& context, const ScriptNode& node);
+		void EndLoop(VMContext& context, uint32 loop);
 	};
 }
@@ -35,11 +35,11 @@ namespace CE
 		}
 
 		const std::string& GetName() const { return mName; }
-		void SetName(std::string_view name) { mName = std::string{ name }; }
+		void SetName(std::string_view name) { mName.assign(name.data(), name.size()); }
 		void SetName(std::string&& name) { mName = std::move(name); }
 
 		std::string_view GetData() const { return mData; }
-		void SetData(std::string_view data) { mData = std::string{ data }; }
+		void SetData(std::string_view data) { mData.assign(data.data(), data.size()); }
 		void SetData(std::string&& data) { mData = std::move(data); }
 
 		void Clear() { mData.clear(); }
@@ -14,7 +14,8 @@ namespace CE
 		template<typename T>
 		void SerializeIntoName(const T& value)
 		{
-			mName = ToBinary(value);
+			mName.clear();
+			BinaryWriter{ mName }.Write(value);
 		}
 
 		template<typename T>
@@ -26,7 +27,9 @@ namespace CE
 		template<typename T>
 		void operator<<(const T& value)
 		{
-			mData = ToBinary(value);
+			// Reuses the capacity of mData, and small values fit in the small string buffer
+			mData.clear();
+			BinaryWriter{ mData }.Write(value);
 		}
 
 		template<typename T>
@@ -46,7 +49,109 @@ namespace CE
 
 		void SaveToBinary(std::ostream& ostream) const;
 
+		// Appends to the buffer. Faster than writing to a stream, as
+		// the entire object is written in a single pass over the buffer.
+		void SaveToBinary(std::string& buffer) const;
+
 		// Returns true on success
 		bool LoadFromBinary(std::istream& ostream);
+
+		// Returns true on success
+		bool LoadFromBinary(BinaryReader& reader);
+	};
+
+	/*
+	A read-only view of a BinaryGSONObject saved using SaveToBinary.
+
+	Names and data are views into the bytes the view was parsed from, so nothing is
+	copied. The bytes, usually a MemoryMappedFile, must outlive the view.
+
+	Looking up children and members by name is a binary search through a table
+	of offsets sorted by name, instead of a linear scan. Returns the same element
+	a BinaryGSONObject would, if several share the same name.
+	*/
+	class BinaryGSONView
+	{
+	public:
+		BinaryGSONView(BinaryGSONView&&) noexcept = default;
+		BinaryGSONView(const BinaryGSONView&) = delete;
+
+		BinaryGSONView& operator=(BinaryGSONView&&) noexcept = default;
+		BinaryGSONView& operator=(const BinaryGSONView&) = delete;
+
+		// Returns std::nullopt if the bytes were not a valid BinaryGSONObject. Does not log, that is left to the caller.
+		static std::optional<BinaryGSONView> Parse(Span<const std::byte> bytes);
+
+		class Member
+		{
+		public:
+			std::string_view GetName() const { return mName; }
+			std::string_view GetData() const { return mData; }
+
+			template<typename T>
+			void operator>>(T& out) const
+			{
+				FromBinary(mData, out);
+			}
+
+		private:
+			friend BinaryGSONView;
+
+			std::string_view mName{};
+			std::string_view mData{};
+		};
+
+		class Object
+		{
+		public:
+			std::string_view GetName() const { return mName; }
+
+			Span<const Object> GetChildren() const { return { mChildren, mNumOfChildren }; }
+			Span<const Member> GetGSONMembers() const { return { mMembers, mNumOfMembers }; }
+
+			const Object* TryGetGSONObject(std::string_view name) const;
+			const Member* TryGetGSONMember(std::string_view name) const;
+
+			// Replaces the contents of object with a copy of this object and everything in it
+			void CopyTo(BinaryGSONObject& object) const;
+
+		private:
+			friend BinaryGSONView;
+
+			std::string_view mName{};
+
+			const Object* mChildren{};
+			const Member* mMembers{};
+			uint32 mNumOfChildren{};
+			uint32 mNumOfMembers{};
+
+			// Indices into mChildren and mMembers, sorted by name
+			const uint32* mChildrenByName{};
+			const uint32* mMembersByName{};
+		};
+
+		const Object& GetRoot() const { return mObjects.front(); }
+
+	private:
+		BinaryGSONView() = default;
+
+		// Only used while parsing, the spans are assigned once the vectors are no longer resized
+		struct Ranges
+		{
+			uint32 mFirstChild{};
+			uint32 mNumOfChildren{};
+			uint32 mFirstMember{};
+			uint32 mNumOfMembers{};
+		};
+
+		bool ParseObject(BinaryReader& reader, uint32 objectIndex, std::vector<Ranges>& ranges);
+
+		// The first object is the root, the children of each object are stored contiguously
+		std::vector<Object> mObjects{};
+		std::vector<Member> mMembers{};
+
+		// Each object's range in these tables matches the range its children and members occupy in mObjects and mMembers
+		std::vector<uint32> mObjectsByName{};
+		std::vector<uint32> mMembersByName{};
 	};
-}
\ No newline at end of file
+}
@@ -196,6 +196,12 @@ namespace CE
 		*/
 		const std::vector<std::reference_wrapper<const MetaType>>& GetDirectDerivedClasses() const { return mDirectDerivedClasses; }
 
+		/*
+		Get the TypeIds of all the classes this type derives from, directly or indirectly,
+		sorted by TypeId. Does not include the TypeId of this type itself.
+		*/
+		const std::vector<TypeId>& GetAllBaseClassTypeIds() const { return mAncestors; }
+
 		/*
 		Get the reflected fields of this type. This function is not recursive, and will not
 		return the fields of any of it's baseclasses.
@@ -332,6 +338,12 @@ namespace CE
 		template<typename TypeT, typename BaseT>
 		void AddFromArg(Base<BaseT>) { AddBaseClass<BaseT>(); }
 
+		// Adds to the ancestors of this type, and of everything that derives from it
+		void AddAncestors(const std::vector<TypeId>& ancestors) const;
+
+		// Adds to the descendants of this type, and of everything it derives from
+		void AddDescendants(const std::vector<TypeId>& descendants) const;
+
 		template<typename TypeT, typename... Args>
 		void AddFromArg(Ctor<Args...>);
 
@@ -414,6 +426,12 @@ namespace CE
 		mutable std::vector<std::reference_wrapper<const MetaType>> mDirectBaseClasses{};
 		mutable std::vector<std::reference_wrapper<const MetaType>> mDirectDerivedClasses{};
 
+		// Every class we derive from, and every class that derives from us, directly or indirectly.
+		// Kept sorted by AddBaseClass, so that IsDerivedFrom and IsBaseClassOf are a binary search,
+		// instead of a walk through the class hierarchy.
+		mutable std::vector<TypeId> mAncestors{};
+		mutable std::vector<TypeId> mDescendants{};
+
 		std::string mName;
 
 		std::unique_ptr<MetaProps> mProperties;
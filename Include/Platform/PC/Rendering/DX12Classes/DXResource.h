@@ -22,6 +22,9 @@ public:
 	void ChangeState(const ComPtr<ID3D12GraphicsCommandList>& list, D3D12_RESOURCE_STATES dstState);
 	void CreateUploadBuffer(const ComPtr<ID3D12Device5>& device, int dataSize, int currentSubresource);
 	void Update(const ComPtr<ID3D12GraphicsCommandList>& list, D3D12_SUBRESOURCE_DATA data, D3D12_RESOURCE_STATES dstState, int currentSubresource, int totalSubresources);
+
+	// Uploads each subresource in order, starting with the first, through the first upload buffer
+	void Update(const ComPtr<ID3D12GraphicsCommandList>& list, const std::vector<D3D12_SUBRESOURCE_DATA>& data, D3D12_RESOURCE_STATES dstState);
 	bool mResizeBuffer = false;
 
 private:
@@ -20,6 +20,8 @@ namespace CE
         void DrawMesh() const;
         void DrawMeshVertexOnly() const;
 
+        size_t GetMemoryUsage() const override;
+
         StaticMesh& operator=(StaticMesh&&) = delete;
         StaticMesh& operator=(const StaticMesh&) = delete;
 
@@ -22,6 +22,8 @@ namespace CE
         void DrawMesh() const;
         void DrawMeshVertexOnly() const;
 
+        size_t GetMemoryUsage() const override;
+
         const std::unordered_map<std::string, BoneInfo>& GetBoneMap() const { return mBoneInfoMap; };
 
         SkinnedMesh& operator=(SkinnedMesh&&) = delete;
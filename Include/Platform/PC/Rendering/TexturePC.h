@@ -47,17 +47,41 @@ namespace CE
 		bool WasSendToGPU() const;
 		void SendToGPU() const;
 
+		// Blocks until the pixels have been read from the file, or decoded for older textures.
+		// Returns false if the texture failed to load, or if it was already sent to the GPU.
+		bool WaitForPixels() const;
+
+		// The largest mip, in RGBA. Empty if the pixels are not loaded yet, or were already sent to the GPU.
+		Span<const unsigned char> GetPixels() const;
+
+		// All the mips that will be uploaded, from largest to smallest. Textures stored as
+		// a PNG only have the largest mip, the others are generated on the GPU.
+		Span<const unsigned char> GetPixelsOfAllMips() const;
+
 		void BindToGraphics(const Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList, unsigned int rootSlot) const;
 		void BindToCompute(const Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList4>& commandList, unsigned int rootSlot) const;
 
 		uint32_t GetWidth() const { return mWidth; };
 		uint32_t GetHeight() const{ return mHeight; };
 
+		size_t GetMemoryUsage() const override;
+
 #ifdef EDITOR
 		ImTextureID GetImGuiId() const;
 #endif // EDITOR
 
 	private:
+		friend class TextureImporter;
+
+		// Returns true on success. The mip chain is generated here, so that loading
+		// the texture only requires copying the pixels to the GPU.
+		static bool WriteMipChain(AssetSaveInfo& saveInfo, Span<const unsigned char> rgbaPixels, uint32 width, uint32 height);
+
+		static uint32 GetNumOfMips(uint32 width, uint32 height);
+
+		// In bytes, the mips are tightly packed RGBA
+		static size_t GetSizeOfMipChain(uint32 width, uint32 height, uint32 numOfMips);
+
 		void GenerateMipmaps() const;
 
 		const DXHeapHandle* TryGetHeapSlot() const;
@@ -73,12 +97,29 @@ namespace CE
 
 		std::unique_ptr<DXImpl, DXImplDeleter> mImpl{};
 
-		struct STBIPixels
+		struct LoadedPixels
 		{
-			~STBIPixels();
-			unsigned char* mPixels{};
+			~LoadedPixels();
+
+			// Only used for textures that were stored as a PNG, which is decoded by stbi
+			unsigned char* mDecodedPixels{};
+
+#ifdef EDITOR
+			// In the editor the pixels are copied out of the file, so the file is not kept
+			// mapped until the texture is sent to the GPU. It may be reimported or saved over.
+			std::vector<unsigned char> mCopiedPixels{};
+#endif // EDITOR
+
+			// Points to the decoded pixels, the copied pixels, or into the memory mapped file
+			const unsigned char* mPixels{};
 			int mWidth{};
 			int mHeight{};
+
+			// If more than one, the mips are stored after each other, from largest to smallest
+			uint32 mNumOfMips = 1;
+
+			// Keeps the memory mapped file alive
+			std::shared_ptr<AssetLoadInfo> mFile{};
 		};
 
 		struct DXGenerateMips
@@ -93,10 +134,11 @@ namespace CE
 		// Stores the return value of the load thread
 		// After the texture has been sent to the GPU,
 		// this value will be reset to nullptr.
-		std::shared_ptr<STBIPixels> mLoadedPixels{};
+		std::shared_ptr<LoadedPixels> mLoadedPixels{};
 		ASyncThread mLoadingThread{};
 
-		uint32_t mWidth, mHeight;
+		uint32_t mWidth{};
+		uint32_t mHeight{};
 
 		friend ReflectAccess;
 		static MetaType Reflect();
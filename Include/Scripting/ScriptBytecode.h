@@ -0,0 +1,166 @@
+#pragma once
+#include "Scripting/ScriptIds.h"
+#include "Scripting/ScriptErrors.h"
+#include "Meta/MetaTypeTraits.h"
+
+namespace CE
+{
+	class ScriptFunc;
+	class ScriptNode;
+	class MetaType;
+	class MetaFunc;
+	class MetaField;
+	enum class ScriptNodeType : uint32;
+
+	/*
+	A ScriptFunc lowered into a linear list of instructions, so that the VirtualMachine
+	does not have to walk the node graph while executing the function.
+
+	Every data output pin is assigned a slot. Slots that own their value are given a fixed
+	offset into a frame, which is allocated once at the start of each call. The pure nodes
+	that an impure node depends on are scheduled right before it, in the same order the node
+	graph would have evaluated them in, and the functions and fields that are called are
+	resolved ahead of time.
+
+	The bytecode holds references to the ScriptFunc it was compiled from, and is only valid
+	for as long as the ScriptFunc is not modified.
+	*/
+	class ScriptBytecode
+	{
+	public:
+		static ScriptBytecode Compile(const ScriptFunc& func);
+
+		static constexpr uint32 sNone = std::numeric_limits<uint32>::max();
+
+		enum class OpCode : uint8
+		{
+			// Executes mCalls[mA]. Pure nodes are skipped if their cached value is still up to date.
+			Call,
+
+			// Continues execution at mA
+			Jump,
+
+			// Continues execution at mB if the bool mOperands[mA] is false
+			JumpIfFalse,
+
+			// Pushes mLoops[mA] to the loop stack. Once the body of the loop has finished, execution continues at mB
+			PushLoop,
+
+			// Removes mLoops[mA] from the loop stack, as well as any loops that were pushed after it
+			PopLoop,
+
+			// Stores the int32 mOperands[mB] in slot mA
+			ForInit,
+
+			// Increments the int32 in slot mA
+			ForIncrement,
+
+			// Continues execution at mC if the int32 in slot mA is greater than or equal to the int32 mOperands[mB]
+			JumpIfForDone,
+
+			// Continues execution at the innermost loop, or returns if there is none
+			FallBack,
+
+			// Returns mOperands[mA], or nothing if mA is sNone
+			Return,
+
+			// Throws mErrors[mA]
+			Throw
+		};
+
+		struct Instruction
+		{
+			OpCode mOpCode{};
+			uint32 mA{};
+			uint32 mB{};
+			uint32 mC{};
+		};
+
+		// Describes where the value that is passed to an input pin comes from
+		struct Operand
+		{
+			enum class Source : uint8
+			{
+				// The value in mSlots[mIndex]
+				Slot,
+
+				// The instance of the script this function was called on
+				This,
+
+				// The value to use if no input is linked, or a default constructed value
+				Unlinked,
+
+				// Throws mErrors[mIndex]
+				Error
+			};
+
+			Source mSource{};
+
+			// Pins that accept MetaAny accept any type, and are never checked for nullptr
+			bool mAcceptsAny{};
+
+			bool mCanPinBeNull{};
+			bool mCanParameterBeNull = true;
+
+			uint32 mIndex{};
+
+			// The pin the value is passed to, after skipping over any reroute nodes
+			PinId mPin{};
+		};
+
+		// A node that is executed through OpCode::Call
+		struct Call
+		{
+			const ScriptNode* mNode{};
+			ScriptNodeType mType{};
+
+			// Depending on mType, only one of these is set
+			const MetaFunc* mFunc{};
+			const MetaField* mField{};
+
+			bool mIsPure{};
+			bool mReturnsCopy{};
+
+			uint32 mFirstOperand{};
+			uint32 mNumOfOperands{};
+
+			// sNone if the node returns void
+			uint32 mOutputSlot = sNone;
+
+			// Assigned by the ScriptProfiler
+			uint32 mProfilerId{};
+		};
+
+		// Holds the value of an output pin
+		struct Slot
+		{
+			const MetaType* mType{};
+
+			// The offset into the frame if the slot owns its value, or sNone if it holds a reference.
+			uint32 mOffset = sNone;
+			bool mNeedsToBeDestructed{};
+		};
+
+		std::vector<Instruction> mInstructions{};
+		std::vector<Call> mCalls{};
+		std::vector<Slot> mSlots{};
+
+		// mOperandForms[i] is the form in which mOperands[i] is passed.
+		// Stored separately, so that they can be passed to MetaFunc::InvokeUnchecked directly.
+		std::vector<Operand> mOperands{};
+		std::vector<TypeForm> mOperandForms{};
+
+		// The slots the arguments are stored in, excluding the 'this' argument of member functions
+		std::vector<uint32> mParameterSlots{};
+
+		std::vector<std::reference_wrapper<const ScriptNode>> mLoops{};
+		std::vector<ScriptError> mErrors{};
+
+		// Assigned by the ScriptProfiler
+		uint32 mProfilerId{};
+
+		uint32 mFrameSize{};
+		uint32 mFrameAlignment = 1;
+		uint32 mMaxNumOfOperands{};
+	};
+}
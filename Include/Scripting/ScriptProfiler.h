@@ -0,0 +1,149 @@
+#pragma once
+#include "Scripting/ScriptIds.h"
+
+namespace CE
+{
+	class ScriptFunc;
+	class ScriptNode;
+
+	/*
+	Measures how much time is spent in each script function, and in each node of those functions.
+
+	Profiling can be turned on and off at runtime. While it is disabled, the virtual machine
+	only checks a single bool before executing a function or node.
+
+	Functions and nodes are identified by integer ids, which are assigned when they are compiled.
+	A function keeps its id when the scripts are recompiled, and so does a node, as long as its
+	NodeId does not change.
+	*/
+	class ScriptProfiler
+	{
+	public:
+		void SetIsEnabled(bool isEnabled);
+		bool IsEnabled() const { return mIsEnabled; }
+
+		// Clears all measurements. The ids remain valid.
+		void Clear();
+
+		bool HasMeasurements() const { return mHasMeasurements; }
+
+		uint32 RegisterFunction(const ScriptFunc& func);
+		uint32 RegisterNode(const ScriptFunc& func, const ScriptNode& node);
+
+		struct Stats
+		{
+			uint64 mNumOfCalls{};
+			std::chrono::nanoseconds mInclusiveTime{};
+			std::chrono::nanoseconds mExclusiveTime{};
+
+			// The number of heap allocations the virtual machine made while this was the innermost function or node
+			uint64 mNumOfAllocations{};
+		};
+
+		uint32 GetNumOfIds() const { return static_cast<uint32>(mZones.size()); }
+		const std::string& GetName(uint32 id) const { return mZones[id].mName; }
+		bool IsFunction(uint32 id) const { return mZones[id].mIsFunction; }
+		const Stats& GetStats(uint32 id) const { return mZones[id].mStats; }
+
+		void BeginZone(uint32 id);
+		void EndZone();
+
+		void AddAllocation()
+		{
+			if (mIsEnabled
+				&& !mStack.empty())
+			{
+				++mZones[mStack.back().mZone].mStats.mNumOfAllocations;
+			}
+		}
+
+		// Begins a zone if profiling is enabled, and ends it when it goes out of scope
+		class Scope
+		{
+		public:
+			Scope(ScriptProfiler& profiler, uint32 id) :
+				mProfiler(profiler.IsEnabled() ? &profiler : nullptr)
+			{
+				if (mProfiler != nullptr)
+				{
+					mProfiler->BeginZone(id);
+				}
+			}
+
+			~Scope()
+			{
+				if (mProfiler != nullptr)
+				{
+					mProfiler->EndZone();
+				}
+			}
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			ScriptProfiler* mProfiler{};
+		};
+
+		// Writes every recorded call in the Chrome trace event format, which can be opened in chrome://tracing or Perfetto
+		void ExportChromeTrace(std::ostream& stream) const;
+
+		// Writes the exclusive time spent in each call stack, in the collapsed stack format used by flamegraph.pl and speedscope
+		void ExportCollapsedStacks(std::ostream& stream) const;
+
+		// Logs the functions and nodes in which the most time was spent
+		void PrintSummary(uint32 maxNumOfEntries = 64) const;
+
+	private:
+		uint32 RegisterZone(std::string&& name, bool isFunction);
+
+		struct Zone
+		{
+			std::string mName{};
+			bool mIsFunction{};
+			Stats mStats{};
+		};
+		std::vector<Zone> mZones{};
+		std::unordered_map<std::string, uint32> mIdsByName{};
+
+		// Every unique call stack is a node in the call tree
+		struct CallTreeNode
+		{
+			uint32 mZone{};
+			uint32 mParent{};
+			std::chrono::nanoseconds mExclusiveTime{};
+		};
+		std::vector<CallTreeNode> mCallTree{};
+
+		// The key is the parent in the upper 32 bits, and the zone in the lower 32 bits.
+		std::unordered_map<uint64, uint32> mCallTreeChildren{};
+
+		struct ActiveZone
+		{
+			uint32 mZone{};
+			uint32 mCallTreeNode{};
+			std::chrono::steady_clock::time_point mStart{};
+			std::chrono::nanoseconds mTimeInChildren{};
+		};
+		std::vector<ActiveZone> mStack{};
+
+		struct TraceEvent
+		{
+			uint32 mZone{};
+			uint32 mDepth{};
+			std::chrono::nanoseconds mStart{};
+			std::chrono::nanoseconds mDuration{};
+		};
+		std::vector<TraceEvent> mTraceEvents{};
+		uint64 mNumOfDroppedTraceEvents{};
+
+		// Prevents the trace from growing indefinitely when profiling is left on
+		static constexpr size_t sMaxNumOfTraceEvents = 1 << 20;
+
+		static constexpr uint32 sNoParent = std::numeric_limits<uint32>::max();
+
+		std::chrono::steady_clock::time_point mTimeOfEnabling{};
+		bool mIsEnabled{};
+		bool mHasMeasurements{};
+	};
+}
@@ -14,6 +14,8 @@ namespace CE
 	struct AnimNode;
 	struct BoneInfo;
 
+	// Never executed in parallel with other systems, as it invokes the
+	// OnAnimationFinish events, which may access any component.
 	class AnimationSystem final :
 		public System
 	{
@@ -1,5 +1,7 @@
 #pragma once
 #include "Systems/System.h"
+#include "Components/Pathfinding/NavMeshComponent.h"
+#include "Utilities/JobSystem.h"
 
 namespace CE
 {
@@ -24,23 +26,59 @@ namespace CE
 		REFLECT_AT_START_UP(NavMeshAgentSystem);
 	};
 
+	/*
+	Finds new paths for the agents that are chasing a target.
+
+	Paths are found on the JobSystem, while the rest of the frame continues. Each frame, the
+	paths found during the previous frame are handed to their agents, after which the agents are
+	sorted by how badly they need a new path. Agents that are close to their target and have not
+	received a new path in a while are handled first. The workers stop starting new requests once
+	sBudgetInMicroseconds has passed; the agents that did not get a turn are requested again during
+	the next frame, by which point they will have climbed in priority.
+
+	The requests are solved on a snapshot of the nav mesh, so the nav mesh can be regenerated while
+	requests are in flight.
+	*/
 	class NavMeshPathingSystem final
 		: public System
 	{
 	public:
+		~NavMeshPathingSystem() override;
+
 		void Update(World& world, float dt) override;
 
 		SystemStaticTraits GetStaticTraits() const override
 		{
 			SystemStaticTraits traits{};
 			traits.mPriority = static_cast<int>(TickPriorities::PreTick);
-			traits.mFixedTickInterval = .2f;
 			return traits;
 		}
 
+		static constexpr float sBudgetInMicroseconds = 2000.0f;
+
+		// How much the priority of a request drops for every unit of distance between the agent and its target
+		static constexpr float sPriorityFalloffPerUnitOfDistance = .05f;
+
 	private:
-		static constexpr uint32 sUpdateEveryNthPath = 10;
-		uint32 mNumOfTicksReceived{};
+		void ApplyFinishedRequests(Registry& registry);
+
+		void SubmitRequests(World& world, std::shared_ptr<const NavMeshComponent::Snapshot> snapshot);
+
+		struct PathRequest
+		{
+			entt::entity mAgent{};
+			glm::vec2 mStart{};
+			glm::vec2 mEnd{};
+			float mPriority{};
+
+			std::vector<glm::vec2> mResult{};
+			bool mWasSolved{};
+		};
+
+		// Owned by the job until it has finished
+		std::vector<PathRequest> mRequests{};
+		std::shared_ptr<const NavMeshComponent::Snapshot> mSnapshot{};
+		JobHandle mJob{};
 
 		friend ReflectAccess;
 		static MetaType Reflect();
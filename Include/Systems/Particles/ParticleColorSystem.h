@@ -11,13 +11,7 @@ namespace CE
 	public:
 		void Update(World& world, float dt) override;
 
-		SystemStaticTraits GetStaticTraits() const override
-		{
-			SystemStaticTraits traits{};
-			traits.mFixedTickInterval = Particles::sParticleFixedTimeStep;
-			traits.mPriority = static_cast<int>(TickPriorities::PreTick);
-			return traits;
-		}
+		SystemStaticTraits GetStaticTraits() const override;
 
 	private:
 		friend ReflectAccess;
@@ -29,6 +29,9 @@ namespace CE
 			traits.mFixedTickInterval = 1 / 60.0f;
 			traits.mShouldTickBeforeBeginPlay = true;
 			traits.mShouldTickWhilstPaused = true;
+
+			// No component access is declared; the collision events may run any
+			// code, including scripts that create or destroy entities.
 			return traits;
 		}
 
@@ -58,6 +61,29 @@ namespace CE
 			glm::vec2 mContactPoint{};
 		};
 
+		using EntityPair = std::pair<entt::entity, entt::entity>;
+
+		// The pairs found by a single batch of the broad phase.
+		// The batches are merged in order, so that the resolution
+		// order does not depend on how the work was distributed.
+		struct CollisionPairs
+		{
+			std::vector<EntityPair> mDiskDisk{};
+			std::vector<EntityPair> mDiskAABB{};
+			std::vector<EntityPair> mDiskPolygon{};
+		};
+
+		// Contacts are generated in parallel, before any collisions
+		// are resolved. If the disks were moved during the resolution
+		// of an earlier collision, the contact is generated again.
+		struct Contact
+		{
+			CollisionData mCollision{};
+			glm::vec2 mCentre1{};
+			glm::vec2 mCentre2{};
+			bool mIsColliding{};
+		};
+
 		void UpdateCollisions(World& world);
 		void DebugDrawing(const World& world);
 
@@ -91,6 +117,21 @@ namespace CE
 
 		std::vector<CollisionData> mPreviousCollisions{};
 
+		// These buffers are reused between steps to prevent reallocating
+		std::vector<entt::entity> mDisks{};
+		std::vector<CollisionPairs> mPairsPerBatch{};
+		CollisionPairs mPairs{};
+		std::vector<Contact> mDiskDiskContacts{};
+		std::vector<Contact> mDiskAABBContacts{};
+		std::vector<Contact> mDiskPolygonContacts{};
+		std::vector<CollisionData> mCurrentCollisions{};
+		std::vector<uint64> mSortedCollisionKeys{};
+		std::vector<std::reference_wrapper<const CollisionData>> mEnters{};
+		std::vector<std::reference_wrapper<const CollisionData>> mExits{};
+
+		static constexpr uint32 sMinNumOfDisksPerBroadPhaseBatch = 64;
+		static constexpr uint32 sMinNumOfPairsPerContactBatch = 256;
+
 		friend ReflectAccess;
 		static MetaType Reflect();
 		REFLECT_AT_START_UP(PhysicsSystem);
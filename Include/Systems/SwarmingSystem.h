@@ -1,12 +1,14 @@
 #pragma once
 #include "Components/Pathfinding/SwarmingTargetComponent.h"
 #include "Systems/System.h"
-#include "Utilities/Time.h"
+#include "Utilities/FlowFieldEngine.h"
 
 namespace CE
 {
 
-	// Moves the agents through the flowfield
+	// Moves the agents through the flowfield of the nearest target.
+	// Does not declare its component access, as it draws debug lines and
+	// queries the physics world for avoidance, neither of which is thread-safe.
 	class SwarmingAgentSystem final
 		: public System
 	{
@@ -14,42 +16,32 @@ namespace CE
 		void Update(World& world, float dt) override;
 
 	private:
+		std::vector<Line> mLinesOfSight{};
+
+		// char because std::vector<bool> is slower
+		std::vector<char> mIsLineOfSightBlocked{};
+
+		// The index of the target each agent moves towards
+		std::vector<uint32> mTargetOfAgent{};
+
 		friend ReflectAccess;
 		static MetaType Reflect();
 		REFLECT_AT_START_UP(SwarmingAgentSystem);
 	};
 
-	// Updates the flowfield
+	// Updates the flowfields of all the targets
 	class SwarmingTargetSystem final
 		: public System
 	{
 	public:
-		~SwarmingTargetSystem();
-
 		void Update(World& world, float dt) override;
 
 		void Render(const World& world) override;
 
-	private:
-		Cooldown mStartNewThreadCooldown{ .5f };
-
-		entt::entity mPendingForEntity{};
-		bool mIsPendingReady{};
-
-		SwarmingTargetComponent::FlowField mPendingFlowField{};
-
-		// Large buffers are stored in the system,
-		// so we can reuse the buffer.
-		// There can only be one flowfield by design,
-		// which allows us to place the data in the system.
-		std::vector<glm::vec2> mSmoothedDirections{};
+		SystemStaticTraits GetStaticTraits() const override;
 
-		// char because std::vector<bool> is slower
-		std::vector<char> mPendingIsBlocked{};
-		std::vector<int> mPendingOpenIndices{};
-		std::vector<float> mPendingDistanceField{};
-
-		std::thread mPendingThread{};
+	private:
+		FlowFieldEngine mFlowFieldEngine{};
 
 		friend ReflectAccess;
 		static MetaType Reflect();
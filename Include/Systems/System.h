@@ -19,6 +19,43 @@ namespace CE
 	};
 
 
+	class Registry;
+
+	// Describes which component storages a system reads from and writes to.
+	// Systems with the same priority are only executed in parallel if they
+	// both declared their access and neither writes to a storage the other accesses.
+	//
+	// By declaring its access, a system promises that it does not access any other
+	// storages, does not create or destroy entities, does not add or remove components
+	// and does not modify state outside of the components it writes to.
+	//
+	// Read and Write are defined in Registry.h.
+	class SystemComponentAccess
+	{
+	public:
+		template<typename... Components>
+		SystemComponentAccess& Read();
+
+		template<typename... Components>
+		SystemComponentAccess& Write();
+
+		// Returns the id of a storage that one of the systems writes to and the other accesses
+		std::optional<TypeId> FindConflict(const SystemComponentAccess& other) const;
+
+		// Creating a view will create the storages if they do not exist yet, which is not thread-safe.
+		// The scheduler makes sure the storages exist before executing systems in parallel.
+		void CreateStorages(Registry& registry) const;
+
+	private:
+		struct StorageAccess
+		{
+			TypeId mTypeId{};
+			void(*mCreateStorage)(Registry&) {};
+		};
+		std::vector<StorageAccess> mReads{};
+		std::vector<StorageAccess> mWrites{};
+	};
+
 	struct SystemStaticTraits
 	{
 		// If no fixed tick interval is provided, 
@@ -27,12 +64,17 @@ namespace CE
 		std::optional<float> mFixedTickInterval{};
 		
 		// Higher priorities get ticked first.
-		// Systems with the same priority MAY be exectuted in parallel.
+		// Systems with the same priority MAY be exectuted in parallel,
+		// see mComponentAccess.
 		int mPriority = static_cast<int>(TickPriorities::Tick);
 
 		bool mShouldTickBeforeBeginPlay{};
 
 		bool mShouldTickWhilstPaused{};
+
+		// Systems that do not declare which components they
+		// access are never executed in parallel with other systems.
+		std::optional<SystemComponentAccess> mComponentAccess{};
 	};
 
 	class World;
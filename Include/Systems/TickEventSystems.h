@@ -1,6 +1,8 @@
 #pragma once
 #include "Systems/System.h"
 #include "Utilities/Events.h"
+#include "Utilities/JobSystem.h"
+#include "Utilities/Random.h"
 #include "World/Registry.h"
 
 #include "entt/entity/runtime_view.hpp"
@@ -29,12 +31,26 @@ namespace CE
 		friend ReflectAccess;
 		static MetaType Reflect();
 
+		static const auto& GetEvent()
+		{
+			if constexpr (IsFixed)
+			{
+				return sOnFixedTick;
+			}
+			else
+			{
+				return sOnTick;
+			}
+		}
+
 		std::vector<BoundEvent> mBoundEvents;
+		std::vector<BoundTickBatch> mBoundTickBatches;
 	};
 
 	template <bool IsFixed, TickResponsibility Responsibility>
 	TickEventSystem<IsFixed, Responsibility>::TickEventSystem() :
-		mBoundEvents(IsFixed ? GetAllBoundEventsSlow(sOnFixedTick) : GetAllBoundEventsSlow(sOnTick))
+		mBoundEvents(GetAllBoundEventsSlow(GetEvent())),
+		mBoundTickBatches(GetAllBoundTickBatches(IsFixed ? sOnFixedTickBatch : sOnTickBatch))
 	{
 		if constexpr (Responsibility == TickResponsibility::BeforeBeginPlay)
 		{
@@ -44,6 +60,12 @@ namespace CE
 				{
 					return !bound.mFunc.get().GetProperties().Has(Props::sShouldTickBeforeBeginPlayTag);
 				}), mBoundEvents.end());
+
+			mBoundTickBatches.erase(std::remove_if(mBoundTickBatches.begin(), mBoundTickBatches.end(),
+				[](const BoundTickBatch& bound)
+				{
+					return !bound.mTraits.mShouldTickBeforeBeginPlay;
+				}), mBoundTickBatches.end());
 		}
 		else if constexpr (Responsibility == TickResponsibility::WhenPaused)
 		{
@@ -53,6 +75,12 @@ namespace CE
 				{
 					return !bound.mFunc.get().GetProperties().Has(Props::sShouldTickWhilstPausedTag);
 				}), mBoundEvents.end());
+
+			mBoundTickBatches.erase(std::remove_if(mBoundTickBatches.begin(), mBoundTickBatches.end(),
+				[](const BoundTickBatch& bound)
+				{
+					return !bound.mTraits.mShouldTickWhilstPaused;
+				}), mBoundTickBatches.end());
 		}
 	}
 
@@ -75,16 +103,54 @@ namespace CE
 
 			for (const entt::entity entity : view)
 			{
-				if (boundEvent.mIsStatic)
+				InvokeBoundEvent(boundEvent, GetEvent(), boundEvent.mIsStatic ? nullptr : storage->value(entity), world, entity, dt);
+			}
+		}
+
+		for (const BoundTickBatch& boundTickBatch : mBoundTickBatches)
+		{
+			entt::sparse_set* const storage = reg.Storage(boundTickBatch.mTypeId);
+
+			if (storage == nullptr
+				|| storage->empty())
+			{
+				continue;
+			}
+
+			const uint32 numOfComponents = static_cast<uint32>(storage->size());
+			const uint32 chunkSize = boundTickBatch.mChunkSize;
+			const uint32 numOfChunks = (numOfComponents + chunkSize - 1) / chunkSize;
+
+			// Selected by the registry before updating this system
+			const uint64 systemStream = Random::GetStream();
+
+			const auto invokeChunk = [&](const uint32 chunk)
 				{
-					boundEvent.mFunc.get().InvokeUncheckedUnpacked(world, entity, dt);
-				}
-				else
+					// Each thread has their own world stack, and the numbers drawn
+					// should not depend on which thread executes which chunk
+					World::PushWorld(world);
+					Random::SelectStream(Random::DeriveStream(systemStream, chunk));
+
+					const uint32 first = chunk * chunkSize;
+					boundTickBatch.Invoke(world, *storage, first, std::min(first + chunkSize, numOfComponents), dt);
+
+					World::PopWorld();
+				};
+
+			if (boundTickBatch.mTraits.mIsThreadSafe)
+			{
+				JobSystem::Get().ParallelFor(0, numOfChunks, invokeChunk);
+			}
+			else
+			{
+				for (uint32 chunk = 0; chunk < numOfChunks; chunk++)
 				{
-					MetaAny component{ boundEvent.mType.get(), storage->value(entity), false };
-					boundEvent.mFunc.get().InvokeUncheckedUnpacked(component, world, entity, dt);
+					invokeChunk(chunk);
 				}
 			}
+
+			// The calling thread may have executed any of the chunks
+			Random::SelectStream(Random::DeriveStream(systemStream, numOfChunks));
 		}
 	}
 
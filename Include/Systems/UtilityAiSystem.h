@@ -15,6 +15,9 @@ namespace CE
 		{
 			SystemStaticTraits traits{};
 			traits.mPriority = static_cast<int>(TickPriorities::PreTick) - 1;
+
+			// The states are implemented through events that may access
+			// any component, so no component access can be declared.
 			return traits;
 		}
 
@@ -34,6 +37,8 @@ namespace CE
 		{
 			SystemStaticTraits traits{};
 			traits.mPriority = static_cast<int>(TickPriorities::PreTick) + 1;
+
+			// Calls the evaluate and transition events, see AITickSystem
 			return traits;
 		}
 
@@ -1,14 +1,11 @@
 #pragma once
+#include "Utilities/JobSystem.h"
 
 namespace CE
 {
-	namespace Internal
-	{
-		struct Job;
-	}
-
 	// Like a regular thread, except this one
 	// does not slow down the main thread.
+	// The work is executed on the JobSystem.
 	class ASyncThread
 	{
 	public:
@@ -30,8 +27,11 @@ namespace CE
 		void Join();
 		void Detach();
 
+		// Can be used to schedule continuations
+		const JobHandle& GetJob() const { return mJob; }
+
 	private:
-		std::shared_ptr<Internal::Job> mJob{};
+		JobHandle mJob{};
 	};
 
 	template<typename T>
@@ -1,10 +1,13 @@
 #pragma once
 #include "Geometry2d.h"
+#include "DynamicAABBTree.h"
+#include "SpatialHashGrid.h"
 #include "Components/Physics2D/AABBColliderComponent.h"
 #include "Components/Physics2D/DiskColliderComponent.h"
 #include "Components/Physics2D/PhysicsBody2DComponent.h"
 #include "Components/Physics2D/PolygonColliderComponent.h"
 #include "World/Registry.h"
+#include "Utilities/JobSystem.h"
 
 namespace CE
 {
@@ -16,8 +19,35 @@ namespace CE
 		BVH() = default;
 		BVH(Physics& physics, CollisionLayer layer);
 
-		void Build();
-		void Refit();
+		// The colliders in a single layer. Physics::RebuildBVHs gathers these
+		// once per frame, so that each BVH only has to visit its own colliders.
+		struct Colliders
+		{
+			void Clear();
+
+			std::vector<entt::entity> mAABBs{};
+			std::vector<entt::entity> mDisks{};
+			std::vector<entt::entity> mPolygons{};
+		};
+
+		/*
+		Static layers are built using the surface area heuristic, which gives
+		fast queries but requires a full rebuild whenever objects are added.
+
+		Dynamic layers use a DynamicAABBTree, where objects are inserted,
+		moved and removed incrementally during Refit. Building a dynamic
+		BVH discards the tree and inserts every object again.
+
+		Layers that use a SpatialHashGrid are rebuilt from scratch during
+		both Build and Refit. See GetCollisionLayerBroadphase.
+		*/
+		void Build(const Colliders& colliders);
+		void Refit(const Colliders& colliders);
+
+		// Whether the objects are updated during Refit, so that Build only has to be called for static layers
+		bool IsDynamic() const { return mBroadphase != Broadphase::SurfaceAreaHeuristic; }
+
+		Broadphase GetBroadphase() const { return mBroadphase; }
 
 		template<bool AlwaysReturnValue>
 		struct DefaultShouldCheckFunction
@@ -43,12 +73,42 @@ namespace CE
 		template<typename OnIntersectFunction = DefaultOnIntersectFunction, typename ShouldCheckFunction = DefaultShouldCheckFunction<true>, typename ShouldReturnFunction = DefaultShouldReturnFunction<true>, typename InquirerShape, typename ...CallbackAdditionalArgs>
 		bool Query(const InquirerShape inquirerShape, CallbackAdditionalArgs&& ...args) const;
 
+		/**
+		 * \brief Performs a Query for each of the inquirers.
+		 *
+		 * Inquirers that are close to each other are grouped into packets that traverse the
+		 * BVH together, and the packets are distributed over the JobSystem.
+		 *
+		 * The index of the inquirer is passed to the callbacks, before the additional arguments.
+		 * The callbacks can be invoked from multiple threads at once, but never for the same inquirer.
+		 *
+		 * \param returnValues Receives what Query would have returned for each inquirer. May be left empty.
+		 */
+		template<typename OnIntersectFunction = DefaultOnIntersectFunction, typename ShouldCheckFunction = DefaultShouldCheckFunction<true>, typename ShouldReturnFunction = DefaultShouldReturnFunction<true>, typename InquirerShape, typename ...CallbackAdditionalArgs>
+		void QueryBatched(Span<const InquirerShape> inquirers, Span<char> returnValues, CallbackAdditionalArgs&& ...args) const;
+
+		// For each inquirer, whether it overlaps with any object
+		template<typename InquirerShape>
+		void QueryAnyHit(Span<const InquirerShape> inquirers, Span<char> isHit) const { QueryBatched(inquirers, isHit); }
+
+		// For each inquirer, all the objects it overlaps with. hits is resized to the number of inquirers.
+		template<typename InquirerShape>
+		void QueryAllHits(Span<const InquirerShape> inquirers, std::vector<std::vector<entt::entity>>& hits) const;
+
 		void DebugDraw() const;
 
 		CollisionLayer GetLayer() const { return mLayer; }
 
 		float GetAmountRefitted() const { return mAmountRefitted; }
 
+		/*
+		The leaves store a copy of the colliders, which is only synced with
+		the registry during Build and Refit. Call this after moving a disk
+		within the frame, so that later queries test its new position.
+		The bounds of the nodes are not updated until the next Refit.
+		*/
+		void OnDiskMoved(entt::entity owner, const TransformedDisk& disk);
+
 	private:
 		const Registry& GetRegistry() const;
 
@@ -66,9 +126,108 @@ namespace CE
 		};
 		static_assert(sizeof(Node) == 32);
 
+		/*
+		A copy of the colliders, stored in the order the leaves reference them.
+		This allows us to test the objects in a leaf without looking them up in the registry.
+
+		Every object stores its bounding box and centre. Disks also store their radius.
+		Polygons are still looked up in the registry, but only once their bounding box
+		was found to overlap.
+
+		Objects whose collider was removed since the last build have an empty
+		bounding box (min > max), and a negative radius if they are a disk.
+		*/
+		struct Objects
+		{
+			void Clear();
+			void Reserve(uint32 capacity);
+			void Add(entt::entity owner, TransformedAABB boundingBox, glm::vec2 centre, float radius);
+			void Set(uint32 index, TransformedAABB boundingBox, glm::vec2 centre, float radius);
+			void SetInvalid(uint32 index);
+			void Append(const Objects& other, uint32 otherIndex);
+			void CopyFrom(const Objects& other, uint32 otherIndex, uint32 index);
+			void PopBack();
+
+			bool IsValid(uint32 index) const { return mMinX[index] <= mMaxX[index]; }
+			TransformedAABB GetBoundingBox(uint32 index) const { return { { mMinX[index], mMinY[index] }, { mMaxX[index], mMaxY[index] } }; }
+			TransformedDisk GetDisk(uint32 index) const { return { { mCentreX[index], mCentreY[index] }, mRadius[index] }; }
+			glm::vec2 GetCentre(uint32 index) const { return { mCentreX[index], mCentreY[index] }; }
+
+			std::vector<entt::entity> mIds{};
+			std::vector<float> mMinX{};
+			std::vector<float> mMinY{};
+			std::vector<float> mMaxX{};
+			std::vector<float> mMaxY{};
+			std::vector<float> mCentreX{};
+			std::vector<float> mCentreY{};
+			std::vector<float> mRadius{};
+		};
+
 		float UpdateNodeBounds(Node& node);
 		void Subdivide(Node& node);
 
+		// Copies the colliders of the objects in this leaf from the registry
+		void SyncObjects(const Node& node);
+
+		// Returns a bitmask of the disks in [firstIndex, firstIndex + sNumOfDisksPerTest) that overlap with the inquirer.
+		uint32 FindOverlappingDisks(TransformedDisk inquirer, uint32 firstIndex) const;
+
+		// Inserts, moves and removes the objects in the dynamic tree to match the registry
+		void UpdateDynamicTree(const Colliders& colliders);
+
+		enum class ObjectType : uint8
+		{
+			AABB,
+			Disk,
+			Polygon,
+			NUM_OF_TYPES
+		};
+
+		void AddOrMoveDynamicObject(ObjectType type, entt::entity owner, TransformedAABB boundingBox, glm::vec2 centre, float radius);
+		void RemoveDynamicObject(uint32 index);
+
+		// Copies all the objects from the registry and bins them into the grid, in the order the grid stores them in
+		void BuildGrid(const Colliders& colliders);
+
+		// Fills mObjectIndexOfEntity for the static tree and the grid. The dynamic tree keeps it up to date itself.
+		void UpdateObjectIndexOfEntity();
+
+		template<typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename InquirerShape, typename ...CallbackAdditionalArgs>
+		bool QueryLeaf(const Node& node, const InquirerShape& inquirerShape, CallbackAdditionalArgs&& ...args) const;
+
+		template<typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename InquirerShape, typename ...CallbackAdditionalArgs>
+		bool QueryDynamicObject(uint32 index, const InquirerShape& inquirerShape, CallbackAdditionalArgs&& ...args) const;
+
+		/**
+		 * \brief Traverses the static tree for a packet of inquirers. Each bit in the mask represents an inquirer.
+		 *
+		 * testNode(boundingBox, mask) returns the inquirers in the mask that overlap with the bounding box.
+		 * onLeaf(node, mask) returns the inquirers that have finished and no longer need to be tested.
+		 */
+		template<typename TestNodeFunction, typename OnLeafFunction>
+		void QueryPacket(uint32 mask, TestNodeFunction&& testNode, OnLeafFunction&& onLeaf) const;
+
+		struct AddHitFunction
+		{
+			template<typename ObjectShapeType>
+			static void Callback(const ObjectShapeType&, entt::entity owner, uint32 inquirerIndex, std::vector<std::vector<entt::entity>>& hits)
+			{
+				hits[inquirerIndex].emplace_back(owner);
+			}
+		};
+
+		// Inquirers are sorted along a Z-order curve, so that the inquirers in a packet are close to each other
+		static void SortByMortonCode(Span<const glm::vec2> positions, std::vector<uint32>& order);
+
+		template<typename InquirerShape>
+		static glm::vec2 GetInquirerCentre(const InquirerShape& inquirerShape);
+
+		template<typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename InquirerShape, typename ...CallbackAdditionalArgs>
+		bool QueryDynamic(const InquirerShape& inquirerShape, CallbackAdditionalArgs&& ...args) const;
+
+		template<typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename InquirerShape, typename ...CallbackAdditionalArgs>
+		bool QueryDisks(const Node& node, const InquirerShape& inquirerShape, CallbackAdditionalArgs&& ...args) const;
+
 		template<typename OnIntersectFunction, typename ShouldReturnFunction, typename InquirerShapeType, typename ObjectShapeType, typename ...CallbackAdditionalArgs>
 		static FORCE_INLINE bool TestAgainstObject(const InquirerShapeType inquirerShape, const ObjectShapeType& object, entt::entity owner, CallbackAdditionalArgs&& ...args);
 
@@ -83,11 +242,47 @@ namespace CE
 		Physics* mPhysics;
 		CollisionLayer mLayer{};
 
-		std::vector<entt::entity> mIds{};
+		Objects mObjects{};
 		std::vector<Node> mNodes{};
 
+		// Used during Subdivide, stored here to prevent reallocating
+		Objects mChildrenObjects[2]{};
+		bool mEdgeCaseFlipper{};
+
 		bool mEmpty = true;
 		float mAmountRefitted{};
+
+		Broadphase mBroadphase{};
+
+		// Only used by dynamic BVHs. Each leaf of the tree stores the
+		// index of its object in mObjects. The vectors below are indexed
+		// the same way as mObjects. mObjectTypes is also used by the grid.
+		DynamicAABBTree mTree{};
+		std::vector<uint32> mProxies{};
+		std::vector<ObjectType> mObjectTypes{};
+		std::vector<bool> mWasObjectFound{};
+
+		// The index of the object in mObjects for each type of collider, indexed by entt::to_entity.
+		// Used by every broadphase, so that OnDiskMoved can find the object.
+		std::array<std::vector<uint32>, static_cast<size_t>(ObjectType::NUM_OF_TYPES)> mObjectIndexOfEntity{};
+
+		// Only used by BVHs that use a SpatialHashGrid, in which case mObjects
+		// is stored in the same order as the objects in the grid.
+		SpatialHashGrid mGrid{};
+
+		// Used during BuildGrid, stored here to prevent reallocating
+		Objects mUnsortedObjects{};
+		std::vector<TransformedAABB> mUnsortedBoundingBoxes{};
+		std::vector<ObjectType> mUnsortedObjectTypes{};
+		std::vector<uint32> mGridOrder{};
+
+		static constexpr uint32 sMaxNumOfObjectsInLeaf = 4;
+
+		// The object arrays are padded, so that the disks can always be loaded in groups of this size.
+		static constexpr uint32 sNumOfDisksPerTest = 4;
+
+		// One bit for each inquirer in a uint32 mask
+		static constexpr uint32 sNumOfInquirersPerPacket = 32;
 	};
 
 	template <typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename
@@ -98,8 +293,12 @@ namespace CE
 		const Node* stack[stackSize];
 		uint32 stackPtr = 0;
 
+		if (IsDynamic())
+		{
+			return QueryDynamic<OnIntersectFunction, ShouldCheckFunction, ShouldReturnFunction>(inquirerShape, std::forward<CallbackAdditionalArgs>(args)...);
+		}
+
 		const Node* node = &mNodes[0];
-		const Registry& reg = GetRegistry();
 
 		while (1)
 		{
@@ -142,80 +341,387 @@ namespace CE
 				continue;
 			}
 
-			uint32 indexOfId = node->mStartIndex;
+			if (QueryLeaf<OnIntersectFunction, ShouldCheckFunction, ShouldReturnFunction>(*node, inquirerShape, std::forward<CallbackAdditionalArgs>(args)...))
+			{
+				return true;
+			}
 
-			for (uint32 i = 0; i < node->mNumOfAABBS; i++, indexOfId++)
+			if (stackPtr == 0)
 			{
-				const entt::entity owner = mIds[indexOfId];
+				break;
+			}
+			node = stack[--stackPtr];
+		}
 
-				if(!ShouldCheckFunction::template Callback<TransformedAABBColliderComponent>(owner, std::forward<CallbackAdditionalArgs>(args)...))
-				{
-					continue;
-				}
+		return false;
+	}
+
+	template <typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename
+		InquirerShape, typename ... CallbackAdditionalArgs>
+	void BVH::QueryBatched(Span<const InquirerShape> inquirers, Span<char> returnValues, CallbackAdditionalArgs&&... args) const
+	{
+		ASSERT(returnValues.empty() || returnValues.size() == inquirers.size());
+		std::fill(returnValues.begin(), returnValues.end(), false);
+
+		const uint32 numOfInquirers = static_cast<uint32>(inquirers.size());
+
+		if (numOfInquirers == 0
+			|| mEmpty)
+		{
+			return;
+		}
+
+		std::vector<glm::vec2> centres{};
+		centres.reserve(numOfInquirers);
+
+		for (const InquirerShape& inquirer : inquirers)
+		{
+			centres.emplace_back(GetInquirerCentre(inquirer));
+		}
+
+		std::vector<uint32> order{};
+		SortByMortonCode(centres, order);
+
+		const uint32 numOfPackets = (numOfInquirers + sNumOfInquirersPerPacket - 1) / sNumOfInquirersPerPacket;
 
-				const TransformedAABB* aabb = reg.TryGet<TransformedAABBColliderComponent>(owner);
+		JobSystem::Get().ParallelFor(0, numOfPackets,
+			[&](uint32 packetIndex)
+			{
+				const uint32 firstInPacket = packetIndex * sNumOfInquirersPerPacket;
+				const uint32 numInPacket = std::min(numOfInquirers - firstInPacket, sNumOfInquirersPerPacket);
+				const uint32* const packet = &order[firstInPacket];
+
+				const auto testNode = [&](const TransformedAABB& boundingBox, uint32 mask) -> uint32
+					{
+						uint32 overlapping{};
+
+						for (uint32 i = 0; mask != 0; i++, mask >>= 1)
+						{
+							if ((mask & 1) != 0
+								&& AreOverlapping(boundingBox, inquirers[packet[i]]))
+							{
+								overlapping |= 1u << i;
+							}
+						}
 
-				if (aabb == nullptr)
+						return overlapping;
+					};
+
+				const auto onLeaf = [&](const auto& leaf, uint32 mask) -> uint32
+					{
+						uint32 finished{};
+
+						for (uint32 i = 0; mask != 0; i++, mask >>= 1)
+						{
+							if ((mask & 1) == 0)
+							{
+								continue;
+							}
+
+							uint32 inquirerIndex = packet[i];
+							bool hasReturned{};
+
+							if constexpr (std::is_same_v<std::decay_t<decltype(leaf)>, Node>)
+							{
+								hasReturned = QueryLeaf<OnIntersectFunction, ShouldCheckFunction, ShouldReturnFunction>(leaf, inquirers[inquirerIndex], inquirerIndex, args...);
+							}
+							else
+							{
+								hasReturned = QueryDynamicObject<OnIntersectFunction, ShouldCheckFunction, ShouldReturnFunction>(leaf, inquirers[inquirerIndex], inquirerIndex, args...);
+							}
+
+							if (hasReturned)
+							{
+								finished |= 1u << i;
+
+								if (!returnValues.empty())
+								{
+									returnValues[inquirerIndex] = true;
+								}
+							}
+						}
+
+						return finished;
+					};
+
+				const uint32 mask = numInPacket == 32 ? ~0u : (1u << numInPacket) - 1;
+
+				if (mBroadphase == Broadphase::SpatialHashGrid)
 				{
-					continue;
+					// The grid only visits the cells around each inquirer, so there is little to share between the inquirers in a packet
+					for (uint32 i = 0; i < numInPacket; i++)
+					{
+						const uint32 inquirerIndex = packet[i];
+
+						const bool hasReturned = mGrid.Query(inquirers[inquirerIndex],
+							[&](uint32 index) -> bool
+							{
+								return QueryDynamicObject<OnIntersectFunction, ShouldCheckFunction, ShouldReturnFunction>(index, inquirers[inquirerIndex], inquirerIndex, args...);
+							});
+
+						if (hasReturned
+							&& !returnValues.empty())
+						{
+							returnValues[inquirerIndex] = true;
+						}
+					}
 				}
-
-				if (TestAgainstObject<OnIntersectFunction, ShouldReturnFunction>(inquirerShape, *aabb, owner, std::forward<CallbackAdditionalArgs>(args)...))
+				else if (mBroadphase == Broadphase::DynamicTree)
 				{
-					return true;
+					mTree.QueryPacket(mask, testNode, onLeaf);
+				}
+				else
+				{
+					QueryPacket(mask, testNode, onLeaf);
 				}
+			});
+	}
+
+	template <typename InquirerShape>
+	void BVH::QueryAllHits(Span<const InquirerShape> inquirers, std::vector<std::vector<entt::entity>>& hits) const
+	{
+		hits.resize(inquirers.size());
+
+		for (std::vector<entt::entity>& hitsOfInquirer : hits)
+		{
+			hitsOfInquirer.clear();
+		}
+
+		QueryBatched<AddHitFunction, DefaultShouldCheckFunction<true>, DefaultShouldReturnFunction<false>>(inquirers, {}, hits);
+	}
+
+	template <typename TestNodeFunction, typename OnLeafFunction>
+	void BVH::QueryPacket(const uint32 mask, TestNodeFunction&& testNode, OnLeafFunction&& onLeaf) const
+	{
+		struct StackEntry
+		{
+			const Node* mNode{};
+			uint32 mMask{};
+		};
+
+		static constexpr uint32 stackSize = 256;
+		StackEntry stack[stackSize];
+		uint32 stackPtr = 0;
+
+		// Like in Query, the bounding box of the root is not tested
+		stack[stackPtr++] = { &mNodes[0], mask };
+		uint32 activeMask = mask;
+
+		while (stackPtr != 0)
+		{
+			const StackEntry entry = stack[--stackPtr];
+			const uint32 entryMask = entry.mMask & activeMask;
+
+			if (entryMask == 0)
+			{
+				continue;
 			}
 
-			for (uint32 i = 0; i < node->mNumOfCircles; i++, indexOfId++)
+			const Node& node = *entry.mNode;
+
+			if (node.mTotalNumOfObjects != 0)
 			{
-				const entt::entity owner = mIds[indexOfId];
+				activeMask &= ~onLeaf(node, entryMask);
+				continue;
+			}
 
-				if (!ShouldCheckFunction::template Callback<TransformedDiskColliderComponent>(owner, std::forward<CallbackAdditionalArgs>(args)...))
+			for (uint32 i = 2; i-- > 0;)
+			{
+				const Node& child = mNodes[node.mStartIndex + i];
+				const uint32 childMask = testNode(child.mBoundingBox, entryMask);
+
+				if (childMask != 0)
 				{
-					continue;
+					ASSERT(stackPtr + 1 < stackSize);
+					stack[stackPtr++] = { &child, childMask };
 				}
+			}
+		}
+	}
+
+	template <typename InquirerShape>
+	glm::vec2 BVH::GetInquirerCentre(const InquirerShape& inquirerShape)
+	{
+		if constexpr (std::is_same_v<InquirerShape, glm::vec2>)
+		{
+			return inquirerShape;
+		}
+		else if constexpr (std::is_same_v<InquirerShape, Line>)
+		{
+			return (inquirerShape.mStart + inquirerShape.mEnd) * .5f;
+		}
+		else
+		{
+			return inquirerShape.GetCentre();
+		}
+	}
 
-				const TransformedDisk* circle = reg.TryGet<TransformedDiskColliderComponent>(owner);
+	template <typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename
+		InquirerShape, typename ... CallbackAdditionalArgs>
+	bool BVH::QueryDynamic(const InquirerShape& inquirerShape, CallbackAdditionalArgs&&... args) const
+	{
+		const auto onObject = [&](uint32 index) -> bool
+			{
+				return QueryDynamicObject<OnIntersectFunction, ShouldCheckFunction, ShouldReturnFunction>(index, inquirerShape, std::forward<CallbackAdditionalArgs>(args)...);
+			};
 
-				if (circle == nullptr)
-				{
-					continue;
-				}
+		if (mBroadphase == Broadphase::SpatialHashGrid)
+		{
+			return mGrid.Query(inquirerShape, onObject);
+		}
+
+		return mTree.Query(inquirerShape, onObject);
+	}
+
+	template <typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename
+		InquirerShape, typename ... CallbackAdditionalArgs>
+	bool BVH::QueryDynamicObject(const uint32 index, const InquirerShape& inquirerShape, CallbackAdditionalArgs&&... args) const
+	{
+		const entt::entity owner = mObjects.mIds[index];
+
+		switch (mObjectTypes[index])
+		{
+		case ObjectType::AABB:
+			return ShouldCheckFunction::template Callback<TransformedAABBColliderComponent>(owner, std::forward<CallbackAdditionalArgs>(args)...)
+				&& TestAgainstObject<OnIntersectFunction, ShouldReturnFunction>(inquirerShape, mObjects.GetBoundingBox(index), owner, std::forward<CallbackAdditionalArgs>(args)...);
+		case ObjectType::Disk:
+			return ShouldCheckFunction::template Callback<TransformedDiskColliderComponent>(owner, std::forward<CallbackAdditionalArgs>(args)...)
+				&& TestAgainstObject<OnIntersectFunction, ShouldReturnFunction>(inquirerShape, mObjects.GetDisk(index), owner, std::forward<CallbackAdditionalArgs>(args)...);
+		case ObjectType::Polygon:
+		{
+			if (!AreOverlapping(mObjects.GetBoundingBox(index), inquirerShape)
+				|| !ShouldCheckFunction::template Callback<TransformedPolygonColliderComponent>(owner, std::forward<CallbackAdditionalArgs>(args)...))
+			{
+				return false;
+			}
+
+			const TransformedPolygon* polygon = GetRegistry().TryGet<TransformedPolygonColliderComponent>(owner);
+
+			return polygon != nullptr
+				&& TestAgainstObject<OnIntersectFunction, ShouldReturnFunction>(inquirerShape, *polygon, owner, std::forward<CallbackAdditionalArgs>(args)...);
+		}
+		default:
+			ABORT;
+			return false;
+		}
+	}
+
+	template <typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename
+		InquirerShape, typename ... CallbackAdditionalArgs>
+	bool BVH::QueryLeaf(const Node& node, const InquirerShape& inquirerShape, CallbackAdditionalArgs&&... args) const
+	{
+		uint32 index = node.mStartIndex;
+
+		for (uint32 i = 0; i < node.mNumOfAABBS; i++, index++)
+		{
+			if (!mObjects.IsValid(index))
+			{
+				continue;
+			}
+
+			const entt::entity owner = mObjects.mIds[index];
 
-				if (TestAgainstObject<OnIntersectFunction, ShouldReturnFunction>(inquirerShape, *circle, owner, std::forward<CallbackAdditionalArgs>(args)...))
+			if(!ShouldCheckFunction::template Callback<TransformedAABBColliderComponent>(owner, std::forward<CallbackAdditionalArgs>(args)...))
+			{
+				continue;
+			}
+
+			if (TestAgainstObject<OnIntersectFunction, ShouldReturnFunction>(inquirerShape, mObjects.GetBoundingBox(index), owner, std::forward<CallbackAdditionalArgs>(args)...))
+			{
+				return true;
+			}
+		}
+
+		if (QueryDisks<OnIntersectFunction, ShouldCheckFunction, ShouldReturnFunction>(node, inquirerShape, std::forward<CallbackAdditionalArgs>(args)...))
+		{
+			return true;
+		}
+		index += node.mNumOfCircles;
+
+		const uint32 numOfPolygons = node.mTotalNumOfObjects - node.mNumOfAABBS - node.mNumOfCircles;
+		for (uint32 i = 0; i < numOfPolygons; i++, index++)
+		{
+			// Removed polygons have an empty bounding box, so they are skipped here as well
+			if (!AreOverlapping(mObjects.GetBoundingBox(index), inquirerShape))
+			{
+				continue;
+			}
+
+			const entt::entity owner = mObjects.mIds[index];
+
+			if (!ShouldCheckFunction::template Callback<TransformedPolygonColliderComponent>(owner, std::forward<CallbackAdditionalArgs>(args)...))
+			{
+				continue;
+			}
+
+			const TransformedPolygon* polygon = GetRegistry().TryGet<TransformedPolygonColliderComponent>(owner);
+
+			if (polygon == nullptr)
+			{
+				continue;
+			}
+
+			if (TestAgainstObject<OnIntersectFunction, ShouldReturnFunction>(inquirerShape, *polygon, owner, std::forward<CallbackAdditionalArgs>(args)...))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template <typename OnIntersectFunction, typename ShouldCheckFunction, typename ShouldReturnFunction, typename
+		InquirerShape, typename ... CallbackAdditionalArgs>
+	bool BVH::QueryDisks(const Node& node, const InquirerShape& inquirerShape, CallbackAdditionalArgs&&... args) const
+	{
+		const uint32 firstDisk = node.mStartIndex + node.mNumOfAABBS;
+
+		for (uint32 groupStart = 0; groupStart < node.mNumOfCircles; groupStart += sNumOfDisksPerTest)
+		{
+			const uint32 numInGroup = std::min(node.mNumOfCircles - groupStart, sNumOfDisksPerTest);
+			uint32 overlapping{};
+
+			if constexpr (std::is_same_v<InquirerShape, TransformedDisk>)
+			{
+				overlapping = FindOverlappingDisks(inquirerShape, firstDisk + groupStart) & ((1u << numInGroup) - 1);
+			}
+			else
+			{
+				for (uint32 i = 0; i < numInGroup; i++)
 				{
-					return true;
+					const uint32 index = firstDisk + groupStart + i;
+
+					if (mObjects.mRadius[index] >= 0.0f
+						&& AreOverlapping(mObjects.GetDisk(index), inquirerShape))
+					{
+						overlapping |= 1u << i;
+					}
 				}
 			}
 
-			const uint32 numOfPolygons = node->mTotalNumOfObjects - node->mNumOfAABBS - node->mNumOfCircles;
-			for (uint32 i = 0; i < numOfPolygons; i++, indexOfId++)
+			for (uint32 i = 0; overlapping != 0; i++, overlapping >>= 1)
 			{
-				const entt::entity owner = mIds[indexOfId];
-
-				if (!ShouldCheckFunction::template Callback<TransformedPolygonColliderComponent>(owner, std::forward<CallbackAdditionalArgs>(args)...))
+				if ((overlapping & 1) == 0)
 				{
 					continue;
 				}
 
-				const TransformedPolygon* polygon = reg.TryGet<TransformedPolygonColliderComponent>(owner);
+				const uint32 index = firstDisk + groupStart + i;
+				const entt::entity owner = mObjects.mIds[index];
 
-				if (polygon == nullptr)
+				if (!ShouldCheckFunction::template Callback<TransformedDiskColliderComponent>(owner, std::forward<CallbackAdditionalArgs>(args)...))
 				{
 					continue;
 				}
 
-				if (TestAgainstObject<OnIntersectFunction, ShouldReturnFunction>(inquirerShape, *polygon, owner, std::forward<CallbackAdditionalArgs>(args)...))
+				const TransformedDisk disk = mObjects.GetDisk(index);
+				OnIntersectFunction::Callback(disk, owner, std::forward<CallbackAdditionalArgs>(args)...);
+
+				if (ShouldReturnFunction::Callback(disk, owner, std::forward<CallbackAdditionalArgs>(args)...))
 				{
 					return true;
 				}
 			}
-
-			if (stackPtr == 0)
-			{
-				break;
-			}
-			node = stack[--stackPtr];
 		}
 
 		return false;
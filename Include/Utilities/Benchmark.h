@@ -26,4 +26,126 @@ namespace CE
 
 	BenchmarkResult BenchMark(World& world, BenchmarkParams params);
 	BenchmarkResult BenchMark(std::string_view levelName, BenchmarkParams params);
-}
\ No newline at end of file
+
+	struct BenchmarkSuiteParams
+	{
+		std::vector<std::string> mLevelNames{};
+
+		// Each level is ticked this many times, with a fixed step size
+		uint32 mNumOfTicks = 1'000;
+
+		// Ticks before the measuring starts, to warm the caches
+		uint32 mNumOfWarmUpTicks = 10;
+
+		// Random is seeded with this before each level is created
+		uint32 mSeed = 0xbadC0ffe;
+
+		float mTickStepSize = 1.0f / 60.0f;
+	};
+
+	// In milliseconds
+	struct DurationStatistics
+	{
+		double mAverage{};
+		double mP50{};
+		double mP95{};
+		double mP99{};
+		double mMax{};
+	};
+
+	struct SystemBenchmarkResult
+	{
+		std::string mName{};
+
+		// The time spent in System::Update during each tick
+		DurationStatistics mTimePerTick{};
+	};
+
+	struct LevelBenchmarkResult
+	{
+		std::string mLevelName{};
+		uint32 mNumOfTicks{};
+		uint32 mSeed{};
+
+		DurationStatistics mTickDuration{};
+		std::vector<SystemBenchmarkResult> mSystems{};
+
+		// The highest memory usage of the process while this level was being benchmarked,
+		// minus the memory that was already in use before the level was loaded. Sampled once per tick.
+		uint64 mPeakMemoryBytes{};
+
+		uint64 mMaxNumOfEntities{};
+		uint64 mFinalNumOfEntities{};
+	};
+
+	struct BenchmarkReport
+	{
+		void ExportToJSON(std::ostream& stream) const;
+		static std::optional<BenchmarkReport> ImportFromJSON(std::istream& stream);
+
+		std::vector<LevelBenchmarkResult> mLevels{};
+	};
+
+	struct BenchmarkThresholds
+	{
+		// A regression is reported when a value increases by more than this percentage of the baseline
+		float mTickDurationPercentage = 10.0f;
+		float mSystemPercentage = 25.0f;
+		float mPeakMemoryPercentage = 10.0f;
+
+		// Timings that increased by less than this are considered noise
+		double mMinTimeIncreaseMs = .05;
+	};
+
+	struct BenchmarkRegression
+	{
+		std::string mLevelName{};
+		std::string mMetric{};
+		double mBaseline{};
+		double mCurrent{};
+	};
+
+	BenchmarkReport RunBenchmarkSuite(const BenchmarkSuiteParams& params);
+
+	struct TextureLoadBenchmarkResult
+	{
+		std::string mLevelName{};
+		uint32 mNumOfTextures{};
+
+		// The time it took to load all the textures of the level, once for each repetition.
+		// Loaded from their files, as they are currently stored.
+		DurationStatistics mLoadDuration{};
+
+		// Loaded from memory, encoded as a PNG, as textures were stored before their mips were.
+		DurationStatistics mPNGLoadDuration{};
+	};
+
+	/**
+	 * \brief Measures how long it takes before the textures used by a level are ready to be sent to the GPU.
+	 *
+	 * The textures are found by creating the level's world. Each texture is then loaded again from its
+	 * file, and from a PNG encoded copy of its pixels, which shows how much time storing the mips saves.
+	 */
+	TextureLoadBenchmarkResult BenchmarkTextureLoading(std::string_view levelName, uint32 numOfRepetitions = 5);
+
+	std::vector<BenchmarkRegression> FindRegressions(const BenchmarkReport& baseline, const BenchmarkReport& current, const BenchmarkThresholds& thresholds);
+
+	/**
+	 * \brief Runs the benchmark suite in headless mode, writes the report, and compares it against the baseline.
+	 * \return The number of regressions.
+	 *
+	 * Each argument after "run_benchmarks" is a key=value pair, all of them are optional:
+	 *
+	 *	run_benchmarks levels=L_Level1,L_Level2 ticks=1000 warmup=10 seed=1234 output=Report.json baseline=Baseline.json
+	 *		tick_threshold=10 system_threshold=25 memory_threshold=10 min_time_increase=0.05
+	 *
+	 * All levels are benchmarked if none are specified. The report is written to
+	 * Intermediate/Benchmarks/BenchmarkReport.json unless an output is specified.
+	 *
+	 * The texture loading of specific levels can be benchmarked as well, see BenchmarkTextureLoading.
+	 * The results are logged, they are not part of the report:
+	 *
+	 *	run_benchmarks texture_load_levels=L_Level1 texture_load_repetitions=5
+	 */
+	uint32 RunBenchmarksFromCommandLine(int argc, char* argv[]);
+}
@@ -3,34 +3,254 @@
 
 namespace CE
 {
+	namespace Internal
+	{
+		/*
+		True for types whose cereal binary representation is exactly their object representation,
+		which allows them to be copied in and out of a buffer with a single memcpy.
+
+		This must produce the same bytes as cereal does, so that data saved through
+		either path can be loaded by the other.
+		*/
+		template<typename T>
+		struct IsRawBinary :
+			std::bool_constant<std::is_arithmetic_v<T> || std::is_enum_v<T>>
+		{};
+
+		template<glm::length_t L, typename T>
+		struct IsRawBinary<glm::vec<L, T>> : IsRawBinary<T> {};
+
+		template<glm::length_t X, glm::length_t Y, typename T>
+		struct IsRawBinary<glm::mat<X, Y, T>> : IsRawBinary<T> {};
+
+		template<>
+		struct IsRawBinary<glm::quat> : std::true_type {};
+
+		template<typename T, size_t N>
+		struct IsRawBinary<std::array<T, N>> : IsRawBinary<T> {};
+
+		template<typename T>
+		static constexpr bool sIsRawBinary = IsRawBinary<T>::value && std::is_trivially_copyable_v<T>;
+
+		// Types that cereal serializes as a uint64 size, followed by the elements
+		template<typename T>
+		struct IsRawBinaryRange : std::false_type {};
+
+		template<typename T>
+		struct IsRawBinaryRange<std::vector<T>> : std::bool_constant<sIsRawBinary<T> && !std::is_same_v<T, bool>> {};
+
+		template<>
+		struct IsRawBinaryRange<std::string> : std::true_type {};
+
+		// A streambuf that appends to a string, so cereal can write directly into a BinaryWriter's buffer
+		class AppendToStringBuf :
+			public std::streambuf
+		{
+		public:
+			AppendToStringBuf(std::string& buffer) :
+				mBuffer(buffer)
+			{}
+
+		protected:
+			int_type overflow(int_type c) override
+			{
+				if (!traits_type::eq_int_type(c, traits_type::eof()))
+				{
+					mBuffer.push_back(traits_type::to_char_type(c));
+				}
+				return traits_type::not_eof(c);
+			}
+
+			std::streamsize xsputn(const char* s, std::streamsize count) override
+			{
+				mBuffer.append(s, static_cast<size_t>(count));
+				return count;
+			}
+
+		private:
+			std::string& mBuffer;
+		};
+	}
+
+	/*
+	Appends the binary representation of values to a buffer owned by the caller.
+
+	The buffer is never cleared, only appended to, so the same buffer can be reused
+	for many values without reallocating. Arithmetic types, enums, glm types and vectors
+	of those are copied directly, everything else is serialized using cereal.
+
+	The output is identical to that of a cereal::BinaryOutputArchive.
+	*/
+	class BinaryWriter
+	{
+	public:
+		BinaryWriter(std::string& buffer) :
+			mBuffer(buffer)
+		{}
+
+		template<typename T>
+		void Write(const T& value);
+
+		void WriteBytes(const void* data, size_t numOfBytes)
+		{
+			mBuffer.append(static_cast<const char*>(data), numOfBytes);
+		}
+
+		std::string& GetBuffer() { return mBuffer; }
+
+	private:
+		std::string& mBuffer;
+	};
+
+	/*
+	Reads values written by a BinaryWriter, or by a cereal::BinaryOutputArchive.
+
+	Does not own the bytes it reads from. Once a read fails, all subsequent reads
+	will fail as well.
+	*/
+	class BinaryReader
+	{
+	public:
+		BinaryReader(Span<const std::byte> bytes) :
+			mBytes(bytes)
+		{}
+
+		BinaryReader(std::string_view bytes) :
+			mBytes(reinterpret_cast<const std::byte*>(bytes.data()), bytes.size())
+		{}
+
+		// Returns false if there were not enough bytes left, or if cereal reported an error
+		template<typename T>
+		bool Read(T& out);
+
+		bool ReadBytes(void* dest, size_t numOfBytes)
+		{
+			if (mHasFailed
+				|| GetNumOfBytesLeft() < numOfBytes)
+			{
+				mHasFailed = true;
+				return false;
+			}
+
+			if (numOfBytes != 0)
+			{
+				memcpy(dest, mBytes.data() + mPosition, numOfBytes);
+			}
+			mPosition += numOfBytes;
+			return true;
+		}
+
+		// Returns the next numOfBytes bytes without copying them, or std::nullopt if there are not enough bytes left
+		std::optional<std::string_view> ReadView(size_t numOfBytes)
+		{
+			if (mHasFailed
+				|| GetNumOfBytesLeft() < numOfBytes)
+			{
+				mHasFailed = true;
+				return std::nullopt;
+			}
+
+			const std::string_view view{ reinterpret_cast<const char*>(mBytes.data()) + mPosition, numOfBytes };
+			mPosition += numOfBytes;
+			return view;
+		}
+
+		size_t GetNumOfBytesLeft() const { return mBytes.size() - mPosition; }
+		bool HasFailed() const { return mHasFailed; }
+
+	private:
+		Span<const std::byte> mBytes{};
+		size_t mPosition{};
+		bool mHasFailed{};
+	};
+
 	template<typename T>
-	std::string ToBinary(const T& value)
+	void BinaryWriter::Write(const T& value)
 	{
-		std::stringstream ss{};
-		
+		if constexpr (Internal::sIsRawBinary<T>)
+		{
+			WriteBytes(&value, sizeof(T));
+		}
+		else if constexpr (Internal::IsRawBinaryRange<T>::value)
+		{
+			const uint64 size = static_cast<uint64>(value.size());
+			WriteBytes(&size, sizeof(size));
+			WriteBytes(value.data(), value.size() * sizeof(typename T::value_type));
+		}
+		else
 		{
-			cereal::BinaryOutputArchive outArchive{ ss };
+			Internal::AppendToStringBuf buf{ mBuffer };
+			std::ostream stream{ &buf };
+			cereal::BinaryOutputArchive outArchive{ stream };
 			outArchive(value);
 		}
-
-		return ss.str();
 	}
 
 	template<typename T>
-	void FromBinary(std::string_view binaryString, T& out)
+	bool BinaryReader::Read(T& out)
 	{
-		try
+		if constexpr (Internal::sIsRawBinary<T>)
 		{
-			view_istream view{ binaryString };
-			cereal::BinaryInputArchive inArchive{ view };
-			inArchive(out);
+			return ReadBytes(&out, sizeof(T));
 		}
-		catch ([[maybe_unused]] const std::exception& e)
+		else if constexpr (Internal::IsRawBinaryRange<T>::value)
 		{
-			LOG(LogCore, Verbose, "Invalid value serialized - {}", e.what());
+			uint64 size{};
+
+			if (!ReadBytes(&size, sizeof(size))
+				|| size > GetNumOfBytesLeft() / sizeof(typename T::value_type))
+			{
+				mHasFailed = true;
+				return false;
+			}
+
+			out.resize(static_cast<size_t>(size));
+			return ReadBytes(out.data(), out.size() * sizeof(typename T::value_type));
+		}
+		else
+		{
+			if (mHasFailed)
+			{
+				return false;
+			}
+
+			try
+			{
+				view_istream view{ std::string_view{ reinterpret_cast<const char*>(mBytes.data()) + mPosition, GetNumOfBytesLeft() } };
+
+				{
+					cereal::BinaryInputArchive inArchive{ view };
+					inArchive(out);
+				}
+
+				// tellg fails if cereal attempted to read past the end, in which case all bytes were consumed
+				const std::streamoff numOfBytesRead = view.tellg();
+				mPosition += numOfBytesRead < 0 ? GetNumOfBytesLeft() : static_cast<size_t>(numOfBytesRead);
+				return true;
+			}
+			catch ([[maybe_unused]] const std::exception& e)
+			{
+				LOG(LogCore, Verbose, "Invalid value serialized - {}", e.what());
+				mHasFailed = true;
+				return false;
+			}
 		}
 	}
 
+	template<typename T>
+	std::string ToBinary(const T& value)
+	{
+		std::string binary{};
+		BinaryWriter{ binary }.Write(value);
+		return binary;
+	}
+
+	template<typename T>
+	void FromBinary(std::string_view binaryString, T& out)
+	{
+		BinaryReader{ binaryString }.Read(out);
+	}
+
 	template<typename T>
 	T FromBinary(std::string_view readableString)
 	{
@@ -0,0 +1,193 @@
+#pragma once
+#include "Geometry2d.h"
+
+namespace CE
+{
+	/*
+	A bounding volume hierarchy that supports inserting, removing and moving
+	objects in O(log n), at the cost of a lower quality tree than one built
+	using the surface area heuristic.
+
+	Each leaf holds a single object. The bounding box of the leaf is
+	'fattened', so that objects can move a little without having to be
+	reinserted. The tree is kept balanced using rotations.
+	*/
+	class DynamicAABBTree
+	{
+	public:
+		static constexpr uint32 sNull = std::numeric_limits<uint32>::max();
+
+		// Returns a proxy that can be used to move or remove the object.
+		uint32 Insert(TransformedAABB boundingBox, uint32 userData);
+
+		void Remove(uint32 proxy);
+
+		// Returns true if the object had to be reinserted because it
+		// moved outside of the fattened bounding box.
+		bool Move(uint32 proxy, TransformedAABB boundingBox);
+
+		void Clear();
+
+		uint32 GetUserData(uint32 proxy) const { return mNodes[proxy].mUserData; }
+		void SetUserData(uint32 proxy, uint32 userData) { mNodes[proxy].mUserData = userData; }
+
+		const TransformedAABB& GetFatBoundingBox(uint32 proxy) const { return mNodes[proxy].mBoundingBox; }
+
+		bool IsEmpty() const { return mRoot == sNull; }
+
+		// The height of a tree with a single leaf is 0
+		int32 GetHeight() const { return IsEmpty() ? 0 : mNodes[mRoot].mHeight; }
+
+		/**
+		 * \brief Calls onLeaf(userData) for every leaf whose fattened bounding box overlaps with the inquirer.
+		 *
+		 * If onLeaf returns true, the query stops and true is returned.
+		 */
+		template<typename InquirerShape, typename OnLeafFunction>
+		bool Query(const InquirerShape& inquirerShape, OnLeafFunction&& onLeaf) const;
+
+		/**
+		 * \brief Traverses the tree for a packet of inquirers at once. Each bit in the mask represents an inquirer.
+		 *
+		 * testNode(boundingBox, mask) returns the inquirers in the mask that overlap with the bounding box.
+		 * onLeaf(userData, mask) returns the inquirers that have finished and no longer need to be tested.
+		 */
+		template<typename TestNodeFunction, typename OnLeafFunction>
+		void QueryPacket(uint32 mask, TestNodeFunction&& testNode, OnLeafFunction&& onLeaf) const;
+
+		// Calls func(boundingBox) for each node that is not a leaf
+		template<typename Func>
+		void ForEachInternalNode(Func&& func) const;
+
+		// How far the bounding boxes of the leaves are extended in each direction
+		static constexpr float sFatMargin = .25f;
+
+	private:
+		struct Node
+		{
+			bool IsLeaf() const { return mChild1 == sNull; }
+
+			TransformedAABB mBoundingBox{};
+
+			// If the node is not in use, this is the next free node instead
+			uint32 mParent = sNull;
+			uint32 mChild1 = sNull;
+			uint32 mChild2 = sNull;
+
+			// Leaves have a height of 0, free nodes -1
+			int32 mHeight = -1;
+			uint32 mUserData{};
+		};
+
+		uint32 AllocateNode();
+		void FreeNode(uint32 index);
+
+		void InsertLeaf(uint32 leaf);
+		void RemoveLeaf(uint32 leaf);
+
+		// Walks up the tree from index, rebalancing and recomputing the bounding boxes
+		void Fixup(uint32 index);
+
+		// Performs a rotation if the subtree at index is imbalanced. Returns the new root of the subtree.
+		uint32 Balance(uint32 index);
+
+		std::vector<Node> mNodes{};
+		uint32 mRoot = sNull;
+		uint32 mFreeList = sNull;
+	};
+
+	template<typename InquirerShape, typename OnLeafFunction>
+	bool DynamicAABBTree::Query(const InquirerShape& inquirerShape, OnLeafFunction&& onLeaf) const
+	{
+		if (mRoot == sNull)
+		{
+			return false;
+		}
+
+		static constexpr uint32 stackSize = 256;
+		uint32 stack[stackSize];
+		uint32 stackPtr = 0;
+		stack[stackPtr++] = mRoot;
+
+		while (stackPtr != 0)
+		{
+			const Node& node = mNodes[stack[--stackPtr]];
+
+			if (!AreOverlapping(node.mBoundingBox, inquirerShape))
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				if (onLeaf(node.mUserData))
+				{
+					return true;
+				}
+				continue;
+			}
+
+			ASSERT(stackPtr + 2 <= stackSize);
+			stack[stackPtr++] = node.mChild2;
+			stack[stackPtr++] = node.mChild1;
+		}
+
+		return false;
+	}
+
+	template<typename TestNodeFunction, typename OnLeafFunction>
+	void DynamicAABBTree::QueryPacket(const uint32 mask, TestNodeFunction&& testNode, OnLeafFunction&& onLeaf) const
+	{
+		if (mRoot == sNull)
+		{
+			return;
+		}
+
+		struct StackEntry
+		{
+			uint32 mNode{};
+			uint32 mMask{};
+		};
+
+		static constexpr uint32 stackSize = 256;
+		StackEntry stack[stackSize];
+		uint32 stackPtr = 0;
+		stack[stackPtr++] = { mRoot, mask };
+
+		uint32 activeMask = mask;
+
+		while (stackPtr != 0)
+		{
+			const StackEntry entry = stack[--stackPtr];
+			const Node& node = mNodes[entry.mNode];
+			const uint32 overlapping = testNode(node.mBoundingBox, entry.mMask & activeMask);
+
+			if (overlapping == 0)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				activeMask &= ~onLeaf(node.mUserData, overlapping);
+				continue;
+			}
+
+			ASSERT(stackPtr + 2 <= stackSize);
+			stack[stackPtr++] = { node.mChild2, overlapping };
+			stack[stackPtr++] = { node.mChild1, overlapping };
+		}
+	}
+
+	template<typename Func>
+	void DynamicAABBTree::ForEachInternalNode(Func&& func) const
+	{
+		for (const Node& node : mNodes)
+		{
+			if (node.mHeight > 0)
+			{
+				func(node.mBoundingBox);
+			}
+		}
+	}
+}
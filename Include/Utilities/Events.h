@@ -124,13 +124,42 @@ namespace CE
 	template<typename FuncRet, typename... FuncParams, typename EventT>
 	void BindEvent(MetaType& type, const EventT& event, FuncRet(*func)(FuncParams...));
 
+	namespace Internal
+	{
+		/**
+		 * \brief Recorded by BindEvent, allows the bound function to be called without going through the MetaFunc.
+		 */
+		struct EventThunk
+		{
+			// Ret(*)(const void* func, void* component, World&, entt::entity, Args...), cast back by InvokeBoundEvent
+			void(*mInvoke)(){};
+
+			// The function that was bound
+			std::shared_ptr<const void> mFunc{};
+		};
+	}
+
 	struct BoundEvent
 	{
 		std::reference_wrapper<const MetaType> mType;
 		std::reference_wrapper<const MetaFunc> mFunc;
 		bool mIsStatic{};
+
+		// Only events bound from C++ have a thunk, events declared in scripts do not.
+		const Internal::EventThunk* mThunk{};
 	};
 
+	/**
+	 * \brief Invokes an event returned from TryGetEvent.
+	 *
+	 * Events bound from C++ are called directly through their thunk, without constructing any MetaAny
+	 * or FuncResult. Only events declared in scripts go through the MetaFunc.
+	 *
+	 * \param component The component the event was bound to. Ignored if the event is static.
+	 */
+	template<typename Derived, typename Ret, typename... Args, EventFlags Flags, typename... CallArgs>
+	Ret InvokeBoundEvent(const BoundEvent& boundEvent, const EventType<Derived, Ret(Args...), Flags>& event, void* component, World& world, entt::entity owner, CallArgs&&... args);
+
 	/**
 	 * \brief Returns the event bound during BindEvent, if any.
 	 *
@@ -234,6 +263,97 @@ namespace CE
 		static constexpr std::string_view sShouldTickBeforeBeginPlayTag = "sShouldTickBeforeBeginPlayTag";
 	}
 
+	/**
+	 * \brief A batched variant of OnTick or OnFixedTick, which is not available to scripts.
+	 *
+	 * Instead of once per entity, the bound function is called once per contiguous chunk
+	 * of the component's storage, and receives all the entities and components in that chunk:
+	 *
+	 *	static void OnTickBatch(World& world, Span<const entt::entity> owners, Span<MyComponent> components, float dt);
+	 *
+	 *	BindTickBatch(type, sOnTickBatch, &MyComponent::OnTickBatch);
+	 *
+	 * The bound function may not add or remove the component from any entity,
+	 * as this would invalidate the spans.
+	 */
+	class TickBatchEvent
+	{
+	public:
+		constexpr TickBatchEvent(std::string_view name) :
+			mName(name)
+		{
+		}
+
+		std::string_view mName{};
+	};
+
+	/**
+	 * \brief Called every frame, with chunks of the components.
+	 * \World& The world the components are in.
+	 * \Span<const entt::entity> The owners of the components.
+	 * \Span<Component> The components.
+	 * \float The deltatime.
+	 */
+	inline const TickBatchEvent sOnTickBatch{ "OnTickBatch" };
+
+	/**
+	 * \brief Called every sOnFixedTickStepSize seconds, with chunks of the components.
+	 * \World& The world the components are in.
+	 * \Span<const entt::entity> The owners of the components.
+	 * \Span<Component> The components.
+	 * \float The deltatime, always equal to sOnFixedTickStepSize.
+	 */
+	inline const TickBatchEvent sOnFixedTickBatch{ "OnFixedTickBatch" };
+
+	struct TickBatchTraits
+	{
+		/**
+		 * \brief If true, the chunks of a storage are handed out to the JobSystem, and the bound
+		 * function may be called for different chunks at the same time.
+		 *
+		 * A thread-safe function may change the local position, orientation and scale of the
+		 * transforms of the entities in its chunk; marking their world transforms as out of date
+		 * is thread-safe. It may not reparent transforms, add or remove components, or read the
+		 * world transform of an entity whose ancestors may be modified by another chunk.
+		 */
+		bool mIsThreadSafe{};
+
+		// See Props::sShouldTickWhilstPausedTag
+		bool mShouldTickWhilstPaused{};
+
+		// See Props::sShouldTickBeforeBeginPlayTag
+		bool mShouldTickBeforeBeginPlay{};
+	};
+
+	template<typename Class>
+	using TickBatchFunc = void(*)(World&, Span<const entt::entity>, Span<Class>, float);
+
+	struct BoundTickBatch
+	{
+		// Calls the bound function for the components in storage from index first to last
+		void Invoke(World& world, entt::sparse_set& storage, uint32 first, uint32 last, float dt) const { mInvoke(mFunc, world, storage, first, last, dt); }
+
+		TypeId mTypeId{};
+		TickBatchTraits mTraits{};
+
+		// Chunks never cross the pages of the storage, so that the components in a chunk are contiguous
+		uint32 mChunkSize{};
+
+		void(*mInvoke)(void(*func)(), World&, entt::sparse_set&, uint32, uint32, float){};
+		void(*mFunc)(){};
+	};
+
+	/**
+	 * \brief Binds a function that receives chunks of Class to sOnTickBatch or sOnFixedTickBatch.
+	 */
+	template<typename Class>
+	void BindTickBatch(MetaType& type, const TickBatchEvent& event, TickBatchFunc<Class> func, TickBatchTraits traits = {});
+
+	std::vector<BoundTickBatch> GetAllBoundTickBatches(const TickBatchEvent& event);
+
+	// The largest number of components passed to a single call to a function bound to a TickBatchEvent
+	static constexpr uint32 sMaxTickBatchSize = 256;
+
 	struct OnEndPlay :
 		EventType<OnEndPlay>
 	{
@@ -303,6 +423,41 @@ namespace CE
 		 * \brief Can be used to check if the MetaFunc returned from TryGetEvent should be called with an instance of the component.
 		 */
 		static constexpr std::string_view sIsEventStaticTag = "sIsEventStaticTag";
+
+		void RegisterEventThunk(TypeId typeId, const EventBase& event, EventThunk&& thunk);
+
+		const EventThunk* TryGetEventThunk(TypeId typeId, const EventBase& event);
+
+		void RegisterTickBatch(const TickBatchEvent& event, BoundTickBatch&& bound);
+
+		template<typename Class>
+		void InvokeTickBatch(void(*func)(), World& world, entt::sparse_set& storage, const uint32 first, const uint32 last, const float dt)
+		{
+			static constexpr uint32 pageSize = static_cast<uint32>(entt::component_traits<Class>::page_size);
+
+			auto& typedStorage = static_cast<entt::registry::storage_for_type<Class>&>(storage);
+			Class* const components = typedStorage.raw()[first / pageSize] + first % pageSize;
+
+			reinterpret_cast<TickBatchFunc<Class>>(func)(world,
+				{ storage.data() + first, last - first },
+				{ components, last - first },
+				dt);
+		}
+
+		template<typename Class, typename Func, bool IsStatic, typename Ret, typename... Args>
+		Ret InvokeEventThunk(const void* func, [[maybe_unused]] void* component, World& world, entt::entity owner, Args... args)
+		{
+			const Func& funcToInvoke = *static_cast<const Func*>(func);
+
+			if constexpr (IsStatic)
+			{
+				return std::invoke(funcToInvoke, world, owner, std::forward<Args>(args)...);
+			}
+			else
+			{
+				return std::invoke(funcToInvoke, *static_cast<Class*>(component), world, owner, std::forward<Args>(args)...);
+			}
+		}
 	}
 
 	template <typename Derived, typename Ret, typename ... Args, EventFlags Flags>
@@ -331,6 +486,12 @@ namespace CE
 		static_assert(isStaticOrMember, "The parameters of the provided function do not match that of the event.");
 		static_assert(!isComponentCompletelyEmpty || isProvidedFuncStatic, "EnTT does not construct components that are completely empty. All functions of this component that you want to bind to an event must be static.");
 
+		using StoredFunc = std::decay_t<Func>;
+		Internal::EventThunk thunk{};
+		thunk.mInvoke = reinterpret_cast<void(*)()>(&Internal::InvokeEventThunk<Class, StoredFunc, isProvidedFuncStatic, Ret, Args...>);
+		thunk.mFunc = std::make_shared<const StoredFunc>(func);
+		Internal::RegisterEventThunk(type.GetTypeId(), event, std::move(thunk));
+
 		MetaFunc* eventFunc{};
 
 		if constexpr (isProvidedFuncStatic)
@@ -363,4 +524,68 @@ namespace CE
 	{
 		BindEvent<std::monostate>(type, event, func);
 	}
-}
\ No newline at end of file
+
+	template<typename Derived, typename Ret, typename... Args, EventFlags Flags, typename... CallArgs>
+	Ret InvokeBoundEvent(const BoundEvent& boundEvent, const EventType<Derived, Ret(Args...), Flags>&, void* component, World& world, entt::entity owner, CallArgs&&... args)
+	{
+		if (boundEvent.mThunk != nullptr)
+		{
+			using Thunk = Ret(*)(const void*, void*, World&, entt::entity, Args...);
+			return reinterpret_cast<Thunk>(boundEvent.mThunk->mInvoke)(boundEvent.mThunk->mFunc.get(), component, world, owner, std::forward<CallArgs>(args)...);
+		}
+
+		const MetaFunc& func = boundEvent.mFunc.get();
+
+		if constexpr (std::is_void_v<Ret>)
+		{
+			if (boundEvent.mIsStatic)
+			{
+				func.InvokeUncheckedUnpacked(world, owner, std::forward<CallArgs>(args)...);
+			}
+			else
+			{
+				MetaAny componentAny{ boundEvent.mType.get(), component, false };
+				func.InvokeUncheckedUnpacked(componentAny, world, owner, std::forward<CallArgs>(args)...);
+			}
+		}
+		else
+		{
+			static_assert(std::is_trivially_copyable_v<Ret>, "The return value is constructed in place over a default constructed value");
+
+			Ret returnValue{};
+
+			if (boundEvent.mIsStatic)
+			{
+				func.InvokeUncheckedUnpackedWithRVO(&returnValue, world, owner, std::forward<CallArgs>(args)...);
+			}
+			else
+			{
+				MetaAny componentAny{ boundEvent.mType.get(), component, false };
+				func.InvokeUncheckedUnpackedWithRVO(&returnValue, componentAny, world, owner, std::forward<CallArgs>(args)...);
+			}
+
+			return returnValue;
+		}
+	}
+
+	template<typename Class>
+	void BindTickBatch(MetaType& type, const TickBatchEvent& event, TickBatchFunc<Class> func, TickBatchTraits traits)
+	{
+		static constexpr uint32 pageSize = static_cast<uint32>(entt::component_traits<Class>::page_size);
+		static constexpr uint32 chunkSize = std::min(pageSize, sMaxTickBatchSize);
+
+		static_assert(pageSize != 0, "EnTT does not construct components that are completely empty, there is nothing to batch.");
+		static_assert(!entt::component_traits<Class>::in_place_delete, "Storages that delete in place contain tombstones, and cannot be passed as a span.");
+		static_assert(pageSize % chunkSize == 0, "Chunks may not cross the pages of a storage.");
+		ASSERT(type.GetTypeId() == MakeStrippedTypeId<Class>());
+
+		BoundTickBatch bound{};
+		bound.mTypeId = type.GetTypeId();
+		bound.mTraits = traits;
+		bound.mChunkSize = chunkSize;
+		bound.mInvoke = &Internal::InvokeTickBatch<Class>;
+		bound.mFunc = reinterpret_cast<void(*)()>(func);
+
+		Internal::RegisterTickBatch(event, std::move(bound));
+	}
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include <atomic>
+
+#include "Utilities/Geometry2d.h"
+#include "Utilities/JobSystem.h"
+#include "Utilities/Time.h"
+
+namespace CE
+{
+	class World;
+	class Registry;
+
+	/*
+	Computes flow fields towards any number of SwarmingTargetComponents, for agents of different sizes.
+
+	Agents are divided into size classes, and each size class has its own grid of cells that are
+	roughly as wide as the agents in it. The cells are grouped into sectors of sSectorWidth by
+	sSectorWidth cells. Each target has a field for every size class in use, which covers the
+	sectors within mDesiredRadius of the target.
+
+	Finding the path to a target happens in two steps. A coarse search over the sectors finds how far
+	each sector is from the target. The integration field of a sector, the distance from each cell to
+	the target, is only computed once an agent asks for a direction inside of that sector, and is
+	seeded from the sectors that are closer to the target. Sectors whose integration field did not
+	change since the last time the field was computed keep their directions.
+
+	Which cells are blocked is only recomputed for sectors whose static obstacles have changed.
+	Fields are only recomputed once their target moves to a different cell, or when the obstacles in
+	one of their sectors change.
+
+	All computations happen on the JobSystem. The fields are published to the SwarmingTargetComponents
+	during the next Update after they were computed, and are never modified afterwards.
+	*/
+	class FlowFieldEngine
+	{
+	public:
+		FlowFieldEngine() = default;
+		FlowFieldEngine(const FlowFieldEngine&) = delete;
+		FlowFieldEngine(FlowFieldEngine&&) = delete;
+
+		~FlowFieldEngine();
+
+		FlowFieldEngine& operator=(const FlowFieldEngine&) = delete;
+		FlowFieldEngine& operator=(FlowFieldEngine&&) = delete;
+
+		static constexpr int sSectorWidth = 16;
+		static constexpr int sNumOfCellsPerSector = sSectorWidth * sSectorWidth;
+
+		// The size class of an agent is the largest one whose cells are not wider than the agent's radius
+		static constexpr float sSmallestCellSize = .25f;
+		static constexpr uint32 sNumOfSizeClasses = 8;
+
+		static uint32 GetSizeClass(float agentRadius);
+		static float GetCellSize(uint32 sizeClass);
+
+		using SectorDirections = std::array<glm::vec2, sNumOfCellsPerSector>;
+
+		// The flow field towards a single target, for a single size class
+		class Field
+		{
+		public:
+			/*
+			The direction an agent at this position should move in, bilinearly interpolated between cells.
+
+			Returns std::nullopt if the position lies outside of the field, or if the sector it lies
+			in was never computed. Sectors that are not up to date are requested, and will be computed
+			during the next update of the FlowFieldEngine. Can be called from multiple threads at once.
+			*/
+			std::optional<glm::vec2> Sample(glm::vec2 position) const;
+
+			float GetCellSize() const { return mCellSize; }
+
+			void DebugDraw(const World& world) const;
+
+		private:
+			friend FlowFieldEngine;
+
+			std::optional<glm::vec2> GetCellDirection(glm::ivec2 cell) const;
+
+			// Returns -1 if the sector lies outside of this field
+			int GetSectorIndex(glm::ivec2 sector) const;
+
+			float mCellSize{};
+
+			glm::ivec2 mFirstSector{};
+			glm::ivec2 mNumOfSectors{};
+
+			// mSectors[x + y * mNumOfSectors.x], nullptr if the sector was never computed
+			std::vector<std::shared_ptr<const SectorDirections>> mSectors{};
+
+			// char because std::vector<bool> is slower
+			std::vector<char> mIsUpToDate{};
+
+			// Set by Sample, read by the FlowFieldEngine
+			std::unique_ptr<std::atomic<bool>[]> mIsRequested{};
+		};
+
+		/*
+		Publishes the fields computed since the last update, gathers the targets and agents,
+		updates the obstacles and starts computing the fields on the JobSystem.
+
+		Does nothing if the fields from the previous update are still being computed.
+		*/
+		void Update(World& world, float dt);
+
+	private:
+		static constexpr float sObstacleCheckInterval = .5f;
+
+		struct ObstacleSector
+		{
+			// char because std::vector<bool> is slower
+			std::vector<char> mIsBlocked{};
+
+			// A hash of the obstacles overlapping with this sector
+			uint64 mSignature{};
+
+			// The value of Layer::mVersion the last time mIsBlocked changed
+			uint32 mLastChangedVersion{};
+
+			bool mIsNew = true;
+			bool mIsUsed{};
+		};
+
+		struct Layer
+		{
+			std::unordered_map<uint64, ObstacleSector> mSectors{};
+			uint32 mVersion{};
+		};
+
+		struct SectorState
+		{
+			// Empty if the sector has not been computed since the last time the field was invalidated
+			std::vector<float> mIntegration{};
+
+			// The last integration field that was computed, used to find out whether the directions can be reused
+			std::vector<float> mPreviousIntegration{};
+
+			std::shared_ptr<const SectorDirections> mDirections{};
+
+			// Changes whenever the integration field changes
+			uint32 mRevision{};
+
+			// The revisions of this sector and of the sectors it depends on, at the time mDirections was computed
+			std::array<uint32, 9> mRevisionsOfDirections{};
+
+			bool mIsUpToDate{};
+		};
+
+		struct TargetState
+		{
+			entt::entity mOwner = entt::null;
+			uint32 mSizeClass{};
+			float mCellSize{};
+
+			glm::ivec2 mGoalCell{};
+			glm::ivec2 mFirstSector{};
+			glm::ivec2 mNumOfSectors{};
+			int mNumOfSmoothingSteps{};
+
+			// Set when the goal, the area or the obstacles changed
+			bool mNeedsNewGeneration = true;
+			uint32 mObstacleVersionSeen{};
+
+			std::unordered_map<uint64, SectorState> mSectors{};
+
+			// The distance from each sector to the sector of the goal, indexed like Field::mSectors
+			std::vector<float> mCoarseCosts{};
+
+			uint32 mNextRevision = 1;
+
+			// The field agents are currently sampling from, whose requests are handled during the next update
+			std::shared_ptr<const Field> mPublishedField{};
+
+			// Computed by the job, published during the next update
+			std::shared_ptr<Field> mPendingField{};
+
+			// Buffers reused between computations
+			std::vector<std::pair<float, int>> mCoarseOpenList{};
+			std::vector<int> mOpenCells{};
+		};
+
+		void PublishFields(Registry& registry);
+
+		void SyncTargets(Registry& registry);
+
+		void UpdateObstacles(const World& world, bool shouldCheckExistingSectors);
+
+		// Returns a sNumOfCellsPerSector chunk of blocked cells for each of the sectors
+		static std::vector<char> RasterizeObstacles(const World& world, float cellSize, Span<const glm::ivec2> sectors);
+
+		void UpdateTarget(TargetState& target) const;
+
+		void ComputeCoarseCosts(TargetState& target) const;
+
+		// Computes the integration field and directions of a sector, after first computing the sectors it depends on
+		SectorState* ComputeSector(TargetState& target, glm::ivec2 sector) const;
+
+		static void ComputeDirections(const TargetState& target, glm::ivec2 sector, SectorState& state, const std::array<const SectorState*, 8>& dependencies);
+
+		// Whether an agent can move from one sector to a sector next to it
+		bool CanCrossBetween(uint32 sizeClass, glm::ivec2 fromSector, glm::ivec2 toSector) const;
+
+		const char* FindBlockedCells(uint32 sizeClass, glm::ivec2 sector) const;
+
+		std::array<Layer, sNumOfSizeClasses> mLayers{};
+		std::vector<std::unique_ptr<TargetState>> mTargets{};
+
+		Cooldown mObstacleCheckCooldown{ sObstacleCheckInterval };
+		bool mShouldCheckObstacles{};
+
+		JobHandle mJob{};
+	};
+}
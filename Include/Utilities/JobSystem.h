@@ -0,0 +1,186 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+namespace CE
+{
+	namespace Internal
+	{
+		struct Job;
+	}
+
+	// A reference to a job that was scheduled on the JobSystem.
+	class JobHandle
+	{
+	public:
+		JobHandle() = default;
+
+		bool IsValid() const { return mJob != nullptr; }
+
+		bool IsFinished() const;
+
+		// If no thread has started the job yet, the job is executed on the calling thread,
+		// as are the dependencies that have not been started yet. Otherwise, the calling
+		// thread waits for the job to finish. Unrelated jobs are never executed.
+		void Wait() const;
+
+		// The job will not be executed if it has not been started yet.
+		// Jobs that depend on this job will still be executed.
+		void Cancel() const;
+
+	private:
+		friend class JobSystem;
+		JobHandle(std::shared_ptr<Internal::Job> job) : mJob(std::move(job)) {}
+
+		std::shared_ptr<Internal::Job> mJob{};
+	};
+
+	/*
+	A pool of worker threads that execute jobs.
+
+	Each worker has their own queue. Workers take the most recently
+	added job from their own queue, and steal the oldest job from
+	another queue when they run out of work. Workers without any work
+	are put to sleep until new jobs are scheduled.
+
+	Threads that wait for a job to finish execute the job and its dependencies
+	themselves if no worker has started on them yet, so it is safe to wait for
+	jobs from within a job. The waiting thread does not pick up unrelated jobs.
+	*/
+	class JobSystem
+	{
+	public:
+		static JobSystem& Get();
+
+		JobSystem(const JobSystem&) = delete;
+		JobSystem(JobSystem&&) = delete;
+
+		JobSystem& operator=(const JobSystem&) = delete;
+		JobSystem& operator=(JobSystem&&) = delete;
+
+		~JobSystem();
+
+		// The job is executed once all of its dependencies have finished.
+		JobHandle Schedule(std::function<void()>&& work, Span<const JobHandle> dependencies = {});
+
+		// The continuation is executed once the job has finished.
+		JobHandle Then(const JobHandle& job, std::function<void()>&& continuation) { return Schedule(std::move(continuation), { &job, 1 }); }
+
+		/**
+		 * \brief Calls func(batchBegin, batchEnd) for batches that together span [begin, end).
+		 *
+		 * The calling thread participates, and the function returns once all the batches are done.
+		 * Batches are atleast minBatchSize large, and the order in which they are executed is undefined.
+		 */
+		template<typename Func>
+		void ParallelForBatched(uint32 begin, uint32 end, Func&& func, uint32 minBatchSize = 1);
+
+		// Calls func(i) for every i in [begin, end). See ParallelForBatched.
+		template<typename Func>
+		void ParallelFor(uint32 begin, uint32 end, Func&& func, uint32 minBatchSize = 1);
+
+		// Returns the size of the batches ParallelForBatched would use for this range.
+		uint32 GetBatchSize(uint32 numOfItems, uint32 minBatchSize = 1) const;
+
+		uint32 GetNumOfWorkers() const { return static_cast<uint32>(mWorkers.size()); }
+
+		// The number of workers, plus the thread that is waiting on them.
+		uint32 GetNumOfThreads() const { return GetNumOfWorkers() + 1; }
+
+		bool IsWorkerThread() const;
+
+	private:
+		friend JobHandle;
+		JobSystem();
+
+		struct Queue
+		{
+			std::mutex mMutex{};
+			std::deque<std::shared_ptr<Internal::Job>> mJobs{};
+		};
+
+		void RunWorkerThread(uint32 workerIndex);
+
+		void Enqueue(std::shared_ptr<Internal::Job> job);
+
+		// Returns false if there was no job to execute
+		bool TryExecuteOne();
+
+		static void Execute(Internal::Job& job);
+
+		// Ready jobs are added to the queue of the worker that created them,
+		// or to the shared queue at the back if they were created by another thread.
+		std::vector<std::unique_ptr<Queue>> mQueues{};
+		std::vector<std::thread> mWorkers{};
+
+		std::atomic<uint32> mNumOfQueuedJobs{};
+		std::mutex mParkMutex{};
+		std::condition_variable mParkCondition{};
+		bool mShouldStopWorking{};
+
+		static constexpr uint32 sNumOfBatchesPerThread = 4;
+	};
+
+	template<typename Func>
+	void JobSystem::ParallelForBatched(uint32 begin, uint32 end, Func&& func, uint32 minBatchSize)
+	{
+		if (begin >= end)
+		{
+			return;
+		}
+
+		const uint32 batchSize = GetBatchSize(end - begin, minBatchSize);
+		const uint32 numOfBatches = (end - begin + batchSize - 1) / batchSize;
+
+		if (numOfBatches == 1)
+		{
+			func(begin, end);
+			return;
+		}
+
+		std::atomic<uint32> nextBatch{};
+
+		const auto doBatches = [&]
+			{
+				for (uint32 batch = nextBatch++; batch < numOfBatches; batch = nextBatch++)
+				{
+					const uint32 batchBegin = begin + batch * batchSize;
+					func(batchBegin, std::min(batchBegin + batchSize, end));
+				}
+			};
+
+		const uint32 numOfHelpers = std::min(numOfBatches - 1, GetNumOfWorkers());
+		std::vector<JobHandle> helpers{};
+		helpers.reserve(numOfHelpers);
+
+		for (uint32 i = 0; i < numOfHelpers; i++)
+		{
+			helpers.emplace_back(Schedule(doBatches));
+		}
+
+		doBatches();
+
+		// Helpers that did not get started are executed here,
+		// but will immediately return as there are no batches left.
+		for (const JobHandle& helper : helpers)
+		{
+			helper.Wait();
+		}
+	}
+
+	template<typename Func>
+	void JobSystem::ParallelFor(uint32 begin, uint32 end, Func&& func, uint32 minBatchSize)
+	{
+		ParallelForBatched(begin, end,
+			[&func](uint32 batchBegin, uint32 batchEnd)
+			{
+				for (uint32 i = batchBegin; i < batchEnd; i++)
+				{
+					func(i);
+				}
+			}, minBatchSize);
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+namespace CE
+{
+	/*
+	Maps the entire contents of a file into memory, read-only.
+
+	The pages are loaded by the operating system as they are accessed, so
+	nothing is copied up front. The bytes are read straight from the file,
+	so the file must not be written to while it is mapped: bytes that were
+	already validated could change underneath the reader, and reading past
+	the end of a file that was truncated crashes on some platforms. Windows
+	refuses to open the file for writing while it is mapped, other platforms
+	do not, so don't hold on to the mapping any longer than needed. The file
+	may still be renamed or deleted while it is mapped.
+	*/
+	class MemoryMappedFile
+	{
+	public:
+		MemoryMappedFile() = default;
+		MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+		MemoryMappedFile(const MemoryMappedFile&) = delete;
+
+		~MemoryMappedFile();
+
+		MemoryMappedFile& operator=(MemoryMappedFile&& other) noexcept;
+		MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+		// Returns std::nullopt if the file could not be opened or mapped. Empty files cannot be mapped.
+		static std::optional<MemoryMappedFile> Map(const std::filesystem::path& path);
+
+		Span<const std::byte> GetBytes() const { return { static_cast<const std::byte*>(mData), mSize }; }
+		std::string_view GetView() const { return { static_cast<const char*>(mData), mSize }; }
+
+		size_t GetSize() const { return mSize; }
+
+		// Loads all the pages into memory on the calling thread, so that later reads do not have to wait on the disk
+		void Prefetch() const;
+
+	private:
+		void Unmap();
+
+		const void* mData{};
+		size_t mSize{};
+
+#ifdef PLATFORM_WINDOWS
+		void* mFileHandle{};
+		void* mMappingHandle{};
+#endif // PLATFORM_WINDOWS
+	};
+}
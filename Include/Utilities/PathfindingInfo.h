@@ -1,4 +1,7 @@
 #pragma once
+#include <mutex>
+
+struct PathfindingUnitTestAccess;
 
 namespace CE
 {
@@ -7,112 +10,114 @@ namespace CE
 	class Pathfinding
 	{
 	public:
-		class Edge;
+		using NodeId = uint32;
+		static constexpr NodeId sInvalidNodeId = std::numeric_limits<NodeId>::max();
 
-		class Node
+		struct Edge
 		{
-		public:
-			/**
-			 * \brief Constructor to initialize the node on the graph
-			 * \param id The node's id
-			 * \param position The node's position on the graph
-			 */
-			Node(int id, glm::vec2 position);
-
-			/// \brief 
-			/// Adds an edge to the node, which connects to another node.
-			/// \param toNode
-			/// The node the edge connects to
-			/// \param cost
-			/// By default, if it's cost is less than 0, it'll calculate the heuristic, if the cost will be that of the given value.
-			/// \param biDirectional
-			/// By default, it'll create an edge in one direction unless otherwise specified, which in that case,
-			/// it'll also create a similar edge but from the other node to the current one, AKA another edge in reverse.
-			void AddEdge(Node* toNode, float cost = -1, bool biDirectional = false);
-
-			/// \brief Getter to grab the connecting edges to the node
-			/// \return The connectingEdges as a vector of Edges
-			[[nodiscard]] const std::vector<Edge>& GetConnectingEdges() const;
+			/// \brief The node this edge connects to
+			NodeId mToNode = sInvalidNodeId;
 
+			/// \brief The edge's cost
+			float mCost{};
+		};
 
-			/// \brief Getter to grab the position of the node
-			/// \return The position as a vec2
-			[[nodiscard]] glm::vec2 GetPosition() const;
-
-			/// \brief Getter to grab the ID of the node
-			/// \return The ID as an int
-			[[nodiscard]] int GetId() const;
+		class Graph;
+
+		/**
+		 * \brief
+		 * The scratch memory used by Graph::AStarSearch.
+		 *
+		 * Each node is stamped with the generation of the search that last visited it, so nodes that were
+		 * visited by a previous search are treated as unvisited without having to clear anything. A context
+		 * can be reused for any number of searches, on any graph, but only by one thread at a time.
+		 */
+		class SearchContext
+		{
+		public:
+			/// \brief A context per thread, so searches on different threads never share their buffers
+			static SearchContext& GetForThisThread();
 
 		private:
-			/// \brief The node's Id
-			int mId{};
+			friend Graph;
+			friend PathfindingUnitTestAccess;
 
-			/// \brief The connecting edges to the node
-			std::vector<Edge> mConnectingEdges{};
+			/// \brief Makes sure there is room for numOfNodes nodes, and starts a new generation
+			void BeginSearch(uint32 numOfNodes);
 
-			/// \brief The position of the node
-			glm::vec2 mPosition{};
-		};
+			struct NodeState
+			{
+				/// \brief The node is in the open set if mOpenGeneration == mGeneration
+				uint32 mOpenGeneration{};
 
-		class Edge
-		{
-		public:
-			/**
-			 * \brief Constructor to initialize the node on the graph
-			 * \param cost The edge's cost
-			 * \param toNode the pointer of the node to which this edge connects to
-			 */
-			Edge(float cost, Node* toNode);
+				/// \brief The node is in the closed set if mClosedGeneration == mGeneration
+				uint32 mClosedGeneration{};
 
-			/**
-			 * \brief Getter to grab the cost of the edge
-			 * \return The cost of the edge as a float
-			 */
-			[[nodiscard]] float GetCost() const;
+				NodeId mCameFrom = sInvalidNodeId;
+				float mG{};
+			};
+			std::vector<NodeState> mStates{};
 
-			/**
-			 * \brief Getter to grab the pointer of the node to which this edge connects to
-			 * \return The node as a pointer
-			 */
-			[[nodiscard]] Node* GetToNode() const;
+			struct OpenListItem
+			{
+				float mF{};
+				NodeId mNode{};
+			};
+			std::vector<OpenListItem> mHeap{};
 
-		private:
-			/// \brief The edge's cost
-			float mCost = 0;
-			/// \brief The pointer of the node to which this edge connects to
-			Node* mToNode = nullptr;
+			uint32 mGeneration{};
 		};
 
+		/**
+		 * \brief
+		 * Nodes and their edges, stored in compressed sparse row form: the edges of node i are
+		 * mEdges[mFirstEdge[i]] to mEdges[mFirstEdge[i + 1]].
+		 *
+		 * Edges are first collected with AddEdge, and are moved into their final layout by Build,
+		 * which has to be called before the graph can be searched.
+		 */
 		class Graph
 		{
 		public:
-			Graph() = default;
-
 			/**
-			 * \brief Constructor to initialize the A* graph
-			 * \param nodes The nodes that belong to this graph
+			 * \brief AddNode, creates a default node based on it's location.
+			 * \param position The node's position on the graph
+			 * \return The id of the new node
 			 */
-			explicit Graph(const std::vector<Node>& nodes);
+			NodeId AddNode(glm::vec2 position);
+
+			/// \brief
+			/// Adds an edge from one node to another.
+			/// \param cost
+			/// By default, if it's cost is less than 0, it'll calculate the heuristic, if the cost will be that of the given value.
+			/// \param biDirectional
+			/// By default, it'll create an edge in one direction unless otherwise specified, which in that case,
+			/// it'll also create a similar edge but from the other node to the current one, AKA another edge in reverse.
+			void AddEdge(NodeId fromNode, NodeId toNode, float cost = -1, bool biDirectional = false);
 
-			/// \brief The vector containing all the nodes belonging to this graph
-			std::vector<Node> mNodes{};
+			/// \brief Moves all the edges added since the last call into the compressed layout
+			void Build();
 
-			/**
-			 * \brief AddNode, creates a default node based on it's location.
-			 * \param x X position
-			 * \param y Y position
-			 */
-			void AddNode(float x, float y);
+			[[nodiscard]] uint32 GetNumOfNodes() const { return static_cast<uint32>(mPositions.size()); }
+
+			/// \brief Getter to grab the position of a node
+			[[nodiscard]] glm::vec2 GetPosition(NodeId node) const { return mPositions[node]; }
+
+			/// \brief Getter to grab the edges leaving a node
+			[[nodiscard]] Span<const Edge> GetConnectingEdges(NodeId node) const;
 
 			/**
 			 * \brief
-			 * AStarSearch, returns the quickest path from startNode to endNode through the use of the A* search algorithm.
+			 * AStarSearch, finds the quickest path from startNode to endNode through the use of the A* search algorithm.
+			 * Does not allocate once the context and outPath have grown large enough, and can be called from
+			 * multiple threads at once, as long as each thread uses its own context.
 			 * \param startNode Starting node
 			 * \param endNode Ending node
-			 * \return The vector returned contains the nodes that you must go through to reach the end in the quickest way possible.
+			 * \param context The scratch memory to use during the search
+			 * \param outPath Is cleared, and then filled with the nodes that you must go through to reach the end in the quickest way possible.
+			 * \return False if there is no path from startNode to endNode
 			 */
-			std::vector<const Node*> AStarSearch(const Node* startNode, const Node* endNode) const;
-
+			bool AStarSearch(NodeId startNode, NodeId endNode, SearchContext& context, std::vector<NodeId>& outPath) const;
 
 			/// \brief DebugDrawAStarGraph, draws the A* Graph in order to be able to debug it
 			void DebugDrawAStarGraph(const World& world) const;
@@ -120,11 +125,76 @@ namespace CE
 		private:
 			/**
 			 * \brief Heuristic calculates the heuristic of the node, aka, the distance between the current Node and the endNode.
-			 * \param currentNode The current node you're on
-			 * \param endNode The ending node
 			 * \return The heuristic estimate as a float
 			 */
-			[[nodiscard]] float Heuristic(const Node& currentNode, const Node& endNode) const;
+			[[nodiscard]] float Heuristic(NodeId currentNode, NodeId endNode) const;
+
+			std::vector<glm::vec2> mPositions{};
+
+			/// \brief Has GetNumOfNodes() + 1 elements once built
+			std::vector<uint32> mFirstEdge{};
+			std::vector<Edge> mEdges{};
+
+			struct PendingEdge
+			{
+				NodeId mFromNode{};
+				Edge mEdge{};
+			};
+			std::vector<PendingEdge> mPendingEdges{};
+		};
+
+		/**
+		 * \brief
+		 * Remembers the most recently requested paths, keyed by their start and end node. When the
+		 * cache is full, the least recently used path is replaced. The buffers of the replaced paths are
+		 * reused, so a cache that has filled up no longer allocates.
+		 *
+		 * Can be used from multiple threads at once.
+		 */
+		class PathCache
+		{
+		public:
+			explicit PathCache(uint32 capacity = sDefaultCapacity);
+
+			PathCache(PathCache&& other) noexcept;
+			PathCache& operator=(PathCache&& other) noexcept;
+
+			/// \brief If the path is in the cache, copies it to outPath and marks it as most recently used.
+			bool TryGet(NodeId startNode, NodeId endNode, std::vector<glm::vec2>& outPath);
+
+			void Add(NodeId startNode, NodeId endNode, Span<const glm::vec2> path);
+
+			void Clear();
+
+			static constexpr uint32 sDefaultCapacity = 256;
+
+		private:
+			static uint64 MakeKey(NodeId startNode, NodeId endNode) { return static_cast<uint64>(startNode) << 32 | endNode; }
+
+			void MoveToFront(uint32 entryIndex);
+			void Unlink(uint32 entryIndex);
+
+			static constexpr uint32 sNone = std::numeric_limits<uint32>::max();
+
+			struct Entry
+			{
+				uint64 mKey{};
+				std::vector<glm::vec2> mPath{};
+
+				// Towards the most recently used entry
+				uint32 mPrev = sNone;
+
+				// Towards the least recently used entry
+				uint32 mNext = sNone;
+			};
+			std::vector<Entry> mEntries{};
+			std::unordered_map<uint64, uint32> mEntryIndices{};
+
+			uint32 mMostRecentlyUsed = sNone;
+			uint32 mLeastRecentlyUsed = sNone;
+			uint32 mCapacity{};
+
+			std::mutex mMutex{};
 		};
 	};
 }
@@ -0,0 +1,169 @@
+#pragma once
+
+#ifdef PROFILING_ENABLED
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+namespace CE
+{
+	/*
+	Records how much time is spent in each zone of the engine's code, on every thread.
+
+	Zones, counters and frame markers are only recorded during a capture. Outside of a capture,
+	a zone costs a single atomic load. Each thread writes its events to its own ring buffer
+	without taking any locks. The ring buffers are drained into the capture at every frame marker.
+	Events that do not fit in a ring buffer are dropped, and reported in the exported trace.
+
+	The capture is exported in the Chrome trace event format, which can be opened in chrome://tracing
+	or Perfetto, and be converted for Tracy using its import-chrome tool.
+
+	Only compiled if PROFILING_ENABLED is defined. Use the PROFILE_ macros at the bottom of this file,
+	which compile to nothing otherwise.
+	*/
+	class Profiler
+	{
+	public:
+		static Profiler& Get();
+
+		Profiler(const Profiler&) = delete;
+		Profiler(Profiler&&) = delete;
+
+		Profiler& operator=(const Profiler&) = delete;
+		Profiler& operator=(Profiler&&) = delete;
+
+		// Discards the previous capture
+		void BeginCapture();
+
+		// Stops recording, and moves what is left in the ring buffers into the capture
+		void EndCapture();
+
+		bool IsCapturing() const { return mIsCapturing.load(std::memory_order_relaxed); }
+
+		bool HasCapture() const;
+
+		// The name of the calling thread in the exported trace
+		void SetThreadName(std::string_view name);
+
+		// Marks the start of a new frame, and moves the events recorded so far into the capture
+		void MarkFrame();
+
+		// Records the current value of a counter, such as the number of entities
+		void SetCounter(std::string_view name, int64 value);
+
+		// Adds to a counter that is summed over each frame, such as the number of BVH rebuilds
+		void AddToCounter(std::string_view name, int64 amount);
+
+		void ExportChromeTrace(std::ostream& stream) const;
+
+		// Records the time between its construction and destruction. The name must outlive the capture.
+		class Zone
+		{
+		public:
+			explicit Zone(std::string_view name) :
+				mName(name),
+				mStart(Get().IsCapturing() ? Now() : sNotRecording)
+			{
+			}
+
+			~Zone()
+			{
+				if (mStart != sNotRecording)
+				{
+					Get().Record({ mName, mStart, Now() - mStart, EventType::Zone });
+				}
+			}
+
+			Zone(const Zone&) = delete;
+			Zone& operator=(const Zone&) = delete;
+
+		private:
+			static constexpr int64 sNotRecording = -1;
+
+			std::string_view mName{};
+			int64 mStart{};
+		};
+
+	private:
+		Profiler() = default;
+
+		// Nanoseconds since an arbitrary point in time
+		static int64 Now() { return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count(); }
+
+		enum class EventType : uint8
+		{
+			Zone,
+			Counter,
+			CounterIncrement,
+			Frame
+		};
+
+		struct Event
+		{
+			std::string_view mName{};
+			int64 mTime{};
+
+			// The duration of a zone, or the value of a counter
+			int64 mValue{};
+
+			EventType mType{};
+		};
+
+		struct CapturedEvent
+		{
+			Event mEvent{};
+			uint32 mThread{};
+		};
+
+		// Written to by a single thread, read from by whoever holds mMutex
+		struct ThreadBuffer
+		{
+			std::unique_ptr<Event[]> mEvents = std::make_unique<Event[]>(sRingBufferSize);
+			std::atomic<uint64> mWriteIndex{};
+			std::atomic<uint64> mReadIndex{};
+			std::atomic<uint64> mNumOfDroppedEvents{};
+			std::string mName{};
+		};
+
+		void Record(const Event& event);
+
+		ThreadBuffer& GetThreadBuffer();
+
+		// Expects mMutex to be locked
+		void DrainThreadBuffers(bool shouldDiscard);
+
+		static constexpr uint64 sRingBufferSize = 1 << 16;
+
+		// Prevents the capture from growing indefinitely when it is never ended
+		static constexpr size_t sMaxNumOfCapturedEvents = 1 << 22;
+
+		std::atomic<bool> mIsCapturing{};
+
+		mutable std::mutex mMutex{};
+		std::vector<std::unique_ptr<ThreadBuffer>> mThreadBuffers{};
+		std::vector<CapturedEvent> mCapturedEvents{};
+		uint64 mNumOfDroppedEvents{};
+		int64 mCaptureStart{};
+	};
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a ## b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#define PROFILE_SCOPE(name) const CE::Profiler::Zone PROFILE_CONCAT(profilerZone, __LINE__){ name }
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_COUNTER(name, value) CE::Profiler::Get().SetCounter(name, static_cast<int64>(value))
+#define PROFILE_COUNTER_ADD(name, amount) CE::Profiler::Get().AddToCounter(name, static_cast<int64>(amount))
+#define PROFILE_FRAME_MARK() CE::Profiler::Get().MarkFrame()
+#define PROFILE_THREAD_NAME(name) CE::Profiler::Get().SetThreadName(name)
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_FUNCTION()
+#define PROFILE_COUNTER(name, value)
+#define PROFILE_COUNTER_ADD(name, amount)
+#define PROFILE_FRAME_MARK()
+#define PROFILE_THREAD_NAME(name)
+
+#endif // PROFILING_ENABLED
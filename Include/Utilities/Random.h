@@ -1,5 +1,7 @@
 #pragma once
+#include <atomic>
 #include <random>
+#include <thread>
 
 #include "Meta/MetaReflect.h"
 
@@ -31,14 +33,14 @@ namespace CE
 		static T Range(T min, T max)
 		{
 			std::uniform_int_distribution distribution{ min, std::max(min, max == min ? max : max - 1) };
-			return distribution(sEngine);
+			return distribution(GetEngine());
 		}
 
 		template<typename T, std::enable_if_t<std::is_floating_point_v<T>, bool> = true>
 		static T Range(T min, T max)
 		{
 			std::uniform_real_distribution distribution{ min, std::max(min, max) };
-			return distribution(sEngine);
+			return distribution(GetEngine());
 		}
 
 		template<glm::length_t L, typename T>
@@ -72,12 +74,65 @@ namespace CE
 
 		static uint32 CreateSeed(glm::vec2 position);
 
+		/**
+		 * \brief Reseeds the engines of all threads, so that a run can be reproduced.
+		 *
+		 * The engine of the calling thread is seeded with the seed itself, the engines of the
+		 * other threads are reseeded the next time they are used.
+		 */
+		static void SetSeed(uint32 seed);
+
+		/**
+		 * \brief Reseeds the engine of the calling thread from the seed and a stream.
+		 *
+		 * The numbers drawn afterwards only depend on the seed and the stream, not on which thread
+		 * draws them or on what that thread drew before. The registry selects a stream made from the
+		 * system and the number of times it was updated before updating it, so that systems that are
+		 * executed in parallel waves draw the same numbers every run.
+		 */
+		static void SelectStream(uint64 stream);
+
+		// The stream that was last selected on the calling thread
+		static uint64 GetStream() { return sStream; }
+
+		/**
+		 * \brief Creates a stream from another stream and an index.
+		 *
+		 * Work that a system splits up between threads selects DeriveStream(systemStream, indexOfWork)
+		 * for each piece of work, so that the numbers drawn do not depend on which thread did what.
+		 */
+		static uint64 DeriveStream(uint64 stream, uint32 index);
+
 	private:
+		static DefaultRandomEngine& GetEngine()
+		{
+			const uint32 seedVersion = sSeedVersion.load(std::memory_order_acquire);
+
+			if (sEngineSeedVersion != seedVersion)
+			{
+				sEngineSeedVersion = seedVersion;
+				sEngine.seed(sSeed.load(std::memory_order_relaxed) ^ static_cast<uint32>(std::hash<std::thread::id>{}(std::this_thread::get_id())));
+			}
+
+			return sEngine;
+		}
+
 		friend ReflectAccess;
 		static MetaType Reflect();
 		REFLECT_AT_START_UP(Random);
 
 		static inline std::random_device sDevice{};
-		static inline DefaultRandomEngine sEngine{ sDevice() };
+		static inline const uint32 sInitialSeed = sDevice();
+
+		// Systems may be executed in parallel, so each thread gets their own engine.
+		static inline thread_local DefaultRandomEngine sEngine{ sInitialSeed ^ static_cast<uint32>(std::hash<std::thread::id>{}(std::this_thread::get_id())) };
+
+		static inline std::atomic<uint32> sSeed{ sInitialSeed };
+
+		// Incremented by SetSeed, each thread reseeds its engine once it sees a new version
+		static inline std::atomic<uint32> sSeedVersion{};
+		static inline thread_local uint32 sEngineSeedVersion{};
+
+		static inline thread_local uint64 sStream{};
 	};
 }
\ No newline at end of file
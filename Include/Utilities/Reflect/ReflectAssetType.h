@@ -25,6 +25,22 @@ namespace CE
 			type.GetProperties().Add(Props::sCannotReferenceOtherAssetsTag)
 		*/
 		static constexpr std::string_view sCannotReferenceOtherAssetsTag = "sCannotReferenceOtherAssetsTag";
+
+		/*
+		Use on:
+			Assets
+
+		Description:
+			Assets that are streamed in through AssetManager::RequestLoad are usually
+			constructed on a worker thread. Use this tag if the constructor uses resources
+			that may only be accessed from the main thread, such as the GPU's upload commands.
+			The file is then still read on the worker thread, but the asset is constructed
+			on the main thread during AssetManager::FinishStreamedLoads.
+
+		Example:
+			type.GetProperties().Add(Props::sMustBeConstructedOnMainThreadTag)
+		*/
+		static constexpr std::string_view sMustBeConstructedOnMainThreadTag = "sMustBeConstructedOnMainThreadTag";
 	}
 
 	// Makes sure the type receives all the functionality that an Asset requires.
@@ -0,0 +1,185 @@
+#pragma once
+#include "Geometry2d.h"
+
+namespace CE
+{
+	/*
+	A uniform grid for many moving objects of roughly the same size, which
+	is rebuilt from scratch in O(n) instead of being updated.
+
+	The cells are as wide as the average object. Each object is placed in
+	the cell that contains the centre of its bounding box, so queries look
+	in the cells around the inquirer, extended by the largest half extent of
+	the objects. Objects that are much larger than the cells are not placed
+	in any cell, but are tested against every inquirer instead.
+
+	Only the occupied cells are stored, in a hash table. The objects are
+	binned using a counting sort on their bucket, so the objects in a bucket
+	are next to each other in memory. Build returns this order, so that the
+	owner can store its own data about the objects in the same order.
+	*/
+	class SpatialHashGrid
+	{
+	public:
+		/**
+		 * \brief Bins the objects into cells.
+		 * \param order Receives the index in boundingBoxes of each object, in the order the objects are stored in.
+		 * Objects are referred to by their position in this order.
+		 */
+		void Build(Span<const TransformedAABB> boundingBoxes, std::vector<uint32>& order);
+
+		void Clear();
+
+		bool IsEmpty() const { return GetNumOfObjects() == 0; }
+
+		uint32 GetNumOfObjects() const { return mNumOfBinnedObjects + static_cast<uint32>(mOversizedBoundingBoxes.size()); }
+
+		float GetCellSize() const { return mCellSize; }
+
+		/**
+		 * \brief Calls onObject(index) for every object that may overlap with the inquirer.
+		 *
+		 * If onObject returns true, the query stops and true is returned.
+		 */
+		template<typename InquirerShape, typename OnObjectFunction>
+		bool Query(const InquirerShape& inquirerShape, OnObjectFunction&& onObject) const;
+
+		// Calls func(boundingBox) for each cell that contains at least one object
+		template<typename Func>
+		void ForEachOccupiedCell(Func&& func) const;
+
+		// Objects whose half extent is larger than this many cells are not placed in a cell
+		static constexpr float sMaxHalfExtentInCells = 1.0f;
+
+		static constexpr float sMinCellSize = .01f;
+
+	private:
+		uint32 GetBucket(glm::ivec2 cell) const
+		{
+			return ((static_cast<uint32>(cell.x) * 73856093u) ^ (static_cast<uint32>(cell.y) * 19349663u)) & mBucketMask;
+		}
+
+		template<typename InquirerShape>
+		static TransformedAABB GetInquirerBoundingBox(const InquirerShape& inquirerShape);
+
+		float mCellSize = 1.0f;
+
+		// The largest half extent of the objects that were placed in a cell
+		float mMaxHalfExtent{};
+
+		// The objects in bucket i are mCells[mBucketStart[i]] to mCells[mBucketStart[i + 1]]
+		std::vector<uint32> mBucketStart{};
+		uint32 mBucketMask{};
+
+		// The cell of each object that was placed in a cell. Different cells can share a bucket.
+		std::vector<glm::ivec2> mCells{};
+		uint32 mNumOfBinnedObjects{};
+
+		// The objects that were too large for a cell, which come after the binned objects
+		std::vector<TransformedAABB> mOversizedBoundingBoxes{};
+
+		// Used during Build, stored here to prevent reallocating
+		std::vector<uint32> mBucketOfObject{};
+		std::vector<glm::ivec2> mCellOfObject{};
+		std::vector<uint32> mNextInBucket{};
+	};
+
+	template<typename InquirerShape, typename OnObjectFunction>
+	bool SpatialHashGrid::Query(const InquirerShape& inquirerShape, OnObjectFunction&& onObject) const
+	{
+		if (mNumOfBinnedObjects != 0)
+		{
+			const TransformedAABB inquirerBox = GetInquirerBoundingBox(inquirerShape);
+
+			const glm::vec2 minCell = glm::floor((inquirerBox.mMin - glm::vec2{ mMaxHalfExtent }) / mCellSize);
+			const glm::vec2 maxCell = glm::floor((inquirerBox.mMax + glm::vec2{ mMaxHalfExtent }) / mCellSize);
+			const float numOfCells = (maxCell.x - minCell.x + 1.0f) * (maxCell.y - minCell.y + 1.0f);
+
+			// Large inquirers, such as long lines, would visit more cells than there are objects
+			if (!(numOfCells <= static_cast<float>(mNumOfBinnedObjects)))
+			{
+				for (uint32 i = 0; i < mNumOfBinnedObjects; i++)
+				{
+					const glm::vec2 cell{ mCells[i] };
+
+					if (cell.x >= minCell.x
+						&& cell.y >= minCell.y
+						&& cell.x <= maxCell.x
+						&& cell.y <= maxCell.y
+						&& onObject(i))
+					{
+						return true;
+					}
+				}
+			}
+			else
+			{
+				const glm::ivec2 minCellIndex{ minCell };
+				const glm::ivec2 maxCellIndex{ maxCell };
+
+				for (int32 y = minCellIndex.y; y <= maxCellIndex.y; y++)
+				{
+					for (int32 x = minCellIndex.x; x <= maxCellIndex.x; x++)
+					{
+						const glm::ivec2 cell{ x, y };
+						const uint32 bucket = GetBucket(cell);
+
+						for (uint32 i = mBucketStart[bucket]; i < mBucketStart[bucket + 1]; i++)
+						{
+							if (mCells[i] == cell
+								&& onObject(i))
+							{
+								return true;
+							}
+						}
+					}
+				}
+			}
+		}
+
+		for (uint32 i = 0; i < static_cast<uint32>(mOversizedBoundingBoxes.size()); i++)
+		{
+			if (AreOverlapping(mOversizedBoundingBoxes[i], inquirerShape)
+				&& onObject(mNumOfBinnedObjects + i))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template<typename Func>
+	void SpatialHashGrid::ForEachOccupiedCell(Func&& func) const
+	{
+		for (uint32 i = 0; i < mNumOfBinnedObjects; i++)
+		{
+			// Objects in the same cell are usually next to each other
+			if (i != 0
+				&& mCells[i] == mCells[i - 1])
+			{
+				continue;
+			}
+
+			const glm::vec2 cellMin = glm::vec2{ mCells[i] } * mCellSize;
+			func(TransformedAABB{ cellMin, cellMin + glm::vec2{ mCellSize } });
+		}
+	}
+
+	template<typename InquirerShape>
+	TransformedAABB SpatialHashGrid::GetInquirerBoundingBox(const InquirerShape& inquirerShape)
+	{
+		if constexpr (std::is_same_v<InquirerShape, glm::vec2>)
+		{
+			return { inquirerShape, inquirerShape };
+		}
+		else if constexpr (std::is_same_v<InquirerShape, Line>)
+		{
+			return { glm::min(inquirerShape.mStart, inquirerShape.mEnd), glm::max(inquirerShape.mStart, inquirerShape.mEnd) };
+		}
+		else
+		{
+			return inquirerShape.GetBoundingBox();
+		}
+	}
+}
@@ -32,5 +32,8 @@ namespace CE
 		// CreateUniqueName("Hello!") returns "Hello! (1)" if "Hello!" is not available,
 		// CreateUniqueName("Hello! (1)") returns "Hello! (2)", etc.
 		static std::string CreateUniqueName(std::string_view desiredName, const std::function<bool(std::string_view)>& isNameAvailable);
+
+		// Writes the string between quotes, escaping the characters that are not allowed in a JSON string
+		static void WriteEscapedJSONString(std::ostream& stream, std::string_view str);
 	};
 }
\ No newline at end of file
@@ -1,10 +1,10 @@
 #pragma once
+#include "GSON/GSONBinary.h"
 
 namespace CE
 {
 	class MetaType;
 	class Registry;
-	class BinaryGSONObject;
 	class World;
 
 	// Can be used to serialize/deserialize worlds
@@ -24,6 +24,9 @@ namespace CE
 		*/
 		static std::vector<entt::entity> Deserialize(World& world, const BinaryGSONObject& serializedWorld);
 
+		// Deserializes straight from a view, without first copying it into a BinaryGSONObject
+		static std::vector<entt::entity> Deserialize(World& world, const BinaryGSONView::Object& serializedWorld);
+
 		// Will serialize the entire world.
 		static BinaryGSONObject Serialize(const World& world);
 
@@ -31,6 +34,9 @@ namespace CE
 		static BinaryGSONObject Serialize(const World& world, Span<const entt::entity> entities, bool serializeChildren);
 
 	private:
+		template<typename ObjectT>
+		static std::vector<entt::entity> DeserializeInternal(World& world, const ObjectT& serializedWorld);
+
 		static BinaryGSONObject SerializeInternal(const World& world, std::vector<entt::entity>&& entitiesToSerialize, bool allEntitiesInWorldAreBeingSerialized);
 	};
 }
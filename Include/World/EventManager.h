@@ -24,10 +24,9 @@ namespace CE
 		Span<const BoundEvent> GetBoundEvents(const EventBase& eventBase) const;
 
 	private:
-		void InvokeEventForAllComponentsOnEntityImpl(const EventBase& eventBase, 
-			entt::entity entity,
-			MetaFunc::DynamicArgs argsProvided, 
-			Span<TypeForm> argFormsProvided);
+		// Returns std::nullopt if the entity does not have the component the event was bound to.
+		// Otherwise returns the component, or nullptr if the event is static.
+		std::optional<void*> TryGetComponentForEvent(const BoundEvent& boundEvent, entt::entity entity) const;
 
 		// mWorld needs to be updated in World::World(World&&), so we give access to World to do so.
 		friend class World;
@@ -42,20 +41,15 @@ namespace CE
 	{
 		static_assert(std::is_invocable_v<std::function<void(Params...)>, Args...>);
 
-		std::array<MetaAny, sizeof...(Args) + 3> argsInclusive{
-			MetaAny{ MakeTypeInfo<void>(), nullptr }, // This slot can be used for the component if the event is not static
-			MetaAny{ mWorld.get() },
-			MetaAny{ entity },
-			MetaFunc::PackSingle<Args>(std::forward<Args>(args))...
-		};
-
-		std::array<TypeForm, sizeof...(Args) + 3> formsInclusive {
-			TypeForm::Ref, // This slot can be used for the component if the event is not static
-			TypeForm::Ref,
-			TypeForm::ConstRef,
-			MakeTypeForm<Args>()...
-		};
-
-		InvokeEventForAllComponentsOnEntityImpl(eventType, entity, { argsInclusive }, { formsInclusive });
+		for (const BoundEvent& boundEvent : GetBoundEvents(eventType))
+		{
+			const std::optional<void*> component = TryGetComponentForEvent(boundEvent, entity);
+
+			if (component.has_value())
+			{
+				// The arguments are passed to every bound event, so they are never forwarded
+				InvokeBoundEvent(boundEvent, eventType, *component, mWorld.get(), entity, args...);
+			}
+		}
 	}
 }
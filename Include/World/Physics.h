@@ -48,6 +48,9 @@ namespace CE
 		template<typename Collider, typename TransformedCollider>
 		void UpdateTransformedColliders(World& world, std::array<bool, static_cast<size_t>(CollisionLayer::NUM_OF_LAYERS)>& wereItemsAddedToLayer);
 
+		// Sorts the transformed colliders into mCollidersPerLayer in a single pass
+		void GatherCollidersPerLayer();
+
 		friend ReflectAccess;
 		static MetaType Reflect();
 		REFLECT_AT_START_UP(Physics);
@@ -57,5 +60,8 @@ namespace CE
 		std::reference_wrapper<World> mWorld;
 
 		BVHS mBVHs;
+
+		// Stored here to prevent reallocating
+		std::array<BVH::Colliders, static_cast<size_t>(CollisionLayer::NUM_OF_LAYERS)> mCollidersPerLayer{};
 	};
 }
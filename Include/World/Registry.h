@@ -1,4 +1,7 @@
 #pragma once
+#include <chrono>
+#include <mutex>
+
 #include "World/World.h"
 #include "Systems/System.h"
 #include "Utilities/MemFunctions.h"
@@ -140,16 +143,51 @@ namespace CE
 
 		void Clear();
 
+		struct SystemMeasurement
+		{
+			std::reference_wrapper<const System> mSystem;
+
+			// The TypeId of the system's most derived class
+			TypeId mSystemTypeId{};
+
+			// Since the measurements were last cleared
+			std::chrono::nanoseconds mTimeSpentUpdating{};
+			uint32 mNumOfUpdates{};
+		};
+
+		// If enabled, the time spent in each System::Update is measured. Used when benchmarking.
+		void SetShouldMeasureSystems(bool shouldMeasure) { mShouldMeasureSystems = shouldMeasure; }
+
+		std::vector<SystemMeasurement> GetSystemMeasurements() const;
+
+		void ClearSystemMeasurements();
+
 	private:
+		struct InternalSystem;
+
 		struct SingleTick
 		{
-			SingleTick(System& system, float deltaTime = 0.0f) : mSystem(system), mDeltaTime(deltaTime) {};
-			std::reference_wrapper<System> mSystem;
+			SingleTick(InternalSystem& system, float deltaTime = 0.0f, std::optional<float> timeOfFixedStep = std::nullopt) :
+				mSystem(system), mDeltaTime(deltaTime), mTimeOfFixedStep(timeOfFixedStep) {};
+
+			// Ticks with the same priority that happen during the same step are allowed to be executed in parallel.
+			bool IsInSameBatchAs(const SingleTick& other) const;
+
+			bool CanBeExecutedInParallelWith(const SingleTick& other) const;
+
+			std::reference_wrapper<InternalSystem> mSystem;
 			float mDeltaTime{};
+			std::optional<float> mTimeOfFixedStep{};
 		};
 		std::vector<SingleTick> GetSortedSystemsToUpdate(float deltaTime);
+
+		// Executes the ticks in waves. The systems within a wave have no conflicting
+		// component access, and are executed in parallel.
+		void UpdateBatch(Span<const SingleTick> batch);
+
+		void UpdateSystem(const SingleTick& tick);
 		
-		void AddSystem(std::unique_ptr<System, InPlaceDeleter<System, true>> system);
+		void AddSystem(std::unique_ptr<System, InPlaceDeleter<System, true>> system, TypeId systemTypeId);
 
 		void CallBeginPlayForEntitiesAwaitingBeginPlay();
 
@@ -166,29 +204,63 @@ namespace CE
 
 		struct InternalSystem
 		{
-			InternalSystem(std::unique_ptr<System, InPlaceDeleter<System, true>> system, SystemStaticTraits traits) :
+			InternalSystem(std::unique_ptr<System, InPlaceDeleter<System, true>> system, TypeId systemTypeId, SystemStaticTraits traits) :
 				mSystem(std::move(system)),
+				mSystemTypeId(systemTypeId),
 				mTraits(traits) {}
 
 			// Systems are created using the runtime reflection system,
 			// which uses placement new for the constructing of objects.
 			// Hence, the custom deleter
 			std::unique_ptr<System, InPlaceDeleter<System, true>> mSystem{};
+			TypeId mSystemTypeId{};
 			SystemStaticTraits mTraits{};
+
+			std::chrono::nanoseconds mTimeSpentUpdating{};
+			uint32 mNumOfUpdates{};
+
+			// Together with mNumOfSteps, selects the Random stream used while updating this system.
+			// Assigned in the order the systems are added, which is the same every run.
+			uint32 mRandomStream{};
+			uint32 mNumOfSteps{};
 		};
 		
 		struct FixedTickSystem :
 			public InternalSystem
 		{
-			FixedTickSystem(std::unique_ptr<System, InPlaceDeleter<System, true>> system, SystemStaticTraits traits, float timeOfNextStep) :
-				InternalSystem(std::move(system), traits),
+			FixedTickSystem(std::unique_ptr<System, InPlaceDeleter<System, true>> system, TypeId systemTypeId, SystemStaticTraits traits, float timeOfNextStep) :
+				InternalSystem(std::move(system), systemTypeId, traits),
 				mTimeOfNextStep(timeOfNextStep) {}
 			float mTimeOfNextStep{};
 		};
 		std::vector<FixedTickSystem> mFixedTickSystems{};
 		std::vector<InternalSystem> mNonFixedSystems{};
+
+		bool mShouldMeasureSystems{};
+
+		// The owners of the root transforms whose hierarchy has a transform that is out of date.
+		// Filled by TransformComponent::MarkWorldDirty, consumed by TransformComponent::UpdateWorldTransforms.
+		// Transforms may be modified from thread-safe OnTickBatch chunks, so roots are appended while
+		// holding mDirtyTransformRootsMutex. Each root is appended at most once per update.
+		friend TransformComponent;
+		std::vector<entt::entity> mDirtyTransformRoots{};
+		std::mutex mDirtyTransformRootsMutex{};
 	};
 
+	template<typename... Components>
+	SystemComponentAccess& SystemComponentAccess::Read()
+	{
+		(mReads.push_back({ MakeStrippedTypeId<Components>(), [](Registry& reg) { reg.Storage<std::remove_const_t<Components>>(); } }), ...);
+		return *this;
+	}
+
+	template<typename... Components>
+	SystemComponentAccess& SystemComponentAccess::Write()
+	{
+		(mWrites.push_back({ MakeStrippedTypeId<Components>(), [](Registry& reg) { reg.Storage<std::remove_const_t<Components>>(); } }), ...);
+		return *this;
+	}
+
 	template<typename ComponentType, typename ...AdditonalArgs>
 	decltype(auto) Registry::AddComponent(const entt::entity toEntity, AdditonalArgs && ...additionalArgs)
 	{
@@ -423,7 +495,7 @@ namespace CE
 
 		T* obj = new (buffer) T(std::forward<Args>(args)...);
 		std::unique_ptr<System, InPlaceDeleter<System, true>> newSystem{ obj };
-		AddSystem(std::move(newSystem));
+		AddSystem(std::move(newSystem), MakeTypeId<T>());
 
 		return *obj;
 	}
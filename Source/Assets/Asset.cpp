@@ -29,6 +29,12 @@ CE::AssetSaveInfo CE::Asset::Save(const std::optional<AssetFileMetaData::Importe
 	return saveInfo;
 }
 
+size_t CE::Asset::GetMemoryUsage() const
+{
+	const MetaType* const type = MetaManager::Get().TryGetType(mTypeId);
+	return (type == nullptr ? sizeof(Asset) : type->GetSize()) + mName.capacity();
+}
+
 void CE::Asset::OnSave(AssetSaveInfo&) const
 {
 	LOG(LogAssets, Verbose, "OnSave was not overriden for this asset class");
@@ -37,5 +43,12 @@ void CE::Asset::OnSave(AssetSaveInfo&) const
 CE::MetaType CE::Asset::Reflect()
 {
 	MetaType type = MetaType{MetaType::T<Asset>{}, "Asset", MetaType::Ctor<AssetLoadInfo&>{} };
+
+	// size_t is not reflected, so the usage is clamped to the range of a uint32
+	type.AddFunc([](const Asset& asset)
+		{
+			return static_cast<uint32>(std::min<size_t>(asset.GetMemoryUsage(), std::numeric_limits<uint32>::max()));
+		}, "GetMemoryUsage", MetaFunc::ExplicitParams<const Asset&>{}, "Asset", "NumOfBytes");
+
 	return type;
 }
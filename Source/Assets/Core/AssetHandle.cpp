@@ -61,7 +61,7 @@ const CE::AssetFileMetaData& CE::AssetHandleBase::GetMetaData() const
 
 bool CE::AssetHandleBase::IsLoaded() const
 {
-	return mAssetInternal != nullptr && mAssetInternal->mAsset != nullptr;
+	return mAssetInternal != nullptr && mAssetInternal->IsLoaded();
 }
 
 void CE::AssetHandleBase::Unload()
@@ -124,6 +124,11 @@ bool CE::AssetHandleBase::IsA(TypeId type) const
 		&& GetMetaData().GetClass().IsDerivedFrom(type);
 }
 
+void CE::AssetHandleBase::RequestLoad(const float priority) const
+{
+	AssetManager::Get().RequestLoad(*this, priority);
+}
+
 void cereal::save(BinaryOutputArchive& archive, const CE::AssetHandleBase& asset)
 {
 	if (asset != nullptr)
@@ -227,13 +232,8 @@ void CE::Internal::DisplayHandleWidget(WeakAssetHandle<>& asset, const std::stri
 		asset = nullptr;
 	}
 
-	for (const WeakAssetHandle<>& weakAsset : AssetManager::Get().GetAllAssets<>())
+	for (const WeakAssetHandle<>& weakAsset : AssetManager::Get().GetAllAssets(type))
 	{
-		if (!weakAsset.GetMetaData().GetClass().IsDerivedFrom(type))
-		{
-			continue;
-		}
-
 		if (Search::AddItem(weakAsset.GetMetaData().GetName(),
 			[weakAsset, thumbnailEditorSystem](std::string_view name)
 			{
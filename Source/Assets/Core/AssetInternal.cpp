@@ -3,8 +3,10 @@
 
 #include "Assets/Asset.h"
 #include "Assets/Core/AssetLoadInfo.h"
+#include "Core/AssetManager.h"
 #include "Meta/MetaTools.h"
 #include "Meta/MetaType.h"
+#include "Utilities/Profiler.h"
 
 CE::Internal::AssetInternal::AssetInternal(AssetFileMetaData&& metaData, const std::optional<std::filesystem::path>& path) :
 	mMetaData(std::move(metaData)),
@@ -12,33 +14,91 @@ CE::Internal::AssetInternal::AssetInternal(AssetFileMetaData&& metaData, const s
 {
 }
 
+CE::Internal::AssetInternal::~AssetInternal() = default;
+
 void CE::Internal::AssetInternal::Load()
 {
-	LOG(LogAssets, Verbose, "Loading {}", mMetaData.GetName());
+	if (IsLoaded())
+	{
+		return;
+	}
 
-	if (mAsset != nullptr)
+	++sNumOfBlockingLoads;
+	PROFILE_COUNTER_ADD("Blocking asset loads", 1);
+
+	std::lock_guard lock{ mLoadMutex };
+	LoadImpl();
+}
+
+void CE::Internal::AssetInternal::Stream()
+{
+	std::lock_guard lock{ mLoadMutex };
+	LoadImpl();
+}
+
+void CE::Internal::AssetInternal::PrepareLoad()
+{
+	std::lock_guard lock{ mLoadMutex };
+
+	if (IsLoaded())
 	{
-		LOG(LogAssets, Warning, "Attempting to load {} twice", mMetaData.GetName());
 		return;
 	}
 
-	if (!mFileOfOrigin.has_value())
+	if (mPreparedLoadInfo == nullptr
+		&& mFileOfOrigin.has_value())
+	{
+		PROFILE_FUNCTION();
+
+		std::optional<AssetLoadInfo> loadInfo = AssetLoadInfo::LoadFromFile(*mFileOfOrigin);
+
+		if (loadInfo.has_value())
+		{
+			loadInfo->Prefetch();
+			mPreparedLoadInfo = std::make_unique<AssetLoadInfo>(std::move(*loadInfo));
+		}
+	}
+
+	// If the file could not be read, the error is logged once the main thread attempts to load it
+	mLoadState = LoadState::AwaitingMainThread;
+}
+
+void CE::Internal::AssetInternal::LoadImpl()
+{
+	// Another thread may have loaded the asset while we were waiting for the lock
+	if (IsLoaded())
 	{
-		LOG(LogAssets, Error, "Attempted to load {}, but this asset was generated at runtime and should not have been unloaded to begin with.",
-			mMetaData.GetName());
 		return;
 	}
 
-	std::optional<AssetLoadInfo> loadInfo = AssetLoadInfo::LoadFromFile(*mFileOfOrigin);
+	LOG(LogAssets, Verbose, "Loading {}", mMetaData.GetName());
+	PROFILE_FUNCTION();
 
-	if (!loadInfo.has_value())
+	if (!mFileOfOrigin.has_value())
 	{
-		LOG(LogAssets, Error, "Asset {} could not be loaded, the metadata failed to load.",
+		LOG(LogAssets, Error, "Attempted to load {}, but this asset was generated at runtime and should not have been unloaded to begin with.",
 			mMetaData.GetName());
 		return;
 	}
 
-	ASSERT(loadInfo.has_value());
+	mLoadState = LoadState::Loading;
+
+	std::unique_ptr<AssetLoadInfo> loadInfo = std::move(mPreparedLoadInfo);
+
+	if (loadInfo == nullptr)
+	{
+		std::optional<AssetLoadInfo> loadedInfo = AssetLoadInfo::LoadFromFile(*mFileOfOrigin);
+
+		if (!loadedInfo.has_value())
+		{
+			LOG(LogAssets, Error, "Asset {} could not be loaded, the metadata failed to load.",
+				mMetaData.GetName());
+			mLoadState = LoadState::Unloaded;
+			return;
+		}
+
+		loadInfo = std::make_unique<AssetLoadInfo>(std::move(*loadedInfo));
+	}
 
 	FuncResult constructResult = mMetaData.GetClass().Construct(*loadInfo);
 
@@ -47,16 +107,86 @@ void CE::Internal::AssetInternal::Load()
 		LOG(LogAssets, Error, "Asset of type {} could not be constructed. Does it have a constructor that takes a LoadInfo&, and was this constructor reflected in your reflect function? {}",
 			mMetaData.GetClass().GetName(),
 			constructResult.Error());
+		mLoadState = LoadState::Unloaded;
 		return;
 	}
-	mAsset = MakeUnique<Asset>(std::move(constructResult.GetReturnValue()));
+
+	SetLoadedAsset(MakeUnique<Asset>(std::move(constructResult.GetReturnValue())));
+}
+
+void CE::Internal::AssetInternal::SetLoadedAsset(std::unique_ptr<Asset, InPlaceDeleter<Asset, true>> asset)
+{
+	mAsset = std::move(asset);
+
+	// Release, so that threads that see the asset as loaded also see the asset itself
+	mLoadState.store(mAsset == nullptr ? LoadState::Unloaded : LoadState::Loaded, std::memory_order_release);
+
+	if (mFileOfOrigin.has_value())
+	{
+		AssetManager::Get().UpdateResidency(*this, true);
+	}
+}
+
+void CE::Internal::AssetInternal::UpdateResidency()
+{
+	// Assets generated at runtime cannot be loaded back in, so they never count towards the budget
+	if (!mFileOfOrigin.has_value())
+	{
+		return;
+	}
+
+	// The asset can only be measured while no other thread is loading or unloading it.
+	// If one is, it measures the asset itself once it is done.
+	std::unique_lock lock{ mLoadMutex, std::try_to_lock };
+	AssetManager::Get().UpdateResidency(*this, lock.owns_lock());
+}
+
+void CE::Internal::AssetInternal::OnFirstStrongReference()
+{
+	// UnLoadIfUnused may have seen no strong references just before this one was
+	// added. If it is still unloading the asset, wait for it to finish, so that the
+	// caller cannot dereference the asset while it is being destroyed. If the asset
+	// is not loaded, there is nothing to wait for; dereferencing it loads it,
+	// which takes the lock as well.
+	if (IsLoaded())
+	{
+		std::lock_guard lock{ mLoadMutex };
+	}
+
+	UpdateResidency();
 }
 
 void CE::Internal::AssetInternal::UnLoad()
+{
+	std::lock_guard lock{ mLoadMutex };
+	UnLoadImpl();
+}
+
+bool CE::Internal::AssetInternal::UnLoadIfUnused()
+{
+	std::lock_guard lock{ mLoadMutex };
+
+	if (mRefCounters[static_cast<int>(RefCountType::Strong)] > 0
+		|| !IsLoaded())
+	{
+		return false;
+	}
+
+	UnLoadImpl();
+	return true;
+}
+
+void CE::Internal::AssetInternal::UnLoadImpl()
 {
 	if (mAsset != nullptr)
 	{
+		mLoadState = LoadState::Unloaded;
 		mAsset.reset();
+
+		if (mFileOfOrigin.has_value())
+		{
+			AssetManager::Get().UpdateResidency(*this, true);
+		}
 	}
 	else
 	{
@@ -6,6 +6,7 @@
 #include "Meta/MetaType.h"
 #include "Assets/Asset.h"
 #include "Utilities/ClassVersion.h"
+#include "Utilities/view_istream.h"
 
 bool CE::AssetLoadInfo::ConstructFromCurrentStream()
 {
@@ -21,12 +22,22 @@ bool CE::AssetLoadInfo::ConstructFromCurrentStream()
 }
 
 CE::AssetLoadInfo::AssetLoadInfo(const std::filesystem::path& fromFile) :
-	mStream(std::make_unique<std::ifstream>(fromFile, std::ifstream::binary))
+	mMappedFile(MemoryMappedFile::Map(fromFile))
 {
-	if (!static_cast<const std::ifstream*>(mStream.get())->is_open())
+	if (mMappedFile.has_value())
 	{
-		LOG(LogAssets, Message, "Failed to produce valid AssetLoadInfo: the file {} could not be opened", fromFile.string());
-		return;
+		mStream = std::make_unique<view_istream>(mMappedFile->GetView());
+	}
+	else
+	{
+		// Empty files cannot be mapped, but we still want to log the same message as before
+		mStream = std::make_unique<std::ifstream>(fromFile, std::ifstream::binary);
+
+		if (!static_cast<const std::ifstream*>(mStream.get())->is_open())
+		{
+			LOG(LogAssets, Message, "Failed to produce valid AssetLoadInfo: the file {} could not be opened", fromFile.string());
+			return;
+		}
 	}
 
 	if (!ConstructFromCurrentStream())
@@ -63,6 +74,27 @@ CE::AssetLoadInfo::AssetLoadInfo(const MetaType& assetClass, const std::string_v
 	}
 }
 
+CE::Span<const std::byte> CE::AssetLoadInfo::GetRemainingBytes()
+{
+	if (mMappedFile.has_value())
+	{
+		const std::streamoff position = mStream->tellg();
+		mStream->seekg(0, std::ios::end);
+
+		if (position >= 0)
+		{
+			return mMappedFile->GetBytes().subspan(static_cast<size_t>(position));
+		}
+		return {};
+	}
+
+	if (mStream->good())
+	{
+		mRemainingBytes.append(std::istreambuf_iterator<char>{ *mStream }, std::istreambuf_iterator<char>{});
+	}
+	return { reinterpret_cast<const std::byte*>(mRemainingBytes.data()), mRemainingBytes.size() };
+}
+
 std::optional<CE::AssetLoadInfo> CE::AssetLoadInfo::LoadFromFile(const std::filesystem::path& fromFile)
 {
 	std::optional<AssetLoadInfo> loadInfo{ AssetLoadInfo{fromFile} };
@@ -85,3 +117,10 @@ std::optional<CE::AssetLoadInfo> CE::AssetLoadInfo::LoadFromStream(std::unique_p
 	return loadInfo;
 }
 
+void CE::AssetLoadInfo::Prefetch() const
+{
+	if (mMappedFile.has_value())
+	{
+		mMappedFile->Prefetch();
+	}
+}
@@ -71,6 +71,7 @@ CE::MetaType CE::Font::Reflect()
 {
     MetaType type = MetaType{ MetaType::T<Font>{}, "Font", MetaType::Base<Asset>{}, MetaType::Ctor<AssetLoadInfo&>{}, MetaType::Ctor<std::string_view>{} };
     type.GetProperties().Add(Props::sCannotReferenceOtherAssetsTag);
+    type.GetProperties().Add(Props::sMustBeConstructedOnMainThreadTag);
     ReflectAssetType<Font>(type);
     return type;
 }
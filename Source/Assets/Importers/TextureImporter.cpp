@@ -2,7 +2,6 @@
 #include "Assets/Importers/TextureImporter.h"
 
 #include "stb_image/stb_image.h"
-#include "stb_image/stbi_image_write.h"
 
 #include "Assets/Texture.h"
 #include "Utilities/ClassVersion.h"
@@ -71,26 +70,21 @@ std::optional<CE::ImportedAsset> CE::TextureImporter::ImportFromMemory(const std
 	const MetaType* const textureType = MetaManager::Get().TryGetType<Texture>();
 	ASSERT(textureType != nullptr);
 
-	std::string pngData{};
-	auto func = [](void* context, void* data, int size)
-		{
-			static_cast<std::string*>(context)->append(static_cast<const char*>(data), size);
-		};
-	
-	if (stbi_write_png_to_func(func, &pngData, static_cast<int>(width), static_cast<int>(height), 4, buffers.data(), width * 4) == 0)
-	{
-		LOG(LogAssets, Error, "Importing texture failed: could not convert data to png");
-		return std::optional<ImportedAsset>{};
-	}
-
 	ImportedAsset texture{ name, *textureType, importedFromFile, importerVersion };
-	texture.GetStream() << pngData;
 
-	return texture;
+	if (Texture::WriteMipChain(texture, { reinterpret_cast<const unsigned char*>(buffers.data()), buffers.size() }, width, height))
+	{
+		return texture;
+	}
+	return std::optional<ImportedAsset>{};
 }
 
 CE::MetaType CE::TextureImporter::Reflect()
 {
 	MetaType type = MetaType{MetaType::T<TextureImporter>{}, "TextureImporter", MetaType::Base<Importer>{} };
+
+	// Version 1 stores the mip chain instead of a PNG
+	SetClassVersion(type, 1);
+
 	return type;
 }
@@ -46,10 +46,17 @@ CE::Level::Level(AssetLoadInfo& loadInfo) :
 	Asset(loadInfo),
 	mWorld(false)
 {
-	BinaryGSONObject savedData{};
-	savedData.LoadFromBinary(loadInfo.GetStream());
+	// The components make up most of the level, and are deserialized straight from the file
+	const std::optional<BinaryGSONView> savedData = BinaryGSONView::Parse(loadInfo.GetRemainingBytes());
 
-	BinaryGSONObject* const serializedWorld = savedData.TryGetGSONObject("Components");
+	if (!savedData.has_value())
+	{
+		LOG(LogAssets, Warning, "Invalid level {}: Could not parse saved data",
+			GetName());
+		return;
+	}
+
+	const BinaryGSONView::Object* const serializedWorld = savedData->GetRoot().TryGetGSONObject("Components");
 
 	if (serializedWorld == nullptr)
 	{
@@ -60,15 +67,19 @@ CE::Level::Level(AssetLoadInfo& loadInfo) :
 
 	Archiver::Deserialize(*mWorld, *serializedWorld);
 
-	BinaryGSONObject* const serializedPrefabs = savedData.TryGetGSONObject("Prefabs");
-	if (serializedPrefabs == nullptr)
+	const BinaryGSONView::Object* const serializedPrefabsView = savedData->GetRoot().TryGetGSONObject("Prefabs");
+	if (serializedPrefabsView == nullptr)
 	{
 		return;
 	}
 
+	// The diffing below holds on to references to the serialized prefabs, so these are copied
+	BinaryGSONObject serializedPrefabs{};
+	serializedPrefabsView->CopyTo(serializedPrefabs);
+
 	std::vector<DiffedPrefab> diffedPrefabs{};
 
-	for (BinaryGSONObject& serializedPrefab : serializedPrefabs->GetChildren())
+	for (BinaryGSONObject& serializedPrefab : serializedPrefabs.GetChildren())
 	{
 		diffedPrefabs.emplace_back(DiffPrefab(serializedPrefab));
 	}
@@ -713,6 +724,7 @@ CE::BinaryGSONObject& CE::GetOrAddSerializedPrefabObject(BinaryGSONObject& prefa
 CE::MetaType CE::Level::Reflect()
 {
 	MetaType type = MetaType{ MetaType::T<Level>{}, "Level", MetaType::Base<Asset>{}, MetaType::Ctor<AssetLoadInfo&>{}, MetaType::Ctor<std::string_view>{} };
+	type.GetProperties().Add(Props::sMustBeConstructedOnMainThreadTag);
 	ReflectAssetType<Level>(type);
 	return type;
 }
\ No newline at end of file
@@ -24,7 +24,8 @@ CE::Prefab::Prefab(AssetLoadInfo& loadInfo) :
 	Asset(loadInfo)
 {
 	BinaryGSONObject object{};
-	object.LoadFromBinary(loadInfo.GetStream());
+	BinaryReader reader{ loadInfo.GetRemainingBytes() };
+	object.LoadFromBinary(reader);
 	LoadFromGSON(object);
 }
 
@@ -163,6 +163,7 @@ CE::MetaType CE::SkinnedMesh::Reflect()
 {
     MetaType type = MetaType{ MetaType::T<SkinnedMesh>{}, "SkinnedMesh", MetaType::Base<Asset>{}, MetaType::Ctor<AssetLoadInfo&>{}, MetaType::Ctor<std::string_view>{} };
     type.GetProperties().Add(Props::sCannotReferenceOtherAssetsTag);
+    type.GetProperties().Add(Props::sMustBeConstructedOnMainThreadTag);
 
     SetClassVersion(type, 1);
 
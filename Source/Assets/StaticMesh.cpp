@@ -120,6 +120,7 @@ CE::MetaType CE::StaticMesh::Reflect()
 {
     MetaType type = MetaType{ MetaType::T<StaticMesh>{}, "StaticMesh", MetaType::Base<Asset>{}, MetaType::Ctor<AssetLoadInfo&>{}, MetaType::Ctor<std::string_view>{} };
     type.GetProperties().Add(Props::sCannotReferenceOtherAssetsTag);
+    type.GetProperties().Add(Props::sMustBeConstructedOnMainThreadTag);
 
     SetClassVersion(type, 1);
 
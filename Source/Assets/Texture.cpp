@@ -2,6 +2,7 @@
 #include "Assets/Texture.h"
 
 #include "Core/AssetManager.h"
+#include "Utilities/ClassVersion.h"
 #include "Utilities/Reflect/ReflectAssetType.h"
 
 CE::Texture::Texture(std::string_view name) :
@@ -12,6 +13,10 @@ CE::MetaType CE::Texture::Reflect()
 {
     MetaType type = MetaType{ MetaType::T<Texture>{}, "Texture", MetaType::Base<Asset>{}, MetaType::Ctor<AssetLoadInfo&>{}, MetaType::Ctor<std::string_view>{} };
 	type.GetProperties().Add(Props::sCannotReferenceOtherAssetsTag);
+
+	// Version 0 stored a single PNG, version 1 stores the mip chain uncompressed
+	SetClassVersion(type, 1);
+
     ReflectAssetType<Texture>(type);
     return type;
 }
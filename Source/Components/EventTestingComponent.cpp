@@ -6,6 +6,8 @@
 #include "Meta/Fwd/MetaPropsFwd.h"
 #include "Utilities/Events.h"
 #include "Utilities/Reflect/ReflectComponentType.h"
+#include "World/World.h"
+#include "World/Registry.h"
 
 void CE::EmptyEventTestingComponent::OnConstruct(World&, entt::entity)
 {
@@ -161,6 +163,34 @@ void CE::EventTestingComponent::OnCollisionExit(World&, entt::entity, entt::enti
 	++mNumOfCollisionExit;
 }
 
+void CE::EventTestingComponent::OnTickBatch(World& world, Span<const entt::entity> owners, Span<EventTestingComponent> components, float)
+{
+	const Registry& reg = world.GetRegistry();
+
+	for (size_t i = 0; i < components.size(); i++)
+	{
+		if (components.size() <= sMaxTickBatchSize
+			&& reg.TryGet<EventTestingComponent>(owners[i]) == &components[i])
+		{
+			++components[i].mNumOfBatchedTicks;
+		}
+	}
+}
+
+void CE::EventTestingComponent::OnFixedTickBatch(World& world, Span<const entt::entity> owners, Span<EventTestingComponent> components, float)
+{
+	const Registry& reg = world.GetRegistry();
+
+	for (size_t i = 0; i < components.size(); i++)
+	{
+		if (components.size() <= sMaxTickBatchSize
+			&& reg.TryGet<EventTestingComponent>(owners[i]) == &components[i])
+		{
+			++components[i].mNumOfBatchedFixedTicks;
+		}
+	}
+}
+
 CE::MetaType CE::EventTestingComponent::Reflect()
 {
 	auto type = MetaType{MetaType::T<EventTestingComponent>{}, "EventTestingComponent"};
@@ -176,6 +206,8 @@ CE::MetaType CE::EventTestingComponent::Reflect()
 	type.AddField(&EventTestingComponent::mNumOfCollisionEntry, "mNumOfCollisionEntry");
 	type.AddField(&EventTestingComponent::mNumOfCollisionStay, "mNumOfCollisionStay");
 	type.AddField(&EventTestingComponent::mNumOfCollisionExit, "mNumOfCollisionExit");
+	type.AddField(&EventTestingComponent::mNumOfBatchedTicks, "mNumOfBatchedTicks");
+	type.AddField(&EventTestingComponent::mNumOfBatchedFixedTicks, "mNumOfBatchedFixedTicks");
 
 	BindEvent(type, sOnConstruct, &EventTestingComponent::OnConstruct);
 	BindEvent(type, sOnBeginPlay, &EventTestingComponent::OnBeginPlay);
@@ -188,6 +220,12 @@ CE::MetaType CE::EventTestingComponent::Reflect()
 	BindEvent(type, sOnCollisionStay, &EventTestingComponent::OnCollisionStay);
 	BindEvent(type, sOnCollisionExit, &EventTestingComponent::OnCollisionExit);
 
+	// The chunks of the non-fixed tick are handed out to the JobSystem, the fixed ones are not
+	TickBatchTraits threadSafeTraits{};
+	threadSafeTraits.mIsThreadSafe = true;
+	BindTickBatch(type, sOnTickBatch, &EventTestingComponent::OnTickBatch, threadSafeTraits);
+	BindTickBatch(type, sOnFixedTickBatch, &EventTestingComponent::OnFixedTickBatch);
+
 	ReflectComponentType<EventTestingComponent>(type);
 	return type;
 }
@@ -29,28 +29,34 @@
 
 void CE::NavMeshComponent::GenerateNavMesh(const World& world)
 {
-	mPolygonDataNavMesh.clear();
 	mCleanedPolygonList.clear();
-	mAStarGraph = {};
+
+	// Never modify the existing snapshot, others may still be using it
+	std::shared_ptr<Snapshot> snapshot = std::make_shared<Snapshot>();
 
 	NavMeshData navMeshData = GenerateNavMeshData(world);
 	mCleanedPolygonList = GetDifferences(navMeshData);
-	Triangulation(mCleanedPolygonList);
+	Triangulation(mCleanedPolygonList, *snapshot);
 	mNavMeshNeedsUpdate = false;
 
-	mBVHWorld.emplace(false);
-	Registry& bvhReg = mBVHWorld->GetRegistry();
+	snapshot->mBVHWorld.emplace(false);
+	Registry& bvhReg = snapshot->mBVHWorld->GetRegistry();
+
+	BVH::Colliders colliders{};
 
-	for (uint32 i = 0; i < mPolygonDataNavMesh.size(); i++)
+	for (uint32 i = 0; i < snapshot->mPolygonDataNavMesh.size(); i++)
 	{
 		const entt::entity entity = bvhReg.Create(entt::entity{ i });
 		ASSERT(entity == entt::entity{ i });
 		bvhReg.AddComponent<PhysicsBody2DComponent>(entity).mRules = CollisionPresets::sTerrain.mRules;
-		bvhReg.AddComponent<TransformedPolygonColliderComponent>(entity, mPolygonDataNavMesh[i]);
+		bvhReg.AddComponent<TransformedPolygonColliderComponent>(entity, snapshot->mPolygonDataNavMesh[i]);
+		colliders.mPolygons.emplace_back(entity);
 	}
 
-	BVH& bvh = mBVHWorld->GetPhysics().GetBVHs()[static_cast<int>(CollisionPresets::sTerrain.mRules.mLayer)];
-	bvh.Build();
+	BVH& bvh = snapshot->mBVHWorld->GetPhysics().GetBVHs()[static_cast<int>(CollisionPresets::sTerrain.mRules.mLayer)];
+	bvh.Build(colliders);
+
+	mSnapshot = std::move(snapshot);
 }
 
 CE::NavMeshComponent::NavMeshData CE::NavMeshComponent::GenerateNavMeshData(const World& world) const
@@ -182,7 +188,7 @@ std::vector<CE::TransformedPolygon> CE::NavMeshComponent::GetDifferences(const N
 	return differences;
 }
 
-void CE::NavMeshComponent::Triangulation(const std::vector<TransformedPolygon>& polygonList)
+void CE::NavMeshComponent::Triangulation(const std::vector<TransformedPolygon>& polygonList, Snapshot& snapshot)
 {
 	// Initialize a constrained Delaunay triangulation (CDT) object
 	CDT::Triangulation<float> cdt;
@@ -228,7 +234,7 @@ void CE::NavMeshComponent::Triangulation(const std::vector<TransformedPolygon>&
 	// Extract triangles from the CDT and add them to PolygonDataNavMesh
 	for (const auto& [vertices, neighbors] : cdt.triangles)
 	{
-		const TransformedPolygon& polygon = mPolygonDataNavMesh.emplace_back(
+		const TransformedPolygon& polygon = snapshot.mPolygonDataNavMesh.emplace_back(
 			PolygonPoints{
 				{cdt.vertices[vertices[0]].x, cdt.vertices[vertices[0]].y},
 				{cdt.vertices[vertices[1]].x, cdt.vertices[vertices[1]].y},
@@ -236,21 +242,22 @@ void CE::NavMeshComponent::Triangulation(const std::vector<TransformedPolygon>&
 			});
 
 		// Calculate the center of the triangle and add it as a node to AStarGraph
-		const glm::vec2 centerOfTriangle = polygon.GetCentre();
-		mAStarGraph.AddNode(centerOfTriangle.x, centerOfTriangle.y);
+		snapshot.mAStarGraph.AddNode(polygon.GetCentre());
 	}
 
 	// Create edges between nodes based on triangle neighbors
-	for (int k = 0; k < static_cast<int>(cdt.triangles.size()); k++)
+	for (uint32 k = 0; k < static_cast<uint32>(cdt.triangles.size()); k++)
 	{
 		for (int j = 0; j < 3; j++)
 		{
 			if (cdt.triangles[k].neighbors[j] < cdt.triangles.size())
 			{
-				mAStarGraph.mNodes[k].AddEdge(&mAStarGraph.mNodes[cdt.triangles[k].neighbors[j]]);
+				snapshot.mAStarGraph.AddEdge(k, static_cast<Pathfinding::NodeId>(cdt.triangles[k].neighbors[j]));
 			}
 		}
 	}
+
+	snapshot.mAStarGraph.Build();
 }
 
 std::vector<glm::vec2> CE::NavMeshComponent::FunnelAlgorithm(const std::vector<PolygonPoints>& triangles,
@@ -434,31 +441,22 @@ void CE::NavMeshComponent::UpdateNavMesh()
 	mNavMeshNeedsUpdate = true;
 }
 
-std::vector<glm::vec2> CE::NavMeshComponent::CleanupPathfinding(const std::vector<const Pathfinding::Node*>& nodes,
-                                                            glm::vec2 start, glm::vec2 goal) const
+void CE::NavMeshComponent::Snapshot::CleanupPathfinding(const Span<const Pathfinding::NodeId> nodes, std::vector<glm::vec2>& outPath) const
 {
-	std::vector<glm::vec2> path{};
-
-	path.reserve(nodes.size() + 2);
-
-	// Initialize the path with the start position
-	path.emplace_back(start);
-
 	// Check if there are enough nodes to form a path
 	if (nodes.size() < 3)
 	{
-		path.emplace_back(goal);
-		return path;
+		return;
 	}
 
-	for (uint32 i = 1; i < nodes.size() - 1; i++)
+	for (size_t i = 1; i < nodes.size() - 1; i++)
 	{
 		std::array<glm::vec2, 2> line{};
 		uint32 numPointsFound{};
 
-		for (const glm::vec2& currentTriangleVertex : mPolygonDataNavMesh[nodes[i]->GetId()].mPoints)
+		for (const glm::vec2& currentTriangleVertex : mPolygonDataNavMesh[nodes[i]].mPoints)
 		{
-			for (const glm::vec2& nextTriangleVertex : mPolygonDataNavMesh[nodes[i + 1]->GetId()].mPoints)
+			for (const glm::vec2& nextTriangleVertex : mPolygonDataNavMesh[nodes[i + 1]].mPoints)
 			{
 				if (currentTriangleVertex != nextTriangleVertex)
 				{
@@ -473,15 +471,12 @@ std::vector<glm::vec2> CE::NavMeshComponent::CleanupPathfinding(const std::vecto
 				}
 
 				const glm::vec2 middlePoint = (line[0] + line[1]) * .5f;
-				path.emplace_back(middlePoint);
+				outPath.emplace_back(middlePoint);
 				goto next;
 			}
 		}
 	next:;
 	}
-
-	path.emplace_back(goal);
-	return path;
 }
 
 CE::MetaType CE::NavMeshComponent::Reflect()
@@ -497,14 +492,25 @@ CE::MetaType CE::NavMeshComponent::Reflect()
 
 std::vector<glm::vec2> CE::NavMeshComponent::FindQuickestPath(glm::vec2 startPos, glm::vec2 endPos) const
 {
-	std::vector<glm::vec2> pathFound{};
-
-	if (!mBVHWorld.has_value())
+	if (mSnapshot == nullptr)
 	{
 		LOG(LogWorld, Error, "Could not find path, navmesh was not build yet");
-		return pathFound;
+		return {};
 	}
 
+	return mSnapshot->FindQuickestPath(startPos, endPos);
+}
+
+const std::vector<CE::TransformedPolygon>& CE::NavMeshComponent::GetPolygonDataNavMesh() const
+{
+	static const std::vector<TransformedPolygon> empty{};
+	return mSnapshot == nullptr ? empty : mSnapshot->GetPolygonDataNavMesh();
+}
+
+std::vector<glm::vec2> CE::NavMeshComponent::Snapshot::FindQuickestPath(glm::vec2 startPos, glm::vec2 endPos) const
+{
+	std::vector<glm::vec2> pathFound{};
+
 	// Initialize pointers to the start and end nodes
 	entt::entity startNodeOwner = entt::null;
 	entt::entity endNodeOwner = entt::null;
@@ -533,12 +539,26 @@ std::vector<glm::vec2> CE::NavMeshComponent::FindQuickestPath(glm::vec2 startPos
 		return pathFound;
 	}
 
-	const Pathfinding::Node& start = mAStarGraph.mNodes[static_cast<int>(startNodeOwner)];
-	const Pathfinding::Node& end = mAStarGraph.mNodes[static_cast<int>(endNodeOwner)];
+	const Pathfinding::NodeId startNode = static_cast<Pathfinding::NodeId>(startNodeOwner);
+	const Pathfinding::NodeId endNode = static_cast<Pathfinding::NodeId>(endNodeOwner);
 
-	// Initialize a vector to store the node path found by the A* algorithm
-	const std::vector<const Pathfinding::Node*> nodePathFound = mAStarGraph.AStarSearch(&start, &end);
-	pathFound = CleanupPathfinding(nodePathFound, startPos, endPos);
+	// Reused between calls, so that cache hits do not allocate
+	static thread_local std::vector<glm::vec2> middlePoints{};
+
+	if (!mPathCache.TryGet(startNode, endNode, middlePoints))
+	{
+		static thread_local std::vector<Pathfinding::NodeId> nodePathFound{};
+		mAStarGraph.AStarSearch(startNode, endNode, Pathfinding::SearchContext::GetForThisThread(), nodePathFound);
+
+		middlePoints.clear();
+		CleanupPathfinding(nodePathFound, middlePoints);
+		mPathCache.Add(startNode, endNode, middlePoints);
+	}
+
+	pathFound.reserve(middlePoints.size() + 2);
+	pathFound.emplace_back(startPos);
+	pathFound.insert(pathFound.end(), middlePoints.begin(), middlePoints.end());
+	pathFound.emplace_back(endPos);
 
 	return pathFound;
 }
@@ -607,5 +627,8 @@ void CE::NavMeshComponent::DebugDrawNavMesh(const World& world) const
 		}
 	}
 
-	mAStarGraph.DebugDrawAStarGraph(world);
+	if (mSnapshot != nullptr)
+	{
+		mSnapshot->GetAStarGraph().DebugDrawAStarGraph(world);
+	}
 }
@@ -8,6 +8,7 @@
 #include "Meta/MetaProps.h"
 #include "Utilities/Reflect/ReflectComponentType.h"
 #include "Meta/ReflectedTypes/STD/ReflectVector.h"
+#include "Utilities/JobSystem.h"
 
 namespace
 {
@@ -22,6 +23,7 @@ CE::TransformComponent::TransformComponent(TransformComponent&& other) noexcept
 	SetLocalScale(other.mLocalScale);
 	SetParent(other.mParent);
 	other.SetParent(nullptr);
+	MarkWorldDirty();
 }
 
 CE::TransformComponent::TransformComponent(const TransformComponent& other) noexcept :
@@ -31,6 +33,7 @@ CE::TransformComponent::TransformComponent(const TransformComponent& other) noex
 	mLocalScale(other.mLocalScale)
 {
 	SetParent(other.mParent);
+	MarkWorldDirty();
 }
 
 CE::TransformComponent::~TransformComponent()
@@ -45,9 +48,24 @@ CE::TransformComponent::~TransformComponent()
 	SetParent(nullptr);
 }
 
-void CE::TransformComponent::OnConstruct(World&, entt::entity owner)
+void CE::TransformComponent::OnConstruct(World& world, entt::entity owner)
 {
 	mOwner = owner;
+	mRegistry = &world.GetRegistry();
+
+	// We may have been marked as dirty before we knew which registry we belong to
+	if (mWorldState.load(std::memory_order_relaxed) != WorldState::UpToDate
+		|| mHasDirtyDescendants.load(std::memory_order_relaxed))
+	{
+		TransformComponent* root = this;
+
+		while (root->mParent != nullptr)
+		{
+			root = root->mParent;
+		}
+
+		root->AddToDirtyRoots();
+	}
 }
 
 glm::mat4 CE::TransformComponent::ToMatrix(const glm::vec3 position, const glm::vec3 scale, const glm::quat orientation)
@@ -83,7 +101,6 @@ void CE::TransformComponent::SetLocalMatrix(const glm::mat4& matrix)
 {
 	const auto [pos, scale, orientation] = FromMatrix(matrix);
 
-	// TODO can be optimized to only call world matrix once
 	SetLocalPosition(pos);
 	SetLocalOrientation(orientation);
 	SetLocalScale(scale);
@@ -91,6 +108,7 @@ void CE::TransformComponent::SetLocalMatrix(const glm::mat4& matrix)
 
 const glm::mat4& CE::TransformComponent::GetWorldMatrix() const
 {
+	ResolveWorld();
 	return mCachedWorldMatrix;
 }
 
@@ -98,7 +116,6 @@ void CE::TransformComponent::SetWorldMatrix(const glm::mat4& matrix)
 {
 	const auto [pos, scale, orientation] = FromMatrix(matrix);
 
-	// TODO can be optimized to only call world matrix once
 	SetWorldPosition(pos);
 	SetWorldOrientation(orientation);
 	SetWorldScale(scale);
@@ -111,7 +128,13 @@ std::tuple<glm::vec3, glm::vec3, glm::quat> CE::TransformComponent::GetLocalPosi
 
 std::tuple<glm::vec3, glm::vec3, glm::quat> CE::TransformComponent::GetWorldPositionScaleOrientation() const
 {
-	return mParent == nullptr ? GetLocalPositionScaleOrientation() : FromMatrix(mCachedWorldMatrix);
+	if (mParent == nullptr)
+	{
+		return GetLocalPositionScaleOrientation();
+	}
+
+	ResolveWorld();
+	return { glm::vec3{ mCachedWorldMatrix[3] }, mCachedWorldScale, mCachedWorldOrientation };
 }
 
 void CE::TransformComponent::SetLocalPositionScaleOrientation(glm::vec3 position, glm::vec3 scale, glm::quat orientation)
@@ -164,15 +187,12 @@ void CE::TransformComponent::SetParent(TransformComponent* const parent, const b
 
 	if (preserveWorld)
 	{
-		// TODO only calculate world matrix once
 		SetWorldPosition(worldPositionToRestore);
 		SetWorldOrientation(worldOrientationToRestore);
 		SetWorldScale(worldScaleToRestore);
 	}
-	else
-	{
-		UpdateCachedWorldMatrix();
-	}
+
+	MarkWorldDirty();
 }
 
 const CE::TransformComponent* CE::TransformComponent::GetParent() const
@@ -218,7 +238,7 @@ void CE::TransformComponent::SetLocalPosition(const glm::vec3 position)
 	}
 
 	mLocalPosition = position;
-	UpdateCachedWorldMatrix();
+	MarkWorldDirty();
 }
 
 void CE::TransformComponent::SetLocalPosition(const glm::vec2 position)
@@ -279,7 +299,7 @@ void CE::TransformComponent::SetLocalOrientation(const glm::quat rotation)
 	}
 
 	mLocalOrientation = rotation;
-	UpdateCachedWorldMatrix();
+	MarkWorldDirty();
 }
 
 void CE::TransformComponent::SetWorldOrientation(const glm::vec3 rotationEuler)
@@ -408,7 +428,7 @@ void CE::TransformComponent::SetLocalScale(const glm::vec3 scale)
 	}
 
 	mLocalScale = scale;
-	UpdateCachedWorldMatrix();
+	MarkWorldDirty();
 }
 
 void CE::TransformComponent::SetLocalScale(const glm::vec2 scale)
@@ -459,7 +479,13 @@ void CE::TransformComponent::SetWorldPosition(const glm::vec3 position)
 
 glm::quat CE::TransformComponent::GetWorldOrientation() const
 {
-	return std::get<2>(GetWorldPositionScaleOrientation());
+	if (mParent == nullptr)
+	{
+		return mLocalOrientation;
+	}
+
+	ResolveWorld();
+	return mCachedWorldOrientation;
 }
 
 void CE::TransformComponent::SetWorldOrientation(const glm::quat orientation)
@@ -477,7 +503,13 @@ void CE::TransformComponent::SetWorldOrientation(const glm::quat orientation)
 
 glm::vec3 CE::TransformComponent::GetWorldScale() const
 {
-	return std::get<1>(GetWorldPositionScaleOrientation());
+	if (mParent == nullptr)
+	{
+		return mLocalScale;
+	}
+
+	ResolveWorld();
+	return mCachedWorldScale;
 }
 
 void CE::TransformComponent::SetWorldScale(const glm::vec3 scale)
@@ -511,21 +543,166 @@ void CE::TransformComponent::DetachChild(TransformComponent& child)
 	mChildren.erase(it);
 }
 
-void CE::TransformComponent::UpdateCachedWorldMatrix()
+void CE::TransformComponent::MarkWorldDirty()
 {
+	if (mWorldState.load(std::memory_order_relaxed) != WorldState::Dirty)
+	{
+		mWorldState.store(WorldState::Dirty, std::memory_order_relaxed);
+		MarkChildrenWorldDirty();
+	}
+
+	TransformComponent* root = this;
+
+	for (TransformComponent* ancestor = mParent; ancestor != nullptr; ancestor = ancestor->mParent)
+	{
+		// The ancestor was marked before, which also added our root
+		if (ancestor->mHasDirtyDescendants.exchange(true, std::memory_order_relaxed))
+		{
+			return;
+		}
+
+		root = ancestor;
+	}
+
+	root->AddToDirtyRoots();
+}
+
+void CE::TransformComponent::AddToDirtyRoots()
+{
+	// Transforms that are not part of a registry yet are added in OnConstruct
+	if (mRegistry == nullptr
+		|| mIsInDirtyRoots.exchange(true, std::memory_order_relaxed))
+	{
+		return;
+	}
+
+	std::lock_guard lock{ mRegistry->mDirtyTransformRootsMutex };
+	mRegistry->mDirtyTransformRoots.emplace_back(mOwner);
+}
+
+void CE::TransformComponent::MarkChildrenWorldDirty()
+{
+	for (TransformComponent& child : mChildren)
+	{
+		// If the child is already dirty, so are all of its children
+		if (child.mWorldState.load(std::memory_order_relaxed) != WorldState::Dirty)
+		{
+			child.mWorldState.store(WorldState::Dirty, std::memory_order_relaxed);
+			child.MarkChildrenWorldDirty();
+		}
+	}
+
+	if (!mChildren.empty())
+	{
+		mHasDirtyDescendants.store(true, std::memory_order_relaxed);
+	}
+}
+
+void CE::TransformComponent::ResolveWorld() const
+{
+	if (mWorldState.load(std::memory_order_acquire) == WorldState::UpToDate)
+	{
+		return;
+	}
+
+	if (mParent != nullptr)
+	{
+		mParent->ResolveWorld();
+	}
+
+	// Multiple threads may be reading the same transform. Only one of them
+	// calculates the world transform, the others wait for it to finish.
+	WorldState expected = WorldState::Dirty;
+
+	if (!mWorldState.compare_exchange_strong(expected, WorldState::Resolving, std::memory_order_acquire))
+	{
+		while (mWorldState.load(std::memory_order_acquire) != WorldState::UpToDate)
+		{
+			std::this_thread::yield();
+		}
+		return;
+	}
+
 	if (mParent == nullptr)
 	{
 		mCachedWorldMatrix = GetLocalMatrix();
+		mCachedWorldOrientation = mLocalOrientation;
+		mCachedWorldScale = mLocalScale;
 	}
 	else
 	{
-		mCachedWorldMatrix = mParent->GetWorldMatrix() * GetLocalMatrix();
+		mCachedWorldMatrix = mParent->mCachedWorldMatrix * GetLocalMatrix();
+		mCachedWorldOrientation = mParent->mCachedWorldOrientation * mLocalOrientation;
+		mCachedWorldScale = mParent->mCachedWorldScale * mLocalScale;
+	}
+
+	mWorldState.store(WorldState::UpToDate, std::memory_order_release);
+}
+
+void CE::TransformComponent::ResolveSubtree()
+{
+	const bool wasDirty = mWorldState.load(std::memory_order_relaxed) != WorldState::UpToDate;
+	ResolveWorld();
+
+	// If we were dirty, so were all of our children
+	if (!wasDirty
+		&& !mHasDirtyDescendants.load(std::memory_order_relaxed))
+	{
+		return;
 	}
 
+	mHasDirtyDescendants.store(false, std::memory_order_relaxed);
+
 	for (TransformComponent& child : mChildren)
 	{
-		child.UpdateCachedWorldMatrix();
+		child.ResolveSubtree();
+	}
+}
+
+void CE::TransformComponent::UpdateWorldTransforms(Registry& registry)
+{
+	// Called from the main thread, after any thread-safe OnTickBatch chunks
+	// have finished, so no other thread is appending to the list anymore.
+	std::vector<entt::entity>& dirtyRoots = registry.mDirtyTransformRoots;
+
+	if (dirtyRoots.empty())
+	{
+		return;
 	}
+
+	// Each hierarchy can be updated independently from the others.
+	// Reused between calls, to avoid allocating every frame.
+	static thread_local std::vector<TransformComponent*> rootsBuffer{};
+	std::vector<TransformComponent*>& roots = rootsBuffer;
+	roots.clear();
+
+	for (const entt::entity owner : dirtyRoots)
+	{
+		TransformComponent* const transform = registry.TryGet<TransformComponent>(owner);
+
+		// The transform may have been removed since, or no longer be a root. In which
+		// case its new root was added when it was parented.
+		if (transform == nullptr)
+		{
+			continue;
+		}
+
+		transform->mIsInDirtyRoots.store(false, std::memory_order_relaxed);
+
+		if (transform->mParent == nullptr
+			&& (transform->mHasDirtyDescendants.load(std::memory_order_relaxed) || transform->mWorldState.load(std::memory_order_relaxed) != WorldState::UpToDate))
+		{
+			roots.emplace_back(transform);
+		}
+	}
+
+	dirtyRoots.clear();
+
+	JobSystem::Get().ParallelFor(0, static_cast<uint32>(roots.size()),
+		[&roots](uint32 i)
+		{
+			roots[i]->ResolveSubtree();
+		}, sMinNumOfRootsPerBatch);
 }
 
 CE::MetaType CE::TransformComponent::Reflect()
@@ -7,9 +7,97 @@
 #include "Meta/MetaTools.h"
 #include "Meta/MetaType.h"
 #include "Core/Editor.h"
+#include "GSON/GSONBinary.h"
 #include "Utilities/ClassVersion.h"
 #include "Utilities/NameLookUp.h"
 #include "Utilities/StringFunctions.h"
+#include "Utilities/JobSystem.h"
+#include "Utilities/Profiler.h"
+#include "Utilities/Reflect/ReflectAssetType.h"
+
+namespace
+{
+	// The metadata of an .asset file, as it was when the index cache was last written
+	struct IndexCacheEntry
+	{
+		uint64 mFileSize{};
+		int64 mLastWriteTime{};
+		std::string mMetaData{};
+	};
+
+	constexpr uint32 sIndexCacheVersion = 1;
+
+	std::filesystem::path GetIndexCachePath()
+	{
+		return CE::FileIO::Get().GetPath(CE::FileIO::Directory::Intermediate, "AssetIndexCache.bin");
+	}
+
+	std::unordered_map<std::string, IndexCacheEntry> LoadIndexCache()
+	{
+		std::unordered_map<std::string, IndexCacheEntry> cache{};
+		std::ifstream file{ GetIndexCachePath(), std::ifstream::binary };
+
+		if (!file.is_open())
+		{
+			return cache;
+		}
+
+		try
+		{
+			cereal::BinaryInputArchive ar{ file };
+
+			uint32 version{};
+			ar(version);
+
+			if (version != sIndexCacheVersion)
+			{
+				LOG(LogAssets, Message, "Asset index cache is of version {}, expected {}. All assets will be indexed from their files.", version, sIndexCacheVersion);
+				return cache;
+			}
+
+			uint32 numOfEntries{};
+			ar(numOfEntries);
+			cache.reserve(numOfEntries);
+
+			for (uint32 i = 0; i < numOfEntries; i++)
+			{
+				std::string path{};
+				IndexCacheEntry entry{};
+				ar(path, entry.mFileSize, entry.mLastWriteTime, entry.mMetaData);
+				cache.emplace(std::move(path), std::move(entry));
+			}
+		}
+		catch ([[maybe_unused]] const std::exception& e)
+		{
+			LOG(LogAssets, Warning, "Asset index cache could not be read, all assets will be indexed from their files - {}", e.what());
+			cache.clear();
+		}
+
+		return cache;
+	}
+
+	void SaveIndexCache(const std::unordered_map<std::string, IndexCacheEntry>& cache)
+	{
+		const std::filesystem::path path = GetIndexCachePath();
+		TRY_CATCH_LOG(std::filesystem::create_directories(path.parent_path()));
+
+		std::ofstream file{ path, std::ofstream::binary };
+
+		if (!file.is_open())
+		{
+			LOG(LogAssets, Warning, "Could not save asset index cache, {} could not be opened", path.string());
+			return;
+		}
+
+		cereal::BinaryOutputArchive ar{ file };
+		ar(sIndexCacheVersion, static_cast<uint32>(cache.size()));
+
+		for (const auto& [assetPath, entry] : cache)
+		{
+			ar(assetPath, entry.mFileSize, entry.mLastWriteTime, entry.mMetaData);
+		}
+	}
+}
 
 void CE::AssetManager::PostConstruct()
 {
@@ -19,8 +107,15 @@ void CE::AssetManager::PostConstruct()
 		std::string mNewName{};
 		std::filesystem::path mRenameFile{};
 	};
-	std::list<RenameLink> renameLinks{};
-	std::vector<std::filesystem::path> assetFiles{};
+	std::vector<RenameLink> renameLinks{};
+
+	struct AssetFile
+	{
+		std::filesystem::path mPath{};
+		uint64 mFileSize{};
+		int64 mLastWriteTime{};
+	};
+	std::vector<AssetFile> assetFiles{};
 
 	assetFiles.reserve(2048);
 
@@ -46,7 +141,13 @@ void CE::AssetManager::PostConstruct()
 
 				if (extension == sAssetExtension)
 				{
-					assetFiles.emplace_back(path);
+					// The size and write time are usually cached by the directory iterator, so this does not touch the file
+					std::error_code err{};
+					const uint64 fileSize = dirEntry.file_size(err);
+					const int64 lastWriteTime = dirEntry.last_write_time(err).time_since_epoch().count();
+
+					// Without them, the cached metadata can not be trusted
+					assetFiles.emplace_back(AssetFile{ path, err ? 0 : fileSize, err ? 0 : lastWriteTime });
 					++numOfAssetsFound;
 				}
 				else if (extension == sRenameExtension)
@@ -80,9 +181,89 @@ void CE::AssetManager::PostConstruct()
 
 	mLookUp.reserve(assetFiles.size() + renameLinks.size());
 
-	for (const std::filesystem::path& assetPath : assetFiles)
+	// Reading the metadata means opening every single asset file, which is what made indexing slow.
+	// The metadata of files that have not changed since the last launch is taken from the cache instead,
+	// and the remaining files are read on the worker threads.
+	std::unordered_map<std::string, IndexCacheEntry> indexCache = LoadIndexCache();
+
+	std::vector<std::optional<AssetFileMetaData>> metaDatas(assetFiles.size());
+	std::vector<std::optional<IndexCacheEntry>> newCacheEntries(assetFiles.size());
+
+	JobSystem::Get().ParallelFor(0, static_cast<uint32>(assetFiles.size()),
+		[&](const uint32 i)
+		{
+			const AssetFile& assetFile = assetFiles[i];
+			const auto cached = indexCache.find(assetFile.mPath.string());
+
+			if (cached != indexCache.end()
+				&& assetFile.mLastWriteTime != 0
+				&& cached->second.mFileSize == assetFile.mFileSize
+				&& cached->second.mLastWriteTime == assetFile.mLastWriteTime)
+			{
+				view_istream stream{ cached->second.mMetaData };
+				metaDatas[i] = AssetFileMetaData::ReadMetaData(stream);
+
+				if (metaDatas[i].has_value())
+				{
+					return;
+				}
+			}
+
+			std::ifstream file{ assetFile.mPath, std::ifstream::binary };
+			metaDatas[i] = AssetFileMetaData::ReadMetaData(file);
+
+			// Metadata of an older version is not cached, so that it is still found by UpdateAssetsToLatestVersions
+			if (metaDatas[i].has_value()
+				&& metaDatas[i]->GetMetaDataVersion() == AssetFileMetaData::GetCurrentMetaDataVersion()
+				&& assetFile.mLastWriteTime != 0)
+			{
+				std::ostringstream serialized{};
+				metaDatas[i]->WriteMetaData(serialized);
+				newCacheEntries[i] = IndexCacheEntry{ assetFile.mFileSize, assetFile.mLastWriteTime, std::move(serialized).str() };
+			}
+		}, 16);
+
+	bool isIndexCacheOutOfDate = indexCache.size() != assetFiles.size();
+
+	for (uint32 i = 0; i < static_cast<uint32>(assetFiles.size()); i++)
 	{
-		OpenAsset(assetPath);
+		const std::filesystem::path& path = assetFiles[i].mPath;
+
+		if (newCacheEntries[i].has_value())
+		{
+			indexCache[path.string()] = std::move(*newCacheEntries[i]);
+			isIndexCacheOutOfDate = true;
+		}
+
+		if (!metaDatas[i].has_value())
+		{
+			LOG(LogAssets, Warning, "Failed to construct asset {}: metadata was invalid", path.string());
+			isIndexCacheOutOfDate |= indexCache.erase(path.string()) != 0;
+			continue;
+		}
+
+		// Constructed in the order the files were found, so that the same asset
+		// wins every time if two assets share the same name
+		TryConstruct(path, std::move(*metaDatas[i]));
+	}
+
+	if (isIndexCacheOutOfDate)
+	{
+		// Removes the files that no longer exist
+		std::unordered_map<std::string, IndexCacheEntry> newIndexCache{};
+		newIndexCache.reserve(assetFiles.size());
+
+		for (const AssetFile& assetFile : assetFiles)
+		{
+			const auto entry = indexCache.find(assetFile.mPath.string());
+
+			if (entry != indexCache.end())
+			{
+				newIndexCache.emplace(entry->first, std::move(entry->second));
+			}
+		}
+
+		SaveIndexCache(newIndexCache);
 	}
 
 	sNameLookUpMutex.lock();
@@ -100,43 +281,61 @@ void CE::AssetManager::PostConstruct()
 
 	sNameLookUpMutex.unlock();
 
-	bool anyResolved;
+	// An asset may have been renamed multiple times, from A to B and from B to C.
+	// Each link follows the chain of renames until it arrives at an existing asset.
+	std::unordered_map<std::string_view, const RenameLink*> linksByOldName{};
+	linksByOldName.reserve(renameLinks.size());
+
+	for (const RenameLink& link : renameLinks)
+	{
+		linksByOldName.emplace(link.mOldName, &link);
+	}
 
-	do
+	for (const RenameLink& link : renameLinks)
 	{
-		anyResolved = false;
+		Internal::AssetInternal* assetWithNewName{};
+		const RenameLink* current = &link;
 
-		for (auto it = renameLinks.begin(); it != renameLinks.end();)
+		// Limited, in case the renames form a cycle
+		for (size_t numOfSteps = 0; numOfSteps <= renameLinks.size(); numOfSteps++)
 		{
-			Internal::AssetInternal* const assetWithNewName = TryGetAssetInternal(it->mNewName, MakeTypeId<Asset>());
+			assetWithNewName = TryGetAssetInternal(current->mNewName, MakeTypeId<Asset>());
 
-			if (assetWithNewName == nullptr)
+			if (assetWithNewName != nullptr)
 			{
-				++it;
-				continue;
+				break;
 			}
 
-			const auto insertResult = mLookUp.emplace(Name::HashString(it->mOldName), *assetWithNewName);
+			const auto next = linksByOldName.find(current->mNewName);
 
-			if (insertResult.second)
+			if (next == linksByOldName.end())
 			{
-				assetWithNewName->mOldNames.emplace_back(it->mRenameFile);
-				anyResolved = true;
-			}
-			else
-			{
-				LOG(LogAssets, Error, "Could not create link from old asset {} to new asset {}", it->mOldName, it->mNewName);
+				break;
 			}
 
-			it = renameLinks.erase(it);
+			current = next->second;
 		}
-	} while (anyResolved);
 
-	for (const RenameLink& link : renameLinks)
-	{
-		LOG(LogAssets, Message, "An asset was once renamed from {} to {}, but it has now been deleted. The rename file {} will now also be removed.",
-			link.mOldName, link.mNewName, link.mRenameFile.string());
-		TRY_CATCH_LOG(std::filesystem::remove(link.mRenameFile));
+		if (assetWithNewName == nullptr)
+		{
+			LOG(LogAssets, Message, "An asset was once renamed from {} to {}, but it has now been deleted. The rename file {} will now also be removed.",
+				link.mOldName, link.mNewName, link.mRenameFile.string());
+			TRY_CATCH_LOG(std::filesystem::remove(link.mRenameFile));
+			continue;
+		}
+
+		std::unique_lock lock{ mAssetsMutex };
+		const auto insertResult = mLookUp.emplace(Name::HashString(link.mOldName), *assetWithNewName);
+		lock.unlock();
+
+		if (insertResult.second)
+		{
+			assetWithNewName->mOldNames.emplace_back(link.mRenameFile);
+		}
+		else
+		{
+			LOG(LogAssets, Error, "Could not create link from old asset {} to new asset {}", link.mOldName, link.mNewName);
+		}
 	}
 
 	UpdateAssetsToLatestVersions();
@@ -144,9 +343,22 @@ void CE::AssetManager::PostConstruct()
 
 CE::AssetManager::~AssetManager()
 {
+	{
+		std::lock_guard lock{ mStreamingMutex };
+		mLoadRequests.clear();
+	}
+
+	// The jobs that have not started yet will find no requests left
+	while (mNumOfStreamingJobs > 0)
+	{
+		std::this_thread::yield();
+	}
+
+	mAwaitingMainThread.clear();
+
 	for (Internal::AssetInternal& assetInternal : mAssets)
 	{
-		if (assetInternal.mAsset != nullptr)
+		if (assetInternal.IsLoaded())
 		{
 			assetInternal.UnLoad();
 		}
@@ -155,6 +367,8 @@ CE::AssetManager::~AssetManager()
 
 CE::Internal::AssetInternal* CE::AssetManager::TryGetAssetInternal(const Name key, const TypeId typeId)
 {
+	std::shared_lock lock{ mAssetsMutex };
+
 	const auto it = mLookUp.find(key.GetHash());
 
 	if (it == mLookUp.end()
@@ -165,6 +379,55 @@ CE::Internal::AssetInternal* CE::AssetManager::TryGetAssetInternal(const Name ke
 	return &it->second.get();
 }
 
+CE::IterableRange<CE::AssetManager::EachAssetIt<CE::Asset>> CE::AssetManager::GetAllAssets(const TypeId typeId)
+{
+	const std::vector<Internal::AssetInternal*>* const assets = TryGetAssetsOfType(typeId);
+	return { { assets, 0 }, { assets, assets == nullptr ? 0 : assets->size() } };
+}
+
+const std::vector<CE::Internal::AssetInternal*>* CE::AssetManager::TryGetAssetsOfType(const TypeId typeId) const
+{
+	std::shared_lock lock{ mAssetsMutex };
+
+	const auto it = mAssetsByType.find(typeId);
+	return it == mAssetsByType.end() ? nullptr : &it->second;
+}
+
+void CE::AssetManager::AddToTypeIndex(Internal::AssetInternal& asset)
+{
+	const MetaType& assetClass = asset.mMetaData.GetClass();
+	mAssetsByType[assetClass.GetTypeId()].emplace_back(&asset);
+
+	for (const TypeId baseClassTypeId : assetClass.GetAllBaseClassTypeIds())
+	{
+		mAssetsByType[baseClassTypeId].emplace_back(&asset);
+	}
+}
+
+void CE::AssetManager::RemoveFromTypeIndex(const Internal::AssetInternal& asset)
+{
+	const auto removeFromBucket = [&](const TypeId typeId)
+		{
+			const auto bucket = mAssetsByType.find(typeId);
+
+			if (bucket == mAssetsByType.end())
+			{
+				return;
+			}
+
+			std::vector<Internal::AssetInternal*>& assets = bucket->second;
+			assets.erase(std::remove(assets.begin(), assets.end(), &asset), assets.end());
+		};
+
+	const MetaType& assetClass = asset.mMetaData.GetClass();
+	removeFromBucket(assetClass.GetTypeId());
+
+	for (const TypeId baseClassTypeId : assetClass.GetAllBaseClassTypeIds())
+	{
+		removeFromBucket(baseClassTypeId);
+	}
+}
+
 CE::Internal::AssetInternal* CE::AssetManager::TryGetLoadedAssetInternal(const Name key, const TypeId typeId)
 {
 	auto* internalAsset = TryGetAssetInternal(key, typeId);
@@ -174,41 +437,336 @@ CE::Internal::AssetInternal* CE::AssetManager::TryGetLoadedAssetInternal(const N
 		return nullptr;
 	}
 
-	if (internalAsset->mAsset == nullptr)
+	if (!internalAsset->IsLoaded())
 	{
 		internalAsset->Load();
-		ASSERT(internalAsset->mAsset != nullptr);
+		ASSERT(internalAsset->IsLoaded());
 	}
 	return internalAsset;
 }
 
 void CE::AssetManager::UnloadAllUnusedAssets()
 {
-	bool wereAnyUnloaded;
+	std::vector<Internal::AssetInternal*> recentlyUsed{};
 
-	do
+	// Unloading an asset can release the last reference to another
+	// asset, which is then added to the unused list as well.
+	while (true)
 	{
-		wereAnyUnloaded = false;
-		for (Internal::AssetInternal& asset : mAssets)
+		Internal::AssetInternal* asset{};
+
+		{
+			std::lock_guard lock{ mResidencyMutex };
+			asset = PopLeastRecentlyUsed();
+		}
+
+		if (asset == nullptr)
+		{
+			break;
+		}
+
+		if (asset->mRefCounters[static_cast<int>(Internal::AssetInternal::RefCountType::Strong)] > 0 // Someone started referencing it again
+			|| !asset->IsLoaded())
 		{
-			if (asset.mAsset == nullptr // Asset is already unloaded
-				|| asset.mRefCounters[static_cast<int>(Internal::AssetInternal::RefCountType::Strong)] > 0 // Someone is holding a reference
-				|| !asset.mFileOfOrigin.has_value() // This asset was generated at runtime; if we unload it, we won't be able to load if back in again. 
-				|| asset.mHasBeenDereferencedSinceGarbageCollect) // While this asset is unloaded, it was recently loaded. Maybe something 
-				// is only briefly loading it every ~30 seconds, so lets not unload this.
+			continue;
+		}
+
+		// While this asset is unloaded, it was recently loaded. Maybe something 
+		// is only briefly loading it every ~30 seconds, so lets not unload this.
+		if (asset->mHasBeenDereferencedSinceGarbageCollect.load(std::memory_order_relaxed))
+		{
+			recentlyUsed.emplace_back(asset);
+			continue;
+		}
+
+		// Someone may start referencing it between the check above and now
+		asset->UnLoadIfUnused();
+	}
+
+	for (Internal::AssetInternal* asset : recentlyUsed)
+	{
+		asset->UpdateResidency();
+	}
+
+	std::shared_lock lock{ mAssetsMutex };
+
+	for (Internal::AssetInternal& asset : mAssets)
+	{
+		asset.mHasBeenDereferencedSinceGarbageCollect.store(false, std::memory_order_relaxed);
+	}
+}
+
+void CE::AssetManager::SetMemoryBudget(const std::optional<size_t> numOfBytes)
+{
+	std::lock_guard lock{ mResidencyMutex };
+	mMemoryBudget = numOfBytes;
+}
+
+std::optional<size_t> CE::AssetManager::GetMemoryBudget() const
+{
+	std::lock_guard lock{ mResidencyMutex };
+	return mMemoryBudget;
+}
+
+size_t CE::AssetManager::GetMemoryUsage() const
+{
+	std::lock_guard lock{ mResidencyMutex };
+	return mMemoryUsage;
+}
+
+void CE::AssetManager::EvictUnusedAssets(const uint32 maxNumOfAssetsToUnload)
+{
+	uint32 numOfUnloaded = 0;
+
+	while (numOfUnloaded < maxNumOfAssetsToUnload)
+	{
+		Internal::AssetInternal* asset{};
+
+		{
+			std::lock_guard lock{ mResidencyMutex };
+
+			if (!mMemoryBudget.has_value()
+				|| mMemoryUsage <= *mMemoryBudget)
 			{
-				continue;
+				return;
 			}
 
-			asset.UnLoad();
-			wereAnyUnloaded = true;
+			asset = PopLeastRecentlyUsed();
 		}
-	} while (wereAnyUnloaded); // We might've unloaded an asset that held onto the last reference of another asset
 
-	for (Internal::AssetInternal& asset : mAssets)
+		if (asset == nullptr)
+		{
+			return;
+		}
+
+		// It is added back to the list once it is no longer referenced
+		if (!asset->UnLoadIfUnused())
+		{
+			continue;
+		}
+
+		LOG(LogAssets, Verbose, "Evicted {}, the assets are over their memory budget", asset->mMetaData.GetName());
+		numOfUnloaded++;
+	}
+}
+
+void CE::AssetManager::RequestLoad(const AssetHandleBase& asset, const float priority)
+{
+	Internal::AssetInternal* const assetInternal = asset.mAssetInternal;
+
+	if (assetInternal == nullptr
+		|| assetInternal->IsLoaded())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard lock{ mStreamingMutex };
+
+		Internal::AssetInternal::LoadState state = Internal::AssetInternal::LoadState::Unloaded;
+
+		if (!assetInternal->mLoadState.compare_exchange_strong(state, Internal::AssetInternal::LoadState::Queued))
+		{
+			// Requests that are still queued can be moved forward, by queueing it again with
+			// a higher priority. Whichever request is handled first will load the asset.
+			if (state != Internal::AssetInternal::LoadState::Queued
+				|| priority <= assetInternal->mRequestedPriority)
+			{
+				return;
+			}
+		}
+
+		assetInternal->mRequestedPriority = priority;
+
+		mLoadRequests.push_back({ priority, mNumOfRequestsMade++, AssetHandle<>{ assetInternal } });
+		std::push_heap(mLoadRequests.begin(), mLoadRequests.end(), &HasLowerPriority);
+	}
+
+	// Each job handles whichever request has the highest priority at the time it starts
+	++mNumOfStreamingJobs;
+	JobSystem::Get().Schedule(
+		[this]
+		{
+			StreamNextRequest();
+		});
+}
+
+bool CE::AssetManager::IsReady(const AssetHandleBase& asset) const
+{
+	return asset.IsLoaded();
+}
+
+void CE::AssetManager::FinishStreamedLoads()
+{
+	std::vector<AssetHandle<>> awaitingMainThread{};
+
+	{
+		std::lock_guard lock{ mStreamingMutex };
+
+		if (mAwaitingMainThread.empty())
+		{
+			return;
+		}
+
+		awaitingMainThread.swap(mAwaitingMainThread);
+	}
+
+	PROFILE_FUNCTION();
+
+	for (const AssetHandle<>& asset : awaitingMainThread)
+	{
+		// Someone may have already loaded it through a blocking load
+		if (asset.mAssetInternal->mLoadState == Internal::AssetInternal::LoadState::AwaitingMainThread)
+		{
+			asset.mAssetInternal->Stream();
+		}
+	}
+}
+
+uint32 CE::AssetManager::GetNumOfBlockingLoads() const
+{
+	return Internal::AssetInternal::sNumOfBlockingLoads;
+}
+
+bool CE::AssetManager::HasLowerPriority(const LoadRequest& lhs, const LoadRequest& rhs)
+{
+	if (lhs.mPriority != rhs.mPriority)
+	{
+		return lhs.mPriority < rhs.mPriority;
+	}
+	return lhs.mRequestIndex > rhs.mRequestIndex;
+}
+
+void CE::AssetManager::StreamNextRequest()
+{
+	AssetHandle<> asset{};
+
+	{
+		std::lock_guard lock{ mStreamingMutex };
+
+		if (!mLoadRequests.empty())
+		{
+			std::pop_heap(mLoadRequests.begin(), mLoadRequests.end(), &HasLowerPriority);
+			asset = std::move(mLoadRequests.back().mAsset);
+			mLoadRequests.pop_back();
+		}
+	}
+
+	Internal::AssetInternal::LoadState state = Internal::AssetInternal::LoadState::Queued;
+
+	// Fails if this was an outdated request, or if someone already loaded the asset through a blocking load
+	if (asset != nullptr
+		&& asset.mAssetInternal->mLoadState.compare_exchange_strong(state, Internal::AssetInternal::LoadState::Loading))
+	{
+		if (asset.GetMetaData().GetClass().GetProperties().Has(Props::sMustBeConstructedOnMainThreadTag))
+		{
+			asset.mAssetInternal->PrepareLoad();
+
+			std::lock_guard lock{ mStreamingMutex };
+			mAwaitingMainThread.emplace_back(std::move(asset));
+		}
+		else
+		{
+			asset.mAssetInternal->Stream();
+		}
+	}
+
+	// Released before we report that we are done, as the AssetManager may be destroyed right after
+	asset = nullptr;
+	--mNumOfStreamingJobs;
+}
+
+void CE::AssetManager::UpdateResidency(Internal::AssetInternal& asset, const bool canMeasure)
+{
+	std::lock_guard lock{ mResidencyMutex };
+
+	const bool isLoaded = asset.IsLoaded();
+	const bool isUnused = isLoaded && asset.mRefCounters[static_cast<int>(Internal::AssetInternal::RefCountType::Strong)] == 0;
+
+	// Measured again once it is no longer used, as some assets,
+	// such as textures, finish loading after they were constructed.
+	if (isLoaded
+		&& canMeasure
+		&& (!asset.mIsResident || (isUnused && !asset.mIsInUnusedList)))
+	{
+		mMemoryUsage -= asset.mMemoryUsage;
+		asset.mMemoryUsage = asset.mAsset->GetMemoryUsage();
+		mMemoryUsage += asset.mMemoryUsage;
+		asset.mIsResident = true;
+	}
+	else if (!isLoaded
+		&& asset.mIsResident)
+	{
+		mMemoryUsage -= asset.mMemoryUsage;
+		asset.mMemoryUsage = 0;
+		asset.mIsResident = false;
+	}
+
+	if (isUnused
+		&& !asset.mIsInUnusedList)
+	{
+		AddToUnusedList(asset);
+	}
+	else if (!isUnused
+		&& asset.mIsInUnusedList)
+	{
+		RemoveFromUnusedList(asset);
+	}
+}
+
+void CE::AssetManager::AddToUnusedList(Internal::AssetInternal& asset)
+{
+	asset.mPreviousUnused = mMostRecentlyUsed;
+	asset.mNextUnused = nullptr;
+	asset.mIsInUnusedList = true;
+
+	if (mMostRecentlyUsed != nullptr)
+	{
+		mMostRecentlyUsed->mNextUnused = &asset;
+	}
+	else
+	{
+		mLeastRecentlyUsed = &asset;
+	}
+
+	mMostRecentlyUsed = &asset;
+}
+
+void CE::AssetManager::RemoveFromUnusedList(Internal::AssetInternal& asset)
+{
+	if (asset.mPreviousUnused != nullptr)
+	{
+		asset.mPreviousUnused->mNextUnused = asset.mNextUnused;
+	}
+	else
+	{
+		mLeastRecentlyUsed = asset.mNextUnused;
+	}
+
+	if (asset.mNextUnused != nullptr)
+	{
+		asset.mNextUnused->mPreviousUnused = asset.mPreviousUnused;
+	}
+	else
+	{
+		mMostRecentlyUsed = asset.mPreviousUnused;
+	}
+
+	asset.mPreviousUnused = nullptr;
+	asset.mNextUnused = nullptr;
+	asset.mIsInUnusedList = false;
+}
+
+CE::Internal::AssetInternal* CE::AssetManager::PopLeastRecentlyUsed()
+{
+	Internal::AssetInternal* const asset = mLeastRecentlyUsed;
+
+	if (asset != nullptr)
 	{
-		asset.mHasBeenDereferencedSinceGarbageCollect = false;
+		RemoveFromUnusedList(*asset);
 	}
+
+	return asset;
 }
 
 void CE::AssetManager::RenameAsset(WeakAssetHandle<> asset, std::string_view newName)
@@ -297,8 +855,10 @@ void CE::AssetManager::RenameAsset(WeakAssetHandle<> asset, std::string_view new
 				assetInternal->mFileOfOrigin = newPath;
 			}
 
+			std::unique_lock lock{ mAssetsMutex };
 			assetInternal->mMetaData = newMetaData;
 			auto emplaceResult = mLookUp.emplace(Name::HashString(newName), *assetInternal);
+			lock.unlock();
 
 			if (!emplaceResult.second)
 			{
@@ -318,7 +878,7 @@ void CE::AssetManager::DeleteAsset(WeakAssetHandle<>&& asset)
 {
 	auto deleteLambda = [this, assetName = asset.GetMetaData().GetName()]()
 		{
-			const Internal::AssetInternal* const asset = TryGetAssetInternal(assetName, MakeTypeId<Asset>());
+			Internal::AssetInternal* const asset = TryGetAssetInternal(assetName, MakeTypeId<Asset>());
 
 			if (asset == nullptr)
 			{
@@ -346,6 +906,22 @@ void CE::AssetManager::DeleteAsset(WeakAssetHandle<>&& asset)
 				TRY_CATCH_LOG(std::filesystem::remove(renameFile));
 			}
 
+			{
+				std::lock_guard lock{ mResidencyMutex };
+
+				if (asset->mIsInUnusedList)
+				{
+					RemoveFromUnusedList(*asset);
+				}
+
+				if (asset->mIsResident)
+				{
+					mMemoryUsage -= asset->mMemoryUsage;
+				}
+			}
+
+			std::unique_lock lock{ mAssetsMutex };
+
 			for (auto it = mLookUp.begin(); it != mLookUp.end();)
 			{
 				if (it->second.get().mMetaData.GetName() == assetName)
@@ -358,6 +934,8 @@ void CE::AssetManager::DeleteAsset(WeakAssetHandle<>&& asset)
 				}
 			}
 
+			RemoveFromTypeIndex(*asset);
+
 			mAssets.remove_if([assetName](const Internal::AssetInternal& asset)
 				{
 					return asset.mMetaData.GetName() == assetName;
@@ -654,6 +1232,8 @@ CE::Internal::AssetInternal* CE::AssetManager::TryConstruct(const std::optional<
 		LOG(LogAssets, Warning, "Expected {}, but extension was {}.", sAssetExtension, path->extension().string());
 	}
 
+	std::unique_lock lock{ mAssetsMutex };
+
 	Internal::AssetInternal& assetInternal = mAssets.emplace_front(std::move(metaData), path);
 
 	const auto emplaceResult = mLookUp.emplace(Name::HashString(assetInternal.mMetaData.GetName()), assetInternal);
@@ -666,6 +1246,9 @@ CE::Internal::AssetInternal* CE::AssetManager::TryConstruct(const std::optional<
 		return nullptr;
 	}
 
+	AddToTypeIndex(assetInternal);
+	lock.unlock();
+
 #ifdef LOGGING_ENABLED
 	const uint32 currentVersion = GetClassVersion(assetInternal.mMetaData.GetClass());
 	if (assetInternal.mMetaData.mAssetVersion != currentVersion)
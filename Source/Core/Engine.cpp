@@ -15,6 +15,7 @@
 #include "Assets/Level.h"
 #include "World/World.h"
 #include "Utilities/Benchmark.h"
+#include "Utilities/Profiler.h"
 #include "World/Registry.h"
 #include "Rendering/Renderer.h"
 
@@ -26,14 +27,28 @@
 
 CE::Engine::Engine(int argc, char* argv[], std::string_view gameDir)
 {
-	Device::sIsHeadless = argc >= 2
+	const bool shouldRunTests = argc >= 2
 		&& strcmp(argv[1], "run_tests") == 0;
 
+	const bool shouldRunBenchmarks = argc >= 2
+		&& strcmp(argv[1], "run_benchmarks") == 0;
+
+	Device::sIsHeadless = shouldRunTests || shouldRunBenchmarks;
+
 	FileIO::StartUp(argc, argv, gameDir);
 	Logger::StartUp();
 
 	LOG(LogCore, Verbose, "Created logger");
 
+	PROFILE_THREAD_NAME("Main");
+
+#ifdef PROFILING_ENABLED
+	if (std::any_of(argv, argv + argc, [](const char* arg) { return strcmp(arg, "profile_cpu") == 0; }))
+	{
+		Profiler::Get().BeginCapture();
+	}
+#endif // PROFILING_ENABLED
+
 	std::thread deviceAgnosticSystems
 	{
 		[&]
@@ -70,6 +85,25 @@ CE::Engine::Engine(int argc, char* argv[], std::string_view gameDir)
 
 	deviceAgnosticSystems.join();
 
+	// Scripts can be profiled in any build, without recompiling
+	if (std::any_of(argv, argv + argc, [](const char* arg) { return strcmp(arg, "profile_scripts") == 0; }))
+	{
+		VirtualMachine::Get().GetProfiler().SetIsEnabled(true);
+	}
+
+	// For example asset_memory_budget_mb=512, see AssetManager::SetMemoryBudget
+	static constexpr std::string_view memoryBudgetArg = "asset_memory_budget_mb=";
+	for (int i = 0; i < argc; i++)
+	{
+		const std::string_view arg = argv[i];
+
+		if (arg.substr(0, memoryBudgetArg.size()) == memoryBudgetArg)
+		{
+			const size_t numOfMegaBytes = std::strtoull(arg.data() + memoryBudgetArg.size(), nullptr, 10);
+			AssetManager::Get().SetMemoryBudget(numOfMegaBytes * 1024 * 1024);
+		}
+	}
+
 #ifdef EDITOR
 	Editor::StartUp();
 #endif // EDITOR
@@ -77,7 +111,7 @@ CE::Engine::Engine(int argc, char* argv[], std::string_view gameDir)
 	LOG(LogCore, Verbose, "Creating UnitTestManager");
 	UnitTestManager::StartUp();
 
-	if (Device::sIsHeadless)
+	if (shouldRunTests)
 	{
 		uint32 numFailed = 0;
 		for (UnitTest& test : UnitTestManager::Get().GetAllTests())
@@ -109,11 +143,34 @@ CE::Engine::Engine(int argc, char* argv[], std::string_view gameDir)
 		}
 	}
 
+	if (shouldRunBenchmarks)
+	{
+		const uint32 numOfRegressions = RunBenchmarksFromCommandLine(argc, argv);
+
+		// Same as with the tests, + 1 to distinguish from other exits
+		if (numOfRegressions != 0)
+		{
+			exit(numOfRegressions + 1);
+		}
+	}
+
 	LOG(LogCore, Verbose, "Completed engine startup");
 }
 
 CE::Engine::~Engine()
 {
+#ifdef PROFILING_ENABLED
+	Profiler::Get().EndCapture();
+
+	if (Profiler::Get().HasCapture())
+	{
+		std::filesystem::create_directories(FileIO::Get().GetPath(FileIO::Directory::Intermediate, "Profiling"));
+
+		std::ofstream chromeTrace{ FileIO::Get().GetPath(FileIO::Directory::Intermediate, "Profiling/CpuProfile.json") };
+		Profiler::Get().ExportChromeTrace(chromeTrace);
+	}
+#endif // PROFILING_ENABLED
+
 	LOG(LogCore, Verbose, "Shutting down UnitTestManager");
 	UnitTestManager::ShutDown();
 
@@ -182,6 +239,8 @@ void CE::Engine::Run([[maybe_unused]] Name starterLevel)
 
 	while (!device.ShouldClose())
 	{
+		PROFILE_FRAME_MARK();
+
 		t2 = std::chrono::high_resolution_clock::now();
 		float deltaTime = std::chrono::duration_cast<std::chrono::duration<float>>(t2 - t1).count();
 
@@ -196,6 +255,7 @@ void CE::Engine::Run([[maybe_unused]] Name starterLevel)
 
 		device.NewFrame();
 		input.NewFrame();
+		AssetManager::Get().FinishStreamedLoads();
 
 		if (device.GetDisplaySize().x <= 0
 			|| device.GetDisplaySize().y <= 0)
@@ -234,5 +294,8 @@ void CE::Engine::Run([[maybe_unused]] Name starterLevel)
 			AssetManager::Get().UnloadAllUnusedAssets();
 			timeElapsedSinceLastGarbageCollect = 0.0f;
 		}
+
+		// Does nothing unless a memory budget was set, and the assets exceed it
+		AssetManager::Get().EvictUnusedAssets();
 	}
 }
@@ -2,19 +2,19 @@
 #include "Core/VirtualMachine.h"
 
 #include "Core/AssetManager.h"
+#include "Core/FileIO.h"
 #include "Meta/MetaManager.h"
 #include "Meta/MetaType.h"
 #include "Meta/MetaFunc.h"
 #include "Scripting/ScriptTools.h"
-#include "Scripting/Nodes/MetaFuncScriptNode.h"
-#include "Scripting/Nodes/MetaFieldScriptNode.h"
-#include "Scripting/Nodes/EntryAndReturnScriptNode.h"
-#include "Scripting/Nodes/ControlScriptNodes.h"
+#include "Meta/MetaField.h"
+#include "Scripting/ScriptNode.h"
 #include "Assets/Script.h"
 #include "Meta/MetaTools.h"
 #include "Utilities/Reflect/ReflectComponentType.h"
 #include "Scripting/ScriptConfig.h"
 #include "Utilities/Time.h"
+#include "Utilities/Profiler.h"
 
 void CE::VirtualMachine::PostConstruct()
 {
@@ -27,28 +27,18 @@ CE::VirtualMachine::~VirtualMachine()
 	// But it's still polite to clean up our own mess
 	DestroyAllTypesCreatedThroughScripts();
 
-#ifdef SCRIPT_PROFILING
-	std::vector<std::pair<std::string, float>> sortedTimesSpent{};
-	sortedTimesSpent.reserve(mNumOfSecondsSpentEachFunction.size());
-
-	for (const auto& [funcName, secondsSpent] : mNumOfSecondsSpentEachFunction)
+	if (mProfiler.HasMeasurements())
 	{
-		sortedTimesSpent.emplace_back(funcName, secondsSpent);
-	}
+		mProfiler.PrintSummary();
 
-	std::sort(sortedTimesSpent.begin(), sortedTimesSpent.end(),
-		[](const std::pair<std::string, float>& lhs, const std::pair<std::string, float>& rhs)
-		{
-			return lhs.second > rhs.second;
-		});
+		std::filesystem::create_directories(FileIO::Get().GetPath(FileIO::Directory::Intermediate, "Profiling"));
 
-	std::string output{};
-	for (const auto& [funcName, timeSpent] : sortedTimesSpent)
-	{
-		output += Format("\n{:>64} -  {:.4f}", funcName, timeSpent);
+		std::ofstream chromeTrace{ FileIO::Get().GetPath(FileIO::Directory::Intermediate, "Profiling/ScriptProfile.json") };
+		mProfiler.ExportChromeTrace(chromeTrace);
+
+		std::ofstream collapsedStacks{ FileIO::Get().GetPath(FileIO::Directory::Intermediate, "Profiling/ScriptProfile.folded") };
+		mProfiler.ExportCollapsedStacks(collapsedStacks);
 	}
-	LOG(LogScripting, Verbose, output);
-#endif // SCRIPT_PROFILING
 }
 
 void CE::VirtualMachine::Recompile()
@@ -97,6 +87,7 @@ void CE::VirtualMachine::Recompile()
 void CE::VirtualMachine::ClearCompilationResult()
 {
 	DestroyAllTypesCreatedThroughScripts();
+	mCompiledFunctions.clear();
 	mErrorsFromLastCompilation.clear();
 	mIsCompiled = false;
 }
@@ -122,32 +113,44 @@ std::vector<std::reference_wrapper<const CE::ScriptError>> CE::VirtualMachine::G
 	return returnValue;
 }
 
-CE::FuncResult CE::VirtualMachine::ExecuteScriptFunction(MetaFunc::DynamicArgs args,
-	MetaFunc::RVOBuffer rvoBuffer,
-	const ScriptFunc& func,
-	const ScriptNode& firstNode,
-	const FunctionEntryScriptNode* entryNode)
+const CE::ScriptBytecode& CE::VirtualMachine::CompileScriptFunction(const ScriptFunc& func)
 {
-#ifdef SCRIPT_PROFILING
-	struct Profiler
+	ScriptBytecode& bytecode = *mCompiledFunctions.emplace_back(std::make_unique<ScriptBytecode>(ScriptBytecode::Compile(func)));
+
+	bytecode.mProfilerId = mProfiler.RegisterFunction(func);
+
+	for (ScriptBytecode::Call& call : bytecode.mCalls)
 	{
-		Profiler(float& numOfSecondsSpent) :
-			mNumOfSecondsSpent(numOfSecondsSpent)
-		{
+		call.mProfilerId = mProfiler.RegisterNode(func, *call.mNode);
+	}
 
-		}
-		~Profiler()
-		{
-			mNumOfSecondsSpent += mTimer.GetSecondsElapsed();
-		}
+	return bytecode;
+}
 
-		float& mNumOfSecondsSpent;
-		Timer mTimer{};
-	};
-	Profiler profiler{ mNumOfSecondsSpentEachFunction[Format("{}::{}", func.GetNameOfScriptAsset(), func.GetName())] };
-#endif // SCRIPT_PROFILING
+template<typename T>
+T CE::VirtualMachine::GetInput(VMContext& context, const uint32 operandIndex)
+{
+	MetaAny input = GetInput(context, operandIndex);
+	ASSERT(input.IsExactly<T>() && "Shoulve been caught at script-compilation");
 
-	VMContext context{ func };
+	const T* const value = static_cast<T*>(input.GetData());
+
+	if (value == nullptr)
+	{
+		throw ScriptError{ ScriptError::ValueWasNull, { context.mFunc, context.mFunc.GetPin(context.mBytecode.mOperands[operandIndex].mPin) } };
+	}
+
+	return *value;
+}
+
+CE::FuncResult CE::VirtualMachine::ExecuteScriptFunction(MetaFunc::DynamicArgs args,
+	MetaFunc::RVOBuffer rvoBuffer,
+	const ScriptFunc& func,
+	const ScriptBytecode& bytecode)
+{
+	ScriptProfiler::Scope profilerScope{ mProfiler, bytecode.mProfilerId };
+
+	VMContext context{ func, bytecode };
 
 	try
 	{
@@ -161,122 +164,181 @@ CE::FuncResult CE::VirtualMachine::ExecuteScriptFunction(MetaFunc::DynamicArgs a
 			context.mThis = &args[0];
 		}
 
-		if (entryNode != nullptr)
+		// Store the arguments we received in their slots. If this is a member function,
+		// skip the first argument; there is no pin for it in the entry node
+		for (uint32 argNum = !func.IsStatic(); argNum < args.size(); argNum++)
 		{
-			const Span<const ScriptPin> entryPins = entryNode->GetOutputs(func);
+			const uint32 paramIndex = argNum - !func.IsStatic();
+			ASSERT(paramIndex < bytecode.mParameterSlots.size());
+
+			const uint32 slotIndex = bytecode.mParameterSlots[paramIndex];
+			const ScriptBytecode::Slot& slot = bytecode.mSlots[slotIndex];
+			VMContext::CachedValue& cachedValue = context.mCachedValues[slotIndex];
+			MetaAny& arg = args[argNum];
 
-			// Push the arguments we received to the cache. If this is a member function,
-			// skip the first argument; there is no pin for it in the entry node
-			for (uint32 argNum = !func.IsStatic(), pinIndex = 0; argNum < args.size();)
+			if (slot.mOffset == ScriptBytecode::sNone)
 			{
-				ASSERT(pinIndex < entryPins.size());
-				const ScriptPin& pin = entryPins[pinIndex];
+				cachedValue.mData = arg.GetData();
+				continue;
+			}
 
-				if (pin.IsFlow())
-				{
-					++pinIndex;
-					continue;
-				}
+			PrepareOutput(context, slotIndex);
 
-				MetaAny& arg = args[argNum];
+			// Copy construct
+			FuncResult copyResult = slot.mType->ConstructAt(cachedValue.mData, arg);
 
-				VMContext::CachedValue& cachedValue = FindCachedValue(context, pin.GetId());
+			// TODO can be checked at compile time?
+			if (copyResult.HasError())
+			{
+				throw ScriptError{ ScriptError::TypeCannotBeOwnedByScripts, { context.mFunc }, Format("Failed to copy construct type {} for parameter {} - {} try passing by reference instead",
+					slot.mType->GetName(),
+					func.GetParameters(true)[paramIndex].GetName(),
+					copyResult.Error())
+				};
+			}
 
-				const MetaType* const type = arg.TryGetType();
-				ASSERT(type != nullptr && "Should've been caught at compile time");
+			cachedValue.mNeedsToBeDestructed = slot.mNeedsToBeDestructed;
+		}
 
-				AllocateForCache(context, cachedValue, pin, type->GetTypeInfo());
+		const ScriptBytecode::Instruction* const instructions = bytecode.mInstructions.data();
+		uint32 pc = 0;
 
-				if (pin.GetTypeForm() == TypeForm::Value)
-				{
-					// Copy construct
-					FuncResult copyResult = type->ConstructAt(cachedValue.mData, arg);
+		// We give up if too many impure nodes were executed, or if too many jumps
+		// were taken without executing an impure node in between.
+		uint32 numOfImpureNodesExecuted = 0;
+		uint32 numOfJumpsSinceLastImpureNode = 0;
 
-					// TODO can be checked at compile time?
-					if (copyResult.HasError())
+		while (true)
+		{
+			const ScriptBytecode::Instruction& instruction = instructions[pc++];
+
+			switch (instruction.mOpCode)
+			{
+			case ScriptBytecode::OpCode::Call:
+			{
+				const ScriptBytecode::Call& call = bytecode.mCalls[instruction.mA];
+
+				if (!call.mIsPure)
+				{
+					if (++numOfImpureNodesExecuted == sMaxNumOfNodesToExecutePerFunctionBeforeGivingUp)
 					{
-						throw ScriptError{ ScriptError::TypeCannotBeOwnedByScripts, { context.mFunc }, Format("Failed to copy construct type {} from pin {} on node {} - {} try passing by reference instead",
-							type->GetName(),
-							pin.GetName(),
-							entryNode->GetDisplayName(),
-							copyResult.Error())
-						};
+						throw ScriptError{ ScriptError::ExecutionTimeOut, { context.mFunc, *call.mNode } };
 					}
+					numOfJumpsSinceLastImpureNode = 0;
 				}
-				else
+
+				ExecuteCall(context, call);
+				continue;
+			}
+			case ScriptBytecode::OpCode::Jump:
+			{
+				pc = instruction.mA;
+				break;
+			}
+			case ScriptBytecode::OpCode::JumpIfFalse:
+			{
+				if (!GetInput<bool>(context, instruction.mA))
 				{
-					cachedValue.mData = arg.GetData();
+					pc = instruction.mB;
 				}
+				break;
+			}
+			case ScriptBytecode::OpCode::PushLoop:
+			{
+				context.mLoops.emplace_back(VMContext::LoopInfo{ instruction.mA, instruction.mB });
+				continue;
+			}
+			case ScriptBytecode::OpCode::PopLoop:
+			{
+				EndLoop(context, instruction.mA);
+				continue;
+			}
+			case ScriptBytecode::OpCode::ForInit:
+			{
+				const int32 start = GetInput<int32>(context, instruction.mB);
 
-				++argNum;
-				++pinIndex;
+				PrepareOutput(context, instruction.mA);
+				*static_cast<int32*>(context.mCachedValues[instruction.mA].mData) = start;
+				continue;
 			}
-		}
+			case ScriptBytecode::OpCode::ForIncrement:
+			{
+				VMContext::CachedValue& index = context.mCachedValues[instruction.mA];
 
-		const ScriptNode* current = &firstNode;
-		uint32 stepNum = 0;
+				// We're updating a value in the cache, any nodes that are linked to the index will be recalculated as needed
+				++context.mNumOfImpureNodesExecuted;
+				++*static_cast<int32*>(index.mData);
+				index.mNumOfImpureNodesExecutedAtTimeOfCaching = context.mNumOfImpureNodesExecuted;
+				continue;
+			}
+			case ScriptBytecode::OpCode::JumpIfForDone:
+			{
+				const int32 index = *static_cast<const int32*>(context.mCachedValues[instruction.mA].mData);
 
-		// We can't execute the entry node, so just skip it and move on to the next one
-		if (firstNode.GetType() == ScriptNodeType::FunctionEntry)
-		{
-			goto nextNode;
-		}
+				if (index >= GetInput<int32>(context, instruction.mB))
+				{
+					pc = instruction.mC;
+				}
+				break;
+			}
+			case ScriptBytecode::OpCode::FallBack:
+			{
+				// We have reached the end of the function
+				if (context.mLoops.empty())
+				{
+					goto noReturnValue;
+				}
 
-		for (; stepNum < sMaxNumOfNodesToExecutePerFunctionBeforeGivingUp; stepNum++)
-		{
-			// We have reached the end of the function and must return the value
-			if (current->GetType() == ScriptNodeType::FunctionReturn)
+				pc = context.mLoops.back().mContinueAt;
+				break;
+			}
+			case ScriptBytecode::OpCode::Return:
 			{
-				for (const ScriptPin& pinToOutputTo : current->GetInputs(func))
+				if (instruction.mA == ScriptBytecode::sNone)
 				{
-					if (pinToOutputTo.IsFlow())
-					{
-						continue;
-					}
+					goto noReturnValue;
+				}
 
-					MetaAny ret = GetValueToPassAsInput(context, pinToOutputTo);
+				MetaAny ret = GetInput(context, instruction.mA);
 
-					if (pinToOutputTo.GetTypeForm() == TypeForm::Value
-						&& !ret.IsOwner())
+				if (bytecode.mOperandForms[instruction.mA] == TypeForm::Value
+					&& !ret.IsOwner())
+				{
+					const MetaType* const returnType = ret.TryGetType();
+					ASSERT(returnType != nullptr && "Shouldve been checked during script compilation");
+
+					if (rvoBuffer == nullptr)
 					{
-						const MetaType* const returnType = ret.TryGetType();
-						ASSERT(returnType != nullptr && "Shouldve been checked during script compilation");
-
-						FuncResult copyConstructResult = rvoBuffer == nullptr ? returnType->Construct(ret) : returnType->ConstructAt(rvoBuffer, ret);
-
-						if (copyConstructResult.HasError()) // TODO can be checked during script compilation
-						{
-							std::string error = Format("Could not copy return value of type {} - {}", returnType->GetName(), copyConstructResult.Error());
-							PrintError({ ScriptError::FunctionCallFailed, { context.mFunc, pinToOutputTo }, error });
-							return error;
-						}
-						return std::move(copyConstructResult.GetReturnValue());
+						mProfiler.AddAllocation();
 					}
 
-					return std::move(ret);
+					FuncResult copyConstructResult = rvoBuffer == nullptr ? returnType->Construct(ret) : returnType->ConstructAt(rvoBuffer, ret);
 
+					if (copyConstructResult.HasError()) // TODO can be checked during script compilation
+					{
+						std::string error = Format("Could not copy return value of type {} - {}", returnType->GetName(), copyConstructResult.Error());
+						PrintError({ ScriptError::FunctionCallFailed, { context.mFunc, func.GetPin(bytecode.mOperands[instruction.mA].mPin) }, error });
+						return error;
+					}
+					return std::move(copyConstructResult.GetReturnValue());
 				}
 
-				break;
+				return std::move(ret);
 			}
-
-			ExecuteNode(context, *current);
-
-		nextNode:
-			current = GetNextNodeToExecute(context, *current);
-
-			// We have reached the end of the function
-			if (current == nullptr)
+			case ScriptBytecode::OpCode::Throw:
 			{
-				break;
+				throw bytecode.mErrors[instruction.mA];
+			}
 			}
-		}
 
-		if (stepNum == sMaxNumOfNodesToExecutePerFunctionBeforeGivingUp)
-		{
-			throw ScriptError{ ScriptError::ExecutionTimeOut, { context.mFunc, *current } };
+			// Only jumps reach this point
+			if (++numOfJumpsSinceLastImpureNode == sMaxNumOfNodesToExecutePerFunctionBeforeGivingUp)
+			{
+				throw ScriptError{ ScriptError::ExecutionTimeOut, { context.mFunc } };
+			}
 		}
 
+	noReturnValue:
 		if (!func.GetReturnType().has_value())
 		{
 			return { std::nullopt };
@@ -287,12 +349,17 @@ CE::FuncResult CE::VirtualMachine::ExecuteScriptFunction(MetaFunc::DynamicArgs a
 
 		ASSERT(returnType != nullptr && "Should've been caught during script compilation");
 
+		if (rvoBuffer == nullptr)
+		{
+			mProfiler.AddAllocation();
+		}
+
 		FuncResult defaultConstructResult = rvoBuffer == nullptr ? returnType->Construct() : returnType->ConstructAt(rvoBuffer);
 
 		// TODO can be compile-time error
 		if (defaultConstructResult.HasError())
 		{
-			throw ScriptError{ ScriptError::Type::ValueWasNull, { context.mFunc, *current },
+			throw ScriptError{ ScriptError::Type::ValueWasNull, { context.mFunc },
 				Format("No return node encountered, and the return type {} cannot be default constructed - {}",
 				returnType->GetName(),
 				defaultConstructResult.Error())
@@ -367,42 +434,49 @@ void CE::VirtualMachine::DestroyAllTypesCreatedThroughScripts()
 	}
 }
 
-CE::VirtualMachine::VMContext::VMContext(const ScriptFunc& func) :
-	mFunc(func)
+CE::VirtualMachine::VMContext::VMContext(const ScriptFunc& func, const ScriptBytecode& bytecode) :
+	mFunc(func),
+	mBytecode(bytecode)
 {
 	VirtualMachine& vm = VirtualMachine::Get();
 
 	mStackPtrToFallBackTo = vm.mStackPtr;
-	uint32 size = static_cast<uint32>(func.GetNumOfPinsIncludingRemoved() * sizeof(CachedValue));
-	mCachedValues = static_cast<CachedValue*>(vm.StackAllocate(size, 8));
 
-	if (mCachedValues != nullptr)
+	mCachedValues = static_cast<CachedValue*>(vm.StackAllocate(static_cast<uint32>(bytecode.mSlots.size() * sizeof(CachedValue)), alignof(CachedValue)));
+	mFrame = static_cast<char*>(vm.StackAllocate(bytecode.mFrameSize, bytecode.mFrameAlignment));
+	mInputs = static_cast<MetaAny*>(vm.StackAllocate(bytecode.mMaxNumOfOperands * static_cast<uint32>(sizeof(MetaAny)), alignof(MetaAny)));
+
+	if (mCachedValues == nullptr
+		|| mFrame == nullptr
+		|| mInputs == nullptr)
 	{
-		memset(mCachedValues, 0, size);
+		// Reported as a stack overflow by ExecuteScriptFunction
+		mCachedValues = nullptr;
+		return;
 	}
+
+	std::uninitialized_default_construct_n(mCachedValues, bytecode.mSlots.size());
 }
 
 CE::VirtualMachine::VMContext::~VMContext()
 {
 	VirtualMachine& vm = VirtualMachine::Get();
 
-	for (uint32 i = 0; i < static_cast<uint32>(mFunc.GetNumOfPinsIncludingRemoved()); i++)
+	if (mCachedValues != nullptr)
 	{
-		CachedValue& cachedValue = mCachedValues[i];
-
-		// The userBit signifies ownership
-		if (!vm.DoesCacheValueNeedToBeFreed(cachedValue))
+		for (uint32 i = 0; i < static_cast<uint32>(mBytecode.mSlots.size()); i++)
 		{
-			continue;
+			if (mCachedValues[i].mNeedsToBeDestructed)
+			{
+				mBytecode.mSlots[i].mType->Destruct(mCachedValues[i].mData, false);
+			}
 		}
-
-		const ScriptPin& pin = mFunc.GetPin(PinId{ i + 1 });
-		const MetaType& metaType = *pin.TryGetType();
-
-		vm.FreeCachedValue(cachedValue, metaType);
 	}
 
 	vm.mStackPtr = mStackPtrToFallBackTo;
+
+	// Only the impure nodes are counted, and the count starts at one
+	PROFILE_COUNTER_ADD("Script node steps", mNumOfImpureNodesExecuted - 1);
 }
 
 void* CE::VirtualMachine::StackAllocate(uint32 numOfBytes, uint32 alignment)
@@ -419,197 +493,19 @@ void* CE::VirtualMachine::StackAllocate(uint32 numOfBytes, uint32 alignment)
 	return allocatedAt;
 }
 
-const CE::ScriptNode* CE::VirtualMachine::GetNextNodeToExecute(VMContext& context, const ScriptNode& start)
-{
-	ASSERT(!start.IsPure(context.mFunc)
-		&& !start.GetOutputs(context.mFunc).empty()
-		&& start.GetOutputs(context.mFunc)[0].IsFlow());
 
-	uint32 indexOfOutputFlowPin = 0;
-	const ScriptNode* current = &start;
+void CE::VirtualMachine::ExecuteCall(VMContext& context, const ScriptBytecode::Call& call)
+{
+	VMContext::CachedValue* const output = call.mOutputSlot == ScriptBytecode::sNone ? nullptr : &context.mCachedValues[call.mOutputSlot];
 
-	for (size_t i = 0; i < sMaxNumOfNodesToExecutePerFunctionBeforeGivingUp; i++)
+	// Did we run any impure nodes that could have changed the cached value
+	if (call.mIsPure
+		&& output != nullptr
+		&& output->mNumOfImpureNodesExecutedAtTimeOfCaching == context.mNumOfImpureNodesExecuted)
 	{
-		uint32 indexOfInputFlowPin{};
-
-		{
-			ASSERT(indexOfOutputFlowPin < current->GetOutputs(context.mFunc).size());
-
-			const ScriptPin& outputFlowPin = current->GetOutputs(context.mFunc)[indexOfOutputFlowPin];
-
-			const PinId linkedToId = outputFlowPin.GetCachedPinWeAreLinkedWith();
-
-			if (linkedToId == PinId::Invalid) // Not linked to anything
-			{
-				if (context.mControlNodesToFallBackTo.empty())
-				{
-					return nullptr;
-				}
-
-				std::variant<VMContext::WhileLoopInfo, VMContext::ForLoopInfo> loopInfo = context.mControlNodesToFallBackTo.back();
-
-				if (std::holds_alternative<VMContext::WhileLoopInfo>(loopInfo))
-				{
-					current = &std::get<VMContext::WhileLoopInfo>(loopInfo).mNode.get();
-				}
-				else
-				{
-					ASSERT(std::holds_alternative<VMContext::ForLoopInfo>(loopInfo));
-					current = &std::get<VMContext::ForLoopInfo>(loopInfo).mNode.get();
-				}
-
-				// We didn't enter through any pins, we just went teleported back to the loop node
-				indexOfInputFlowPin = std::numeric_limits<uint32>::max();
-			}
-			else
-			{
-				current = nullptr;
-
-				const ScriptPin& linkedTo = context.mFunc.GetPin(linkedToId);
-				current = &context.mFunc.GetNode(linkedTo.GetNodeId());
-
-				indexOfInputFlowPin = linkedToId.Get() - current->GetIdOfFirstPin().Get();
-
-				ASSERT(&current->GetInputs(context.mFunc)[indexOfInputFlowPin] == &linkedTo);
-			}
-		}
-
-		ASSERT(current != nullptr);
-
-		switch (current->GetType())
-		{
-		case ScriptNodeType::ForLoop:
-		{
-			Span<const ScriptPin> inputs = current->GetInputs(context.mFunc);
-			Span<const ScriptPin> outputs = current->GetOutputs(context.mFunc);
-
-			//ASSERT(inputs.size() == 4
-			//	&& inputs[ForLoopScriptNode::sIndexOfEntryPin].IsFlow() // Entry
-			//	&& inputs[ForLoopScriptNode::sIndexOfStartPin].GetTypeTraits() == MakeTypeTraits<int32>() // Start
-			//	&& inputs[ForLoopScriptNode::sIndexOfEndPin].GetTypeTraits() == MakeTypeTraits<const int32&>() // End
-			//	&& inputs[ForLoopScriptNode::sIndexOfBreakPin].IsFlow() // Break
-			//	&& outputs.size() == 3
-			//	&& outputs[ForLoopScriptNode::sIndexOfLoopPin].IsFlow() // Loop body
-			//	&& outputs[ForLoopScriptNode::sIndexOfIndexPin].GetTypeTraits() == MakeTypeTraits<int32>() // Current index
-			//	&& outputs[ForLoopScriptNode::sIndexOfExitPin].IsFlow()); // Exit
-
-			const ScriptPin& indexPin = outputs[ForLoopScriptNode::sIndexOfIndexPin];
-			VMContext::CachedValue& cachedIndex = FindCachedValue(context, indexPin.GetId());
-
-			if (indexOfInputFlowPin == ForLoopScriptNode::sIndexOfEntryPin) // for (int i = startValue;
-			{
-				BeginLoop(context, VMContext::ForLoopInfo{ static_cast<const ForLoopScriptNode&>(*current) });
-				AllocateForCache(context, cachedIndex, indexPin, MakeTypeInfo<int32>());
-
-				const ScriptPin& startPin = inputs[ForLoopScriptNode::sIndexOfStartPin];
-				*static_cast<int32*>(cachedIndex.mData) = GetValueToPassAsInput<int32>(context, startPin);
-			}
-
-			int32& index = *static_cast<int32*>(cachedIndex.mData);
-
-			if (indexOfInputFlowPin != ForLoopScriptNode::sIndexOfEntryPin // Don't increment if we just started the for loop
-				&& indexOfInputFlowPin != ForLoopScriptNode::sIndexOfBreakPin) // Don't increment if we hit the break pin
-			{
-				// We're updating a value in the cache, any nodes that are linked to the index will be recalculated as needed
-				++context.mNumOfImpureNodesExecutedAtTimeOfCaching;
-				++index;
-				cachedIndex.mNumOfImpureNodesExecutedAtTimeOfCaching = context.mNumOfImpureNodesExecutedAtTimeOfCaching;
-			}
-
-			const ScriptPin& endPin = inputs[ForLoopScriptNode::sIndexOfEndPin];
-			int32 end = GetValueToPassAsInput<int32>(context, endPin);
-
-			if (index >= end // If we've finished iterating
-				|| indexOfInputFlowPin == ForLoopScriptNode::sIndexOfBreakPin) // If break pin hit 
-			{
-				EndLoop(context, *current);
-				indexOfOutputFlowPin = ForLoopScriptNode::sIndexOfExitPin; // Exit loop
-			}
-			else
-			{
-				indexOfOutputFlowPin = ForLoopScriptNode::sIndexOfLoopPin; // Continue loop body
-			}
-
-			break;
-		}
-		case ScriptNodeType::WhileLoop:
-		{
-			Span<const ScriptPin> inputs = current->GetInputs(context.mFunc);
-
-			//ASSERT(inputs.size() == 3
-			//	&& inputs[WhileLoopScriptNode::sIndexOfEntryPin].IsFlow() // Entry
-			//	&& inputs[WhileLoopScriptNode::sIndexOfConditionPin].GetTypeTraits() == MakeTypeTraits<const bool&>() // Condition
-			//	&& inputs[WhileLoopScriptNode::sIndexOfBreakPin].IsFlow() // Break
-			//	&& current->GetOutputs(context.mFunc).size() == 2
-			//	&& current->GetOutputs(context.mFunc)[WhileLoopScriptNode::sIndexOfLoopPin].IsFlow() // Loop body
-			//	&& current->GetOutputs(context.mFunc)[WhileLoopScriptNode::sIndexOfExitPin].IsFlow()); // Exit
-
-			const ScriptPin& conditionPin = inputs[WhileLoopScriptNode::sIndexOfConditionPin];
-
-			bool condition = GetValueToPassAsInput<bool>(context, conditionPin);
-
-			if (indexOfInputFlowPin == WhileLoopScriptNode::sIndexOfEntryPin)
-			{
-				BeginLoop(context, VMContext::WhileLoopInfo{ static_cast<const WhileLoopScriptNode&>(*current) });
-			}
-
-			if (indexOfInputFlowPin == WhileLoopScriptNode::sIndexOfBreakPin // If break pin hit
-				|| !condition) // Or if the condition is false
-			{
-				EndLoop(context, *current);
-				indexOfOutputFlowPin = WhileLoopScriptNode::sIndexOfExitPin; // Exit loop
-			}
-			else
-			{
-				indexOfOutputFlowPin = WhileLoopScriptNode::sIndexOfLoopPin; // Continue to loop body
-			}
-
-			break;
-		}
-		case ScriptNodeType::Branch:
-		{
-			Span<const ScriptPin> inputs = current->GetInputs(context.mFunc);
-
-			//ASSERT(inputs.size() == 2
-			//	&& inputs[BranchScriptNode::sIndexOfEntryPin].IsFlow()
-			//	&& inputs[BranchScriptNode::sIndexOfConditionPin].GetTypeTraits() == MakeTypeTraits<const bool&>()
-			//	&& current->GetOutputs(context.mFunc).size() == 2
-			//	&& current->GetOutputs(context.mFunc)[BranchScriptNode::sIndexOfIfPin].IsFlow()
-			//	&& current->GetOutputs(context.mFunc)[BranchScriptNode::sIndexOfElsePin].IsFlow());
-
-			const ScriptPin& conditionPin = inputs[BranchScriptNode::sIndexOfConditionPin];
-
-			if (GetValueToPassAsInput<bool>(context, conditionPin))
-			{
-				indexOfOutputFlowPin = BranchScriptNode::sIndexOfIfPin;
-			}
-			else
-			{
-				indexOfOutputFlowPin = BranchScriptNode::sIndexOfElsePin;
-			}
-
-			break;
-		}
-		case ScriptNodeType::Rerout:
-		{
-			indexOfOutputFlowPin = 0;
-			break;
-		}
-		default:
-		{
-			return current;
-		}
-		}
+		return;
 	}
 
-	throw ScriptError{ ScriptError::ExecutionTimeOut, { context.mFunc, start } };
-}
-
-CE::VirtualMachine::VMContext::CachedValue* CE::VirtualMachine::ExecuteNode(VMContext& context, const ScriptNode& node)
-{
-	Span<const ScriptPin> inputs = node.GetInputs(context.mFunc);
-	const size_t numOfInputPins = inputs.size();
-
 	// Raii object that manages the lifetime
 	struct InputDeleter
 	{
@@ -617,102 +513,55 @@ CE::VirtualMachine::VMContext::CachedValue* CE::VirtualMachine::ExecuteNode(VMCo
 		{
 			for (size_t i = 0; i < mSize; i++)
 			{
-				mInputForms[i].~MetaAny();
+				mInputs[i].~MetaAny();
 			}
 		}
 
-		MetaAny* mInputForms;
+		MetaAny* mInputs;
 		size_t mSize{};
 	};
 
-	// Stack allocation
-	MetaAny* inputValues = static_cast<MetaAny*>(ENGINE_ALLOCA(numOfInputPins * sizeof(MetaAny)));
-	TypeForm* inputForms = static_cast<TypeForm*>(ENGINE_ALLOCA(numOfInputPins * sizeof(TypeForm)));
-
+	MetaAny* const inputValues = context.mInputs;
 	InputDeleter inputDeleter{ inputValues };
-	ASSERT(inputValues != nullptr && inputForms != nullptr);
-	// Collect the inputs that this node needs
 
-	for (size_t i = 0; i < numOfInputPins; i++)
+	for (uint32 i = 0; i < call.mNumOfOperands; i++)
 	{
-		const ScriptPin& param = inputs[i];
-
-		if (param.IsFlow())
-		{
-			continue;
-		}
-
-		MetaAny valueToPassToPureNode = GetValueToPassAsInput(context, param);
-		new (&inputValues[inputDeleter.mSize])MetaAny(std::move(valueToPassToPureNode));
-		inputForms[inputDeleter.mSize] = param.GetTypeForm();
+		new (&inputValues[i])MetaAny(GetInput(context, call.mFirstOperand + i));
 		inputDeleter.mSize++;
 	}
 
-	const Span<const ScriptPin> nodeOutputs = node.GetOutputs(context.mFunc);
-	ASSERT(nodeOutputs.size() >= 1);
-
-	// If the node returns void, all of these are nullptr.
-	const ScriptPin* outputPin = &nodeOutputs[0];
-	VMContext::CachedValue* returnAddress{};
-	const MetaType* returnType{};
-
-	// If the node is impure
-	if (outputPin->IsFlow())
+	if (!call.mIsPure)
 	{
-		++context.mNumOfImpureNodesExecutedAtTimeOfCaching;
-
-		if (nodeOutputs.size() == 1)
-		{
-			// This is an impure node with no return values
-			outputPin = nullptr;
-		}
-		else
-		{
-			ASSERT(nodeOutputs.size() == 2);
-			outputPin++;
-
-			ASSERT(!outputPin->IsFlow());
-			ASSERT(outputPin->TryGetType() != nullptr);
-		}
+		++context.mNumOfImpureNodesExecuted;
 	}
 
-	if (outputPin != nullptr)
+	// If the node returns void, this is nullptr.
+	const MetaType* returnType{};
+
+	if (output != nullptr)
 	{
-		returnAddress = &FindCachedValue(context, outputPin->GetId());
-		returnType = outputPin->TryGetType();
-		ASSERT(returnType != nullptr);
-		AllocateForCache(context, *returnAddress, *outputPin, returnType->GetTypeInfo());
+		PrepareOutput(context, call.mOutputSlot);
+		returnType = context.mBytecode.mSlots[call.mOutputSlot].mType;
 	}
 
+	ScriptProfiler::Scope profilerScope{ mProfiler, call.mProfilerId };
 	FuncResult result{};
 
-	switch (node.GetType())
+	switch (call.mType)
 	{
-	default:
-	case ScriptNodeType::Comment: // How would we even execute a comment node
-	case ScriptNodeType::FunctionReturn: // This node can never be executed
-	case ScriptNodeType::FunctionEntry: // This node can never be executed
-	case ScriptNodeType::Branch: // This node can never be executed
-	{
-		throw ScriptError{ ScriptError::CompilerBug, { context.mFunc, *outputPin } };
-	}
 	case ScriptNodeType::Setter:
 	case ScriptNodeType::Getter:
 	{
 		ASSERT(inputDeleter.mSize != 0 && "Getting or setting a field always require a target");
-		ASSERT(returnAddress != nullptr && "Does not return void; memory should have been allocated");
-
-		const MetaField* const metaMember = static_cast<const NodeInvolvingField&>(node).TryGetOriginalField();
-		ASSERT(metaMember != nullptr && "Should've been caught during script-compilation");
-
-		ASSERT(&metaMember->GetType() == returnType);
+		ASSERT(output != nullptr && "Does not return void; memory should have been allocated");
+		ASSERT(&call.mField->GetType() == returnType);
 
 		MetaAny& refToTarget = inputValues[0];
-		ASSERT(metaMember->GetOuterType().IsBaseClassOf(refToTarget.GetTypeId()) && "Invalid link, should've been caught during script compilation");
+		ASSERT(call.mField->GetOuterType().IsBaseClassOf(refToTarget.GetTypeId()) && "Invalid link, should've been caught during script compilation");
 
-		MetaAny refToMemberInsideTarget = metaMember->MakeRef(refToTarget);
+		MetaAny refToMemberInsideTarget = call.mField->MakeRef(refToTarget);
 
-		if (node.GetType() == ScriptNodeType::Setter)
+		if (call.mType == ScriptNodeType::Setter)
 		{
 			ASSERT(inputDeleter.mSize == 2 && "setting a field always require two arguments");
 
@@ -729,14 +578,14 @@ CE::VirtualMachine::VMContext::CachedValue* CE::VirtualMachine::ExecuteNode(VMCo
 
 			if (setResult.HasError())
 			{
-				throw ScriptError{ ScriptError::FunctionCallFailed, { context.mFunc, node }, setResult.Error() };
+				throw ScriptError{ ScriptError::FunctionCallFailed, { context.mFunc, *call.mNode }, setResult.Error() };
 			}
 		}
-		else if (static_cast<const GetterScriptNode&>(node).DoesNodeReturnCopy())
+		else if (call.mReturnsCopy)
 		{
 			// Make a copy of the value when getting or setting
 			// TODO Check if it has the copy-constructor at script-compile time
-			result = returnType->ConstructAt(returnAddress->mData, refToMemberInsideTarget);
+			result = returnType->ConstructAt(output->mData, refToMemberInsideTarget);
 			break;
 		}
 
@@ -745,305 +594,163 @@ CE::VirtualMachine::VMContext::CachedValue* CE::VirtualMachine::ExecuteNode(VMCo
 	}
 	case ScriptNodeType::FunctionCall:
 	{
-		const MetaFuncScriptNode& metaFuncNode = static_cast<const MetaFuncScriptNode&>(node);
-
-		const MetaFunc* const originalFunc = metaFuncNode.TryGetOriginalFunc();
-		ASSERT(originalFunc != nullptr && "Should've been caught during script-compilation");
-
 		// We assume the types match, because that was checked during script-compilation
 		// so we only have to check if something was null
-
-		const std::vector<MetaFuncNamedParam>& params = originalFunc->GetParameters();
-
-		for (uint32 i = 0; i < inputDeleter.mSize; i++)
+		for (uint32 i = 0; i < call.mNumOfOperands; i++)
 		{
 			if (inputValues[i] == nullptr
-				&& !CanFormBeNullable(params[i].mTypeTraits.mForm))
+				&& !context.mBytecode.mOperands[call.mFirstOperand + i].mCanParameterBeNull)
 			{
-				throw ScriptError{ ScriptError::ValueWasNull, { context.mFunc, node } };
+				throw ScriptError{ ScriptError::ValueWasNull, { context.mFunc, *call.mNode } };
 			}
 		}
 
-		result = originalFunc->InvokeUnchecked({ inputValues, inputDeleter.mSize }, { inputForms, inputDeleter.mSize }, returnAddress == nullptr ? nullptr : returnAddress->mData);
+		result = call.mFunc->InvokeUnchecked({ inputValues, call.mNumOfOperands },
+			{ &context.mBytecode.mOperandForms[call.mFirstOperand], call.mNumOfOperands },
+			output == nullptr ? nullptr : output->mData);
 		break;
 	}
+	default:
+	{
+		throw ScriptError{ ScriptError::CompilerBug, { context.mFunc, *call.mNode } };
+	}
 	}
 
 	if (result.HasError())
 	{
-		throw ScriptError{ ScriptError::FunctionCallFailed, { context.mFunc, node }, result.Error() };
+		throw ScriptError{ ScriptError::FunctionCallFailed, { context.mFunc, *call.mNode }, result.Error() };
 	}
 
-	ASSERT(returnAddress == nullptr == !result.HasReturnValue() && "No memory was allocated, but the result holds a return value, or Memory was allocated, but the result holds no return value");
+	ASSERT(output == nullptr == !result.HasReturnValue() && "No memory was allocated, but the result holds a return value, or Memory was allocated, but the result holds no return value");
 
-	if (returnAddress != nullptr)
+	if (output != nullptr)
 	{
-		// Some functions may return a reference or pointer.
-		returnAddress->mData = result.GetReturnValue().GetData();
-		return returnAddress;
-	}
+		const ScriptBytecode::Slot& slot = context.mBytecode.mSlots[call.mOutputSlot];
 
-	return nullptr;
-}
+		// Some functions may return a reference or pointer.
+		output->mData = result.GetReturnValue().GetData();
 
-CE::VirtualMachine::VMContext::WhileLoopInfo& CE::VirtualMachine::BeginLoop(VMContext& context, VMContext::WhileLoopInfo&& loopInfo)
-{
-	return std::get<VMContext::WhileLoopInfo>(context.mControlNodesToFallBackTo.emplace_back(std::move(loopInfo)));
-}
+		// The function did not construct the value in the buffer we provided
+		if (result.GetReturnValue().IsOwner())
+		{
+			mProfiler.AddAllocation();
+		}
 
-CE::VirtualMachine::VMContext::ForLoopInfo& CE::VirtualMachine::BeginLoop(VMContext& context, VMContext::ForLoopInfo&& loopInfo)
-{
-	return std::get<VMContext::ForLoopInfo>(context.mControlNodesToFallBackTo.emplace_back(std::move(loopInfo)));
+		// Only values that were constructed in our frame are ours to destruct
+		output->mNeedsToBeDestructed = slot.mNeedsToBeDestructed && output->mData == context.mFrame + slot.mOffset;
+	}
 }
 
-void CE::VirtualMachine::EndLoop(VMContext& context, const ScriptNode& node)
+void CE::VirtualMachine::EndLoop(VMContext& context, const uint32 loop)
 {
-	auto nodeToFallBackTo = std::find_if(context.mControlNodesToFallBackTo.crbegin(), context.mControlNodesToFallBackTo.crend(),
-		[&node](const std::variant<VMContext::WhileLoopInfo, VMContext::ForLoopInfo>& loopInfo)
+	const auto loopToEnd = std::find_if(context.mLoops.crbegin(), context.mLoops.crend(),
+		[loop](const VMContext::LoopInfo& loopInfo)
 		{
-			if (std::holds_alternative<VMContext::WhileLoopInfo>(loopInfo))
-			{
-				return &node == &std::get<VMContext::WhileLoopInfo>(loopInfo).mNode.get();
-			}
-			ASSERT(std::holds_alternative<VMContext::ForLoopInfo>(loopInfo));
-			return &node == &std::get<VMContext::ForLoopInfo>(loopInfo).mNode.get();
+			return loopInfo.mLoop == loop;
 		});
 
-	if (nodeToFallBackTo == context.mControlNodesToFallBackTo.crend())
+	if (loopToEnd == context.mLoops.crend())
 	{
-		PrintError(ScriptError{ ScriptError::LinkNotAllowed, { context.mFunc, node }, "Attempted to break out of a loop that was not running", });
+		PrintError(ScriptError{ ScriptError::LinkNotAllowed, { context.mFunc, context.mBytecode.mLoops[loop] }, "Attempted to break out of a loop that was not running", });
 	}
 	else
 	{
-		++nodeToFallBackTo;
-		context.mControlNodesToFallBackTo.erase(nodeToFallBackTo.base(), context.mControlNodesToFallBackTo.end());
+		context.mLoops.erase(std::next(loopToEnd).base(), context.mLoops.end());
 	}
 }
 
-CE::VirtualMachine::VMContext::CachedValue& CE::VirtualMachine::FindCachedValue(VMContext& context, PinId pinId)
+void CE::VirtualMachine::PrepareOutput(VMContext& context, const uint32 slotIndex)
 {
-	return context.mCachedValues[pinId.Get() - 1];
-}
-
-template<>
-CE::MetaAny CE::VirtualMachine::GetValueToPassAsInput(VMContext& context, const ScriptPin& pinToPassInputInto)
-{
-	ASSERT(pinToPassInputInto.IsInput());
-
-	// Get the output pin this pin is linked to
-	const PinId otherPinId = pinToPassInputInto.GetCachedPinWeAreLinkedWith();
+	const ScriptBytecode::Slot& slot = context.mBytecode.mSlots[slotIndex];
+	VMContext::CachedValue& cachedValue = context.mCachedValues[slotIndex];
 
-	std::optional<MetaAny> returnValue{};
-	const TypeForm form = pinToPassInputInto.GetTypeForm();
+	cachedValue.mNumOfImpureNodesExecutedAtTimeOfCaching = context.mNumOfImpureNodesExecuted;
 
-	// No output pin? No worries, we'll just use the default value!
-	if (otherPinId == PinId::Invalid)
+	// Reuse the existing space
+	if (cachedValue.mNeedsToBeDestructed)
 	{
-		// There is no link connected to this pin, maybe we can default to 'this'?
-		if (pinToPassInputInto.GetTypeName() == context.mFunc.GetNameOfScriptAsset())
-		{
-			if (context.mFunc.IsStatic())
-			{
-				throw ScriptError{ ScriptError::ValueWasNull, { context.mFunc, pinToPassInputInto },
-					Format("Cannot call non-static functions ({}) from static functions ({})",
-						context.mFunc.GetNode(pinToPassInputInto.GetNodeId()).GetDisplayName(),
-						context.mFunc.GetName())
-				};
-			}
-
-			// An instance of the script should have been provided as an argument to this function
-			if (context.mThis == nullptr)
-			{
-				throw ScriptError{ ScriptError::CompilerBug, { context.mFunc, pinToPassInputInto },
-					"Compiler error: 'This' was unexpectedly nullptr for a non-static function. This should have been checked earlier." };
-			}
-
-			returnValue = MakeRef(*context.mThis);
-		}
-		else if (!DoesPinRequireLink(context.mFunc, pinToPassInputInto))
-		{
-			const MetaAny* valueIfNoInputLinked = pinToPassInputInto.TryGetValueIfNoInputLinked();
+		slot.mType->Destruct(cachedValue.mData, false);
+		cachedValue.mNeedsToBeDestructed = false;
+	}
 
-			if (valueIfNoInputLinked != nullptr)
-			{
-				ASSERT(valueIfNoInputLinked->GetData() != nullptr && "Not sure how this could have happened");
-				returnValue = MakeRef(const_cast<MetaAny&>(*valueIfNoInputLinked));
-			}
-			else
-			{
-				const MetaType* const pinType = pinToPassInputInto.TryGetType();
-				ASSERT(pinType != nullptr && "Shoulve been caught during script compilation");
+	if (slot.mOffset != ScriptBytecode::sNone)
+	{
+		cachedValue.mData = context.mFrame + slot.mOffset;
+	}
+}
 
-				// Construct default
-				FuncResult defaultConstructedValue = pinType->Construct();
+CE::MetaAny CE::VirtualMachine::GetInput(VMContext& context, const uint32 operandIndex)
+{
+	const ScriptBytecode::Operand& operand = context.mBytecode.mOperands[operandIndex];
 
-				// TODO can be checked during script-compilation
-				if (defaultConstructedValue.HasError())
-				{
-					throw ScriptError{ ScriptError::FunctionCallFailed, { context.mFunc, pinToPassInputInto },
-						Format("Type {} of input pin {} has no link connected to it, and creating a default value failed - {}",
-						pinType->GetName(),
-						pinToPassInputInto.GetName(),
-						defaultConstructedValue.Error())
-					};
-				}
+	switch (operand.mSource)
+	{
+	case ScriptBytecode::Operand::Source::Slot:
+	{
+		MetaAny value{ *context.mBytecode.mSlots[operand.mIndex].mType, context.mCachedValues[operand.mIndex].mData, false };
 
-				returnValue = std::move(defaultConstructedValue.GetReturnValue());
-			}
-		}
-		else
+		if (operand.mAcceptsAny
+			|| operand.mCanPinBeNull
+			|| !(value == nullptr))
 		{
-			// TODO can be checked during script-compilation
-			throw ScriptError{ ScriptError::ValueWasNull, { context.mFunc, pinToPassInputInto }, "No link was connected to pin" };
+			return value;
 		}
+		break;
 	}
-	else
+	case ScriptBytecode::Operand::Source::This:
 	{
-		const ScriptPin& otherPin = context.mFunc.GetPin(otherPinId);
-		const ScriptNode& otherNode = context.mFunc.GetNode(otherPin.GetNodeId());
-
-		if (otherNode.GetType() == ScriptNodeType::Rerout)
-		{
-			return GetValueToPassAsInput(context, otherNode.GetInputs(context.mFunc)[0]);
-		}
-
-		// If the pin type is MetaAny, we accept anything. We cannot assign that to returnValue, 
-		// because typeId<MetaAny> != typeIdOfWhateverIsConnectedToOurPin
-		// A bit of an exception to the rule that makes this part of the code a bit messy
-		// At the time of writing, this is only used for the IsNull node
-		bool returnImmediately{};
-
-		if (pinToPassInputInto.TryGetType()->GetTypeId() == MakeTypeId<MetaAny>())
+		// An instance of the script should have been provided as an argument to this function
+		if (context.mThis == nullptr)
 		{
-			// TODO can be checked during script compilation
-			if (pinToPassInputInto.GetTypeForm() == TypeForm::Value)
-			{
-				throw ScriptError{ ScriptError::TypeCannotBeOwnedByScripts, { context.mFunc, pinToPassInputInto }, "Pins accepting 'MetaAny' by value is not allowed; use a reference or a const reference instead" };
-			}
-			returnImmediately = true;
+			throw ScriptError{ ScriptError::CompilerBug, { context.mFunc, context.mFunc.GetPin(operand.mPin) },
+				"Compiler error: 'This' was unexpectedly nullptr for a non-static function. This should have been checked earlier." };
 		}
 
-		VMContext::CachedValue& cachedValue = FindCachedValue(context, otherPin.GetId());
+		MetaAny value = MakeRef(*context.mThis);
 
-		if (cachedValue.mNumOfImpureNodesExecutedAtTimeOfCaching == context.mNumOfImpureNodesExecutedAtTimeOfCaching // Did we run any impure nodes that could have changed the cached value
-			|| !otherNode.IsPure(context.mFunc)) // Impure nodes are not executed again if the cache is 'out of date', this is perfectly valid and expected behaviour
+		if (operand.mCanPinBeNull
+			|| !(value == nullptr))
 		{
-			// Yay! We can use the cached value
-			if (returnImmediately)
-			{
-				return MetaAny{ *otherPin.TryGetType(), cachedValue.mData, false };
-			}
-			returnValue = MetaAny{ *otherPin.TryGetType(), cachedValue.mData, false };
-		}
-		else
-		{
-			// The cache is out of date. We have to recalculate it
-
-			// We can't suddenly execute a non-pure node
-			if (!otherNode.IsPure(context.mFunc))
-			{
-				throw ScriptError{ ScriptError::LinkNotAllowed, { context.mFunc, context.mFunc.GetAllLinksConnectedToPin(pinToPassInputInto.GetId())[0] },
-					Format("The input pin {} in node {} is connected to the output pin {} in node {}, but node {} runs before node {}!",
-					pinToPassInputInto.GetName(),
-					context.mFunc.GetNode(pinToPassInputInto.GetNodeId()).GetDisplayName(),
-					otherNode.GetDisplayName(),
-					otherNode.GetDisplayName(),
-					context.mFunc.GetNode(pinToPassInputInto.GetNodeId()).GetDisplayName(),
-					otherNode.GetDisplayName())
-				};
-			}
-
-			// Run the node
-			const VMContext::CachedValue* const nodeReturnValue = ExecuteNode(context, otherNode);
-
-			if (nodeReturnValue == nullptr)
-			{
-				throw ScriptError{ ScriptError::CompilerBug, { context.mFunc, pinToPassInputInto },
-					Format("The node {} unexpectedly returned void", otherNode.GetDisplayName()) };
-			}
-
-			const TypeInfo returnTypeInfo = otherPin.TryGetType()->GetTypeInfo();
-
-			if (returnImmediately)
-			{
-				return MetaAny{ returnTypeInfo, nodeReturnValue->mData };
-			}
-
-			returnValue = MetaAny{ returnTypeInfo, nodeReturnValue->mData };
+			return value;
 		}
+		break;
 	}
-
-	ASSERT(returnValue.has_value());
-
-	// Check if it's nullptr
-	if (*returnValue == nullptr
-		&& !CanFormBeNullable(form))
+	case ScriptBytecode::Operand::Source::Unlinked:
 	{
-		throw ScriptError{ ScriptError::ValueWasNull, { context.mFunc, pinToPassInputInto } };
-	}
-
-	return std::move(*returnValue);
-}
+		const ScriptPin& pin = context.mFunc.GetPin(operand.mPin);
+		const MetaAny* valueIfNoInputLinked = pin.TryGetValueIfNoInputLinked();
 
-void CE::VirtualMachine::AllocateForCache(VMContext& context, VMContext::CachedValue& cachedValue, const ScriptPin& pin, TypeInfo typeInfo)
-{
-	cachedValue.mNumOfImpureNodesExecutedAtTimeOfCaching = context.mNumOfImpureNodesExecutedAtTimeOfCaching;
+		if (valueIfNoInputLinked != nullptr)
+		{
+			ASSERT(valueIfNoInputLinked->GetData() != nullptr && "Not sure how this could have happened");
+			return MakeRef(const_cast<MetaAny&>(*valueIfNoInputLinked));
+		}
 
-	cachedValue.mTypeInfoFlags = typeInfo.mFlags;
+		const MetaType* const pinType = pin.TryGetType();
+		ASSERT(pinType != nullptr && "Shoulve been caught during script compilation");
 
-	if (pin.GetTypeForm() != TypeForm::RValue
-		&& pin.GetTypeForm() != TypeForm::Value)
-	{
-		cachedValue.mTypeInfoFlags &= ~TypeInfo::UserBit;
-		return;
-	}
+		// Construct default
+		mProfiler.AddAllocation();
+		FuncResult defaultConstructedValue = pinType->Construct();
 
-	// Reuse the existing space if we can
-	if (cachedValue.mData != nullptr)
-	{
-		if (DoesCacheValueNeedToBeFreed(cachedValue))
+		// TODO can be checked during script-compilation
+		if (defaultConstructedValue.HasError())
 		{
-			FreeCachedValue(cachedValue, *pin.TryGetType());
+			throw ScriptError{ ScriptError::FunctionCallFailed, { context.mFunc, pin },
+				Format("Type {} of input pin {} has no link connected to it, and creating a default value failed - {}",
+				pinType->GetName(),
+				pin.GetName(),
+				defaultConstructedValue.Error())
+			};
 		}
 
-		return;
+		return std::move(defaultConstructedValue.GetReturnValue());
 	}
-
-	cachedValue.mData = StackAllocate(typeInfo.GetSize(), typeInfo.GetAlign());
-	cachedValue.mTypeInfoFlags |= TypeInfo::UserBit;
-
-	if (cachedValue.mData == nullptr)
+	case ScriptBytecode::Operand::Source::Error:
 	{
-		throw ScriptError{ ScriptError::StackOverflow, { context.mFunc } };
+		throw context.mBytecode.mErrors[operand.mIndex];
 	}
-}
-
-bool CE::VirtualMachine::DoesCacheValueNeedToBeFreed(VMContext::CachedValue& cachedValue)
-{
-	return (cachedValue.mTypeInfoFlags & TypeInfo::UserBit) && (cachedValue.mTypeInfoFlags & TypeInfo::IsTriviallyDestructible) == 0 && cachedValue.mData != nullptr;
-}
-
-void CE::VirtualMachine::FreeCachedValue(VMContext::CachedValue& cachedValue, const MetaType& pinType)
-{
-	ASSERT(DoesCacheValueNeedToBeFreed(cachedValue));
-	pinType.Destruct(cachedValue.mData, false);
-}
-
-template<typename T>
-T CE::VirtualMachine::GetValueToPassAsInput(VMContext& context, const ScriptPin& pinToPassInputInto)
-{
-	ASSERT(pinToPassInputInto.IsInput() && pinToPassInputInto.TryGetType()->GetTypeId() == MakeTypeId<T>());
-
-	MetaAny valueToPassAsInput = GetValueToPassAsInput(context, pinToPassInputInto);
-	ASSERT(valueToPassAsInput.IsExactly<T>() && "Shoulve been caught at script-compilation");
-
-	const T* const conditionValue = static_cast<T*>(valueToPassAsInput.GetData());
-
-	if (conditionValue == nullptr)
-	{
-		throw ScriptError{ ScriptError::ValueWasNull, { context.mFunc, pinToPassInputInto } };
 	}
 
-	return *conditionValue;
+	throw ScriptError{ ScriptError::ValueWasNull, { context.mFunc, context.mFunc.GetPin(operand.mPin) } };
 }
-
@@ -488,10 +488,10 @@ void CE::ScriptEditorSystem::CopySelection()
 		}
 	}
 
-	std::stringstream str{};
-	object.SaveToBinary(str);
+	std::string binary{};
+	object.SaveToBinary(binary);
 
-	std::string clipBoardText = std::string{ sClipboardScriptIdentifier } + StringFunctions::BinaryToHex(str.str());
+	std::string clipBoardText = std::string{ sClipboardScriptIdentifier } + StringFunctions::BinaryToHex(binary);
 
 	ImGui::SetClipboardText(clipBoardText.c_str());
 }
@@ -531,9 +531,9 @@ void CE::ScriptEditorSystem::Paste(std::optional<glm::vec2> offsetToOldPos)
 
 	std::string_view hexContent = clipBoardText.substr(sClipboardScriptIdentifier.size());
 	std::string binaryContent = StringFunctions::HexToBinary(hexContent);
-	view_istream stream{ binaryContent };
+	BinaryReader reader{ binaryContent };
 
-	bool success = object.LoadFromBinary(stream);
+	bool success = object.LoadFromBinary(reader);
 
 	const BinaryGSONObject* serializedNodes = object.TryGetGSONObject("nodes");
 	const BinaryGSONObject* serializedLinks = object.TryGetGSONObject("links");
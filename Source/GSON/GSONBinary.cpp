@@ -3,33 +3,39 @@
 
 #include "Utilities/StringFunctions.h"
 
+#include <numeric>
+
 template<typename SizeType>
-static inline bool TrySaveSizeAsType(std::ostream& ostream, const size_t size)
+static inline bool TrySaveSizeAsType(CE::BinaryWriter& writer, const size_t size)
 {
 	if (size < std::numeric_limits<SizeType>::max())
 	{
-		const SizeType smallSize = static_cast<SizeType>(size);
-		ostream.write(reinterpret_cast<const char*>(&smallSize), sizeof(smallSize));
+		writer.Write(static_cast<SizeType>(size));
 		return true;
 	}
 	else
 	{
-		constexpr SizeType max = std::numeric_limits<SizeType>::max();
-		ostream.write(reinterpret_cast<const char*>(&max), sizeof(max));
+		writer.Write(std::numeric_limits<SizeType>::max());
 		return false;
 	}
 }
 
-static inline void SaveSmallSize(std::ostream& ostream, const size_t size)
+static inline void SaveSmallSize(CE::BinaryWriter& writer, const size_t size)
 {
-	if (TrySaveSizeAsType<uint8>(ostream, size)
-		|| TrySaveSizeAsType<uint16>(ostream, size)
-		|| TrySaveSizeAsType<size_t>(ostream, size))
+	if (TrySaveSizeAsType<uint8>(writer, size)
+		|| TrySaveSizeAsType<uint16>(writer, size)
+		|| TrySaveSizeAsType<size_t>(writer, size))
 	{
 
 	}
 }
 
+static inline void SaveSmallString(CE::BinaryWriter& writer, const std::string& str)
+{
+	SaveSmallSize(writer, str.size());
+	writer.WriteBytes(str.data(), str.size());
+}
+
 template<typename SizeType>
 static inline bool TryLoadSizeAsType(std::istream& istream, size_t& size)
 {
@@ -55,27 +61,115 @@ static inline std::optional<size_t> LoadSmallSize(std::istream& istream)
 	return size;
 }
 
+template<typename SizeType>
+static inline bool TryLoadSizeAsType(CE::BinaryReader& reader, size_t& size)
+{
+	SizeType smallSize{};
+
+	if (!reader.Read(smallSize))
+	{
+		return false;
+	}
+
+	size = static_cast<size_t>(smallSize);
+	return smallSize != std::numeric_limits<SizeType>::max();
+}
+
+// Does not log, for callers that report invalid data themselves
+static inline std::optional<size_t> TryLoadSmallSize(CE::BinaryReader& reader)
+{
+	size_t size{};
+
+	if (!TryLoadSizeAsType<uint8>(reader, size)
+		&& !TryLoadSizeAsType<uint16>(reader, size)
+		&& !TryLoadSizeAsType<size_t>(reader, size))
+	{
+		return std::nullopt;
+	}
+	return size;
+}
+
+static inline std::optional<size_t> LoadSmallSize(CE::BinaryReader& reader)
+{
+	const std::optional<size_t> size = TryLoadSmallSize(reader);
+
+	if (!size.has_value())
+	{
+		LOG(LogCore, Error, "Invalid save, serialized size invalid.");
+	}
+	return size;
+}
+
+// Does not log, for callers that report invalid data themselves
+static inline std::optional<std::string_view> TryLoadSmallStringView(CE::BinaryReader& reader)
+{
+	const std::optional<size_t> size = TryLoadSmallSize(reader);
+
+	if (!size.has_value())
+	{
+		return std::nullopt;
+	}
+
+	return reader.ReadView(*size);
+}
+
+static inline std::optional<std::string_view> LoadSmallStringView(CE::BinaryReader& reader)
+{
+	const std::optional<size_t> size = LoadSmallSize(reader);
+
+	if (!size.has_value())
+	{
+		return std::nullopt;
+	}
+
+	const std::optional<std::string_view> view = reader.ReadView(*size);
+
+	if (!view.has_value())
+	{
+		LOG(LogCore, Error, "Invalid GSONObject: expected string of {} length, but found only {} bytes.", *size, reader.GetNumOfBytesLeft());
+	}
+	return view;
+}
+
+static inline bool LoadSmallString(CE::BinaryReader& reader, std::string& str)
+{
+	const std::optional<std::string_view> view = LoadSmallStringView(reader);
+
+	if (!view.has_value())
+	{
+		return false;
+	}
+
+	str.assign(view->data(), view->size());
+	return true;
+}
+
 void CE::BinaryGSONObject::SaveToBinary(std::ostream& ostream) const
 {
-	SaveSmallSize(ostream, mName.size());
-	ostream.write(mName.c_str(), mName.size());
+	std::string buffer{};
+	SaveToBinary(buffer);
+	ostream.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+}
 
-	SaveSmallSize(ostream, mChildren.size());
+void CE::BinaryGSONObject::SaveToBinary(std::string& buffer) const
+{
+	BinaryWriter writer{ buffer };
+
+	SaveSmallString(writer, mName);
+
+	SaveSmallSize(writer, mChildren.size());
 
 	for (const BinaryGSONObject& child : mChildren)
 	{
-		child.SaveToBinary(ostream);
+		child.SaveToBinary(buffer);
 	}
 
-	SaveSmallSize(ostream, mMembers.size());
+	SaveSmallSize(writer, mMembers.size());
 
 	for (const BinaryGSONMember& member : mMembers)
 	{
-		SaveSmallSize(ostream, member.mName.size());
-		ostream.write(member.mName.c_str(), member.mName.size());
-
-		SaveSmallSize(ostream, member.mData.size());
-		ostream.write(member.mData.c_str(), member.mData.size());
+		SaveSmallString(writer, member.mName);
+		SaveSmallString(writer, member.mData);
 	}
 }
 
@@ -160,3 +254,217 @@ bool CE::BinaryGSONObject::LoadFromBinary(std::istream& istream)
 
 	return true;
 }
+
+bool CE::BinaryGSONObject::LoadFromBinary(BinaryReader& reader)
+{
+	if (!LoadSmallString(reader, mName))
+	{
+		return false;
+	}
+
+	const std::optional<size_t> numOfChildren = LoadSmallSize(reader);
+
+	if (!numOfChildren.has_value())
+	{
+		return false;
+	}
+
+	// The sizes have not been validated yet, so don't reserve more than could possibly be read
+	mChildren.reserve(std::min(*numOfChildren, reader.GetNumOfBytesLeft()));
+
+	for (size_t i = 0; i < *numOfChildren; i++)
+	{
+		if (!AddGSONObject({}).LoadFromBinary(reader))
+		{
+			return false;
+		}
+	}
+
+	const std::optional<size_t> numOfMembers = LoadSmallSize(reader);
+
+	if (!numOfMembers.has_value())
+	{
+		return false;
+	}
+
+	mMembers.reserve(std::min(*numOfMembers, reader.GetNumOfBytesLeft()));
+
+	for (size_t i = 0; i < *numOfMembers; i++)
+	{
+		BinaryGSONMember& newMember = AddGSONMember({});
+
+		if (!LoadSmallString(reader, newMember.mName)
+			|| !LoadSmallString(reader, newMember.mData))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+std::optional<CE::BinaryGSONView> CE::BinaryGSONView::Parse(Span<const std::byte> bytes)
+{
+	BinaryGSONView view{};
+	std::vector<Ranges> ranges(1);
+	view.mObjects.resize(1);
+
+	BinaryReader reader{ bytes };
+
+	if (!view.ParseObject(reader, 0, ranges))
+	{
+		return std::nullopt;
+	}
+
+	view.mObjectsByName.resize(view.mObjects.size());
+	view.mMembersByName.resize(view.mMembers.size());
+
+	for (size_t i = 0; i < view.mObjects.size(); i++)
+	{
+		Object& object = view.mObjects[i];
+		const Ranges& range = ranges[i];
+
+		object.mChildren = view.mObjects.data() + range.mFirstChild;
+		object.mMembers = view.mMembers.data() + range.mFirstMember;
+		object.mNumOfChildren = range.mNumOfChildren;
+		object.mNumOfMembers = range.mNumOfMembers;
+
+		uint32* const childrenByName = view.mObjectsByName.data() + range.mFirstChild;
+		uint32* const membersByName = view.mMembersByName.data() + range.mFirstMember;
+
+		std::iota(childrenByName, childrenByName + range.mNumOfChildren, 0u);
+		std::iota(membersByName, membersByName + range.mNumOfMembers, 0u);
+
+		// Stable, so that the first element with a given name is found first, just like in a linear search
+		std::stable_sort(childrenByName, childrenByName + range.mNumOfChildren,
+			[&object](uint32 lhs, uint32 rhs)
+			{
+				return object.mChildren[lhs].mName < object.mChildren[rhs].mName;
+			});
+		std::stable_sort(membersByName, membersByName + range.mNumOfMembers,
+			[&object](uint32 lhs, uint32 rhs)
+			{
+				return object.mMembers[lhs].mName < object.mMembers[rhs].mName;
+			});
+
+		object.mChildrenByName = childrenByName;
+		object.mMembersByName = membersByName;
+	}
+
+	return view;
+}
+
+bool CE::BinaryGSONView::ParseObject(BinaryReader& reader, const uint32 objectIndex, std::vector<Ranges>& ranges)
+{
+	const std::optional<std::string_view> name = TryLoadSmallStringView(reader);
+
+	if (!name.has_value())
+	{
+		return false;
+	}
+	mObjects[objectIndex].mName = *name;
+
+	const std::optional<size_t> numOfChildren = TryLoadSmallSize(reader);
+
+	// Every child takes up at least three bytes, a name and two sizes.
+	// This prevents allocating absurd amounts of memory for invalid data.
+	if (!numOfChildren.has_value()
+		|| *numOfChildren > reader.GetNumOfBytesLeft() / 3)
+	{
+		return false;
+	}
+
+	const uint32 firstChild = static_cast<uint32>(mObjects.size());
+	mObjects.resize(mObjects.size() + *numOfChildren);
+	ranges.resize(mObjects.size());
+
+	ranges[objectIndex].mFirstChild = firstChild;
+	ranges[objectIndex].mNumOfChildren = static_cast<uint32>(*numOfChildren);
+
+	for (uint32 i = 0; i < *numOfChildren; i++)
+	{
+		if (!ParseObject(reader, firstChild + i, ranges))
+		{
+			return false;
+		}
+	}
+
+	const std::optional<size_t> numOfMembers = TryLoadSmallSize(reader);
+
+	// Every member takes up at least two bytes, the sizes of its name and data
+	if (!numOfMembers.has_value()
+		|| *numOfMembers > reader.GetNumOfBytesLeft() / 2)
+	{
+		return false;
+	}
+
+	ranges[objectIndex].mFirstMember = static_cast<uint32>(mMembers.size());
+	ranges[objectIndex].mNumOfMembers = static_cast<uint32>(*numOfMembers);
+
+	for (size_t i = 0; i < *numOfMembers; i++)
+	{
+		const std::optional<std::string_view> memberName = TryLoadSmallStringView(reader);
+
+		if (!memberName.has_value())
+		{
+			return false;
+		}
+
+		const std::optional<std::string_view> memberData = TryLoadSmallStringView(reader);
+
+		if (!memberData.has_value())
+		{
+			return false;
+		}
+
+		Member& member = mMembers.emplace_back();
+		member.mName = *memberName;
+		member.mData = *memberData;
+	}
+
+	return true;
+}
+
+const CE::BinaryGSONView::Object* CE::BinaryGSONView::Object::TryGetGSONObject(const std::string_view name) const
+{
+	const uint32* const end = mChildrenByName + mNumOfChildren;
+	const uint32* const it = std::lower_bound(mChildrenByName, end, name,
+		[this](uint32 index, std::string_view value)
+		{
+			return mChildren[index].mName < value;
+		});
+
+	return it != end && mChildren[*it].mName == name ? &mChildren[*it] : nullptr;
+}
+
+const CE::BinaryGSONView::Member* CE::BinaryGSONView::Object::TryGetGSONMember(const std::string_view name) const
+{
+	const uint32* const end = mMembersByName + mNumOfMembers;
+	const uint32* const it = std::lower_bound(mMembersByName, end, name,
+		[this](uint32 index, std::string_view value)
+		{
+			return mMembers[index].mName < value;
+		});
+
+	return it != end && mMembers[*it].mName == name ? &mMembers[*it] : nullptr;
+}
+
+void CE::BinaryGSONView::Object::CopyTo(BinaryGSONObject& object) const
+{
+	object.Clear();
+	object.SetName(std::string{ mName });
+
+	// Reserved up front, so that the references to the children stay valid while we recurse
+	object.ReserveChildren(mNumOfChildren);
+	object.ReserveMembers(mNumOfMembers);
+
+	for (const Object& child : GetChildren())
+	{
+		child.CopyTo(object.AddGSONObject(child.mName));
+	}
+
+	for (const Member& member : GetGSONMembers())
+	{
+		object.AddGSONMember(member.mName).SetData(member.mData);
+	}
+}
@@ -6,6 +6,25 @@
 #include "Meta/MetaProps.h"
 #include "Utilities/MemFunctions.h"
 
+namespace
+{
+	// Returns false if all of the typeIds were already present
+	bool MergeSortedTypeIds(std::vector<CE::TypeId>& into, const std::vector<CE::TypeId>& typeIds)
+	{
+		std::vector<CE::TypeId> merged{};
+		merged.reserve(into.size() + typeIds.size());
+		std::set_union(into.begin(), into.end(), typeIds.begin(), typeIds.end(), std::back_inserter(merged));
+
+		if (merged.size() == into.size())
+		{
+			return false;
+		}
+
+		into = std::move(merged);
+		return true;
+	}
+}
+
 CE::MetaType::MetaType(const TypeInfo typeInfo,
 	const std::string_view name) :
 	mTypeInfo(typeInfo),
@@ -20,6 +39,8 @@ CE::MetaType::MetaType(MetaType&& other) noexcept :
 	mFields(std::move(other.mFields)),
 	mDirectBaseClasses(std::move(other.mDirectBaseClasses)),
 	mDirectDerivedClasses(std::move(other.mDirectDerivedClasses)),
+	mAncestors(std::move(other.mAncestors)),
+	mDescendants(std::move(other.mDescendants)),
 	mName(std::move(other.mName)),
 	mProperties(std::move(other.mProperties))
 {
@@ -49,44 +70,55 @@ CE::MetaType::~MetaType() = default;
 
 bool CE::MetaType::IsDerivedFrom(const TypeId baseClassTypeId) const
 {
-	if (GetTypeId() == baseClassTypeId)
-	{
-		return true;
-	}
+	return GetTypeId() == baseClassTypeId
+		|| std::binary_search(mAncestors.begin(), mAncestors.end(), baseClassTypeId);
+}
 
-	for (const MetaType& base : mDirectBaseClasses)
-	{
-		if (base.IsDerivedFrom(baseClassTypeId))
-		{
-			return true;
-		}
-	}
+bool CE::MetaType::IsBaseClassOf(const TypeId derivedClassTypeId) const
+{
+	return GetTypeId() == derivedClassTypeId
+		|| std::binary_search(mDescendants.begin(), mDescendants.end(), derivedClassTypeId);
+}
 
-	return false;
+void CE::MetaType::AddBaseClass(const MetaType& baseClass)
+{
+	mDirectBaseClasses.push_back(baseClass);
+	baseClass.mDirectDerivedClasses.push_back(*this);
+
+	std::vector<TypeId> ancestors = baseClass.mAncestors;
+	ancestors.insert(std::upper_bound(ancestors.begin(), ancestors.end(), baseClass.GetTypeId()), baseClass.GetTypeId());
+	AddAncestors(ancestors);
+
+	std::vector<TypeId> descendants = mDescendants;
+	descendants.insert(std::upper_bound(descendants.begin(), descendants.end(), GetTypeId()), GetTypeId());
+	baseClass.AddDescendants(descendants);
 }
 
-bool CE::MetaType::IsBaseClassOf(const TypeId derivedClassTypeId) const
+void CE::MetaType::AddAncestors(const std::vector<TypeId>& ancestors) const
 {
-	if (GetTypeId() == derivedClassTypeId)
+	// If we already had them, so does everything that derives from us
+	if (!MergeSortedTypeIds(mAncestors, ancestors))
 	{
-		return true;
+		return;
 	}
 
-	for (const MetaType& child : mDirectDerivedClasses)
+	for (const MetaType& derived : mDirectDerivedClasses)
 	{
-		if (child.IsBaseClassOf(derivedClassTypeId))
-		{
-			return true;
-		}
+		derived.AddAncestors(ancestors);
 	}
-
-	return false;
 }
 
-void CE::MetaType::AddBaseClass(const MetaType& baseClass)
+void CE::MetaType::AddDescendants(const std::vector<TypeId>& descendants) const
 {
-	mDirectBaseClasses.push_back(baseClass);
-	baseClass.mDirectDerivedClasses.push_back(*this);
+	if (!MergeSortedTypeIds(mDescendants, descendants))
+	{
+		return;
+	}
+
+	for (const MetaType& base : mDirectBaseClasses)
+	{
+		base.AddDescendants(descendants);
+	}
 }
 
 size_t CE::MetaType::RemoveFunc(const std::variant<Name, OperatorType>& nameOrType)
@@ -66,3 +66,10 @@ void DXResource::Update(const ComPtr<ID3D12GraphicsCommandList>& list, D3D12_SUB
 	UpdateSubresources(list.Get(), mResource.Get(), mUploadBuffers[currentSubresource]->mResource.Get(), 0, currentSubresource, totalSubresources, &data);
 	ChangeState(list, dstState);
 }
+
+void DXResource::Update(const ComPtr<ID3D12GraphicsCommandList>& list, const std::vector<D3D12_SUBRESOURCE_DATA>& data, D3D12_RESOURCE_STATES dstState)
+{
+	ChangeState(list, D3D12_RESOURCE_STATE_COPY_DEST);
+	UpdateSubresources(list.Get(), mResource.Get(), mUploadBuffers[0]->mResource.Get(), 0, 0, static_cast<UINT>(data.size()), data.data());
+	ChangeState(list, dstState);
+}
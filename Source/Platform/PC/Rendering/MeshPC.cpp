@@ -161,6 +161,22 @@ CE::StaticMesh::StaticMesh(AssetLoadInfo& loadInfo) :
 
 CE::StaticMesh::StaticMesh(StaticMesh&& other) noexcept = default;
 
+size_t CE::StaticMesh::GetMemoryUsage() const
+{
+    size_t memoryUsage = Asset::GetMemoryUsage()
+        + mImpl->mVertexBufferView.SizeInBytes
+        + mImpl->mNormalBufferView.SizeInBytes
+        + mImpl->mTexCoordBufferView.SizeInBytes
+        + mImpl->mTangentBufferView.SizeInBytes
+        + mImpl->mIndexBufferView.SizeInBytes;
+
+#ifdef EDITOR
+    memoryUsage += mCPUVertexBuffer.capacity() * sizeof(glm::vec3) + mCPUIndexBuffer.capacity() * sizeof(uint32);
+#endif // EDITOR
+
+    return memoryUsage;
+}
+
 void CE::StaticMesh::DrawMesh() const
 {
     if (mImpl->mVertexBuffer == nullptr)
@@ -213,6 +213,29 @@ CE::SkinnedMesh::SkinnedMesh(AssetLoadInfo& loadInfo) :
 
 CE::SkinnedMesh::SkinnedMesh(SkinnedMesh&& other) noexcept = default;
 
+size_t CE::SkinnedMesh::GetMemoryUsage() const
+{
+    size_t memoryUsage = Asset::GetMemoryUsage()
+        + mImpl->mVertexBufferView.SizeInBytes
+        + mImpl->mNormalBufferView.SizeInBytes
+        + mImpl->mTexCoordBufferView.SizeInBytes
+        + mImpl->mTangentBufferView.SizeInBytes
+        + mImpl->mBoneIdBufferView.SizeInBytes
+        + mImpl->mBoneWeightBufferView.SizeInBytes
+        + mImpl->mIndexBufferView.SizeInBytes;
+
+    for (const auto& [name, boneInfo] : mBoneInfoMap)
+    {
+        memoryUsage += sizeof(boneInfo) + name.capacity();
+    }
+
+#ifdef EDITOR
+    memoryUsage += mCPUVertexBuffer.capacity() * sizeof(glm::vec3) + mCPUIndexBuffer.capacity() * sizeof(uint32);
+#endif // EDITOR
+
+    return memoryUsage;
+}
+
 void CE::SkinnedMesh::DrawMesh() const
 {
     if (mImpl->mVertexBuffer == nullptr)
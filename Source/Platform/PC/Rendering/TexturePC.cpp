@@ -10,6 +10,7 @@
 #include "Platform/PC/Rendering/DX12Classes/DXHeapHandle.h"
 #include "Utilities/StringFunctions.h"
 #include "Assets/Core/AssetLoadInfo.h"
+#include "Assets/Core/AssetSaveInfo.h"
 #include "Utilities/Reflect/ReflectAssetType.h"
 #include "Core/Device.h"
 #include "Rendering/FrameBuffer.h"
@@ -36,20 +37,66 @@ CE::Texture::Texture(std::string_view name, FrameBuffer&& frameBuffer) :
 CE::Texture::Texture(AssetLoadInfo& loadInfo) :
 	Asset(loadInfo),
 	mImpl(new DXImpl()),
-	mLoadedPixels(std::make_shared<STBIPixels>()),
-	mLoadingThread([loadInfoMoved = std::make_shared<AssetLoadInfo>(std::move(loadInfo)), buffer = mLoadedPixels]
-		{
-			const std::string data = StringFunctions::StreamToString(loadInfoMoved->GetStream());
-			int channels{};
-			buffer->mPixels = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(data.data()), static_cast<int>(data.size()), &buffer->mWidth, &buffer->mHeight, &channels, 4);
-		})
+	mLoadedPixels(std::make_shared<LoadedPixels>())
 {
+	const std::shared_ptr<AssetLoadInfo> file = std::make_shared<AssetLoadInfo>(std::move(loadInfo));
+
+	if (file->GetMetaData().GetAssetVersion() == 0)
+	{
+		// Stored as a PNG, which is decoded on another thread
+		mLoadingThread = ASyncThread{ [file, buffer = mLoadedPixels]
+			{
+				const Span<const std::byte> data = file->GetRemainingBytes();
+				int channels{};
+				buffer->mDecodedPixels = stbi_load_from_memory(reinterpret_cast<const unsigned char*>(data.data()), static_cast<int>(data.size()), &buffer->mWidth, &buffer->mHeight, &channels, 4);
+				buffer->mPixels = buffer->mDecodedPixels;
+			} };
+		return;
+	}
+
+	std::istream& str = file->GetStream();
+
+	uint32 width{};
+	uint32 height{};
+	uint32 numOfMips{};
+	str.read(reinterpret_cast<char*>(&width), sizeof(width));
+	str.read(reinterpret_cast<char*>(&height), sizeof(height));
+	str.read(reinterpret_cast<char*>(&numOfMips), sizeof(numOfMips));
+
+	// Outside of the editor, the pixels are not copied, they are uploaded straight from the memory mapped file
+	const Span<const std::byte> pixels = file->GetRemainingBytes();
+
+	if (width == 0
+		|| height == 0
+		|| numOfMips == 0
+		|| numOfMips > GetNumOfMips(width, height)
+		|| pixels.size() < GetSizeOfMipChain(width, height, numOfMips))
+	{
+		LOG(LogAssets, Error, "Texture {} is corrupt, {}x{} with {} mips does not fit in {} bytes", GetName(), width, height, numOfMips, pixels.size());
+		return;
+	}
+
+	mWidth = width;
+	mHeight = height;
+
+	mLoadedPixels->mWidth = static_cast<int>(width);
+	mLoadedPixels->mHeight = static_cast<int>(height);
+	mLoadedPixels->mNumOfMips = numOfMips;
+
+#ifdef EDITOR
+	const unsigned char* const mipChain = reinterpret_cast<const unsigned char*>(pixels.data());
+	mLoadedPixels->mCopiedPixels.assign(mipChain, mipChain + GetSizeOfMipChain(width, height, numOfMips));
+	mLoadedPixels->mPixels = mLoadedPixels->mCopiedPixels.data();
+#else
+	mLoadedPixels->mPixels = reinterpret_cast<const unsigned char*>(pixels.data());
+	mLoadedPixels->mFile = file;
+#endif // EDITOR
 }
 
 CE::Texture::Texture(std::string_view name, uint32_t width, uint32_t height, const unsigned char* pixels) :
 	Asset(name, MakeTypeId<Texture>()),
 	mImpl(new DXImpl()),
-	mLoadedPixels(std::make_shared<STBIPixels>())
+	mLoadedPixels(std::make_shared<LoadedPixels>())
 {
 	mWidth = width;
 	mHeight = height;
@@ -144,6 +191,104 @@ CE::Texture::~Texture()
 	}
 }
 
+bool CE::Texture::WriteMipChain(AssetSaveInfo& saveInfo, const Span<const unsigned char> rgbaPixels, const uint32 width, const uint32 height)
+{
+	if (width == 0
+		|| height == 0)
+	{
+		LOG(LogAssets, Error, "Saving texture failed: invalid dimensions ({}x{})", width, height);
+		return false;
+	}
+
+	if (rgbaPixels.size() != static_cast<size_t>(width) * height * 4)
+	{
+		LOG(LogAssets, Error, "Saving texture failed: wrong number of bytes, received {} but expected {} (RGBA) bytes",
+			rgbaPixels.size(),
+			static_cast<size_t>(width) * height * 4);
+		return false;
+	}
+
+	const uint32 numOfMips = GetNumOfMips(width, height);
+
+	std::ostream& str = saveInfo.GetStream();
+	str.write(reinterpret_cast<const char*>(&width), sizeof(width));
+	str.write(reinterpret_cast<const char*>(&height), sizeof(height));
+	str.write(reinterpret_cast<const char*>(&numOfMips), sizeof(numOfMips));
+	str.write(reinterpret_cast<const char*>(rgbaPixels.data()), rgbaPixels.size());
+
+	std::vector<unsigned char> previousMip{ rgbaPixels.begin(), rgbaPixels.end() };
+	std::vector<unsigned char> currentMip{};
+
+	uint32 previousWidth = width;
+	uint32 previousHeight = height;
+
+	for (uint32 mip = 1; mip < numOfMips; mip++)
+	{
+		const uint32 currentWidth = std::max(previousWidth / 2, 1u);
+		const uint32 currentHeight = std::max(previousHeight / 2, 1u);
+
+		currentMip.resize(static_cast<size_t>(currentWidth) * currentHeight * 4);
+
+		// A box filter, the last row or column of a mip with an odd size is sampled twice
+		for (uint32 y = 0; y < currentHeight; y++)
+		{
+			const uint32 y0 = std::min(y * 2, previousHeight - 1);
+			const uint32 y1 = std::min(y * 2 + 1, previousHeight - 1);
+
+			for (uint32 x = 0; x < currentWidth; x++)
+			{
+				const uint32 x0 = std::min(x * 2, previousWidth - 1);
+				const uint32 x1 = std::min(x * 2 + 1, previousWidth - 1);
+
+				for (uint32 channel = 0; channel < 4; channel++)
+				{
+					const auto sample = [&](const uint32 sampleX, const uint32 sampleY)
+						{
+							return static_cast<uint32>(previousMip[(static_cast<size_t>(sampleY) * previousWidth + sampleX) * 4 + channel]);
+						};
+
+					const uint32 sum = sample(x0, y0) + sample(x1, y0) + sample(x0, y1) + sample(x1, y1);
+					currentMip[(static_cast<size_t>(y) * currentWidth + x) * 4 + channel] = static_cast<unsigned char>((sum + 2) / 4);
+				}
+			}
+		}
+
+		str.write(reinterpret_cast<const char*>(currentMip.data()), currentMip.size());
+
+		std::swap(previousMip, currentMip);
+		previousWidth = currentWidth;
+		previousHeight = currentHeight;
+	}
+
+	return true;
+}
+
+uint32 CE::Texture::GetNumOfMips(const uint32 width, const uint32 height)
+{
+	uint32 numOfMips = 1;
+
+	for (uint32 size = std::max(width, height); size > 1; size /= 2)
+	{
+		numOfMips++;
+	}
+
+	return numOfMips;
+}
+
+size_t CE::Texture::GetSizeOfMipChain(uint32 width, uint32 height, const uint32 numOfMips)
+{
+	size_t size{};
+
+	for (uint32 mip = 0; mip < numOfMips; mip++)
+	{
+		size += static_cast<size_t>(width) * height * 4;
+		width = std::max(width / 2, 1u);
+		height = std::max(height / 2, 1u);
+	}
+
+	return size;
+}
+
 bool CE::Texture::IsReadyToBeSentToGpu() const
 {
 	return !mImpl->mHeapSlot.has_value()
@@ -156,10 +301,84 @@ bool CE::Texture::WasSendToGPU() const
 	return mImpl->mHeapSlot.has_value();
 }
 
+bool CE::Texture::WaitForPixels() const
+{
+	Texture& self = const_cast<Texture&>(*this);
+
+	if (self.mLoadingThread.WasLaunched())
+	{
+		self.mLoadingThread.Join();
+	}
+
+	if (!IsReadyToBeSentToGpu())
+	{
+		return false;
+	}
+
+	// Only known once the PNG has been decoded
+	self.mWidth = static_cast<uint32_t>(mLoadedPixels->mWidth);
+	self.mHeight = static_cast<uint32_t>(mLoadedPixels->mHeight);
+	return true;
+}
+
+CE::Span<const unsigned char> CE::Texture::GetPixels() const
+{
+	if (!IsReadyToBeSentToGpu())
+	{
+		return {};
+	}
+
+	return { mLoadedPixels->mPixels, static_cast<size_t>(mLoadedPixels->mWidth) * mLoadedPixels->mHeight * 4 };
+}
+
+CE::Span<const unsigned char> CE::Texture::GetPixelsOfAllMips() const
+{
+	if (!IsReadyToBeSentToGpu())
+	{
+		return {};
+	}
+
+	return { mLoadedPixels->mPixels, GetSizeOfMipChain(static_cast<uint32>(mLoadedPixels->mWidth), static_cast<uint32>(mLoadedPixels->mHeight), mLoadedPixels->mNumOfMips) };
+}
+
+size_t CE::Texture::GetMemoryUsage() const
+{
+	size_t memoryUsage = Asset::GetMemoryUsage();
+
+	if (mImpl->mTextureBuffer != nullptr)
+	{
+		const CD3DX12_RESOURCE_DESC desc = mImpl->mTextureBuffer->GetDesc();
+		const size_t sizeOfLargestMip = static_cast<size_t>(desc.Width) * desc.Height * 4;
+
+		// Each mip is a quarter of the size of the previous one
+		memoryUsage += desc.MipLevels > 1 ? sizeOfLargestMip * 4 / 3 : sizeOfLargestMip;
+	}
+
+	// Pixels that are memory mapped are not counted, they are paged out as needed
+	if (IsReadyToBeSentToGpu()
+		&& mLoadedPixels->mDecodedPixels != nullptr)
+	{
+		memoryUsage += static_cast<size_t>(mLoadedPixels->mWidth) * mLoadedPixels->mHeight * 4;
+	}
+
+#ifdef EDITOR
+	if (IsReadyToBeSentToGpu())
+	{
+		memoryUsage += mLoadedPixels->mCopiedPixels.capacity();
+	}
+#endif // EDITOR
+
+	return memoryUsage;
+}
+
 void CE::Texture::SendToGPU() const
 {
 	Texture& self = const_cast<Texture&>(*this);
-	self.mLoadingThread.Join();
+
+	if (self.mLoadingThread.WasLaunched())
+	{
+		self.mLoadingThread.Join();
+	}
 
 	if (!IsReadyToBeSentToGpu())
 	{
@@ -184,6 +403,10 @@ void CE::Texture::SendToGPU() const
 
 	engineDevice.StartUploadCommands();
 
+	// Textures stored as a PNG only contain the largest mip, the others are generated on the GPU
+	const bool hasPrecomputedMips = mLoadedPixels->mNumOfMips > 1;
+	const uint32 numOfUploadedMips = mLoadedPixels->mNumOfMips;
+
 	DXGI_FORMAT dxgiformat = (DXGI_FORMAT)DXGI_FORMAT_R8G8B8A8_UNORM;
 	CD3DX12_RESOURCE_DESC resourceDescription = {};
 	resourceDescription.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
@@ -191,18 +414,18 @@ void CE::Texture::SendToGPU() const
 	resourceDescription.Width = mLoadedPixels->mWidth;
 	resourceDescription.Height = mLoadedPixels->mHeight;
 	resourceDescription.DepthOrArraySize = 1;
-	resourceDescription.MipLevels = resourceDescription.Width <=5 ? 1 :4;
+	resourceDescription.MipLevels = hasPrecomputedMips ? static_cast<UINT16>(numOfUploadedMips) : (resourceDescription.Width <=5 ? 1 :4);
 	resourceDescription.Format = dxgiformat;
 	resourceDescription.SampleDesc.Count = 1;
 	resourceDescription.SampleDesc.Quality = 0;
 	resourceDescription.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-	resourceDescription.Flags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+	resourceDescription.Flags = hasPrecomputedMips ? D3D12_RESOURCE_FLAG_NONE : D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
 
 	CD3DX12_HEAP_PROPERTIES heapProperties = CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT);
 	self.mImpl->mTextureBuffer = std::make_unique<DXResource>(device, heapProperties, resourceDescription, nullptr, "Texture Buffer Resource Heap");
 
 	UINT64 textureUploadBufferSize;
-	device->GetCopyableFootprints(&resourceDescription, 0, 1, 0, nullptr, nullptr, nullptr, &textureUploadBufferSize);
+	device->GetCopyableFootprints(&resourceDescription, 0, numOfUploadedMips, 0, nullptr, nullptr, nullptr, &textureUploadBufferSize);
 
 	const int bitsPerPixel = [&resourceDescription]
 		{
@@ -233,15 +456,26 @@ void CE::Texture::SendToGPU() const
 			}
 		}();
 
-	int bytesPerRow = (mLoadedPixels->mWidth * bitsPerPixel) / 8; // number of bytes in each row of the image data
+	std::vector<D3D12_SUBRESOURCE_DATA> textureData(numOfUploadedMips);
+	const unsigned char* mipPixels = mLoadedPixels->mPixels;
+	uint32 mipWidth = static_cast<uint32>(mLoadedPixels->mWidth);
+	uint32 mipHeight = static_cast<uint32>(mLoadedPixels->mHeight);
 
-	D3D12_SUBRESOURCE_DATA textureData = {};
-	textureData.pData = mLoadedPixels->mPixels; // pointer to our image data
-	textureData.RowPitch = bytesPerRow; // size of all our triangle vertex data
-	textureData.SlicePitch = bytesPerRow * resourceDescription.Height; // also the size of our triangle vertex data
+	for (D3D12_SUBRESOURCE_DATA& mipData : textureData)
+	{
+		const LONG_PTR bytesPerRow = (mipWidth * bitsPerPixel) / 8; // number of bytes in each row of the image data
+
+		mipData.pData = mipPixels;
+		mipData.RowPitch = bytesPerRow;
+		mipData.SlicePitch = bytesPerRow * mipHeight;
+
+		mipPixels += mipData.SlicePitch;
+		mipWidth = std::max(mipWidth / 2, 1u);
+		mipHeight = std::max(mipHeight / 2, 1u);
+	}
 
 	mImpl->mTextureBuffer->CreateUploadBuffer(device, static_cast<int>(textureUploadBufferSize), 0);
-	mImpl->mTextureBuffer->Update(uploadCmdList, textureData, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE, 0, 1);
+	mImpl->mTextureBuffer->Update(uploadCmdList, textureData, D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE);
 
 	D3D12_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
 	srvDesc.Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING;
@@ -251,7 +485,7 @@ void CE::Texture::SendToGPU() const
 	srvDesc.ViewDimension = D3D12_SRV_DIMENSION_TEXTURE2D;
 	self.mImpl->mHeapSlot = engineDevice.GetDescriptorHeap(RESOURCE_HEAP)->AllocateResource(mImpl->mTextureBuffer.get(), &srvDesc);
 
-	for (int i = 1; i < resourceDescription.MipLevels; i++)
+	for (int i = 1; i < resourceDescription.MipLevels && !hasPrecomputedMips; i++)
 	{
 		D3D12_UNORDERED_ACCESS_VIEW_DESC uavDesc = {};
 		uavDesc.ViewDimension = D3D12_UAV_DIMENSION_TEXTURE2D;
@@ -262,7 +496,10 @@ void CE::Texture::SendToGPU() const
 		self.mImpl->mUAVslots[i-1] = engineDevice.GetDescriptorHeap(RESOURCE_HEAP)->AllocateUAV(mImpl->mTextureBuffer.get(), &uavDesc);
 	}
 
-	GenerateMipmaps();
+	if (!hasPrecomputedMips)
+	{
+		GenerateMipmaps();
+	}
 
 	for (int i = 0; i < 3; i++)
 	{
@@ -405,7 +642,7 @@ void CE::Texture::DXImplDeleter::operator()(DXImpl* impl) const
 	delete impl;
 }
 
-CE::Texture::STBIPixels::~STBIPixels()
+CE::Texture::LoadedPixels::~LoadedPixels()
 {
-	stbi_image_free(mPixels);
+	stbi_image_free(mDecodedPixels);
 }
@@ -0,0 +1,682 @@
+#include "Precomp.h"
+#include "Scripting/ScriptBytecode.h"
+
+#include "Meta/MetaType.h"
+#include "Meta/MetaFunc.h"
+#include "Meta/MetaField.h"
+#include "Scripting/ScriptFunc.h"
+#include "Scripting/ScriptNode.h"
+#include "Scripting/ScriptTools.h"
+#include "Scripting/Nodes/MetaFuncScriptNode.h"
+#include "Scripting/Nodes/MetaFieldScriptNode.h"
+#include "Scripting/Nodes/ControlScriptNodes.h"
+#include "Scripting/Nodes/EntryAndReturnScriptNode.h"
+
+namespace
+{
+	using namespace CE;
+
+	using OpCode = ScriptBytecode::OpCode;
+	using Instruction = ScriptBytecode::Instruction;
+	using Operand = ScriptBytecode::Operand;
+	static constexpr uint32 sNone = ScriptBytecode::sNone;
+
+	class Compiler
+	{
+	public:
+		Compiler(const ScriptFunc& func, ScriptBytecode& bytecode);
+
+		void CompileFunction();
+
+	private:
+		uint32 GetPC() const { return static_cast<uint32>(mBytecode.mInstructions.size()); }
+
+		uint32 Emit(OpCode opCode, uint32 a = sNone, uint32 b = sNone, uint32 c = sNone);
+		void EmitThrow(ScriptError&& error);
+
+		uint32 AddError(ScriptError&& error);
+		uint32 GetSlot(const ScriptPin& outputPin);
+
+		// Compiles the nodes that are executed after this output flow pin, until the flow
+		// ends or reaches a node that was already compiled.
+		void CompileFlow(const ScriptPin* outputFlowPin);
+
+		// Jumps to whichever node this output flow pin leads to. The jump is patched once that node is compiled.
+		void EmitJumpToFlow(const ScriptPin& outputFlowPin);
+		void CompilePendingFlows();
+
+		void CompileForLoop(const ScriptNode& node);
+		void CompileWhileLoop(const ScriptNode& node);
+		void CompileReturn(const ScriptNode& node);
+		void CompileImpureNode(const ScriptNode& node);
+
+		// Pure nodes are only scheduled once per group. Every impure node,
+		// control node or return node starts a new group.
+		void BeginGroup() { ++mCurrentGroup; }
+
+		// Schedules the pure nodes that need to run to compute the input
+		void ScheduleInput(const ScriptPin& inputPin);
+		void SchedulePureNode(const ScriptNode& node);
+
+		uint32 AddCall(const ScriptNode& node);
+		uint32 AddOperand(const ScriptPin& inputPin, bool canParameterBeNull = true);
+
+		const ScriptPin& SkipReroutes(const ScriptPin& inputPin) const;
+
+		uint32 AddLoop(const ScriptNode& node);
+		uint32& GetLabel(const ScriptPin& inputFlowPin) { return mLabels[inputFlowPin.GetId().Get() - 1]; }
+
+		const ScriptFunc& mFunc;
+		ScriptBytecode& mBytecode;
+
+		// Indexed by PinId - 1
+		std::vector<uint32> mSlotOfPin{};
+		std::vector<uint32> mLabels{};
+
+		// Indexed by NodeId - 1
+		std::vector<uint32> mGroupNodeWasScheduledIn{};
+		std::vector<bool> mIsBeingScheduled{};
+		uint32 mCurrentGroup{};
+
+		struct PendingFlow
+		{
+			std::reference_wrapper<const ScriptPin> mOutputFlowPin;
+			uint32 mJump{};
+		};
+		std::vector<PendingFlow> mPendingFlows{};
+	};
+}
+
+CE::ScriptBytecode CE::ScriptBytecode::Compile(const ScriptFunc& func)
+{
+	ScriptBytecode bytecode{};
+	Compiler{ func, bytecode }.CompileFunction();
+	return bytecode;
+}
+
+Compiler::Compiler(const ScriptFunc& func, ScriptBytecode& bytecode) :
+	mFunc(func),
+	mBytecode(bytecode),
+	mSlotOfPin(func.GetNumOfPinsIncludingRemoved(), sNone),
+	mLabels(func.GetNumOfPinsIncludingRemoved(), sNone),
+	mGroupNodeWasScheduledIn(func.GetNumOfNodesIncludingRemoved(), sNone),
+	mIsBeingScheduled(func.GetNumOfNodesIncludingRemoved())
+{
+}
+
+void Compiler::CompileFunction()
+{
+	Expected<std::reference_wrapper<const ScriptNode>, std::string> firstNode = mFunc.GetFirstNode();
+	Expected<const FunctionEntryScriptNode*, std::string> entryNode = mFunc.GetEntryNode();
+
+	if (firstNode.HasError()
+		|| entryNode.HasError())
+	{
+		EmitThrow({ ScriptError::NotPossibleToEnterFunc, { mFunc }, firstNode.HasError() ? firstNode.GetError() : entryNode.GetError() });
+		return;
+	}
+
+	if (entryNode.GetValue() != nullptr)
+	{
+		for (const ScriptPin& pin : entryNode.GetValue()->GetOutputs(mFunc))
+		{
+			if (!pin.IsFlow())
+			{
+				mBytecode.mParameterSlots.emplace_back(GetSlot(pin));
+			}
+		}
+	}
+
+	const ScriptNode& node = firstNode.GetValue();
+
+	if (node.GetType() == ScriptNodeType::FunctionEntry)
+	{
+		const Span<const ScriptPin> outputs = node.GetOutputs(mFunc);
+
+		if (outputs.empty()
+			|| !outputs[0].IsFlow())
+		{
+			EmitThrow({ ScriptError::CompilerBug, { mFunc, node }, "Entry node has no output flow pin" });
+			return;
+		}
+
+		CompileFlow(&outputs[0]);
+	}
+	else
+	{
+		CompileReturn(node);
+	}
+
+	CompilePendingFlows();
+}
+
+uint32 Compiler::Emit(const OpCode opCode, const uint32 a, const uint32 b, const uint32 c)
+{
+	mBytecode.mInstructions.emplace_back(Instruction{ opCode, a, b, c });
+	return GetPC() - 1;
+}
+
+void Compiler::EmitThrow(ScriptError&& error)
+{
+	Emit(OpCode::Throw, AddError(std::move(error)));
+}
+
+uint32 Compiler::AddError(ScriptError&& error)
+{
+	mBytecode.mErrors.emplace_back(std::move(error));
+	return static_cast<uint32>(mBytecode.mErrors.size() - 1);
+}
+
+uint32 Compiler::GetSlot(const ScriptPin& outputPin)
+{
+	ASSERT(outputPin.IsOutput() && !outputPin.IsFlow());
+
+	uint32& slotIndex = mSlotOfPin[outputPin.GetId().Get() - 1];
+
+	if (slotIndex != sNone)
+	{
+		return slotIndex;
+	}
+
+	slotIndex = static_cast<uint32>(mBytecode.mSlots.size());
+	ScriptBytecode::Slot& slot = mBytecode.mSlots.emplace_back();
+	slot.mType = outputPin.TryGetType();
+
+	// Compilation errors are checked before we compile to bytecode
+	ASSERT(slot.mType != nullptr);
+
+	if (outputPin.GetTypeForm() != TypeForm::Value
+		&& outputPin.GetTypeForm() != TypeForm::RValue)
+	{
+		return slotIndex;
+	}
+
+	const TypeInfo typeInfo = slot.mType->GetTypeInfo();
+	const uint32 alignment = std::max(typeInfo.GetAlign(), 1u);
+
+	slot.mOffset = (mBytecode.mFrameSize + alignment - 1) / alignment * alignment;
+	slot.mNeedsToBeDestructed = (typeInfo.mFlags & TypeInfo::IsTriviallyDestructible) == 0;
+
+	mBytecode.mFrameSize = slot.mOffset + typeInfo.GetSize();
+	mBytecode.mFrameAlignment = std::max(mBytecode.mFrameAlignment, alignment);
+
+	return slotIndex;
+}
+
+void Compiler::CompileFlow(const ScriptPin* outputFlowPin)
+{
+	while (true)
+	{
+		ASSERT(outputFlowPin->IsOutput() && outputFlowPin->IsFlow());
+
+		if (!outputFlowPin->IsLinked())
+		{
+			Emit(OpCode::FallBack);
+			return;
+		}
+
+		const ScriptPin& inputFlowPin = mFunc.GetPin(outputFlowPin->GetCachedPinWeAreLinkedWith());
+
+		if (GetLabel(inputFlowPin) != sNone)
+		{
+			Emit(OpCode::Jump, GetLabel(inputFlowPin));
+			return;
+		}
+
+		const ScriptNode& node = mFunc.GetNode(inputFlowPin.GetNodeId());
+		const Span<const ScriptPin> outputs = node.GetOutputs(mFunc);
+
+		if (node.GetType() == ScriptNodeType::ForLoop
+			|| node.GetType() == ScriptNodeType::WhileLoop)
+		{
+			// The loop is compiled as a whole, but it may have been entered through the break pin
+			const bool isEntry = &inputFlowPin == &node.GetInputs(mFunc)[0];
+			const uint32 jumpToBreak = isEntry ? sNone : Emit(OpCode::Jump);
+
+			if (node.GetType() == ScriptNodeType::ForLoop)
+			{
+				CompileForLoop(node);
+			}
+			else
+			{
+				CompileWhileLoop(node);
+			}
+
+			if (jumpToBreak != sNone)
+			{
+				mBytecode.mInstructions[jumpToBreak].mA = GetLabel(inputFlowPin);
+			}
+			return;
+		}
+
+		GetLabel(inputFlowPin) = GetPC();
+
+		switch (node.GetType())
+		{
+		case ScriptNodeType::Rerout:
+		{
+			outputFlowPin = &outputs[0];
+			break;
+		}
+		case ScriptNodeType::Branch:
+		{
+			const ScriptPin& conditionPin = node.GetInputs(mFunc)[BranchScriptNode::sIndexOfConditionPin];
+
+			BeginGroup();
+			ScheduleInput(conditionPin);
+			const uint32 jumpIfFalse = Emit(OpCode::JumpIfFalse, AddOperand(conditionPin));
+
+			// The else branch is compiled later, the if branch directly follows the jump
+			mPendingFlows.emplace_back(PendingFlow{ outputs[BranchScriptNode::sIndexOfElsePin], jumpIfFalse });
+			outputFlowPin = &outputs[BranchScriptNode::sIndexOfIfPin];
+			break;
+		}
+		case ScriptNodeType::FunctionReturn:
+		{
+			CompileReturn(node);
+			return;
+		}
+		case ScriptNodeType::FunctionCall:
+		case ScriptNodeType::Getter:
+		case ScriptNodeType::Setter:
+		{
+			if (node.IsPure(mFunc))
+			{
+				EmitThrow({ ScriptError::CompilerBug, { mFunc, node }, "Pure node was linked to flow" });
+				return;
+			}
+
+			CompileImpureNode(node);
+			outputFlowPin = &outputs[0];
+			break;
+		}
+		default:
+		{
+			EmitThrow({ ScriptError::CompilerBug, { mFunc, node }, "Node cannot be executed" });
+			return;
+		}
+		}
+	}
+}
+
+void Compiler::EmitJumpToFlow(const ScriptPin& outputFlowPin)
+{
+	mPendingFlows.emplace_back(PendingFlow{ outputFlowPin, Emit(OpCode::Jump) });
+}
+
+void Compiler::CompilePendingFlows()
+{
+	while (!mPendingFlows.empty())
+	{
+		const PendingFlow pending = mPendingFlows.back();
+		mPendingFlows.pop_back();
+
+		Instruction& jump = mBytecode.mInstructions[pending.mJump];
+		uint32& target = jump.mOpCode == OpCode::JumpIfFalse ? jump.mB : jump.mA;
+
+		const ScriptPin& outputFlowPin = pending.mOutputFlowPin;
+
+		// Jump straight to the node if it was already compiled
+		if (outputFlowPin.IsLinked())
+		{
+			const uint32 label = GetLabel(mFunc.GetPin(outputFlowPin.GetCachedPinWeAreLinkedWith()));
+
+			if (label != sNone)
+			{
+				target = label;
+				continue;
+			}
+		}
+
+		// An unconditional jump to the next instruction can be removed entirely
+		if (jump.mOpCode == OpCode::Jump
+			&& pending.mJump == GetPC() - 1)
+		{
+			mBytecode.mInstructions.pop_back();
+		}
+		else
+		{
+			target = GetPC();
+		}
+
+		CompileFlow(&outputFlowPin);
+	}
+}
+
+void Compiler::CompileForLoop(const ScriptNode& node)
+{
+	const Span<const ScriptPin> inputs = node.GetInputs(mFunc);
+	const Span<const ScriptPin> outputs = node.GetOutputs(mFunc);
+
+	const ScriptPin& startPin = inputs[ForLoopScriptNode::sIndexOfStartPin];
+	const ScriptPin& endPin = inputs[ForLoopScriptNode::sIndexOfEndPin];
+
+	const uint32 loop = AddLoop(node);
+	const uint32 indexSlot = GetSlot(outputs[ForLoopScriptNode::sIndexOfIndexPin]);
+
+	// for (int i = start;
+	GetLabel(inputs[ForLoopScriptNode::sIndexOfEntryPin]) = GetPC();
+	const uint32 pushLoop = Emit(OpCode::PushLoop, loop);
+
+	BeginGroup();
+	ScheduleInput(startPin);
+	Emit(OpCode::ForInit, indexSlot, AddOperand(startPin));
+	const uint32 jumpToCondition = Emit(OpCode::Jump);
+
+	// ++i)
+	mBytecode.mInstructions[pushLoop].mB = GetPC();
+	Emit(OpCode::ForIncrement, indexSlot);
+
+	// i < end;
+	mBytecode.mInstructions[jumpToCondition].mA = GetPC();
+	BeginGroup();
+	ScheduleInput(endPin);
+	const uint32 jumpIfDone = Emit(OpCode::JumpIfForDone, indexSlot, AddOperand(endPin));
+	EmitJumpToFlow(outputs[ForLoopScriptNode::sIndexOfLoopPin]);
+
+	// Finishing the loop and breaking out of it are the same
+	GetLabel(inputs[ForLoopScriptNode::sIndexOfBreakPin]) = GetPC();
+	mBytecode.mInstructions[jumpIfDone].mC = GetPC();
+	Emit(OpCode::PopLoop, loop);
+	EmitJumpToFlow(outputs[ForLoopScriptNode::sIndexOfExitPin]);
+}
+
+void Compiler::CompileWhileLoop(const ScriptNode& node)
+{
+	const Span<const ScriptPin> inputs = node.GetInputs(mFunc);
+	const Span<const ScriptPin> outputs = node.GetOutputs(mFunc);
+
+	const ScriptPin& conditionPin = inputs[WhileLoopScriptNode::sIndexOfConditionPin];
+
+	const uint32 loop = AddLoop(node);
+
+	GetLabel(inputs[WhileLoopScriptNode::sIndexOfEntryPin]) = GetPC();
+	const uint32 pushLoop = Emit(OpCode::PushLoop, loop);
+
+	// The condition is checked again each time the body finishes
+	mBytecode.mInstructions[pushLoop].mB = GetPC();
+	BeginGroup();
+	ScheduleInput(conditionPin);
+	const uint32 jumpIfFalse = Emit(OpCode::JumpIfFalse, AddOperand(conditionPin));
+	EmitJumpToFlow(outputs[WhileLoopScriptNode::sIndexOfLoopPin]);
+
+	GetLabel(inputs[WhileLoopScriptNode::sIndexOfBreakPin]) = GetPC();
+	mBytecode.mInstructions[jumpIfFalse].mB = GetPC();
+	Emit(OpCode::PopLoop, loop);
+	EmitJumpToFlow(outputs[WhileLoopScriptNode::sIndexOfExitPin]);
+}
+
+void Compiler::CompileReturn(const ScriptNode& node)
+{
+	BeginGroup();
+
+	for (const ScriptPin& pin : node.GetInputs(mFunc))
+	{
+		if (pin.IsFlow())
+		{
+			continue;
+		}
+
+		ScheduleInput(pin);
+		Emit(OpCode::Return, AddOperand(pin));
+		return;
+	}
+
+	Emit(OpCode::Return);
+}
+
+void Compiler::CompileImpureNode(const ScriptNode& node)
+{
+	BeginGroup();
+
+	for (const ScriptPin& pin : node.GetInputs(mFunc))
+	{
+		if (!pin.IsFlow())
+		{
+			ScheduleInput(pin);
+		}
+	}
+
+	const uint32 call = AddCall(node);
+
+	if (call != sNone)
+	{
+		Emit(OpCode::Call, call);
+	}
+}
+
+void Compiler::ScheduleInput(const ScriptPin& inputPin)
+{
+	const ScriptPin& pin = SkipReroutes(inputPin);
+
+	if (!pin.IsLinked())
+	{
+		return;
+	}
+
+	const ScriptNode& node = mFunc.GetNode(mFunc.GetPin(pin.GetCachedPinWeAreLinkedWith()).GetNodeId());
+
+	// The outputs of impure nodes are never recomputed
+	if (node.IsPure(mFunc))
+	{
+		SchedulePureNode(node);
+	}
+}
+
+void Compiler::SchedulePureNode(const ScriptNode& node)
+{
+	const uint32 nodeIndex = node.GetId().Get() - 1;
+
+	if (mGroupNodeWasScheduledIn[nodeIndex] == mCurrentGroup)
+	{
+		return;
+	}
+
+	if (mIsBeingScheduled[nodeIndex])
+	{
+		EmitThrow({ ScriptError::LinkNotAllowed, { mFunc, node }, "The output of this node depends on itself" });
+		return;
+	}
+
+	mIsBeingScheduled[nodeIndex] = true;
+
+	for (const ScriptPin& pin : node.GetInputs(mFunc))
+	{
+		if (!pin.IsFlow())
+		{
+			ScheduleInput(pin);
+		}
+	}
+
+	mIsBeingScheduled[nodeIndex] = false;
+	mGroupNodeWasScheduledIn[nodeIndex] = mCurrentGroup;
+
+	const uint32 call = AddCall(node);
+
+	if (call != sNone)
+	{
+		Emit(OpCode::Call, call);
+	}
+}
+
+uint32 Compiler::AddCall(const ScriptNode& node)
+{
+	ScriptBytecode::Call call{};
+	call.mNode = &node;
+	call.mType = node.GetType();
+	call.mIsPure = node.IsPure(mFunc);
+
+	const Span<const ScriptPin> outputs = node.GetOutputs(mFunc);
+
+	if (outputs.empty())
+	{
+		EmitThrow({ ScriptError::CompilerBug, { mFunc, node }, "Node has no outputs" });
+		return sNone;
+	}
+
+	// Impure nodes have at most one output besides their flow pin
+	const ScriptPin* outputPin = &outputs[0];
+
+	if (outputPin->IsFlow())
+	{
+		outputPin = outputs.size() == 1 ? nullptr : &outputs[1];
+	}
+
+	if (outputPin != nullptr)
+	{
+		call.mOutputSlot = GetSlot(*outputPin);
+	}
+
+	const std::vector<MetaFuncNamedParam>* params{};
+
+	switch (call.mType)
+	{
+	case ScriptNodeType::FunctionCall:
+	{
+		call.mFunc = static_cast<const MetaFuncScriptNode&>(node).TryGetOriginalFunc();
+
+		if (call.mFunc == nullptr)
+		{
+			EmitThrow({ ScriptError::UnderlyingFuncNoLongerExists, { mFunc, node } });
+			return sNone;
+		}
+
+		params = &call.mFunc->GetParameters();
+		break;
+	}
+	case ScriptNodeType::Getter:
+	case ScriptNodeType::Setter:
+	{
+		call.mField = static_cast<const NodeInvolvingField&>(node).TryGetOriginalField();
+
+		if (call.mField == nullptr)
+		{
+			EmitThrow({ ScriptError::UnderlyingFuncNoLongerExists, { mFunc, node } });
+			return sNone;
+		}
+
+		if (call.mOutputSlot == sNone)
+		{
+			EmitThrow({ ScriptError::CompilerBug, { mFunc, node }, "Getting or setting a field always returns a value" });
+			return sNone;
+		}
+
+		call.mReturnsCopy = call.mType == ScriptNodeType::Getter && static_cast<const GetterScriptNode&>(node).DoesNodeReturnCopy();
+		break;
+	}
+	default:
+	{
+		EmitThrow({ ScriptError::CompilerBug, { mFunc, node }, "Node cannot be executed" });
+		return sNone;
+	}
+	}
+
+	call.mFirstOperand = static_cast<uint32>(mBytecode.mOperands.size());
+
+	for (const ScriptPin& pin : node.GetInputs(mFunc))
+	{
+		if (pin.IsFlow())
+		{
+			continue;
+		}
+
+		const bool canParameterBeNull = params == nullptr
+			|| call.mNumOfOperands >= params->size()
+			|| CanFormBeNullable((*params)[call.mNumOfOperands].mTypeTraits.mForm);
+
+		AddOperand(pin, canParameterBeNull);
+		++call.mNumOfOperands;
+	}
+
+	mBytecode.mMaxNumOfOperands = std::max(mBytecode.mMaxNumOfOperands, call.mNumOfOperands);
+
+	mBytecode.mCalls.emplace_back(call);
+	return static_cast<uint32>(mBytecode.mCalls.size() - 1);
+}
+
+uint32 Compiler::AddOperand(const ScriptPin& inputPin, const bool canParameterBeNull)
+{
+	const ScriptPin& pin = SkipReroutes(inputPin);
+
+	Operand operand{};
+	operand.mPin = pin.GetId();
+	operand.mCanPinBeNull = CanFormBeNullable(pin.GetTypeForm());
+	operand.mCanParameterBeNull = canParameterBeNull;
+
+	if (pin.IsLinked())
+	{
+		const ScriptPin& otherPin = mFunc.GetPin(pin.GetCachedPinWeAreLinkedWith());
+
+		// If the pin type is MetaAny, we accept anything.
+		// At the time of writing, this is only used for the IsNull node
+		operand.mAcceptsAny = pin.TryGetType() != nullptr && pin.TryGetType()->GetTypeId() == MakeTypeId<MetaAny>();
+
+		if (operand.mAcceptsAny
+			&& pin.GetTypeForm() == TypeForm::Value)
+		{
+			operand.mSource = Operand::Source::Error;
+			operand.mIndex = AddError({ ScriptError::TypeCannotBeOwnedByScripts, { mFunc, pin }, "Pins accepting 'MetaAny' by value is not allowed; use a reference or a const reference instead" });
+		}
+		else
+		{
+			operand.mSource = Operand::Source::Slot;
+			operand.mIndex = GetSlot(otherPin);
+		}
+	}
+	// There is no link connected to this pin, maybe we can default to 'this'?
+	else if (pin.GetTypeName() == mFunc.GetNameOfScriptAsset())
+	{
+		if (mFunc.IsStatic())
+		{
+			operand.mSource = Operand::Source::Error;
+			operand.mIndex = AddError({ ScriptError::ValueWasNull, { mFunc, pin },
+				Format("Cannot call non-static functions ({}) from static functions ({})",
+					mFunc.GetNode(pin.GetNodeId()).GetDisplayName(),
+					mFunc.GetName()) });
+		}
+		else
+		{
+			operand.mSource = Operand::Source::This;
+		}
+	}
+	else if (!DoesPinRequireLink(mFunc, pin))
+	{
+		operand.mSource = Operand::Source::Unlinked;
+	}
+	else
+	{
+		operand.mSource = Operand::Source::Error;
+		operand.mIndex = AddError({ ScriptError::ValueWasNull, { mFunc, pin }, "No link was connected to pin" });
+	}
+
+	mBytecode.mOperands.emplace_back(operand);
+	mBytecode.mOperandForms.emplace_back(inputPin.GetTypeForm());
+	return static_cast<uint32>(mBytecode.mOperands.size() - 1);
+}
+
+const CE::ScriptPin& Compiler::SkipReroutes(const ScriptPin& inputPin) const
+{
+	const ScriptPin* pin = &inputPin;
+
+	// A reroute node passes on whatever is linked to its input. The number
+	// of iterations is bounded, in case the reroute nodes form a cycle
+	for (size_t i = 0; i < mFunc.GetNumOfNodesIncludingRemoved() && pin->IsLinked(); i++)
+	{
+		const ScriptNode& otherNode = mFunc.GetNode(mFunc.GetPin(pin->GetCachedPinWeAreLinkedWith()).GetNodeId());
+
+		if (otherNode.GetType() != ScriptNodeType::Rerout)
+		{
+			break;
+		}
+
+		pin = &otherNode.GetInputs(mFunc)[0];
+	}
+
+	return *pin;
+}
+
+uint32 Compiler::AddLoop(const ScriptNode& node)
+{
+	mBytecode.mLoops.emplace_back(node);
+	return static_cast<uint32>(mBytecode.mLoops.size() - 1);
+}
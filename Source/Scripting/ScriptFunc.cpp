@@ -144,15 +144,12 @@ mNameOfScriptAsset);
 	}
 	else
 	{
-		Expected<std::reference_wrapper<const ScriptNode>, std::string> possibleFirstNode = GetFirstNode();
-		Expected<const FunctionEntryScriptNode*, std::string> possibleEntryNode = GetEntryNode();
+		ASSERT(!GetFirstNode().HasError() && "Should've been part of the compilation errors");
 
-		ASSERT(!possibleFirstNode.HasError() && "Should've been part of the compilation errors");
-
-		func.RedirectFunction([this, ourScript, firstNode = possibleFirstNode.GetValue(), entry = possibleEntryNode.GetValue()]
+		func.RedirectFunction([this, ourScript, &bytecode = VirtualMachine::Get().CompileScriptFunction(*this)]
 		(MetaFunc::DynamicArgs args, MetaFunc::RVOBuffer rvoBuffer) -> FuncResult
 			{
-				return VirtualMachine::Get().ExecuteScriptFunction(args, rvoBuffer, *this, firstNode, entry);
+				return VirtualMachine::Get().ExecuteScriptFunction(args, rvoBuffer, *this, bytecode);
 			});
 	}
 }
@@ -0,0 +1,218 @@
+#include "Precomp.h"
+#include "Scripting/ScriptProfiler.h"
+
+#include "Scripting/ScriptFunc.h"
+#include "Scripting/ScriptNode.h"
+#include "Utilities/StringFunctions.h"
+
+namespace
+{
+	// The collapsed stack format uses ';' as a separator
+	std::string MakeZoneName(std::string name)
+	{
+		std::replace(name.begin(), name.end(), ';', ':');
+		return name;
+	}
+}
+
+void CE::ScriptProfiler::SetIsEnabled(const bool isEnabled)
+{
+	if (isEnabled
+		&& !mHasMeasurements)
+	{
+		mTimeOfEnabling = std::chrono::steady_clock::now();
+	}
+
+	mIsEnabled = isEnabled;
+}
+
+void CE::ScriptProfiler::Clear()
+{
+	for (Zone& zone : mZones)
+	{
+		zone.mStats = {};
+	}
+
+	// The call tree is kept, as the zones that are still active refer to it
+	for (CallTreeNode& node : mCallTree)
+	{
+		node.mExclusiveTime = {};
+	}
+
+	mTraceEvents.clear();
+	mNumOfDroppedTraceEvents = 0;
+	mTimeOfEnabling = std::chrono::steady_clock::now();
+	mHasMeasurements = false;
+}
+
+uint32 CE::ScriptProfiler::RegisterFunction(const ScriptFunc& func)
+{
+	return RegisterZone(MakeZoneName(Format("{}::{}", func.GetNameOfScriptAsset(), func.GetName())), true);
+}
+
+uint32 CE::ScriptProfiler::RegisterNode(const ScriptFunc& func, const ScriptNode& node)
+{
+	return RegisterZone(MakeZoneName(Format("{}::{} - {} #{}", func.GetNameOfScriptAsset(), func.GetName(), node.GetDisplayName(), node.GetId().Get())), false);
+}
+
+uint32 CE::ScriptProfiler::RegisterZone(std::string&& name, const bool isFunction)
+{
+	const auto existing = mIdsByName.find(name);
+
+	if (existing != mIdsByName.end())
+	{
+		return existing->second;
+	}
+
+	const uint32 id = static_cast<uint32>(mZones.size());
+	mIdsByName.emplace(name, id);
+	mZones.emplace_back(Zone{ std::move(name), isFunction });
+	return id;
+}
+
+void CE::ScriptProfiler::BeginZone(const uint32 id)
+{
+	ASSERT(id < mZones.size());
+
+	const uint32 parent = mStack.empty() ? sNoParent : mStack.back().mCallTreeNode;
+	const uint64 key = static_cast<uint64>(parent) << 32 | id;
+
+	auto [child, wasInserted] = mCallTreeChildren.emplace(key, static_cast<uint32>(mCallTree.size()));
+
+	if (wasInserted)
+	{
+		mCallTree.emplace_back(CallTreeNode{ id, parent });
+	}
+
+	mStack.emplace_back(ActiveZone{ id, child->second, std::chrono::steady_clock::now() });
+}
+
+void CE::ScriptProfiler::EndZone()
+{
+	const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	ASSERT(!mStack.empty());
+	const ActiveZone zone = mStack.back();
+	mStack.pop_back();
+
+	const std::chrono::nanoseconds inclusiveTime = now - zone.mStart;
+	const std::chrono::nanoseconds exclusiveTime = inclusiveTime - zone.mTimeInChildren;
+
+	Stats& stats = mZones[zone.mZone].mStats;
+	++stats.mNumOfCalls;
+	stats.mInclusiveTime += inclusiveTime;
+	stats.mExclusiveTime += exclusiveTime;
+
+	mCallTree[zone.mCallTreeNode].mExclusiveTime += exclusiveTime;
+
+	if (!mStack.empty())
+	{
+		mStack.back().mTimeInChildren += inclusiveTime;
+	}
+
+	if (mTraceEvents.size() < sMaxNumOfTraceEvents)
+	{
+		mTraceEvents.emplace_back(TraceEvent{ zone.mZone, static_cast<uint32>(mStack.size()), zone.mStart - mTimeOfEnabling, inclusiveTime });
+	}
+	else
+	{
+		++mNumOfDroppedTraceEvents;
+	}
+
+	mHasMeasurements = true;
+}
+
+void CE::ScriptProfiler::ExportChromeTrace(std::ostream& stream) const
+{
+	stream << "{\"traceEvents\":[";
+
+	for (size_t i = 0; i < mTraceEvents.size(); i++)
+	{
+		const TraceEvent& event = mTraceEvents[i];
+		const Zone& zone = mZones[event.mZone];
+
+		stream << (i == 0 ? "\n" : ",\n") << "{\"name\":";
+		StringFunctions::WriteEscapedJSONString(stream, zone.mName);
+		stream << Format(",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,\"tid\":0,\"args\":{{\"depth\":{}}}}}",
+			zone.mIsFunction ? "function" : "node",
+			static_cast<double>(event.mStart.count()) * 1e-3,
+			static_cast<double>(event.mDuration.count()) * 1e-3,
+			event.mDepth);
+	}
+
+	stream << Format("\n],\"displayTimeUnit\":\"ns\",\"otherData\":{{\"droppedEvents\":{}}}}}\n", mNumOfDroppedTraceEvents);
+}
+
+void CE::ScriptProfiler::ExportCollapsedStacks(std::ostream& stream) const
+{
+	std::vector<uint32> stack{};
+	std::string line{};
+
+	for (const CallTreeNode& node : mCallTree)
+	{
+		if (node.mExclusiveTime.count() <= 0)
+		{
+			continue;
+		}
+
+		stack.clear();
+		for (const CallTreeNode* current = &node;; current = &mCallTree[current->mParent])
+		{
+			stack.emplace_back(current->mZone);
+
+			if (current->mParent == sNoParent)
+			{
+				break;
+			}
+		}
+
+		line.clear();
+		for (auto it = stack.rbegin(); it != stack.rend(); ++it)
+		{
+			if (!line.empty())
+			{
+				line += ';';
+			}
+			line += mZones[*it].mName;
+		}
+
+		stream << line << ' ' << node.mExclusiveTime.count() << '\n';
+	}
+}
+
+void CE::ScriptProfiler::PrintSummary(const uint32 maxNumOfEntries) const
+{
+	std::vector<uint32> sortedIds{};
+
+	for (uint32 id = 0; id < GetNumOfIds(); id++)
+	{
+		if (mZones[id].mStats.mNumOfCalls != 0)
+		{
+			sortedIds.emplace_back(id);
+		}
+	}
+
+	std::sort(sortedIds.begin(), sortedIds.end(),
+		[this](uint32 lhs, uint32 rhs)
+		{
+			return mZones[lhs].mStats.mExclusiveTime > mZones[rhs].mStats.mExclusiveTime;
+		});
+
+	sortedIds.resize(std::min(sortedIds.size(), static_cast<size_t>(maxNumOfEntries)));
+
+	std::string output = Format("\n{:>80} {:>10} {:>12} {:>12} {:>8}", "Name", "Calls", "Incl (ms)", "Excl (ms)", "Allocs");
+
+	for (const uint32 id : sortedIds)
+	{
+		const Zone& zone = mZones[id];
+
+		output += Format("\n{:>80} {:>10} {:>12.4f} {:>12.4f} {:>8}",
+			zone.mName,
+			zone.mStats.mNumOfCalls,
+			static_cast<double>(zone.mStats.mInclusiveTime.count()) * 1e-6,
+			static_cast<double>(zone.mStats.mExclusiveTime.count()) * 1e-6,
+			zone.mStats.mNumOfAllocations);
+	}
+
+	LOG(LogScripting, Message, output);
+}
@@ -171,12 +171,33 @@ CE::MetaType CE::NavMeshAgentSystem::Reflect()
 	return MetaType{MetaType::T<NavMeshAgentSystem>{}, "NavMeshAgentSystem", MetaType::Base<System>{}};
 }
 
-void CE::NavMeshPathingSystem::Update(World& world, float)
+CE::NavMeshPathingSystem::~NavMeshPathingSystem()
 {
-	mNumOfTicksReceived++;
+	if (mJob.IsValid())
+	{
+		mJob.Wait();
+	}
+}
 
+void CE::NavMeshPathingSystem::Update(World& world, float dt)
+{
 	Registry& registry = world.GetRegistry();
 
+	for (auto [agentId, agent] : registry.View<NavMeshAgentComponent>().each())
+	{
+		agent.mTimeSincePathWasUpdated += dt;
+	}
+
+	if (mJob.IsValid())
+	{
+		if (!mJob.IsFinished())
+		{
+			return;
+		}
+
+		ApplyFinishedRequests(registry);
+	}
+
 	const entt::entity navMeshOwner = registry.View<NavMeshComponent>().front();
 
 	if (navMeshOwner == entt::null)
@@ -184,24 +205,50 @@ void CE::NavMeshPathingSystem::Update(World& world, float)
 		return;
 	}
 
-	NavMeshComponent& navMesh = registry.Get<NavMeshComponent>(navMeshOwner);
+	const NavMeshComponent& navMesh = registry.Get<NavMeshComponent>(navMeshOwner);
 
 	if (!navMesh.WasGenerated())
 	{
 		return;
 	}
 
-	const auto agentsView = registry.View<NavMeshAgentComponent, TransformComponent>();
-	uint32 index{};
+	SubmitRequests(world, navMesh.GetSnapshot());
+}
 
-	for (auto [agentId, agent, agentTransform] : agentsView.each())
+void CE::NavMeshPathingSystem::ApplyFinishedRequests(Registry& registry)
+{
+	for (PathRequest& request : mRequests)
 	{
-		if ((mNumOfTicksReceived + index++) % sUpdateEveryNthPath
-			|| !agent.IsChasing())
+		if (!request.mWasSolved
+			|| !registry.Valid(request.mAgent))
+		{
+			continue;
+		}
+
+		NavMeshAgentComponent* const agent = registry.TryGet<NavMeshAgentComponent>(request.mAgent);
+
+		if (agent == nullptr)
 		{
 			continue;
 		}
 
+		agent->mPath = std::move(request.mResult);
+		agent->mTimeSincePathWasUpdated = 0.0f;
+	}
+
+	mRequests.clear();
+	mSnapshot.reset();
+	mJob = {};
+}
+
+void CE::NavMeshPathingSystem::SubmitRequests(World& world, std::shared_ptr<const NavMeshComponent::Snapshot> snapshot)
+{
+	ASSERT(!mJob.IsValid() && mRequests.empty());
+
+	const auto agentsView = world.GetRegistry().View<NavMeshAgentComponent, TransformComponent>();
+
+	for (auto [agentId, agent, agentTransform] : agentsView.each())
+	{
 		if (!agent.IsChasing())
 		{
 			continue;
@@ -214,8 +261,48 @@ void CE::NavMeshPathingSystem::Update(World& world, float)
 			continue;
 		}
 
-		agent.mPath = navMesh.FindQuickestPath(agentTransform.GetWorldPosition2D(), *targetPosition);
+		const glm::vec2 agentPosition = agentTransform.GetWorldPosition2D();
+
+		// Agents without a path are always handled first
+		const float priority = agent.mPath.empty() ? std::numeric_limits<float>::infinity() :
+			agent.mTimeSincePathWasUpdated / (1.0f + glm::distance(agentPosition, *targetPosition) * sPriorityFalloffPerUnitOfDistance);
+
+		mRequests.emplace_back(PathRequest{ agentId, agentPosition, *targetPosition, priority });
 	}
+
+	if (mRequests.empty())
+	{
+		return;
+	}
+
+	std::sort(mRequests.begin(), mRequests.end(),
+		[](const PathRequest& lhs, const PathRequest& rhs)
+		{
+			return lhs.mPriority > rhs.mPriority;
+		});
+
+	mSnapshot = std::move(snapshot);
+
+	mJob = JobSystem::Get().Schedule(
+		[this]
+		{
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			const std::chrono::duration<float, std::micro> budget{ sBudgetInMicroseconds };
+
+			// Batches are handed out in order, so the requests with the highest priority are started first
+			JobSystem::Get().ParallelFor(0, static_cast<uint32>(mRequests.size()),
+				[&](uint32 i)
+				{
+					if (std::chrono::steady_clock::now() - start > budget)
+					{
+						return;
+					}
+
+					PathRequest& request = mRequests[i];
+					request.mResult = mSnapshot->FindQuickestPath(request.mStart, request.mEnd);
+					request.mWasSolved = true;
+				});
+		});
 }
 
 CE::MetaType CE::NavMeshPathingSystem::Reflect()
@@ -18,6 +18,17 @@ void CE::ParticleColorSystem::Update(World& world, [[maybe_unused]] float dt)
 	}
 }
 
+CE::SystemStaticTraits CE::ParticleColorSystem::GetStaticTraits() const
+{
+	SystemStaticTraits traits{};
+	traits.mFixedTickInterval = Particles::sParticleFixedTimeStep;
+	traits.mPriority = static_cast<int>(TickPriorities::PreTick);
+	traits.mComponentAccess.emplace()
+		.Read<ParticleEmitterComponent>()
+		.Write<ParticleColorComponent>();
+	return traits;
+}
+
 CE::MetaType CE::ParticleColorSystem::Reflect()
 {
 	return MetaType{ MetaType::T<ParticleColorSystem>{}, "ParticleColorSystem", MetaType::Base<System>{} };
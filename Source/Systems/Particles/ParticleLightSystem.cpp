@@ -18,6 +18,17 @@ void CE::ParticleLightSystem::Update(World& world, [[maybe_unused]] float dt)
 	}
 }
 
+CE::SystemStaticTraits CE::ParticleLightSystem::GetStaticTraits() const
+{
+	SystemStaticTraits traits{};
+	traits.mFixedTickInterval = Particles::sParticleFixedTimeStep;
+	traits.mPriority = static_cast<int>(TickPriorities::PreTick);
+	traits.mComponentAccess.emplace()
+		.Read<ParticleEmitterComponent>()
+		.Write<ParticleLightComponent>();
+	return traits;
+}
+
 CE::MetaType CE::ParticleLightSystem::Reflect()
 {
 	return MetaType{ MetaType::T<ParticleLightSystem>{}, "ParticleLightSystem", MetaType::Base<System>{} };
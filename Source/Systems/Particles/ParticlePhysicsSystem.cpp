@@ -77,6 +77,17 @@ void CE::ParticlePhysicsSystem::Update(World& world, float dt)
 	}
 }
 
+CE::SystemStaticTraits CE::ParticlePhysicsSystem::GetStaticTraits() const
+{
+	SystemStaticTraits traits{};
+	traits.mFixedTickInterval = Particles::sParticleFixedTimeStep;
+	traits.mPriority = static_cast<int>(TickPriorities::PreTick);
+	traits.mComponentAccess.emplace()
+		.Read<TransformComponent>()
+		.Write<ParticleEmitterComponent, ParticlePhysicsComponent>();
+	return traits;
+}
+
 CE::MetaType CE::ParticlePhysicsSystem::Reflect()
 {
 	return MetaType{ MetaType::T<ParticlePhysicsSystem>{}, "ParticlePhysicsSystem", MetaType::Base<System>{} };
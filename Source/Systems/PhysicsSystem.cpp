@@ -15,6 +15,7 @@
 #include "Utilities/DrawDebugHelpers.h"
 #include "World/EventManager.h"
 #include "World/Physics.h"
+#include "Utilities/JobSystem.h"
 
 void CE::PhysicsSystem::Update(World& world, float dt)
 {
@@ -69,24 +70,18 @@ namespace CE::Internal
 {
 	struct ShouldCheckForCollision
 	{
-		template<typename ColliderType>
-		static bool Callback(entt::entity entity2, entt::entity entity1, const PhysicsBody2DComponent& body1, const Registry& reg)
+		template<typename ColliderType, typename... AdditionalArgs>
+		static bool Callback(entt::entity entity2, entt::entity entity1, const PhysicsBody2DComponent& body1, const Registry& reg, AdditionalArgs&&...)
 		{
-			if (entity1 == entity2)
+			if constexpr (std::is_same_v<ColliderType, TransformedDiskColliderComponent>)
 			{
-				return false;
+				// Both disks query the BVH, we only want to register the pair once.
+				if (entity1 >= entity2)
+				{
+					return false;
+				}
 			}
-
-			const PhysicsBody2DComponent* body2 = reg.TryGet<PhysicsBody2DComponent>(entity2);
-
-			return body2 != nullptr
-				&& body1.mRules.GetResponse(body2->mRules) != CollisionResponse::Ignore;
-		}
-
-		template<>
-		STATIC_SPECIALIZATION bool Callback<TransformedDiskColliderComponent>(entt::entity entity2, entt::entity entity1, const PhysicsBody2DComponent& body1, const Registry& reg)
-		{
-			if (entity1 >= entity2)
+			else if (entity1 == entity2)
 			{
 				return false;
 			}
@@ -97,43 +92,33 @@ namespace CE::Internal
 				&& body1.mRules.GetResponse(body2->mRules) != CollisionResponse::Ignore;
 		}
 	};
+
+	static uint64 MakeCollisionKey(const entt::entity entity1, const entt::entity entity2)
+	{
+		return (static_cast<uint64>(entt::to_integral(entity1)) << 32) | static_cast<uint64>(entt::to_integral(entity2));
+	}
 }
 
 void CE::PhysicsSystem::UpdateCollisions(World& world)
 {
 	Registry& reg = world.GetRegistry();
-
-	static std::vector<std::pair<entt::entity, entt::entity>> diskDiskCollisions{};
-	static std::vector<std::pair<entt::entity, entt::entity>> diskAABBCollisions{};
-	static std::vector<std::pair<entt::entity, entt::entity>> diskPolygonCollisions{};
-
-	diskDiskCollisions.clear();
-	diskAABBCollisions.clear();
-	diskPolygonCollisions.clear();
-
-	CollisionData collision;
-
-	// prev collisions are stored as a member function,
-	// but this is made static so we can reuse the same
-	// buffer every frame, even if we have multiple worlds.
-	static std::vector<CollisionData> currentCollisions{};
-	currentCollisions.clear();
+	JobSystem& jobSystem = JobSystem::Get();
 
 	struct OnIntersect
 	{
-		static void Callback(const TransformedDiskColliderComponent&, entt::entity entity2, entt::entity entity1, const PhysicsBody2DComponent&, const Registry&)
+		static void Callback(const TransformedDiskColliderComponent&, entt::entity entity2, entt::entity entity1, const PhysicsBody2DComponent&, const Registry&, CollisionPairs& pairs)
 		{
-			diskDiskCollisions.emplace_back(entity1, entity2);
+			pairs.mDiskDisk.emplace_back(entity1, entity2);
 		}
 
-		static void Callback(const TransformedAABBColliderComponent&, entt::entity entity2, entt::entity entity1, const PhysicsBody2DComponent&, const Registry&)
+		static void Callback(const TransformedAABBColliderComponent&, entt::entity entity2, entt::entity entity1, const PhysicsBody2DComponent&, const Registry&, CollisionPairs& pairs)
 		{
-			diskAABBCollisions.emplace_back(entity1, entity2);
+			pairs.mDiskAABB.emplace_back(entity1, entity2);
 		}
 
-		static void Callback(const TransformedPolygonColliderComponent&, entt::entity entity2, entt::entity entity1, const PhysicsBody2DComponent&, const Registry&)
+		static void Callback(const TransformedPolygonColliderComponent&, entt::entity entity2, entt::entity entity1, const PhysicsBody2DComponent&, const Registry&, CollisionPairs& pairs)
 		{
-			diskPolygonCollisions.emplace_back(entity1, entity2);
+			pairs.mDiskPolygon.emplace_back(entity1, entity2);
 		}
 	};
 
@@ -141,37 +126,132 @@ void CE::PhysicsSystem::UpdateCollisions(World& world)
 	const auto viewPolygon = reg.View<PhysicsBody2DComponent, TransformedPolygonColliderComponent>();
 	const auto viewAABB = reg.View<PhysicsBody2DComponent, TransformedAABBColliderComponent>();
 
-	const Physics::BVHS& bvhs = world.GetPhysics().GetBVHs();
+	Physics::BVHS& bvhs = world.GetPhysics().GetBVHs();
 
 	// In the first pass we collect all the collision pairs,
 	// but we don't move anything to prevent the BVH from being
-	// invalidated.
-	for (entt::entity entity1 : viewDisk)
+	// invalidated. Nothing is written to the registry, so
+	// the disks can be split over multiple threads.
+	mDisks.assign(viewDisk.begin(), viewDisk.end());
+
+	const uint32 numOfDisks = static_cast<uint32>(mDisks.size());
+	const uint32 broadPhaseBatchSize = jobSystem.GetBatchSize(numOfDisks, sMinNumOfDisksPerBroadPhaseBatch);
+	const uint32 numOfBroadPhaseBatches = (numOfDisks + broadPhaseBatchSize - 1) / broadPhaseBatchSize;
+
+	if (mPairsPerBatch.size() < numOfBroadPhaseBatches)
 	{
-		const auto [body1, disk1] = viewDisk.get<PhysicsBody2DComponent, TransformedDiskColliderComponent>(entity1);
+		mPairsPerBatch.resize(numOfBroadPhaseBatches);
+	}
 
-		for (const BVH& bvh : bvhs)
+	jobSystem.ParallelForBatched(0, numOfDisks,
+		[&](uint32 batchBegin, uint32 batchEnd)
 		{
-			if (body1.mRules.mResponses[static_cast<int>(bvh.GetLayer())] == CollisionResponse::Ignore)
+			CollisionPairs& pairs = mPairsPerBatch[batchBegin / broadPhaseBatchSize];
+			pairs.mDiskDisk.clear();
+			pairs.mDiskAABB.clear();
+			pairs.mDiskPolygon.clear();
+
+			const Registry& constReg = reg;
+
+			for (uint32 i = batchBegin; i < batchEnd; i++)
 			{
-				continue;
+				const entt::entity entity1 = mDisks[i];
+				const auto [body1, disk1] = viewDisk.get<PhysicsBody2DComponent, TransformedDiskColliderComponent>(entity1);
+
+				for (const BVH& bvh : bvhs)
+				{
+					if (body1.mRules.mResponses[static_cast<int>(bvh.GetLayer())] == CollisionResponse::Ignore)
+					{
+						continue;
+					}
+
+					bvh.Query<OnIntersect, Internal::ShouldCheckForCollision, BVH::DefaultShouldReturnFunction<false>>(disk1, entity1, body1, constReg, pairs);
+				}
 			}
+		}, sMinNumOfDisksPerBroadPhaseBatch);
 
-			bvh.Query<OnIntersect, Internal::ShouldCheckForCollision, BVH::DefaultShouldReturnFunction<false>>(disk1, entity1, body1, reg);
-		}
+	mPairs.mDiskDisk.clear();
+	mPairs.mDiskAABB.clear();
+	mPairs.mDiskPolygon.clear();
+
+	for (uint32 i = 0; i < numOfBroadPhaseBatches; i++)
+	{
+		const CollisionPairs& batchPairs = mPairsPerBatch[i];
+		mPairs.mDiskDisk.insert(mPairs.mDiskDisk.end(), batchPairs.mDiskDisk.begin(), batchPairs.mDiskDisk.end());
+		mPairs.mDiskAABB.insert(mPairs.mDiskAABB.end(), batchPairs.mDiskAABB.begin(), batchPairs.mDiskAABB.end());
+		mPairs.mDiskPolygon.insert(mPairs.mDiskPolygon.end(), batchPairs.mDiskPolygon.begin(), batchPairs.mDiskPolygon.end());
 	}
 
-	for (auto [entity1, entity2] : diskDiskCollisions)
+	// Generate the contacts in parallel, before anything is moved.
+	const auto generateContacts = [&](const std::vector<EntityPair>& pairs, std::vector<Contact>& contacts, const auto& getCollider2, const auto& check)
+		{
+			contacts.resize(pairs.size());
+
+			jobSystem.ParallelFor(0, static_cast<uint32>(pairs.size()),
+				[&](uint32 i)
+				{
+					const TransformedDiskColliderComponent& disk1 = viewDisk.get<TransformedDiskColliderComponent>(pairs[i].first);
+					const auto& collider2 = getCollider2(pairs[i].second);
+
+					Contact& contact = contacts[i];
+					contact.mCentre1 = disk1.mCentre;
+					contact.mIsColliding = check(disk1, collider2, contact.mCollision);
+
+					if constexpr (std::is_same_v<std::decay_t<decltype(collider2)>, TransformedDiskColliderComponent>)
+					{
+						contact.mCentre2 = collider2.mCentre;
+					}
+				}, sMinNumOfPairsPerContactBatch);
+		};
+
+	generateContacts(mPairs.mDiskDisk, mDiskDiskContacts,
+		[&](entt::entity entity2) -> const TransformedDiskColliderComponent& { return viewDisk.get<TransformedDiskColliderComponent>(entity2); },
+		&CollisionCheckDiskDisk);
+
+	generateContacts(mPairs.mDiskAABB, mDiskAABBContacts,
+		[&](entt::entity entity2) -> const TransformedAABBColliderComponent& { return viewAABB.get<TransformedAABBColliderComponent>(entity2); },
+		&CollisionCheckDiskAABB);
+
+	generateContacts(mPairs.mDiskPolygon, mDiskPolygonContacts,
+		[&](entt::entity entity2) -> const TransformedPolygonColliderComponent& { return viewPolygon.get<TransformedPolygonColliderComponent>(entity2); },
+		&CollisionCheckDiskPolygon);
+
+	// The collisions are resolved on a single thread,
+	// in the order the broad phase found them.
+	CollisionData collision;
+
+	// The leaves of the BVHs store a copy of the colliders, which
+	// has to follow the disks we move, for the queries made later this frame.
+	const auto onDiskMoved = [&bvhs](const entt::entity entity, const PhysicsBody2DComponent& body, const TransformedDisk& disk)
+		{
+			bvhs[static_cast<size_t>(body.mRules.mLayer)].OnDiskMoved(entity, disk);
+		};
+	mCurrentCollisions.clear();
+
+	for (size_t i = 0; i < mPairs.mDiskDisk.size(); i++)
 	{
+		const auto [entity1, entity2] = mPairs.mDiskDisk[i];
+		const Contact& contact = mDiskDiskContacts[i];
+
 		auto [body1, transformedDiskCollider1, transform1] = viewDisk.get<PhysicsBody2DComponent, TransformedDiskColliderComponent, TransformComponent>(entity1);
 		auto [body2, transformedDiskCollider2, transform2] = viewDisk.get<PhysicsBody2DComponent, TransformedDiskColliderComponent, TransformComponent>(entity2);
 
-		if (!CollisionCheckDiskDisk(transformedDiskCollider1, transformedDiskCollider2, collision))
+		if (contact.mCentre1 == transformedDiskCollider1.mCentre
+			&& contact.mCentre2 == transformedDiskCollider2.mCentre)
+		{
+			if (!contact.mIsColliding)
+			{
+				continue;
+			}
+
+			collision = contact.mCollision;
+		}
+		else if (!CollisionCheckDiskDisk(transformedDiskCollider1, transformedDiskCollider2, collision))
 		{
 			continue;
 		}
 
-		RegisterCollision(currentCollisions, collision, entity1, entity2);
+		RegisterCollision(mCurrentCollisions, collision, entity1, entity2);
 		const CollisionResponse response = body1.mRules.GetResponse(body2.mRules);
 
 		if (response != CollisionResponse::Blocking)
@@ -185,6 +265,7 @@ void CE::PhysicsSystem::UpdateCollisions(World& world)
 			body1.ApplyImpulse(entity1Impulse);
 			transform1.SetWorldPosition(newEntity1Pos);
 			transformedDiskCollider1.mCentre = newEntity1Pos;
+			onDiskMoved(entity1, body1, transformedDiskCollider1);
 		}
 
 		if (body2.mIsAffectedByForces)
@@ -193,11 +274,15 @@ void CE::PhysicsSystem::UpdateCollisions(World& world)
 			body2.ApplyImpulse(entity2Impulse);
 			transform2.SetWorldPosition(newEntity2Pos);
 			transformedDiskCollider2.mCentre = newEntity2Pos;
+			onDiskMoved(entity2, body2, transformedDiskCollider2);
 		}
 	}
 
-	for (const auto& [entity1, entity2] : diskAABBCollisions)
+	for (size_t i = 0; i < mPairs.mDiskAABB.size(); i++)
 	{
+		const auto [entity1, entity2] = mPairs.mDiskAABB[i];
+		const Contact& contact = mDiskAABBContacts[i];
+
 		auto [transform1, body1, transformedDiskCollider1] = viewDisk.get<TransformComponent, PhysicsBody2DComponent, TransformedDiskColliderComponent>(entity1);
 		auto [body2, transformedAABBCollider] = viewAABB.get<PhysicsBody2DComponent, TransformedAABBColliderComponent>(entity2);
 
@@ -208,23 +293,38 @@ void CE::PhysicsSystem::UpdateCollisions(World& world)
 			continue;
 		}
 
-		if (CollisionCheckDiskAABB(transformedDiskCollider1, transformedAABBCollider, collision))
+		if (contact.mCentre1 == transformedDiskCollider1.mCentre)
 		{
-			RegisterCollision(currentCollisions, collision, entity1, entity2);
-
-			if (response == CollisionResponse::Blocking
-				&& body1.mIsAffectedByForces)
+			if (!contact.mIsColliding)
 			{
-				auto [newEntity1Pos, entity1Impulse] = ResolveDiskCollision(collision, body1, body2, transformedDiskCollider1.mCentre);
-				body1.ApplyImpulse(entity1Impulse);
-				transform1.SetWorldPosition(newEntity1Pos);
-				transformedDiskCollider1.mCentre = newEntity1Pos;
+				continue;
 			}
+
+			collision = contact.mCollision;
+		}
+		else if (!CollisionCheckDiskAABB(transformedDiskCollider1, transformedAABBCollider, collision))
+		{
+			continue;
+		}
+
+		RegisterCollision(mCurrentCollisions, collision, entity1, entity2);
+
+		if (response == CollisionResponse::Blocking
+			&& body1.mIsAffectedByForces)
+		{
+			auto [newEntity1Pos, entity1Impulse] = ResolveDiskCollision(collision, body1, body2, transformedDiskCollider1.mCentre);
+			body1.ApplyImpulse(entity1Impulse);
+			transform1.SetWorldPosition(newEntity1Pos);
+			transformedDiskCollider1.mCentre = newEntity1Pos;
+			onDiskMoved(entity1, body1, transformedDiskCollider1);
 		}
 	}
 
-	for (auto [entity1, entity2] : diskPolygonCollisions)
+	for (size_t i = 0; i < mPairs.mDiskPolygon.size(); i++)
 	{
+		const auto [entity1, entity2] = mPairs.mDiskPolygon[i];
+		const Contact& contact = mDiskPolygonContacts[i];
+
 		auto [transform1, body1, transformedDiskCollider1] = viewDisk.get<TransformComponent, PhysicsBody2DComponent, TransformedDiskColliderComponent>(entity1);
 		auto [body2, transformedPolygonCollider2] = viewPolygon.get<PhysicsBody2DComponent, TransformedPolygonColliderComponent>(entity2);
 
@@ -235,62 +335,75 @@ void CE::PhysicsSystem::UpdateCollisions(World& world)
 			continue;
 		}
 
-		if (CollisionCheckDiskPolygon(transformedDiskCollider1, transformedPolygonCollider2, collision))
+		if (contact.mCentre1 == transformedDiskCollider1.mCentre)
 		{
-			RegisterCollision(currentCollisions, collision, entity1, entity2);
-
-			if (response == CollisionResponse::Blocking
-				&& body1.mIsAffectedByForces)
+			if (!contact.mIsColliding)
 			{
-				auto [newEntity1Pos, entity1Impulse] = ResolveDiskCollision(collision, body1, body2, transformedDiskCollider1.mCentre);
-				body1.ApplyImpulse(entity1Impulse);
-				transform1.SetWorldPosition(newEntity1Pos);
-				transformedDiskCollider1.mCentre = newEntity1Pos;
+				continue;
 			}
+
+			collision = contact.mCollision;
+		}
+		else if (!CollisionCheckDiskPolygon(transformedDiskCollider1, transformedPolygonCollider2, collision))
+		{
+			continue;
+		}
+
+		RegisterCollision(mCurrentCollisions, collision, entity1, entity2);
+
+		if (response == CollisionResponse::Blocking
+			&& body1.mIsAffectedByForces)
+		{
+			auto [newEntity1Pos, entity1Impulse] = ResolveDiskCollision(collision, body1, body2, transformedDiskCollider1.mCentre);
+			body1.ApplyImpulse(entity1Impulse);
+			transform1.SetWorldPosition(newEntity1Pos);
+			transformedDiskCollider1.mCentre = newEntity1Pos;
+			onDiskMoved(entity1, body1, transformedDiskCollider1);
 		}
 	}
 
-	static std::vector<std::reference_wrapper<const CollisionData>> enters{};
-	static std::vector<std::reference_wrapper<const CollisionData>> exits{};
-	enters.clear();
-	exits.clear();
+	mEnters.clear();
+	mExits.clear();
 
-	for (const CollisionData& currFrame : currentCollisions)
-	{
-		const bool wasCollidingPrevFrame = std::any_of(mPreviousCollisions.begin(), mPreviousCollisions.end(),
-		                                               [&currFrame](const CollisionData& prevFrame)
-		                                               {
-			                                               return currFrame.mEntity1 == prevFrame.mEntity1
-				                                               && currFrame.mEntity2 == prevFrame.mEntity2;
-		                                               });
+	// Sorted keys let us look up whether a pair was colliding in O(log n)
+	const auto sortKeys = [this](const std::vector<CollisionData>& collisions)
+		{
+			mSortedCollisionKeys.clear();
+
+			for (const CollisionData& collisionData : collisions)
+			{
+				mSortedCollisionKeys.emplace_back(Internal::MakeCollisionKey(collisionData.mEntity1, collisionData.mEntity2));
+			}
+
+			std::sort(mSortedCollisionKeys.begin(), mSortedCollisionKeys.end());
+		};
 
-		if (!wasCollidingPrevFrame)
+	sortKeys(mPreviousCollisions);
+
+	for (const CollisionData& currFrame : mCurrentCollisions)
+	{
+		if (!std::binary_search(mSortedCollisionKeys.begin(), mSortedCollisionKeys.end(), Internal::MakeCollisionKey(currFrame.mEntity1, currFrame.mEntity2)))
 		{
-			enters.emplace_back(currFrame);
+			mEnters.emplace_back(currFrame);
 		}
 	}
 
+	sortKeys(mCurrentCollisions);
+
 	for (const CollisionData& prevFrame : mPreviousCollisions)
 	{
-		const bool isCollidingNow = std::any_of(currentCollisions.begin(), currentCollisions.end(),
-		                                        [&prevFrame](const CollisionData& currFrame)
-		                                        {
-			                                        return currFrame.mEntity1 == prevFrame.mEntity1
-				                                        && currFrame.mEntity2 == prevFrame.mEntity2;
-		                                        });
-
-		if (!isCollidingNow)
+		if (!std::binary_search(mSortedCollisionKeys.begin(), mSortedCollisionKeys.end(), Internal::MakeCollisionKey(prevFrame.mEntity1, prevFrame.mEntity2)))
 		{
-			exits.emplace_back(prevFrame);
+			mExits.emplace_back(prevFrame);
 		}
 	}
 
 	// Call events
-	CallEvents(world, enters, sOnCollisionEntry);
-	CallEvents(world, currentCollisions, sOnCollisionStay);
-	CallEvents(world, exits, sOnCollisionExit);
+	CallEvents(world, mEnters, sOnCollisionEntry);
+	CallEvents(world, mCurrentCollisions, sOnCollisionStay);
+	CallEvents(world, mExits, sOnCollisionExit);
 
-	std::swap(mPreviousCollisions, currentCollisions);
+	std::swap(mPreviousCollisions, mCurrentCollisions);
 }
 
 
@@ -7,3 +7,43 @@ CE::MetaType CE::System::Reflect()
 {
     return MetaType{ MetaType::T<System>{}, "System" };
 }
+
+std::optional<CE::TypeId> CE::SystemComponentAccess::FindConflict(const SystemComponentAccess& other) const
+{
+	const auto findWriteConflict = [](const std::vector<StorageAccess>& writes, const SystemComponentAccess& accessor) -> std::optional<TypeId>
+		{
+			for (const StorageAccess& write : writes)
+			{
+				const auto isSameStorage = [&write](const StorageAccess& access) { return access.mTypeId == write.mTypeId; };
+
+				if (std::any_of(accessor.mReads.begin(), accessor.mReads.end(), isSameStorage)
+					|| std::any_of(accessor.mWrites.begin(), accessor.mWrites.end(), isSameStorage))
+				{
+					return write.mTypeId;
+				}
+			}
+			return std::nullopt;
+		};
+
+	std::optional<TypeId> conflict = findWriteConflict(mWrites, other);
+
+	if (!conflict.has_value())
+	{
+		conflict = findWriteConflict(other.mWrites, *this);
+	}
+
+	return conflict;
+}
+
+void CE::SystemComponentAccess::CreateStorages(Registry& registry) const
+{
+	for (const StorageAccess& read : mReads)
+	{
+		read.mCreateStorage(registry);
+	}
+
+	for (const StorageAccess& write : mWrites)
+	{
+		write.mCreateStorage(registry);
+	}
+}
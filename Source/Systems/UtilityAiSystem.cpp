@@ -37,15 +37,7 @@ void CE::AITickSystem::Update(World& world, float dt)
 			continue;
 		}
 
-		if (aiTickEvent->mIsStatic)
-		{
-			aiTickEvent->mFunc.get().InvokeUncheckedUnpacked(world, entity, dt);
-		}
-		else
-		{
-			MetaAny component{ *currentAIController.mCurrentState, storage->value(entity), false };
-			aiTickEvent->mFunc.get().InvokeUncheckedUnpacked(component, world, entity, dt);
-		}
+		InvokeBoundEvent(*aiTickEvent, sOnAITick, aiTickEvent->mIsStatic ? nullptr : storage->value(entity), world, entity, dt);
 	}
 }
 
@@ -86,17 +78,7 @@ void CE::AIEvaluateSystem::Update(World& world, float)
 
 		for (entt::entity entity : view)
 		{
-			float score{};
-
-			if (boundEvent.mIsStatic)
-			{
-				boundEvent.mFunc.get().InvokeUncheckedUnpackedWithRVO(&score, world, entity);
-			}
-			else
-			{
-				MetaAny component{ boundEvent.mType, storage->value(entity), false };
-				boundEvent.mFunc.get().InvokeUncheckedUnpackedWithRVO(&score, component, world, entity);
-			}
+			const float score = InvokeBoundEvent(boundEvent, sOnAIEvaluate, boundEvent.mIsStatic ? nullptr : storage->value(entity), world, entity);
 
 			EnemyAiControllerComponent& aiController = reg.Get<EnemyAiControllerComponent>(entity);
 
@@ -155,15 +137,7 @@ void CE::AIEvaluateSystem::CallTransitionEvent(const EventT& event, const MetaTy
 		return;
 	}
 
-	if (boundEvent->mIsStatic)
-	{
-		boundEvent->mFunc.get().InvokeUncheckedUnpacked(world, owner);
-	}
-	else
-	{
-		MetaAny component{ *type, storage->value(owner), false };
-		boundEvent->mFunc.get().InvokeUncheckedUnpacked(component, world, owner);
-	}
+	InvokeBoundEvent(*boundEvent, event, boundEvent->mIsStatic ? nullptr : storage->value(owner), world, owner);
 }
 
 CE::MetaType CE::AIEvaluateSystem::Reflect()
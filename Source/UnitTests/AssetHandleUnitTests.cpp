@@ -1,13 +1,38 @@
 #include "Precomp.h"
 #include "Assets/Core/AssetHandle.h"
 
+#include <chrono>
+#include <thread>
+
+#include "Core/AssetManager.h"
 #include "Core/UnitTests.h"
 #include "Meta/MetaManager.h"
+#include "Assets/Material.h"
 #include "Assets/StaticMesh.h"
+#include "Assets/Texture.h"
 #include "Assets/Prefabs/Prefab.h"
 
 using namespace CE;
 
+struct AssetManagerUnitTestAccess
+{
+	// Walks every asset, without going through the index that GetAllAssets uses
+	static uint32 CountAssetsDerivedFrom(const TypeId typeId)
+	{
+		const AssetManager& assetManager = AssetManager::Get();
+		std::shared_lock lock{ assetManager.mAssetsMutex };
+
+		uint32 count{};
+
+		for (const Internal::AssetInternal& asset : assetManager.mAssets)
+		{
+			count += asset.mMetaData.GetClass().IsDerivedFrom(typeId);
+		}
+
+		return count;
+	}
+};
+
 UNIT_TEST(AssetHandleTests, SingleThread)
 {
 	{
@@ -71,3 +96,177 @@ UNIT_TEST(AssetHandleTests, DynamicCasts)
 
 	return UnitTest::Success;
 }
+
+UNIT_TEST(AssetHandleTests, StreamingDoesNotBlock)
+{
+	AssetManager& assetManager = AssetManager::Get();
+
+	// Twice, as assets that were dereferenced since the last garbage collect are not unloaded
+	assetManager.UnloadAllUnusedAssets();
+	assetManager.UnloadAllUnusedAssets();
+
+	std::vector<AssetHandle<>> assets{};
+
+	for (const WeakAssetHandle<>& weakAsset : assetManager.GetAllAssets())
+	{
+		if (!weakAsset.IsLoaded())
+		{
+			assets.emplace_back(AssetHandle<>{ weakAsset });
+		}
+	}
+
+	TEST_ASSERT(!assets.empty());
+
+	const uint32 numOfBlockingLoadsAtStart = assetManager.GetNumOfBlockingLoads();
+
+	// Every asset is requested multiple times with varying
+	// priorities, which moves some of them forward in the queue
+	static constexpr uint32 numOfRequestsPerAsset = 4;
+
+	for (uint32 round = 0; round < numOfRequestsPerAsset; round++)
+	{
+		for (size_t i = 0; i < assets.size(); i++)
+		{
+			assetManager.RequestLoad(assets[i], static_cast<float>((i * 7 + round * 3) % 10));
+		}
+	}
+
+	const std::chrono::steady_clock::time_point timeOut = std::chrono::steady_clock::now() + std::chrono::minutes{ 2 };
+	bool areAllReady = false;
+
+	// Like the main thread would each frame, we only use the functions that do not block
+	while (!areAllReady
+		&& std::chrono::steady_clock::now() < timeOut)
+	{
+		assetManager.FinishStreamedLoads();
+
+		areAllReady = true;
+
+		for (const AssetHandle<>& asset : assets)
+		{
+			areAllReady &= asset.TryGet() != nullptr;
+		}
+
+		std::this_thread::yield();
+	}
+
+	TEST_ASSERT(areAllReady);
+	TEST_ASSERT(std::all_of(assets.begin(), assets.end(), [&](const AssetHandle<>& asset) { return assetManager.IsReady(asset); }));
+	TEST_ASSERT(assetManager.GetNumOfBlockingLoads() == numOfBlockingLoadsAtStart);
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(AssetHandleTests, MemoryBudgetEvictsLeastRecentlyUsed)
+{
+	AssetManager& assetManager = AssetManager::Get();
+
+	// Twice, as assets that were dereferenced since the last garbage collect are not unloaded
+	assetManager.UnloadAllUnusedAssets();
+	assetManager.UnloadAllUnusedAssets();
+
+	// Textures do not reference other assets, so unloading one does not affect the other
+	std::vector<WeakAssetHandle<Texture>> textures{};
+
+	for (const WeakAssetHandle<Texture>& texture : assetManager.GetAllAssets<Texture>())
+	{
+		if (!texture.IsLoaded()
+			&& texture.GetFileOfOrigin().has_value()
+			&& textures.size() < 2)
+		{
+			textures.emplace_back(texture);
+		}
+	}
+
+	TEST_ASSERT(textures.size() == 2);
+
+	{
+		AssetHandle<Texture> first{ textures[0] };
+		AssetHandle<Texture> second{ textures[1] };
+		TEST_ASSERT(first.Get() != nullptr && second.Get() != nullptr);
+
+		// Released in this order, so the first one is the least recently used
+		first = nullptr;
+		second = nullptr;
+	}
+
+	const std::optional<size_t> originalBudget = assetManager.GetMemoryBudget();
+	assetManager.SetMemoryBudget(0);
+
+	// Other assets may have been released before our textures, those are evicted first
+	bool wasSecondEvictedFirst = false;
+	for (uint32 i = 0; i < 1 << 16
+		&& textures[0].IsLoaded()
+		&& !wasSecondEvictedFirst; i++)
+	{
+		assetManager.EvictUnusedAssets(1);
+		wasSecondEvictedFirst = !textures[1].IsLoaded();
+	}
+
+	assetManager.EvictUnusedAssets(std::numeric_limits<uint32>::max());
+
+	const bool wereAllEvicted = !textures[0].IsLoaded() && !textures[1].IsLoaded();
+	const size_t memoryUsage = assetManager.GetMemoryUsage();
+
+	assetManager.SetMemoryBudget(originalBudget);
+
+	TEST_ASSERT(!wasSecondEvictedFirst);
+	TEST_ASSERT(wereAllEvicted);
+
+	// Would have wrapped around if the same asset was subtracted twice
+	TEST_ASSERT(memoryUsage < std::numeric_limits<size_t>::max() / 2);
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(AssetHandleTests, GetAllAssetsOfType)
+{
+	AssetManager& assetManager = AssetManager::Get();
+
+	const auto countByScanning = [](const TypeId typeId)
+		{
+			return AssetManagerUnitTestAccess::CountAssetsDerivedFrom(typeId);
+		};
+
+	const auto countFromIndex = [&](auto typeTag)
+		{
+			using T = typename decltype(typeTag)::type;
+			uint32 count{};
+
+			for (const WeakAssetHandle<T>& asset : assetManager.GetAllAssets<T>())
+			{
+				if (!asset.GetMetaData().GetClass().template IsDerivedFrom<T>())
+				{
+					return std::numeric_limits<uint32>::max();
+				}
+				++count;
+			}
+
+			return count;
+		};
+
+	const uint32 numOfMaterials = countFromIndex(std::common_type<Material>{});
+	TEST_ASSERT(numOfMaterials == countByScanning(MakeTypeId<Material>()));
+	TEST_ASSERT(countFromIndex(std::common_type<Texture>{}) == countByScanning(MakeTypeId<Texture>()));
+	TEST_ASSERT(countFromIndex(std::common_type<Asset>{}) == countByScanning(MakeTypeId<Asset>()));
+
+	// Assets added at runtime are indexed as well
+	{
+		const AssetHandle<Material> added = assetManager.AddAsset(Material{ "GetAllAssetsOfTypeTestMaterial" });
+		TEST_ASSERT(added != nullptr);
+		TEST_ASSERT(countFromIndex(std::common_type<Material>{}) == numOfMaterials + 1);
+
+		uint32 numFoundByTypeId{};
+		for (const WeakAssetHandle<>& asset : assetManager.GetAllAssets(MakeTypeId<Material>()))
+		{
+			numFoundByTypeId += asset == added;
+		}
+		TEST_ASSERT(numFoundByTypeId == 1);
+	}
+
+	// And removed from the index once deleted
+	assetManager.DeleteAsset(assetManager.TryGetWeakAsset<Material>("GetAllAssetsOfTypeTestMaterial"));
+	TEST_ASSERT(countFromIndex(std::common_type<Material>{}) == numOfMaterials);
+
+	return UnitTest::Success;
+}
@@ -137,6 +137,84 @@ UNIT_TEST(Events, OnFixedTick)
 	return UnitTest::Success;
 }
 
+UNIT_TEST(Events, OnTickBatch)
+{
+	using namespace CE;
+
+	World world{true};
+	Registry& reg = world.GetRegistry();
+
+	// Enough components for multiple chunks, so that some are executed in parallel
+	std::vector<entt::entity> owners(sMaxTickBatchSize * 4 + 1);
+	reg.Create(owners.begin(), owners.end());
+
+	for (const entt::entity owner : owners)
+	{
+		reg.AddComponent<EventTestingComponent>(owner);
+	}
+
+	// Removing components in the middle of the storage swaps them with the last one
+	reg.RemoveComponent<EventTestingComponent>(owners[sMaxTickBatchSize / 2]);
+	owners.erase(owners.begin() + sMaxTickBatchSize / 2);
+
+	world.Tick(sOnFixedTickStepSize * .5f);
+
+	for (const entt::entity owner : owners)
+	{
+		TEST_ASSERT(reg.Get<EventTestingComponent>(owner).mNumOfBatchedTicks == 1);
+	}
+
+	world.Tick(sOnFixedTickStepSize * .5f);
+
+	for (const entt::entity owner : owners)
+	{
+		TEST_ASSERT(reg.Get<EventTestingComponent>(owner).mNumOfBatchedTicks == 2);
+	}
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(Events, OnFixedTickBatch)
+{
+	using namespace CE;
+
+	World world{true};
+	Registry& reg = world.GetRegistry();
+
+	std::vector<entt::entity> owners(sMaxTickBatchSize + 1);
+	reg.Create(owners.begin(), owners.end());
+
+	for (const entt::entity owner : owners)
+	{
+		reg.AddComponent<EventTestingComponent>(owner);
+	}
+
+	const auto doAllMatch = [&](uint32 expectedNumOfTicks)
+		{
+			return std::all_of(owners.begin(), owners.end(),
+				[&](entt::entity owner)
+				{
+					return reg.Get<EventTestingComponent>(owner).mNumOfBatchedFixedTicks == expectedNumOfTicks;
+				});
+		};
+
+	TEST_ASSERT(doAllMatch(0));
+
+	world.Tick(sOnFixedTickStepSize * .5f);
+
+	TEST_ASSERT(doAllMatch(1));
+
+	world.Tick(sOnFixedTickStepSize * .6f);
+
+	TEST_ASSERT(doAllMatch(2));
+
+	world.Tick(sOnFixedTickStepSize * .5f);
+
+	TEST_ASSERT(doAllMatch(2));
+
+	return UnitTest::Success;
+}
+
 UNIT_TEST(Events, OnConstruct)
 {
 	using namespace CE;
@@ -0,0 +1,195 @@
+#include "Precomp.h"
+#include "Utilities/JobSystem.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "Core/UnitTests.h"
+
+using namespace CE;
+
+UNIT_TEST(JobSystem, ThenAndDependencies)
+{
+	JobSystem& jobSystem = JobSystem::Get();
+
+	for (uint32 repetition = 0; repetition < 32; repetition++)
+	{
+		std::atomic<uint32> nextPosition{ 1 };
+
+		// The position at which each job was executed, 0 if it was not
+		std::atomic<uint32> a{}, b{}, c{}, d{}, e{};
+
+		const JobHandle jobA = jobSystem.Schedule([&]
+			{
+				// Gives the others a chance to run too early
+				std::this_thread::sleep_for(std::chrono::microseconds{ 100 });
+				a = nextPosition++;
+			});
+
+		const JobHandle jobE = jobSystem.Schedule([&] { e = nextPosition++; });
+		const JobHandle jobB = jobSystem.Then(jobA, [&] { b = nextPosition++; });
+		const JobHandle jobC = jobSystem.Then(jobB, [&] { c = nextPosition++; });
+
+		const JobHandle dependenciesOfD[]{ jobB, jobE };
+		const JobHandle jobD = jobSystem.Schedule([&] { d = nextPosition++; }, dependenciesOfD);
+
+		jobC.Wait();
+		jobD.Wait();
+
+		TEST_ASSERT(jobA.IsFinished() && jobB.IsFinished() && jobC.IsFinished() && jobD.IsFinished() && jobE.IsFinished());
+		TEST_ASSERT(a != 0 && b != 0 && c != 0 && d != 0 && e != 0);
+		TEST_ASSERT(a < b);
+		TEST_ASSERT(b < c);
+		TEST_ASSERT(b < d);
+		TEST_ASSERT(e < d);
+	}
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(JobSystem, WaitFromInsideJob)
+{
+	JobSystem& jobSystem = JobSystem::Get();
+
+	static constexpr uint32 sNumOfOuterJobs = 64;
+	static constexpr uint32 sNumOfInnerItems = 100;
+
+	std::atomic<uint32> numOfInnerItemsVisited{};
+	std::atomic<uint32> numOfNestedJobsFinished{};
+
+	// More outer jobs than there are threads, so that every worker ends up waiting from inside a job
+	std::vector<JobHandle> outerJobs{};
+
+	for (uint32 i = 0; i < sNumOfOuterJobs; i++)
+	{
+		outerJobs.emplace_back(jobSystem.Schedule([&]
+			{
+				jobSystem.ParallelFor(0, sNumOfInnerItems,
+					[&](uint32)
+					{
+						++numOfInnerItemsVisited;
+					});
+
+				const JobHandle nested = jobSystem.Schedule([&] { ++numOfNestedJobsFinished; });
+				nested.Wait();
+				ASSERT(nested.IsFinished());
+			}));
+	}
+
+	for (const JobHandle& job : outerJobs)
+	{
+		job.Wait();
+		TEST_ASSERT(job.IsFinished());
+	}
+
+	TEST_ASSERT(numOfInnerItemsVisited == sNumOfOuterJobs * sNumOfInnerItems);
+	TEST_ASSERT(numOfNestedJobsFinished == sNumOfOuterJobs);
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(JobSystem, ParallelForVisitsEveryIndexOnce)
+{
+	JobSystem& jobSystem = JobSystem::Get();
+
+	const std::pair<uint32, uint32> ranges[]{ { 0, 0 }, { 7, 3 }, { 0, 1 }, { 5, 6 }, { 0, 1000 }, { 3, 1027 }, { 10, 10010 } };
+	const uint32 minBatchSizes[]{ 1, 7, 64, 5000 };
+
+	for (const std::pair<uint32, uint32>& range : ranges)
+	{
+		const uint32 begin = range.first;
+		const uint32 end = range.second;
+		const uint32 numOfItems = end > begin ? end - begin : 0;
+
+		for (const uint32 minBatchSize : minBatchSizes)
+		{
+			std::vector<std::atomic<uint32>> numOfVisits(numOfItems);
+
+			jobSystem.ParallelFor(begin, end,
+				[&](uint32 i)
+				{
+					++numOfVisits[i - begin];
+				}, minBatchSize);
+
+			for (const std::atomic<uint32>& visits : numOfVisits)
+			{
+				TEST_ASSERT(visits == 1);
+			}
+
+			std::vector<std::atomic<uint32>> numOfBatchedVisits(numOfItems);
+			std::atomic<bool> wereBatchesValid{ true };
+
+			jobSystem.ParallelForBatched(begin, end,
+				[&](uint32 batchBegin, uint32 batchEnd)
+				{
+					// Only the last batch may be smaller than the minimum
+					if (batchBegin < begin
+						|| batchEnd > end
+						|| batchBegin >= batchEnd
+						|| (batchEnd - batchBegin < minBatchSize && batchEnd != end))
+					{
+						wereBatchesValid = false;
+						return;
+					}
+
+					for (uint32 i = batchBegin; i < batchEnd; i++)
+					{
+						++numOfBatchedVisits[i - begin];
+					}
+				}, minBatchSize);
+
+			TEST_ASSERT(wereBatchesValid);
+
+			for (const std::atomic<uint32>& visits : numOfBatchedVisits)
+			{
+				TEST_ASSERT(visits == 1);
+			}
+		}
+	}
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(JobSystem, CancelStillReleasesContinuations)
+{
+	JobSystem& jobSystem = JobSystem::Get();
+
+	std::atomic<bool> shouldBlock{ true };
+	std::atomic<bool> didCancelledJobRun{};
+	std::atomic<bool> didContinuationRun{};
+
+	const std::shared_ptr<int> capturedByCancelledJob = std::make_shared<int>();
+	const std::weak_ptr<int> weakCaptured = capturedByCancelledJob;
+
+	// Keeps the cancelled job from being started before it is cancelled
+	const JobHandle blocker = jobSystem.Schedule([&]
+		{
+			while (shouldBlock)
+			{
+				std::this_thread::yield();
+			}
+		});
+
+	const JobHandle cancelled = jobSystem.Then(blocker, [&, captured = capturedByCancelledJob]
+		{
+			didCancelledJobRun = true;
+		});
+
+	const JobHandle continuation = jobSystem.Then(cancelled, [&] { didContinuationRun = true; });
+
+	cancelled.Cancel();
+	shouldBlock = false;
+
+	continuation.Wait();
+
+	TEST_ASSERT(!didCancelledJobRun);
+	TEST_ASSERT(didContinuationRun);
+	TEST_ASSERT(cancelled.IsFinished());
+	TEST_ASSERT(continuation.IsFinished());
+
+	// The work of the cancelled job is released, along with anything it captured
+	TEST_ASSERT(weakCaptured.use_count() == 1);
+
+	return UnitTest::Success;
+}
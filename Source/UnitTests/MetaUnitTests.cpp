@@ -1,5 +1,8 @@
 #include "Precomp.h"
 
+#include <chrono>
+#include <deque>
+
 #include "Meta/MetaType.h"
 #include "Meta/MetaFunc.h"
 #include "Meta/MetaTypeId.h"
@@ -74,3 +77,94 @@ UNIT_TEST(Meta, FunctionHash)
 	}
 	return UnitTest::Failure;
 }
+
+namespace
+{
+	// How IsDerivedFrom used to work, before the ancestors were precomputed
+	bool IsDerivedFromByWalking(const MetaType& type, const TypeId baseClassTypeId)
+	{
+		if (type.GetTypeId() == baseClassTypeId)
+		{
+			return true;
+		}
+
+		for (const MetaType& base : type.GetDirectBaseClasses())
+		{
+			if (IsDerivedFromByWalking(base, baseClassTypeId))
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
+
+UNIT_TEST(Meta, IsDerivedFrom)
+{
+	// A deque, as the types refer to each other and must not be moved
+	std::deque<MetaType> types{};
+	static constexpr uint32 sNumOfTypes = 256;
+
+	for (uint32 i = 0; i < sNumOfTypes; i++)
+	{
+		const std::string name = Format("IsDerivedFromTestType{}", i);
+		MetaType& type = types.emplace_back(TypeInfo{ Name::HashString(name), 0 }, name);
+
+		// A tree, with the occasional diamond
+		if (i != 0)
+		{
+			type.AddBaseClass(types[(i - 1) / 2]);
+		}
+
+		if (i % 16 == 15)
+		{
+			type.AddBaseClass(types[i - 1]);
+		}
+	}
+
+	// Bases added after the derived classes were, must be seen by the derived classes as well
+	const std::string lateBaseName = "IsDerivedFromTestLateBase";
+	const MetaType& lateBase = types.emplace_back(TypeInfo{ Name::HashString(lateBaseName), 0 }, lateBaseName);
+	types[1].AddBaseClass(lateBase);
+
+	for (const MetaType& derived : types)
+	{
+		for (const MetaType& base : types)
+		{
+			const bool expected = IsDerivedFromByWalking(derived, base.GetTypeId());
+			TEST_ASSERT(derived.IsDerivedFrom(base.GetTypeId()) == expected);
+			TEST_ASSERT(base.IsBaseClassOf(derived.GetTypeId()) == expected);
+		}
+	}
+
+	TEST_ASSERT(types[sNumOfTypes - 1].IsDerivedFrom(lateBase.GetTypeId()));
+	TEST_ASSERT(!types[2].IsDerivedFrom(lateBase.GetTypeId()));
+
+	// A microbenchmark, comparing against walking the hierarchy
+	const auto measure = [&](const auto& isDerivedFrom)
+		{
+			uint32 numOfMatches{};
+			const std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+			for (const MetaType& derived : types)
+			{
+				for (const MetaType& base : types)
+				{
+					numOfMatches += isDerivedFrom(derived, base.GetTypeId());
+				}
+			}
+
+			const std::chrono::high_resolution_clock::time_point end = std::chrono::high_resolution_clock::now();
+			return std::make_pair(std::chrono::duration<double, std::milli>(end - start).count(), numOfMatches);
+		};
+
+	const auto [precomputedMs, numOfPrecomputedMatches] = measure([](const MetaType& derived, const TypeId base) { return derived.IsDerivedFrom(base); });
+	const auto [walkingMs, numOfWalkingMatches] = measure(&IsDerivedFromByWalking);
+	TEST_ASSERT(numOfPrecomputedMatches == numOfWalkingMatches);
+
+	LOG(UnitTests, Message, "{} IsDerivedFrom checks took {:.3f}ms, walking the class hierarchy took {:.3f}ms",
+		types.size() * types.size(), precomputedMs, walkingMs);
+
+	return UnitTest::Success;
+}
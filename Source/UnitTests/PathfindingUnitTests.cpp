@@ -0,0 +1,419 @@
+#include "Precomp.h"
+#include "Utilities/PathfindingInfo.h"
+
+#include <chrono>
+#include <thread>
+
+#include "Core/UnitTests.h"
+#include "Components/TransformComponent.h"
+#include "Components/Pathfinding/SwarmingAgentTag.h"
+#include "Components/Pathfinding/SwarmingTargetComponent.h"
+#include "Components/Physics2D/AABBColliderComponent.h"
+#include "Components/Physics2D/PhysicsBody2DComponent.h"
+#include "Utilities/FlowFieldEngine.h"
+#include "Utilities/Random.h"
+#include "World/Physics.h"
+#include "World/Registry.h"
+#include "World/World.h"
+
+using namespace CE;
+
+struct PathfindingUnitTestAccess
+{
+	static void SetGeneration(Pathfinding::SearchContext& context, uint32 generation)
+	{
+		context.mGeneration = generation;
+	}
+};
+
+namespace
+{
+	constexpr float sInf = std::numeric_limits<float>::infinity();
+
+	// A grid of slightly jittered nodes, with random edges between the nodes near each other.
+	// Edges cost at least the distance between their nodes, so the heuristic never overestimates.
+	Pathfinding::Graph CreateRandomGraph(uint32 width, uint32 seed)
+	{
+		DefaultRandomEngine engine{ seed };
+		std::uniform_real_distribution<float> jitter{ -.3f, .3f };
+		std::uniform_real_distribution<float> costMultiplier{ 1.0f, 3.0f };
+		std::uniform_int_distribution<int> edgeKind{ 0, 3 };
+
+		Pathfinding::Graph graph{};
+
+		for (uint32 y = 0; y < width; y++)
+		{
+			for (uint32 x = 0; x < width; x++)
+			{
+				graph.AddNode({ static_cast<float>(x) + jitter(engine), static_cast<float>(y) + jitter(engine) });
+			}
+		}
+
+		for (uint32 y = 0; y < width; y++)
+		{
+			for (uint32 x = 0; x < width; x++)
+			{
+				const Pathfinding::NodeId from = x + y * width;
+
+				for (const glm::uvec2 offset : { glm::uvec2{ 1, 0 }, glm::uvec2{ 0, 1 }, glm::uvec2{ 1, 1 } })
+				{
+					if (x + offset.x >= width
+						|| y + offset.y >= width)
+					{
+						continue;
+					}
+
+					const Pathfinding::NodeId to = (x + offset.x) + (y + offset.y) * width;
+					const float distance = glm::distance(graph.GetPosition(from), graph.GetPosition(to));
+
+					switch (edgeKind(engine))
+					{
+					case 0: break;
+					case 1: graph.AddEdge(from, to, distance * costMultiplier(engine)); break;
+					case 2: graph.AddEdge(to, from, distance * costMultiplier(engine)); break;
+					default: graph.AddEdge(from, to, -1.0f, true); break;
+					}
+				}
+			}
+		}
+
+		graph.Build();
+		return graph;
+	}
+
+	// The cost of the cheapest path from startNode to every node
+	std::vector<float> FindCostsUsingDijkstra(const Pathfinding::Graph& graph, Pathfinding::NodeId startNode)
+	{
+		std::vector<float> costs(graph.GetNumOfNodes(), sInf);
+		std::vector<std::pair<float, Pathfinding::NodeId>> openList{};
+		const std::greater<std::pair<float, Pathfinding::NodeId>> compare{};
+
+		costs[startNode] = 0.0f;
+		openList.emplace_back(0.0f, startNode);
+
+		while (!openList.empty())
+		{
+			std::pop_heap(openList.begin(), openList.end(), compare);
+			const auto [cost, node] = openList.back();
+			openList.pop_back();
+
+			if (cost > costs[node])
+			{
+				continue;
+			}
+
+			for (const Pathfinding::Edge& edge : graph.GetConnectingEdges(node))
+			{
+				if (cost + edge.mCost < costs[edge.mToNode])
+				{
+					costs[edge.mToNode] = cost + edge.mCost;
+					openList.emplace_back(costs[edge.mToNode], edge.mToNode);
+					std::push_heap(openList.begin(), openList.end(), compare);
+				}
+			}
+		}
+
+		return costs;
+	}
+
+	// Returns infinity if the path is not connected by edges, or does not go from startNode to endNode
+	float GetPathCost(const Pathfinding::Graph& graph, Span<const Pathfinding::NodeId> path, Pathfinding::NodeId startNode, Pathfinding::NodeId endNode)
+	{
+		if (path.empty()
+			|| path.front() != startNode
+			|| path.back() != endNode)
+		{
+			return sInf;
+		}
+
+		float totalCost{};
+
+		for (size_t i = 0; i + 1 < path.size(); i++)
+		{
+			float cheapestEdge = sInf;
+
+			for (const Pathfinding::Edge& edge : graph.GetConnectingEdges(path[i]))
+			{
+				if (edge.mToNode == path[i + 1])
+				{
+					cheapestEdge = std::min(cheapestEdge, edge.mCost);
+				}
+			}
+
+			totalCost += cheapestEdge;
+		}
+
+		return totalCost;
+	}
+
+	bool IsCostEqual(float cost, float expectedCost)
+	{
+		if (expectedCost == sInf)
+		{
+			return cost == sInf;
+		}
+		return std::abs(cost - expectedCost) <= 1e-3f * std::max(1.0f, expectedCost);
+	}
+}
+
+UNIT_TEST(Pathfinding, AStarFindsCheapestPath)
+{
+	static constexpr uint32 sWidth = 12;
+	const Pathfinding::Graph graph = CreateRandomGraph(sWidth, 0x5eed);
+
+	Pathfinding::SearchContext context{};
+	std::vector<Pathfinding::NodeId> path{};
+	uint32 numOfPathsFound{};
+
+	for (Pathfinding::NodeId startNode = 0; startNode < graph.GetNumOfNodes(); startNode += 5)
+	{
+		const std::vector<float> expectedCosts = FindCostsUsingDijkstra(graph, startNode);
+
+		for (Pathfinding::NodeId endNode = 0; endNode < graph.GetNumOfNodes(); endNode++)
+		{
+			const bool wasFound = graph.AStarSearch(startNode, endNode, context, path);
+
+			TEST_ASSERT(wasFound == (expectedCosts[endNode] != sInf));
+			TEST_ASSERT(wasFound || path.empty());
+
+			if (wasFound)
+			{
+				TEST_ASSERT(IsCostEqual(GetPathCost(graph, path, startNode, endNode), expectedCosts[endNode]));
+				++numOfPathsFound;
+			}
+		}
+	}
+
+	// Otherwise the graph was too sparse to test anything
+	TEST_ASSERT(numOfPathsFound > graph.GetNumOfNodes());
+
+	// Invalid nodes have no path
+	TEST_ASSERT(!graph.AStarSearch(0, graph.GetNumOfNodes(), context, path));
+	TEST_ASSERT(path.empty());
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(Pathfinding, SearchContextCanBeReused)
+{
+	const Pathfinding::Graph smallGraph = CreateRandomGraph(4, 1);
+	const Pathfinding::Graph largeGraph = CreateRandomGraph(16, 2);
+
+	Pathfinding::SearchContext reusedContext{};
+	std::vector<Pathfinding::NodeId> reusedPath{};
+	std::vector<Pathfinding::NodeId> freshPath{};
+
+	const auto doSearchesMatchFreshContext = [&](const Pathfinding::Graph& graph, uint32 numOfSearches)
+		{
+			for (uint32 i = 0; i < numOfSearches; i++)
+			{
+				const Pathfinding::NodeId startNode = (i * 7) % graph.GetNumOfNodes();
+				const Pathfinding::NodeId endNode = (i * 13 + 5) % graph.GetNumOfNodes();
+
+				Pathfinding::SearchContext freshContext{};
+				const bool wasFoundWithFresh = graph.AStarSearch(startNode, endNode, freshContext, freshPath);
+				const bool wasFoundWithReused = graph.AStarSearch(startNode, endNode, reusedContext, reusedPath);
+
+				if (wasFoundWithFresh != wasFoundWithReused
+					|| !IsCostEqual(GetPathCost(graph, reusedPath, startNode, endNode), GetPathCost(graph, freshPath, startNode, endNode)))
+				{
+					return false;
+				}
+			}
+			return true;
+		};
+
+	// Growing and shrinking the graph between searches
+	TEST_ASSERT(doSearchesMatchFreshContext(smallGraph, 16));
+	TEST_ASSERT(doSearchesMatchFreshContext(largeGraph, 64));
+	TEST_ASSERT(doSearchesMatchFreshContext(smallGraph, 16));
+
+	// The generation wraps around after these searches, nodes visited before then should not be seen as visited
+	PathfindingUnitTestAccess::SetGeneration(reusedContext, std::numeric_limits<uint32>::max() - 8);
+	TEST_ASSERT(doSearchesMatchFreshContext(largeGraph, 32));
+	TEST_ASSERT(doSearchesMatchFreshContext(smallGraph, 16));
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(Pathfinding, PathCacheEvictsLeastRecentlyUsed)
+{
+	const std::vector<glm::vec2> pathA{ { 0.0f, 0.0f }, { 1.0f, 0.0f } };
+	const std::vector<glm::vec2> pathB{ { 0.0f, 1.0f } };
+	const std::vector<glm::vec2> pathC{ { 2.0f, 2.0f }, { 3.0f, 3.0f }, { 4.0f, 4.0f } };
+	const std::vector<glm::vec2> pathD{ { 5.0f, 5.0f } };
+
+	Pathfinding::PathCache cache{ 3 };
+	std::vector<glm::vec2> path{};
+
+	TEST_ASSERT(!cache.TryGet(0, 1, path));
+
+	cache.Add(0, 1, pathA);
+	cache.Add(1, 0, pathB);
+	cache.Add(2, 3, pathC);
+
+	// The start and end node are not interchangeable
+	TEST_ASSERT(cache.TryGet(0, 1, path) && path == pathA);
+	TEST_ASSERT(cache.TryGet(1, 0, path) && path == pathB);
+
+	// (2, 3) is now the least recently used
+	cache.Add(4, 5, pathD);
+	TEST_ASSERT(!cache.TryGet(2, 3, path));
+	TEST_ASSERT(cache.TryGet(4, 5, path) && path == pathD);
+
+	// (0, 1) is now the least recently used, adding an existing key replaces its path without evicting anything
+	cache.Add(1, 0, pathC);
+	TEST_ASSERT(cache.TryGet(1, 0, path) && path == pathC);
+	TEST_ASSERT(cache.TryGet(0, 1, path) && path == pathA);
+
+	// (4, 5) is now the least recently used
+	cache.Add(2, 3, pathC);
+	TEST_ASSERT(!cache.TryGet(4, 5, path));
+	TEST_ASSERT(cache.TryGet(0, 1, path) && path == pathA);
+	TEST_ASSERT(cache.TryGet(1, 0, path) && path == pathC);
+	TEST_ASSERT(cache.TryGet(2, 3, path) && path == pathC);
+
+	Pathfinding::PathCache movedCache = std::move(cache);
+	TEST_ASSERT(movedCache.TryGet(0, 1, path) && path == pathA);
+
+	movedCache.Clear();
+	TEST_ASSERT(!movedCache.TryGet(0, 1, path));
+
+	Pathfinding::PathCache emptyCache{ 0 };
+	emptyCache.Add(0, 1, pathA);
+	TEST_ASSERT(!emptyCache.TryGet(0, 1, path));
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(Pathfinding, FlowFieldLeadsEverySectorToTarget)
+{
+	World world{ false };
+	Registry& reg = world.GetRegistry();
+
+	// Walls whose edges do not line up with the edges of the cells. They are shorter than a sector is wide,
+	// as the cells in a sector are only reachable through the sectors closer to the target, so a wall that
+	// cuts a sector in two could leave one of the halves unreachable.
+	const TransformedAABB walls[]
+	{
+		{ { .1f, 3.1f }, { 2.6f, 3.4f } },
+		{ { -1.4f, 4.6f }, { 2.4f, 5.1f } },
+		{ { -2.9f, -.4f }, { -.6f, .1f } },
+		{ { 5.1f, -3.4f }, { 5.6f, -.6f } },
+		{ { -8.4f, -5.9f }, { -6.1f, -5.4f } },
+	};
+
+	for (const TransformedAABB& wall : walls)
+	{
+		const entt::entity obstacle = reg.Create();
+		reg.AddComponent<TransformComponent>(obstacle).SetLocalPosition((wall.mMin + wall.mMax) * .5f);
+		reg.AddComponent<PhysicsBody2DComponent>(obstacle).mRules.mLayer = CollisionLayer::StaticObstacles;
+		reg.AddComponent<AABBColliderComponent>(obstacle).mHalfExtends = (wall.mMax - wall.mMin) * .5f;
+	}
+
+	// Decides which size class the fields are computed for
+	static constexpr float sAgentRadius = .3f;
+	const entt::entity agent = reg.Create();
+	reg.AddComponent<SwarmingAgentTag>(agent);
+	reg.AddComponent<TransformedDiskColliderComponent>(agent).mRadius = sAgentRadius;
+
+	const entt::entity target = reg.Create();
+	reg.AddComponent<TransformComponent>(target).SetLocalPosition(glm::vec2{ 1.1f, 2.3f });
+	SwarmingTargetComponent& targetComponent = reg.AddComponent<SwarmingTargetComponent>(target);
+	targetComponent.mDesiredRadius = 10.0f;
+
+	// Smoothing blends in the directions of neighbouring cells, which would make the directions harder to follow
+	targetComponent.mNumberOfSmoothingSteps = 0;
+
+	world.GetPhysics().RebuildBVHs(true);
+
+	const uint32 sizeClass = FlowFieldEngine::GetSizeClass(sAgentRadius);
+	const float cellSize = FlowFieldEngine::GetCellSize(sizeClass);
+	const glm::ivec2 goalCell{ glm::floor(glm::vec2{ 1.1f, 2.3f } / cellSize) };
+	const int radiusInCells = static_cast<int>(std::ceil(targetComponent.mDesiredRadius / cellSize));
+
+	// Every cell in these sectors is covered by the field
+	const glm::ivec2 firstCell = glm::ivec2{ glm::floor(glm::vec2{ goalCell - glm::ivec2{ radiusInCells } } / static_cast<float>(FlowFieldEngine::sSectorWidth)) } * FlowFieldEngine::sSectorWidth;
+	const glm::ivec2 endCell = glm::ivec2{ glm::floor(glm::vec2{ goalCell + glm::ivec2{ radiusInCells } } / static_cast<float>(FlowFieldEngine::sSectorWidth)) + glm::vec2{ 1.0f } } * FlowFieldEngine::sSectorWidth;
+
+	const auto getCellCentre = [cellSize](glm::ivec2 cell)
+		{
+			return (glm::vec2{ cell } + glm::vec2{ .5f }) * cellSize;
+		};
+
+	const auto isBlocked = [&](glm::ivec2 cell)
+		{
+			const TransformedAABB cellBox{ glm::vec2{ cell } * cellSize, glm::vec2{ cell + glm::ivec2{ 1 } } * cellSize };
+
+			return std::any_of(std::begin(walls), std::end(walls),
+				[&cellBox](const TransformedAABB& wall)
+				{
+					return AreOverlapping(wall, cellBox);
+				});
+		};
+
+	FlowFieldEngine engine{};
+	bool isEverySectorComputed{};
+
+	// Sampling requests the sectors, which are computed during the next updates
+	for (uint32 attempt = 0; attempt < 10'000 && !isEverySectorComputed; attempt++)
+	{
+		engine.Update(world, 0.0f);
+		std::this_thread::sleep_for(std::chrono::milliseconds{ 1 });
+
+		const FlowFieldEngine::Field* const field = targetComponent.GetFlowField(sizeClass);
+
+		if (field == nullptr)
+		{
+			continue;
+		}
+
+		isEverySectorComputed = true;
+
+		for (int y = firstCell.y; y < endCell.y; y += FlowFieldEngine::sSectorWidth)
+		{
+			for (int x = firstCell.x; x < endCell.x; x += FlowFieldEngine::sSectorWidth)
+			{
+				isEverySectorComputed &= field->Sample(getCellCentre({ x, y })).has_value();
+			}
+		}
+	}
+
+	TEST_ASSERT(isEverySectorComputed);
+
+	const FlowFieldEngine::Field* const field = targetComponent.GetFlowField(sizeClass);
+	TEST_ASSERT(field != nullptr);
+	TEST_ASSERT(field->GetCellSize() == cellSize);
+
+	// Following the directions from any open cell reaches the goal. Sampling at the centre of a cell
+	// returns the direction of that cell, which points towards one of the neighbouring cells.
+	const int maxNumOfSteps = (endCell.x - firstCell.x) * (endCell.y - firstCell.y);
+
+	for (int y = firstCell.y; y < endCell.y; y++)
+	{
+		for (int x = firstCell.x; x < endCell.x; x++)
+		{
+			glm::ivec2 cell{ x, y };
+
+			if (isBlocked(cell))
+			{
+				continue;
+			}
+
+			for (int step = 0; step < maxNumOfSteps && cell != goalCell; step++)
+			{
+				const std::optional<glm::vec2> direction = field->Sample(getCellCentre(cell));
+				TEST_ASSERT(direction.has_value());
+
+				cell += glm::ivec2{ glm::round(*direction) };
+
+				TEST_ASSERT(!isBlocked(cell));
+				TEST_ASSERT(cell.x >= firstCell.x && cell.y >= firstCell.y && cell.x < endCell.x && cell.y < endCell.y);
+			}
+
+			TEST_ASSERT(cell == goalCell);
+		}
+	}
+
+	return UnitTest::Success;
+}
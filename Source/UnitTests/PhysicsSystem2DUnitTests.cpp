@@ -2,6 +2,16 @@
 
 #include "Systems/PhysicsSystem.h"
 #include "Core/UnitTests.h"
+#include "World/Physics.h"
+#include "World/Registry.h"
+#include "World/World.h"
+#include "Components/TransformComponent.h"
+#include "Components/Physics2D/AABBColliderComponent.h"
+#include "Components/Physics2D/DiskColliderComponent.h"
+#include "Components/Physics2D/PhysicsBody2DComponent.h"
+#include "Utilities/BVH.h"
+#include "Utilities/DynamicAABBTree.h"
+#include "Utilities/Random.h"
 
 using namespace CE;
 
@@ -120,3 +130,291 @@ UNIT_TEST(PhysicsSystem, CollisionCheckDiskPolygon)
 	}
 	return UnitTest::Success;
 }
+
+namespace
+{
+	// A fixed seed, so that a failure can be reproduced
+	struct BroadphaseTestRandom
+	{
+		float Range(float min, float max) { return std::uniform_real_distribution<float>{ min, max }(mEngine); }
+		glm::vec2 Position(float worldSize) { return { Range(-worldSize, worldSize), Range(-worldSize, worldSize) }; }
+
+		DefaultRandomEngine mEngine{ 0x5eed };
+	};
+
+	struct CollectHitsFunction
+	{
+		template<typename ObjectShapeType>
+		static void Callback(const ObjectShapeType&, entt::entity owner, std::vector<entt::entity>& hits)
+		{
+			hits.emplace_back(owner);
+		}
+	};
+
+	std::vector<entt::entity> FindOverlappingByBruteForce(const Registry& reg, CollisionLayer layer, const TransformedDisk& inquirer)
+	{
+		std::vector<entt::entity> hits{};
+
+		for (const auto [entity, body, disk] : reg.View<const PhysicsBody2DComponent, const TransformedDiskColliderComponent>().each())
+		{
+			if (body.mRules.mLayer == layer
+				&& AreOverlapping(disk, inquirer))
+			{
+				hits.emplace_back(entity);
+			}
+		}
+
+		for (const auto [entity, body, aabb] : reg.View<const PhysicsBody2DComponent, const TransformedAABBColliderComponent>().each())
+		{
+			if (body.mRules.mLayer == layer
+				&& AreOverlapping(aabb, inquirer))
+			{
+				hits.emplace_back(entity);
+			}
+		}
+
+		std::sort(hits.begin(), hits.end());
+		return hits;
+	}
+
+	// Compares Query, QueryAllHits and QueryAnyHit against testing every collider in the layer
+	bool DoQueriesMatchBruteForce(const World& world, CollisionLayer layer, Span<const TransformedDisk> inquirers)
+	{
+		const Registry& reg = world.GetRegistry();
+		const BVH& bvh = world.GetPhysics().GetBVHs()[static_cast<size_t>(layer)];
+
+		std::vector<std::vector<entt::entity>> allHits{};
+		bvh.QueryAllHits(inquirers, allHits);
+
+		std::vector<char> anyHit(inquirers.size());
+		bvh.QueryAnyHit(inquirers, Span<char>{ anyHit });
+
+		for (size_t i = 0; i < inquirers.size(); i++)
+		{
+			const std::vector<entt::entity> expected = FindOverlappingByBruteForce(reg, layer, inquirers[i]);
+
+			std::vector<entt::entity> batchedHits = allHits[i];
+			std::sort(batchedHits.begin(), batchedHits.end());
+
+			std::vector<entt::entity> singleHits{};
+			bvh.Query<CollectHitsFunction, BVH::DefaultShouldCheckFunction<true>, BVH::DefaultShouldReturnFunction<false>>(inquirers[i], singleHits);
+			std::sort(singleHits.begin(), singleHits.end());
+
+			if (batchedHits != expected
+				|| singleHits != expected
+				|| static_cast<bool>(anyHit[i]) != !expected.empty())
+			{
+				LOG(LogUnitTest, Error, "Inquirer {} in layer {} found {} (batched) and {} (single) hits, expected {}",
+					i, static_cast<int>(layer), batchedHits.size(), singleHits.size(), expected.size());
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	entt::entity CreateCollider(Registry& reg, BroadphaseTestRandom& random, CollisionLayer layer, float worldSize, bool isDisk)
+	{
+		const entt::entity entity = reg.Create();
+		reg.AddComponent<TransformComponent>(entity).SetLocalPosition(random.Position(worldSize));
+		reg.AddComponent<PhysicsBody2DComponent>(entity).mRules.mLayer = layer;
+
+		if (isDisk)
+		{
+			reg.AddComponent<DiskColliderComponent>(entity).mRadius = random.Range(.2f, 2.0f);
+		}
+		else
+		{
+			reg.AddComponent<AABBColliderComponent>(entity).mHalfExtends = { random.Range(.2f, 2.0f), random.Range(.2f, 2.0f) };
+		}
+
+		return entity;
+	}
+}
+
+UNIT_TEST(PhysicsSystem, DynamicAABBTreeMatchesBruteForce)
+{
+	static constexpr uint32 sNumOfObjects = 500;
+	static constexpr float sWorldSize = 50.0f;
+
+	BroadphaseTestRandom random{};
+	DynamicAABBTree tree{};
+
+	std::vector<TransformedAABB> boxes(sNumOfObjects);
+	std::vector<uint32> proxies(sNumOfObjects, DynamicAABBTree::sNull);
+
+	const auto createBox = [&]
+		{
+			const glm::vec2 centre = random.Position(sWorldSize);
+			const glm::vec2 halfSize{ random.Range(.1f, 3.0f), random.Range(.1f, 3.0f) };
+			return TransformedAABB{ centre - halfSize, centre + halfSize };
+		};
+
+	const auto doQueriesMatch = [&]
+		{
+			for (uint32 queryIndex = 0; queryIndex < 64; queryIndex++)
+			{
+				const TransformedAABB inquirer = createBox();
+				std::vector<uint32> numOfTimesReported(sNumOfObjects);
+
+				tree.Query(inquirer,
+					[&](uint32 userData)
+					{
+						++numOfTimesReported[userData];
+						return false;
+					});
+
+				for (uint32 i = 0; i < sNumOfObjects; i++)
+				{
+					const bool isInTree = proxies[i] != DynamicAABBTree::sNull;
+
+					// The leaves are fattened, so objects close to the inquirer may be reported as well
+					if (numOfTimesReported[i] > 1
+						|| (numOfTimesReported[i] == 1 && (!isInTree || !AreOverlapping(tree.GetFatBoundingBox(proxies[i]), inquirer)))
+						|| (numOfTimesReported[i] == 0 && isInTree && AreOverlapping(boxes[i], inquirer)))
+					{
+						LOG(LogUnitTest, Error, "Object {} was reported {} times", i, numOfTimesReported[i]);
+						return false;
+					}
+				}
+			}
+
+			// The tree is kept balanced
+			uint32 numInTree{};
+			for (const uint32 proxy : proxies)
+			{
+				numInTree += proxy != DynamicAABBTree::sNull;
+			}
+			return tree.GetHeight() <= 2 * static_cast<int32>(Math::ceillog2(std::max(numInTree, 2u))) + 2;
+		};
+
+	for (uint32 i = 0; i < sNumOfObjects; i++)
+	{
+		boxes[i] = createBox();
+		proxies[i] = tree.Insert(boxes[i], i);
+	}
+	TEST_ASSERT(doQueriesMatch());
+
+	// Small moves stay within the fattened box, large ones are reinserted
+	for (uint32 i = 0; i < sNumOfObjects; i += 2)
+	{
+		const glm::vec2 offset = i % 4 == 0 ? glm::vec2{ DynamicAABBTree::sFatMargin * .5f, 0.0f } : random.Position(sWorldSize * .5f);
+		boxes[i].mMin += offset;
+		boxes[i].mMax += offset;
+		tree.Move(proxies[i], boxes[i]);
+	}
+	TEST_ASSERT(doQueriesMatch());
+
+	for (uint32 i = 1; i < sNumOfObjects; i += 3)
+	{
+		tree.Remove(proxies[i]);
+		proxies[i] = DynamicAABBTree::sNull;
+	}
+	TEST_ASSERT(doQueriesMatch());
+
+	// Reinserting reuses the freed nodes
+	for (uint32 i = 1; i < sNumOfObjects; i += 6)
+	{
+		boxes[i] = createBox();
+		proxies[i] = tree.Insert(boxes[i], i);
+	}
+	TEST_ASSERT(doQueriesMatch());
+
+	tree.Clear();
+	TEST_ASSERT(tree.IsEmpty());
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(PhysicsSystem, BroadphaseQueriesMatchBruteForce)
+{
+	static constexpr float sWorldSize = 40.0f;
+	static constexpr uint32 sNumOfColliders = 400;
+
+	// One layer for each broadphase
+	static constexpr CollisionLayer sLayers[]{ CollisionLayer::StaticObstacles, CollisionLayer::Projectiles, CollisionLayer::Character };
+	static_assert(GetCollisionLayerBroadphase(CollisionLayer::StaticObstacles) == Broadphase::SurfaceAreaHeuristic);
+	static_assert(GetCollisionLayerBroadphase(CollisionLayer::Projectiles) == Broadphase::DynamicTree);
+	static_assert(GetCollisionLayerBroadphase(CollisionLayer::Character) == Broadphase::SpatialHashGrid);
+
+	for (const CollisionLayer layer : sLayers)
+	{
+		// Not begun play, so that the colliders in the static layer are updated as well
+		World world{ false };
+		Registry& reg = world.GetRegistry();
+		Physics& physics = world.GetPhysics();
+		BroadphaseTestRandom random{};
+
+		std::vector<entt::entity> colliders{};
+
+		for (uint32 i = 0; i < sNumOfColliders; i++)
+		{
+			colliders.emplace_back(CreateCollider(reg, random, layer, sWorldSize, i % 3 != 0));
+		}
+
+		std::vector<TransformedDisk> inquirers{};
+
+		for (uint32 i = 0; i < 256; i++)
+		{
+			inquirers.push_back({ random.Position(sWorldSize), random.Range(.1f, 4.0f) });
+		}
+
+		physics.RebuildBVHs(true);
+		TEST_ASSERT(DoQueriesMatchBruteForce(world, layer, inquirers));
+
+		// Moves
+		for (size_t i = 0; i < colliders.size(); i += 2)
+		{
+			reg.Get<TransformComponent>(colliders[i]).SetLocalPosition(random.Position(sWorldSize));
+		}
+
+		// Removals, of the collider and of the entire entity
+		for (size_t i = 1; i < colliders.size(); i += 7)
+		{
+			if (reg.TryGet<DiskColliderComponent>(colliders[i]) != nullptr)
+			{
+				reg.RemoveComponent<DiskColliderComponent>(colliders[i]);
+			}
+			else
+			{
+				reg.Destroy(colliders[i], true);
+			}
+		}
+		reg.RemovedDestroyed();
+
+		// Inserts
+		for (uint32 i = 0; i < sNumOfColliders / 4; i++)
+		{
+			colliders.emplace_back(CreateCollider(reg, random, layer, sWorldSize, i % 2 == 0));
+		}
+
+		// Dynamic layers refit, the static layer is rebuilt as colliders were added
+		physics.RebuildBVHs();
+		TEST_ASSERT(DoQueriesMatchBruteForce(world, layer, inquirers));
+
+		// Only moves, so that every layer is refitted rather than rebuilt
+		for (const auto [entity, transform, body] : reg.View<TransformComponent, const PhysicsBody2DComponent>().each())
+		{
+			transform.TranslateLocalPosition(glm::vec2{ random.Range(-1.0f, 1.0f), random.Range(-1.0f, 1.0f) });
+		}
+
+		physics.RebuildBVHs();
+		TEST_ASSERT(DoQueriesMatchBruteForce(world, layer, inquirers));
+
+		// Disks moved during collision resolution, within the fattened bounds of the dynamic tree
+		if (GetCollisionLayerBroadphase(layer) == Broadphase::DynamicTree)
+		{
+			BVH& bvh = physics.GetBVHs()[static_cast<size_t>(layer)];
+
+			for (auto [entity, disk] : reg.View<TransformedDiskColliderComponent>().each())
+			{
+				disk.mCentre.x += DynamicAABBTree::sFatMargin * .5f;
+				bvh.OnDiskMoved(entity, disk);
+			}
+
+			TEST_ASSERT(DoQueriesMatchBruteForce(world, layer, inquirers));
+		}
+	}
+
+	return UnitTest::Success;
+}
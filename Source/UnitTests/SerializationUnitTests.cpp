@@ -5,7 +5,9 @@
 #include "Core/UnitTests.h"
 #include "Core/Editor.h"
 #include "Core/AssetManager.h"
+#include "GSON/GSONBinary.h"
 #include "Meta/MetaType.h"
+#include "Utilities/BinarySerialization.h"
 #include "Utilities/view_istream.h"
 #include "World/Registry.h"
 #include "World/World.h"
@@ -91,4 +93,351 @@ using namespace CE;
 //#else
 //	return UnitTest::Success;
 //#endif
-//}
\ No newline at end of file
+//}
+
+namespace
+{
+	Span<const std::byte> AsBytes(std::string_view str)
+	{
+		return { reinterpret_cast<const std::byte*>(str.data()), str.size() };
+	}
+
+	// Contains duplicate names, empty names and sizes that do not fit in a single byte
+	BinaryGSONObject CreateTestGSONObject()
+	{
+		BinaryGSONObject root{ "Root" };
+		root.AddGSONMember("Version") << 3;
+		root.AddGSONMember("LongString") << std::string(300, 'q');
+		root.AddGSONMember("Version") << 4;
+		root.AddGSONMember("") << glm::vec3{ 1.0f, 2.0f, 3.0f };
+
+		BinaryGSONObject& components = root.AddGSONObject("Components");
+
+		for (int i = 0; i < 300; i++)
+		{
+			BinaryGSONObject& component = components.AddGSONObject(i % 3 == 0 ? "Transform" : "Collider" + std::to_string(i % 7));
+			component.AddGSONMember("Index") << i;
+
+			if (i % 5 == 0)
+			{
+				component.AddGSONObject("Nested").AddGSONObject("").AddGSONMember("Deep") << std::string{ "Value" };
+			}
+		}
+
+		root.AddGSONObject("Components").AddGSONMember("IsDuplicate") << true;
+		root.AddGSONObject("");
+		return root;
+	}
+
+	bool DoesViewMatchObject(const BinaryGSONView::Object& view, const BinaryGSONObject& object)
+	{
+		const std::vector<BinaryGSONObject>& children = object.GetChildren();
+		const std::vector<BinaryGSONMember>& members = object.GetGSONMembers();
+
+		if (view.GetName() != object.GetName()
+			|| view.GetChildren().size() != children.size()
+			|| view.GetGSONMembers().size() != members.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < members.size(); i++)
+		{
+			const BinaryGSONView::Member& viewMember = view.GetGSONMembers()[i];
+
+			if (viewMember.GetName() != members[i].GetName()
+				|| viewMember.GetData() != members[i].GetData())
+			{
+				return false;
+			}
+
+			// The same element is found if several share the same name
+			if (view.TryGetGSONMember(members[i].GetName()) - view.GetGSONMembers().data()
+				!= object.TryGetGSONMember(members[i].GetName()) - members.data())
+			{
+				return false;
+			}
+		}
+
+		for (size_t i = 0; i < children.size(); i++)
+		{
+			if (!DoesViewMatchObject(view.GetChildren()[i], children[i]))
+			{
+				return false;
+			}
+
+			if (view.TryGetGSONObject(children[i].GetName()) - view.GetChildren().data()
+				!= object.TryGetGSONObject(children[i].GetName()) - children.data())
+			{
+				return false;
+			}
+		}
+
+		return view.TryGetGSONObject("DoesNotExist") == nullptr
+			&& view.TryGetGSONMember("DoesNotExist") == nullptr;
+	}
+}
+
+UNIT_TEST(Serialization, BinaryGSONViewMatchesObject)
+{
+	const BinaryGSONObject original = CreateTestGSONObject();
+
+	std::string saved{};
+	original.SaveToBinary(saved);
+
+	const std::optional<BinaryGSONView> view = BinaryGSONView::Parse(AsBytes(saved));
+	TEST_ASSERT(view.has_value());
+	TEST_ASSERT(DoesViewMatchObject(view->GetRoot(), original));
+
+	// Both ways of loading a BinaryGSONObject agree with the view
+	BinaryGSONObject loadedFromReader{};
+	BinaryReader reader{ saved };
+	TEST_ASSERT(loadedFromReader.LoadFromBinary(reader));
+	TEST_ASSERT(reader.GetNumOfBytesLeft() == 0);
+	TEST_ASSERT(DoesViewMatchObject(view->GetRoot(), loadedFromReader));
+
+	BinaryGSONObject loadedFromStream{};
+	view_istream stream{ saved };
+	TEST_ASSERT(loadedFromStream.LoadFromBinary(stream));
+	TEST_ASSERT(DoesViewMatchObject(view->GetRoot(), loadedFromStream));
+
+	// Copying the view back into an object produces the same bytes
+	BinaryGSONObject copied{};
+	view->GetRoot().CopyTo(copied);
+
+	std::string resaved{};
+	copied.SaveToBinary(resaved);
+	TEST_ASSERT(resaved == saved);
+
+	int version{};
+	*view->GetRoot().TryGetGSONMember("Version") >> version;
+	TEST_ASSERT(version == 3);
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(Serialization, BinaryGSONViewRejectsInvalidInput)
+{
+	std::string saved{};
+	CreateTestGSONObject().SaveToBinary(saved);
+
+	// Every byte is needed, so any truncation is invalid
+	for (size_t size = 0; size < saved.size(); size++)
+	{
+		TEST_ASSERT(!BinaryGSONView::Parse(AsBytes(std::string_view{ saved }.substr(0, size))).has_value());
+	}
+
+	// The smallest valid objects, every child takes up at least three bytes and every member at least two
+	const std::string emptyObject{ 0, 0, 0 };
+	const std::string smallestChild{ 0, 1, 0, 0, 0, 0 };
+	const std::string smallestMember{ 0, 0, 1, 0, 0 };
+
+	TEST_ASSERT(BinaryGSONView::Parse(AsBytes(emptyObject)).has_value());
+
+	const std::optional<BinaryGSONView> withChild = BinaryGSONView::Parse(AsBytes(smallestChild));
+	TEST_ASSERT(withChild.has_value() && withChild->GetRoot().GetChildren().size() == 1);
+
+	const std::optional<BinaryGSONView> withMember = BinaryGSONView::Parse(AsBytes(smallestMember));
+	TEST_ASSERT(withMember.has_value() && withMember->GetRoot().GetGSONMembers().size() == 1);
+
+	// More children or members than could possibly fit in the remaining bytes
+	const std::string tooManyChildren{ 4, 'R', 'o', 'o', 't', static_cast<char>(200), 0, 0, 0, 0, 0, 0 };
+	const std::string tooManyMembers{ 0, 0, static_cast<char>(200), 1, 'a', 0, 0, 0 };
+	const std::string hugeSize{ 0, static_cast<char>(0xff), static_cast<char>(0xfe), static_cast<char>(0xff), 0, 0 };
+
+	// A name longer than the remaining bytes
+	const std::string nameTooLong{ 50, 'a', 'b', 0, 0 };
+
+	TEST_ASSERT(!BinaryGSONView::Parse(AsBytes(tooManyChildren)).has_value());
+	TEST_ASSERT(!BinaryGSONView::Parse(AsBytes(tooManyMembers)).has_value());
+	TEST_ASSERT(!BinaryGSONView::Parse(AsBytes(hugeSize)).has_value());
+	TEST_ASSERT(!BinaryGSONView::Parse(AsBytes(nameTooLong)).has_value());
+
+	return UnitTest::Success;
+}
+
+namespace
+{
+	enum class TestEnum : uint16
+	{
+		First,
+		Second = 513
+	};
+
+	// Not trivially copyable, so always serialized through cereal
+	struct TestCerealType
+	{
+		int32 mNumber{};
+		std::string mText{};
+		std::vector<glm::vec2> mPoints{};
+
+		bool operator==(const TestCerealType& other) const
+		{
+			return mNumber == other.mNumber && mText == other.mText && mPoints == other.mPoints;
+		}
+
+		template<class Archive>
+		void serialize(Archive& ar)
+		{
+			ar(mNumber, mText, mPoints);
+		}
+	};
+
+	static_assert(Internal::sIsRawBinary<float>);
+	static_assert(Internal::sIsRawBinary<TestEnum>);
+	static_assert(Internal::sIsRawBinary<glm::mat4>);
+	static_assert(Internal::sIsRawBinary<glm::quat>);
+	static_assert(Internal::sIsRawBinary<std::array<glm::ivec2, 3>>);
+	static_assert(Internal::IsRawBinaryRange<std::vector<glm::vec3>>::value);
+	static_assert(Internal::IsRawBinaryRange<std::string>::value);
+	static_assert(!Internal::sIsRawBinary<TestCerealType>);
+	static_assert(!Internal::IsRawBinaryRange<std::vector<bool>>::value);
+	static_assert(!Internal::IsRawBinaryRange<std::vector<std::string>>::value);
+
+	// How ToBinary and FromBinary were implemented before the BinaryWriter and BinaryReader
+	template<typename T>
+	std::string ToBinaryUsingCereal(const T& value)
+	{
+		std::stringstream ss{};
+
+		{
+			cereal::BinaryOutputArchive outArchive{ ss };
+			outArchive(value);
+		}
+
+		return ss.str();
+	}
+
+	template<typename T>
+	T FromBinaryUsingCereal(std::string_view binaryString)
+	{
+		T value{};
+		view_istream view{ binaryString };
+		cereal::BinaryInputArchive inArchive{ view };
+		inArchive(value);
+		return value;
+	}
+
+	template<typename T>
+	bool DoesRoundTrip(const T& value)
+	{
+		const std::string expected = ToBinaryUsingCereal(value);
+
+		// The writer appends to whatever is already in the buffer
+		std::string buffer = "Prefix";
+		BinaryWriter{ buffer }.Write(value);
+
+		if (buffer != "Prefix" + expected
+			|| ToBinary(value) != expected)
+		{
+			LOG(LogUnitTests, Error, "Saving a {} did not produce the same bytes as cereal", typeid(T).name());
+			return false;
+		}
+
+		BinaryReader reader{ std::string_view{ buffer }.substr(6) };
+		T loaded{};
+
+		if (!reader.Read(loaded)
+			|| reader.HasFailed()
+			|| reader.GetNumOfBytesLeft() != 0
+			|| !(loaded == value)
+			|| !(FromBinaryUsingCereal<T>(expected) == value)
+			|| !(FromBinary<T>(expected) == value))
+		{
+			LOG(LogUnitTests, Error, "Loading a {} did not produce the saved value", typeid(T).name());
+			return false;
+		}
+
+		// Missing the last byte
+		BinaryReader truncatedReader{ std::string_view{ expected }.substr(0, expected.size() - 1) };
+		T truncated{};
+
+		if (truncatedReader.Read(truncated)
+			|| !truncatedReader.HasFailed())
+		{
+			LOG(LogUnitTests, Error, "Loading a truncated {} did not fail", typeid(T).name());
+			return false;
+		}
+
+		return true;
+	}
+}
+
+UNIT_TEST(Serialization, BinaryWriterMatchesCereal)
+{
+	// Copied directly
+	TEST_ASSERT(DoesRoundTrip(int32{ -123456 }));
+	TEST_ASSERT(DoesRoundTrip(uint8{ 255 }));
+	TEST_ASSERT(DoesRoundTrip(uint64{ 0x0123456789abcdefull }));
+	TEST_ASSERT(DoesRoundTrip(-1.5f));
+	TEST_ASSERT(DoesRoundTrip(3.25));
+	TEST_ASSERT(DoesRoundTrip(true));
+	TEST_ASSERT(DoesRoundTrip(TestEnum::Second));
+	TEST_ASSERT(DoesRoundTrip(glm::vec2{ 1.0f, -2.0f }));
+	TEST_ASSERT(DoesRoundTrip(glm::ivec3{ 1, -2, 3 }));
+	TEST_ASSERT(DoesRoundTrip(glm::vec4{ 1.0f, 2.0f, 3.0f, 4.0f }));
+	TEST_ASSERT(DoesRoundTrip(glm::quat{ .5f, -.5f, .5f, -.5f }));
+	TEST_ASSERT(DoesRoundTrip(glm::mat4{ 2.0f }));
+	TEST_ASSERT(DoesRoundTrip(std::array<float, 3>{ 1.0f, 2.0f, 3.0f }));
+	TEST_ASSERT(DoesRoundTrip(std::vector<float>{}));
+	TEST_ASSERT(DoesRoundTrip(std::vector<glm::vec3>{ { 1.0f, 2.0f, 3.0f }, { 4.0f, 5.0f, 6.0f } }));
+	TEST_ASSERT(DoesRoundTrip(std::string{}));
+	TEST_ASSERT(DoesRoundTrip(std::string{ "With a \0 in it", 14 }));
+	TEST_ASSERT(DoesRoundTrip(std::string(1000, 'x')));
+
+	// Serialized through cereal
+	TEST_ASSERT(DoesRoundTrip(std::vector<bool>{ true, false, true }));
+	TEST_ASSERT(DoesRoundTrip(std::vector<std::string>{ "First", "", "Third" }));
+	TEST_ASSERT(DoesRoundTrip(std::pair<int32, std::string>{ 7, "Seven" }));
+	TEST_ASSERT(DoesRoundTrip(std::optional<int32>{ 42 }));
+	TEST_ASSERT(DoesRoundTrip(std::unordered_map<std::string, int32>{ { "One", 1 } }));
+	TEST_ASSERT(DoesRoundTrip(TestCerealType{ 5, "Five", { { 1.0f, 2.0f } } }));
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(Serialization, BinaryReaderReadsConsecutiveValues)
+{
+	const TestCerealType cerealValue{ -1, "Text", { { 3.0f, 4.0f }, { 5.0f, 6.0f } } };
+	const std::vector<glm::vec2> rangeValue{ { 7.0f, 8.0f } };
+
+	// Alternating between the fast path and cereal, which has to report how many bytes it read
+	std::string buffer{};
+	BinaryWriter writer{ buffer };
+	writer.Write(uint16{ 12345 });
+	writer.Write(cerealValue);
+	writer.Write(rangeValue);
+	writer.Write(std::string{ "End" });
+	writer.Write(cerealValue);
+	writer.Write(2.5f);
+
+	BinaryReader reader{ buffer };
+
+	uint16 first{};
+	TestCerealType second{};
+	std::vector<glm::vec2> third{};
+	std::string fourth{};
+	TestCerealType fifth{};
+	float sixth{};
+
+	TEST_ASSERT(reader.Read(first) && first == 12345);
+	TEST_ASSERT(reader.Read(second) && second == cerealValue);
+	TEST_ASSERT(reader.Read(third) && third == rangeValue);
+	TEST_ASSERT(reader.Read(fourth) && fourth == "End");
+	TEST_ASSERT(reader.Read(fifth) && fifth == cerealValue);
+	TEST_ASSERT(reader.Read(sixth) && sixth == 2.5f);
+	TEST_ASSERT(reader.GetNumOfBytesLeft() == 0);
+
+	// Once a read has failed, all the reads after it fail as well
+	TEST_ASSERT(!reader.Read(sixth));
+
+	BinaryReader failedReader{ buffer };
+	std::vector<float> tooLarge{};
+
+	// The size of the range is read from the first bytes, which claim far more elements than there are bytes
+	TEST_ASSERT(!failedReader.Read(tooLarge));
+	TEST_ASSERT(!failedReader.Read(first));
+	TEST_ASSERT(failedReader.HasFailed());
+
+	return UnitTest::Success;
+}
@@ -0,0 +1,267 @@
+#include "Precomp.h"
+
+#include "Core/UnitTests.h"
+#include "World/Registry.h"
+#include "World/World.h"
+#include "Components/TransformComponent.h"
+
+using namespace CE;
+
+// How the world matrix was calculated before it was resolved lazily; walks up the entire hierarchy every time
+static glm::mat4 CalculateWorldMatrixEagerly(const TransformComponent& transform)
+{
+	const glm::mat4 localMatrix = TransformComponent::ToMatrix(transform.GetLocalPosition(), transform.GetLocalScale(), transform.GetLocalOrientation());
+	const TransformComponent* parent = transform.GetParent();
+	return parent == nullptr ? localMatrix : CalculateWorldMatrixEagerly(*parent) * localMatrix;
+}
+
+static bool AreMatricesEqual(const glm::mat4& a, const glm::mat4& b)
+{
+	for (int column = 0; column < 4; column++)
+	{
+		for (int row = 0; row < 4; row++)
+		{
+			if (!Math::AreFloatsEqual(a[column][row], b[column][row], 1e-3f))
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static bool AreVectorsEqual(const glm::vec3 a, const glm::vec3 b)
+{
+	return Math::AreFloatsEqual(a.x, b.x, 1e-3f)
+		&& Math::AreFloatsEqual(a.y, b.y, 1e-3f)
+		&& Math::AreFloatsEqual(a.z, b.z, 1e-3f);
+}
+
+static bool DoesWorldMatrixMatchEagerComputation(const TransformComponent& transform)
+{
+	return AreMatricesEqual(transform.GetWorldMatrix(), CalculateWorldMatrixEagerly(transform));
+}
+
+UNIT_TEST(Transform, ManyChildrenMatchEagerComputation)
+{
+	World world{ false };
+	Registry& reg = world.GetRegistry();
+
+	const entt::entity rootOwner = reg.Create();
+	TransformComponent& root = reg.AddComponent<TransformComponent>(rootOwner);
+
+	std::vector<entt::entity> owners{};
+
+	for (uint32 i = 0; i < 256; i++)
+	{
+		const entt::entity childOwner = reg.Create();
+		TransformComponent& child = reg.AddComponent<TransformComponent>(childOwner);
+		child.SetParent(&root);
+		child.SetLocalPosition(glm::vec3{ static_cast<float>(i), 1.0f, -2.0f });
+		child.SetLocalOrientation(glm::vec3{ 0.0f, 0.01f * static_cast<float>(i), 0.0f });
+		owners.emplace_back(childOwner);
+
+		// Some grandchildren, so that more than one level is out of date
+		if (i % 4 == 0)
+		{
+			const entt::entity grandChildOwner = reg.Create();
+			TransformComponent& grandChild = reg.AddComponent<TransformComponent>(grandChildOwner);
+			grandChild.SetParent(&child);
+			grandChild.SetLocalPosition(glm::vec3{ 0.0f, 0.0f, 3.0f });
+			grandChild.SetLocalScale(0.5f);
+			owners.emplace_back(grandChildOwner);
+		}
+	}
+
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	// Both are applied before the world transforms are resolved again
+	root.SetLocalPosition(glm::vec3{ 10.0f, -5.0f, 2.0f });
+	root.SetLocalOrientation(glm::vec3{ 0.3f, 1.2f, -0.4f });
+
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	for (const entt::entity owner : owners)
+	{
+		TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(reg.Get<TransformComponent>(owner)));
+	}
+
+	// Requesting the world matrix before the next update resolves it on demand
+	root.SetLocalScale(glm::vec3{ 2.0f });
+	root.SetLocalOrientation(glm::vec3{ -0.2f, 0.5f, 0.0f });
+
+	for (const entt::entity owner : owners)
+	{
+		TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(reg.Get<TransformComponent>(owner)));
+	}
+
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	for (const entt::entity owner : owners)
+	{
+		TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(reg.Get<TransformComponent>(owner)));
+	}
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(Transform, ReparentDirtyChild)
+{
+	World world{ false };
+	Registry& reg = world.GetRegistry();
+
+	TransformComponent& parentA = reg.AddComponent<TransformComponent>(reg.Create());
+	TransformComponent& parentB = reg.AddComponent<TransformComponent>(reg.Create());
+	TransformComponent& child = reg.AddComponent<TransformComponent>(reg.Create());
+	TransformComponent& grandChild = reg.AddComponent<TransformComponent>(reg.Create());
+
+	parentA.SetLocalPosition(glm::vec3{ 1.0f, 2.0f, 3.0f });
+	parentB.SetLocalPosition(glm::vec3{ -4.0f, 0.0f, 8.0f });
+	parentB.SetLocalOrientation(glm::vec3{ 0.0f, 1.0f, 0.0f });
+	child.SetParent(&parentA);
+	grandChild.SetParent(&child);
+	grandChild.SetLocalPosition(glm::vec3{ 0.0f, 1.0f, 0.0f });
+
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	// Out of date when it is moved to the other parent
+	child.SetLocalPosition(glm::vec3{ 5.0f, 0.0f, 0.0f });
+	child.SetParent(&parentB);
+
+	TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(child));
+	TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(grandChild));
+
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(child));
+	TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(grandChild));
+
+	// Moving the old parent no longer affects the child
+	const glm::mat4 childWorldBefore = child.GetWorldMatrix();
+	parentA.SetLocalPosition(glm::vec3{ 100.0f, 0.0f, 0.0f });
+	TransformComponent::UpdateWorldTransforms(reg);
+	TEST_ASSERT(AreMatricesEqual(child.GetWorldMatrix(), childWorldBefore));
+
+	// Keeping the world transform while reparenting a dirty child
+	child.SetLocalPosition(glm::vec3{ 0.0f, 0.0f, -7.0f });
+	const glm::mat4 expectedWorld = CalculateWorldMatrixEagerly(child);
+	child.SetParent(&parentA, true);
+
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	TEST_ASSERT(AreMatricesEqual(child.GetWorldMatrix(), expectedWorld));
+	TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(child));
+	TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(grandChild));
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(Transform, RemoveDirtyRoot)
+{
+	World world{ false };
+	Registry& reg = world.GetRegistry();
+
+	const entt::entity rootOwner = reg.Create();
+	TransformComponent& root = reg.AddComponent<TransformComponent>(rootOwner);
+	TransformComponent& otherRoot = reg.AddComponent<TransformComponent>(reg.Create());
+
+	std::vector<entt::entity> childOwners{};
+
+	for (uint32 i = 0; i < 8; i++)
+	{
+		const entt::entity childOwner = reg.Create();
+		TransformComponent& child = reg.AddComponent<TransformComponent>(childOwner);
+		child.SetParent(&root);
+		child.SetLocalPosition(glm::vec3{ 0.0f, static_cast<float>(i), 0.0f });
+		childOwners.emplace_back(childOwner);
+	}
+
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	// Both roots are now waiting to be updated
+	root.SetLocalPosition(glm::vec3{ 3.0f, 3.0f, 3.0f });
+	otherRoot.SetLocalPosition(glm::vec3{ -1.0f, 0.0f, 0.0f });
+
+	std::vector<glm::mat4> expectedChildWorlds{};
+
+	for (const entt::entity childOwner : childOwners)
+	{
+		expectedChildWorlds.emplace_back(CalculateWorldMatrixEagerly(reg.Get<TransformComponent>(childOwner)));
+	}
+
+	// The children keep their world transform, and become roots themselves
+	reg.RemoveComponent<TransformComponent>(rootOwner);
+
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(otherRoot));
+
+	for (size_t i = 0; i < childOwners.size(); i++)
+	{
+		const TransformComponent& child = reg.Get<TransformComponent>(childOwners[i]);
+		TEST_ASSERT(child.GetParent() == nullptr);
+		TEST_ASSERT(AreMatricesEqual(child.GetWorldMatrix(), expectedChildWorlds[i]));
+	}
+
+	// A new transform on the same entity starts out clean
+	TransformComponent& readded = reg.AddComponent<TransformComponent>(rootOwner);
+	readded.SetLocalPosition(glm::vec3{ 0.0f, 0.0f, 9.0f });
+	TransformComponent::UpdateWorldTransforms(reg);
+	TEST_ASSERT(DoesWorldMatrixMatchEagerComputation(readded));
+
+	return UnitTest::Success;
+}
+
+UNIT_TEST(Transform, ComposedWorldScaleAndOrientation)
+{
+	World world{ false };
+	Registry& reg = world.GetRegistry();
+
+	TransformComponent& parent = reg.AddComponent<TransformComponent>(reg.Create());
+	TransformComponent& child = reg.AddComponent<TransformComponent>(reg.Create());
+	TransformComponent& grandChild = reg.AddComponent<TransformComponent>(reg.Create());
+
+	child.SetParent(&parent);
+	grandChild.SetParent(&child);
+
+	parent.SetLocalScale(glm::vec3{ 2.0f, 3.0f, 4.0f });
+	parent.SetLocalOrientation(glm::vec3{ 0.5f, 0.0f, 0.2f });
+	child.SetLocalScale(glm::vec3{ 0.5f, 2.0f, 1.0f });
+	child.SetLocalOrientation(glm::vec3{ 0.0f, 1.1f, 0.0f });
+	grandChild.SetLocalScale(glm::vec3{ 3.0f, 1.0f, 0.25f });
+	grandChild.SetLocalOrientation(glm::vec3{ -0.7f, 0.0f, 0.3f });
+
+	// Resolved on demand
+	TEST_ASSERT(AreVectorsEqual(grandChild.GetWorldScale(), parent.GetLocalScale() * child.GetLocalScale() * grandChild.GetLocalScale()));
+
+	const glm::quat expectedOrientation = parent.GetLocalOrientation() * child.GetLocalOrientation() * grandChild.GetLocalOrientation();
+	TEST_ASSERT(Math::AreFloatsEqual(std::abs(glm::dot(grandChild.GetWorldOrientation(), expectedOrientation)), 1.0f, 1e-4f));
+
+	// And after a batched update
+	parent.SetLocalScale(glm::vec3{ 1.5f });
+	parent.SetLocalOrientation(glm::vec3{ 0.0f, -0.4f, 0.0f });
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	TEST_ASSERT(AreVectorsEqual(grandChild.GetWorldScale(), parent.GetLocalScale() * child.GetLocalScale() * grandChild.GetLocalScale()));
+
+	const glm::quat newExpectedOrientation = parent.GetLocalOrientation() * child.GetLocalOrientation() * grandChild.GetLocalOrientation();
+	TEST_ASSERT(Math::AreFloatsEqual(std::abs(glm::dot(grandChild.GetWorldOrientation(), newExpectedOrientation)), 1.0f, 1e-4f));
+
+	// Without non-uniform scales, the composed values describe the same transform as the world matrix
+	child.SetLocalScale(glm::vec3{ 2.0f });
+	grandChild.SetLocalScale(glm::vec3{ 0.5f });
+	TransformComponent::UpdateWorldTransforms(reg);
+
+	const glm::mat4& worldMatrix = grandChild.GetWorldMatrix();
+	const glm::vec3 worldScale = grandChild.GetWorldScale();
+	const glm::quat worldOrientation = grandChild.GetWorldOrientation();
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		const glm::vec3 column{ worldMatrix[axis] };
+		TEST_ASSERT(Math::AreFloatsEqual(glm::length(column), worldScale[axis], 1e-3f));
+		TEST_ASSERT(AreVectorsEqual(glm::normalize(column), Math::RotateVector(ToVector3(static_cast<Axis::Values>(axis)), worldOrientation)));
+	}
+
+	return UnitTest::Success;
+}
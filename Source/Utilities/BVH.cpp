@@ -1,6 +1,8 @@
 #include "Precomp.h"
 #include "Utilities/BVH.h"
 
+#include <xmmintrin.h>
+
 #include "Components/TransformComponent.h"
 #include "Components/Physics2D/AABBColliderComponent.h"
 #include "Components/Physics2D/DiskColliderComponent.h"
@@ -8,65 +10,93 @@
 #include "World/Registry.h"
 #include "Utilities/DrawDebugHelpers.h"
 #include "World/Physics.h"
+#include "Utilities/Profiler.h"
 
 CE::BVH::BVH(Physics& physics, CollisionLayer layer) :
     mPhysics(&physics),
-    mLayer(layer)
+    mLayer(layer),
+    mBroadphase(GetCollisionLayerBroadphase(layer))
 {
     mNodes.resize(4);
 }
 
-void CE::BVH::Build()
+void CE::BVH::Colliders::Clear()
 {
+    mAABBs.clear();
+    mDisks.clear();
+    mPolygons.clear();
+}
+
+void CE::BVH::Build(const Colliders& colliders)
+{
+    PROFILE_FUNCTION();
+    PROFILE_COUNTER_ADD("BVH rebuilds", 1);
+
+    if (mBroadphase == Broadphase::SpatialHashGrid)
+    {
+        BuildGrid(colliders);
+        return;
+    }
+
+    if (mBroadphase == Broadphase::DynamicTree)
+    {
+        mTree.Clear();
+        mObjects.Clear();
+        mProxies.clear();
+        mObjectTypes.clear();
+
+        for (std::vector<uint32>& objectIndexOfEntity : mObjectIndexOfEntity)
+        {
+            objectIndexOfEntity.clear();
+        }
+
+        UpdateDynamicTree(colliders);
+        return;
+    }
+
     // Paranoia
     memset(mNodes.data(), 0, mNodes.capacity() * sizeof(mNodes[0]));
-    memset(mIds.data(), 0, mIds.capacity() * sizeof(mIds[0]));
 
     mNodes.clear();
-    mIds.clear();
+    mObjects.Clear();
     mAmountRefitted = 0.0f;
 
     const Registry& reg = mPhysics->GetWorld().GetRegistry();
 
-    const auto aabbView = reg.View<PhysicsBody2DComponent, TransformedAABBColliderComponent>();
-    const auto circlesView = reg.View<PhysicsBody2DComponent, TransformedDiskColliderComponent>();
-    const auto polygonView = reg.View<PhysicsBody2DComponent, TransformedPolygonColliderComponent>();
-
-    for (const entt::entity entity : aabbView)
+    for (const entt::entity entity : colliders.mAABBs)
     {
-        if (aabbView.get<PhysicsBody2DComponent>(entity).mRules.mLayer == mLayer)
-        {
-            mIds.emplace_back(entity);
-        }
+        const TransformedAABB& aabb = reg.Get<TransformedAABBColliderComponent>(entity);
+        mObjects.Add(entity, aabb, aabb.GetCentre(), 0.0f);
     }
 
-    const uint32 numOfAABBs = static_cast<uint32>(mIds.size());
+    const uint32 numOfAABBs = static_cast<uint32>(mObjects.mIds.size());
 
-    for (const entt::entity entity : circlesView)
+    for (const entt::entity entity : colliders.mDisks)
     {
-        if (circlesView.get<PhysicsBody2DComponent>(entity).mRules.mLayer == mLayer)
-        {
-            mIds.emplace_back(entity);
-        }
+        const TransformedDisk& circle = reg.Get<TransformedDiskColliderComponent>(entity);
+        mObjects.Add(entity, circle.GetBoundingBox(), circle.mCentre, circle.mRadius);
     }
 
-    const uint32 numOfCircles = static_cast<uint32>(mIds.size()) - numOfAABBs;
+    const uint32 numOfCircles = static_cast<uint32>(mObjects.mIds.size()) - numOfAABBs;
 
-    for (const entt::entity entity : polygonView)
+    for (const entt::entity entity : colliders.mPolygons)
     {
-        if (polygonView.get<PhysicsBody2DComponent>(entity).mRules.mLayer == mLayer)
-        {
-            mIds.emplace_back(entity);
-        }
+        const TransformedPolygon& polygon = reg.Get<TransformedPolygonColliderComponent>(entity);
+        mObjects.Add(entity, polygon.GetBoundingBox(), polygon.mBoundingBox.GetCentre(), 0.0f);
     }
 
-    const uint32 numOfPolygons = static_cast<uint32>(mIds.size()) - numOfAABBs - numOfCircles;
+    const uint32 numOfPolygons = static_cast<uint32>(mObjects.mIds.size()) - numOfAABBs - numOfCircles;
     const uint32 totalNumObjects = numOfAABBs + numOfCircles + numOfPolygons;
 
-    if (totalNumObjects != 0)
+    // Padding, so the last disks can be tested in a full group
+    for (uint32 i = 1; i < sNumOfDisksPerTest; i++)
     {
-        mIds.resize(totalNumObjects);
+        mObjects.Add(entt::null, {}, {}, 0.0f);
+        mObjects.SetInvalid(totalNumObjects + i - 1);
+    }
 
+    if (totalNumObjects != 0)
+    {
         size_t maxSize = (2 * totalNumObjects - 1) * 2;
 
         if (mNodes.capacity() < maxSize)
@@ -87,6 +117,7 @@ void CE::BVH::Build()
     if (mEmpty)
     {
         mNodes.resize(4);
+        UpdateObjectIndexOfEntity();
         return;
     }
 
@@ -96,14 +127,29 @@ void CE::BVH::Build()
 
     UpdateNodeBounds(root);
 
-    if (root.mTotalNumOfObjects > 2)
+    if (root.mTotalNumOfObjects > sMaxNumOfObjectsInLeaf)
     {
         Subdivide(root);
     }
+
+    UpdateObjectIndexOfEntity();
 }
 
-void CE::BVH::Refit()
+void CE::BVH::Refit(const Colliders& colliders)
 {
+    // Rebuilding the grid is O(n), which is cheaper than moving the objects around in it
+    if (mBroadphase == Broadphase::SpatialHashGrid)
+    {
+        BuildGrid(colliders);
+        return;
+    }
+
+    if (mBroadphase == Broadphase::DynamicTree)
+    {
+        UpdateDynamicTree(colliders);
+        return;
+    }
+
     if (mEmpty)
     {
         return;
@@ -120,6 +166,7 @@ void CE::BVH::Refit()
         if (node.mTotalNumOfObjects != 0)
         {
             // leaf node: adjust bounds to contained triangles
+            SyncObjects(node);
             mAmountRefitted += UpdateNodeBounds(node);
             continue;
         }
@@ -134,6 +181,26 @@ void CE::BVH::Refit()
 
 void CE::BVH::DebugDraw() const
 {
+    if (mBroadphase == Broadphase::SpatialHashGrid)
+    {
+        mGrid.ForEachOccupiedCell(
+            [this](const TransformedAABB& boundingBox)
+            {
+                DrawDebugRectangle(mPhysics->GetWorld(), DebugCategory::AccelStructs, To3DRightForward(boundingBox.GetCentre()), boundingBox.GetSize() * .5f, glm::vec4{ 0.0f, 1.0f, 1.0f, 1.0f });
+            });
+        return;
+    }
+
+    if (mBroadphase == Broadphase::DynamicTree)
+    {
+        mTree.ForEachInternalNode(
+            [this](const TransformedAABB& boundingBox)
+            {
+                DrawDebugRectangle(mPhysics->GetWorld(), DebugCategory::AccelStructs, To3DRightForward(boundingBox.GetCentre()), boundingBox.GetSize() * .5f, glm::vec4{ 0.0f, 1.0f, 1.0f, 1.0f });
+            });
+        return;
+    }
+
     if (mEmpty)
     {
         return;
@@ -154,6 +221,35 @@ void CE::BVH::DebugDraw() const
     }
 }
 
+void CE::BVH::OnDiskMoved(const entt::entity owner, const TransformedDisk& disk)
+{
+    const std::vector<uint32>& objectIndexOfEntity = mObjectIndexOfEntity[static_cast<size_t>(ObjectType::Disk)];
+    const size_t entityIndex = static_cast<size_t>(entt::to_entity(owner));
+
+    if (entityIndex >= objectIndexOfEntity.size())
+    {
+        return;
+    }
+
+    const uint32 objectIndex = objectIndexOfEntity[entityIndex];
+
+    // The index may belong to an entity that was destroyed, which had the same entity index
+    if (objectIndex == DynamicAABBTree::sNull
+        || mObjects.mIds[objectIndex] != owner)
+    {
+        return;
+    }
+
+    const TransformedAABB boundingBox = disk.GetBoundingBox();
+    mObjects.Set(objectIndex, boundingBox, disk.mCentre, disk.mRadius);
+
+    // Cheap as long as the disk stays within its fattened bounding box
+    if (mBroadphase == Broadphase::DynamicTree)
+    {
+        mTree.Move(mProxies[objectIndex], boundingBox);
+    }
+}
+
 const CE::Registry& CE::BVH::GetRegistry() const
 {
     return mPhysics->GetWorld().GetRegistry();
@@ -166,55 +262,93 @@ float CE::BVH::UpdateNodeBounds(Node& node)
     node.mBoundingBox.mMin = glm::vec2(INFINITY);
     node.mBoundingBox.mMax = glm::vec2(-INFINITY);
 
-    uint32 indexOfId = node.mStartIndex;
+    const uint32 end = node.mStartIndex + node.mTotalNumOfObjects;
+
+    for (uint32 index = node.mStartIndex; index < end; index++)
+    {
+        if (mObjects.IsValid(index))
+        {
+            node.mBoundingBox.CombineWith(mObjects.GetBoundingBox(index));
+        }
+    }
+
+    return glm::distance2(initialAABB.mMin, node.mBoundingBox.mMin) + glm::distance2(initialAABB.mMax, node.mBoundingBox.mMax);
+}
+
+void CE::BVH::SyncObjects(const Node& node)
+{
+    uint32 index = node.mStartIndex;
     const Registry& reg = mPhysics->GetWorld().GetRegistry();
 
-    for (uint32 i = 0; i < node.mNumOfAABBS; i++, indexOfId++)
+    for (uint32 i = 0; i < node.mNumOfAABBS; i++, index++)
     {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedAABB* const aabb = reg.TryGet<TransformedAABBColliderComponent>(owner);
+        const TransformedAABB* const aabb = reg.TryGet<TransformedAABBColliderComponent>(mObjects.mIds[index]);
 
         if (aabb != nullptr)
         {
-    		    node.mBoundingBox.CombineWith(*aabb);
+            mObjects.Set(index, *aabb, aabb->GetCentre(), 0.0f);
+        }
+        else
+        {
+            mObjects.SetInvalid(index);
         }
     }
 
-    for (uint32 i = 0; i < node.mNumOfCircles; i++, indexOfId++)
+    for (uint32 i = 0; i < node.mNumOfCircles; i++, index++)
     {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedDisk* const circle = reg.TryGet<TransformedDiskColliderComponent>(owner);
+        const TransformedDisk* const circle = reg.TryGet<TransformedDiskColliderComponent>(mObjects.mIds[index]);
 
         if (circle != nullptr)
         {
-			      node.mBoundingBox.CombineWith(circle->GetBoundingBox());
+            mObjects.Set(index, circle->GetBoundingBox(), circle->mCentre, circle->mRadius);
+        }
+        else
+        {
+            mObjects.SetInvalid(index);
         }
     }
 
     const uint32 numOfPolygons = node.mTotalNumOfObjects - node.mNumOfAABBS - node.mNumOfCircles;
-    for (uint32 i = 0; i < numOfPolygons; i++, indexOfId++)
+    for (uint32 i = 0; i < numOfPolygons; i++, index++)
     {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedPolygon* const polygon = reg.TryGet<TransformedPolygonColliderComponent>(owner);
+        const TransformedPolygon* const polygon = reg.TryGet<TransformedPolygonColliderComponent>(mObjects.mIds[index]);
 
         if (polygon != nullptr)
         {
-            node.mBoundingBox.CombineWith(polygon->GetBoundingBox());
+            mObjects.Set(index, polygon->GetBoundingBox(), polygon->mBoundingBox.GetCentre(), 0.0f);
+        }
+        else
+        {
+            mObjects.SetInvalid(index);
         }
     }
+}
 
-    return glm::distance2(initialAABB.mMin, node.mBoundingBox.mMin) + glm::distance2(initialAABB.mMax, node.mBoundingBox.mMax);
+uint32 CE::BVH::FindOverlappingDisks(const TransformedDisk inquirer, const uint32 firstIndex) const
+{
+    // Same test as AreOverlapping(TransformedDisk, TransformedDisk), but for four disks at once
+    const __m128 deltaX = _mm_sub_ps(_mm_loadu_ps(&mObjects.mCentreX[firstIndex]), _mm_set1_ps(inquirer.mCentre.x));
+    const __m128 deltaY = _mm_sub_ps(_mm_loadu_ps(&mObjects.mCentreY[firstIndex]), _mm_set1_ps(inquirer.mCentre.y));
+    const __m128 distance2 = _mm_add_ps(_mm_mul_ps(deltaX, deltaX), _mm_mul_ps(deltaY, deltaY));
+
+    const __m128 radius = _mm_loadu_ps(&mObjects.mRadius[firstIndex]);
+    const __m128 combinedRadius = _mm_add_ps(radius, _mm_set1_ps(inquirer.mRadius));
+
+    // Removed disks have a negative radius
+    const __m128 isValid = _mm_cmpge_ps(radius, _mm_setzero_ps());
+    const __m128 isOverlapping = _mm_cmple_ps(distance2, _mm_mul_ps(combinedRadius, combinedRadius));
+
+    return static_cast<uint32>(_mm_movemask_ps(_mm_and_ps(isValid, isOverlapping)));
 }
 
 void CE::BVH::Subdivide(Node& node)
 {
     const SplitPoint splitPoint = DetermineSplitPos(node);
 
-    static std::vector<entt::entity> childrenIds[2]{};
-    childrenIds[0].clear();
-    childrenIds[1].clear();
-    childrenIds[0].reserve(node.mTotalNumOfObjects);
-    childrenIds[1].reserve(node.mTotalNumOfObjects);
+    mChildrenObjects[0].Clear();
+    mChildrenObjects[1].Clear();
+    mChildrenObjects[0].Reserve(node.mTotalNumOfObjects);
+    mChildrenObjects[1].Reserve(node.mTotalNumOfObjects);
 
     ASSERT(mNodes.size() + 2 <= mNodes.capacity());
     uint32 firstNodeIndex = static_cast<uint32>(mNodes.size());
@@ -232,79 +366,45 @@ void CE::BVH::Subdivide(Node& node)
         children[i]->mNumOfAABBS = children[i]->mNumOfCircles = 0;
     }
 
-    const Registry& reg = mPhysics->GetWorld().GetRegistry();
-    uint32 indexOfId = node.mStartIndex;
-    static bool edgeCaseFlipper{};
-
-    for (uint32 i = 0; i < node.mNumOfAABBS; i++, indexOfId++)
+    // The objects are sorted by type, the order is
+    // preserved when distributing them over the children.
+    for (uint32 i = 0; i < node.mTotalNumOfObjects; i++)
     {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedAABB& collider = reg.Get<TransformedAABBColliderComponent>(owner);
+        const uint32 index = node.mStartIndex + i;
 
-        const glm::vec2 centre = collider.GetCentre();
-        const float posOnAxis = centre[splitPoint.mAxis];
+        const float posOnAxis = mObjects.GetCentre(index)[splitPoint.mAxis];
         bool childIndex = posOnAxis < splitPoint.mPosition;
 
         if (posOnAxis == splitPoint.mPosition)
         {
-            childIndex = edgeCaseFlipper;
-            edgeCaseFlipper = !edgeCaseFlipper;
+            childIndex = mEdgeCaseFlipper;
+            mEdgeCaseFlipper = !mEdgeCaseFlipper;
         }
 
-        childrenIds[childIndex].push_back(owner);
-        children[childIndex]->mNumOfAABBS++;
-    }
-
-    for (uint32 i = 0; i < node.mNumOfCircles; i++, indexOfId++)
-    {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedDisk& collider = reg.Get<TransformedDiskColliderComponent>(owner);
+        mChildrenObjects[childIndex].Append(mObjects, index);
 
-        const glm::vec2 centre = collider.GetCentre();
-        const float posOnAxis = centre[splitPoint.mAxis];
-        bool childIndex = posOnAxis < splitPoint.mPosition;
-
-        if (posOnAxis == splitPoint.mPosition)
+        if (i < node.mNumOfAABBS)
         {
-            childIndex = edgeCaseFlipper;
-            edgeCaseFlipper = !edgeCaseFlipper;
+            children[childIndex]->mNumOfAABBS++;
         }
-
-        childrenIds[childIndex].push_back(owner);
-        children[childIndex]->mNumOfCircles++;
-    }
-
-    const uint32 numOfPolygons = node.mTotalNumOfObjects - node.mNumOfAABBS - node.mNumOfCircles;
-    for (uint32 i = 0; i < numOfPolygons; i++, indexOfId++)
-    {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedPolygon& polygon = reg.Get<TransformedPolygonColliderComponent>(owner);
-
-        const glm::vec2 centre = polygon.mBoundingBox.GetCentre();
-        const float posOnAxis = centre[splitPoint.mAxis];
-        bool childIndex = posOnAxis < splitPoint.mPosition;
-
-        if (posOnAxis == splitPoint.mPosition)
+        else if (i < node.mNumOfAABBS + node.mNumOfCircles)
         {
-            childIndex = edgeCaseFlipper;
-            edgeCaseFlipper = !edgeCaseFlipper;
+            children[childIndex]->mNumOfCircles++;
         }
-
-        childrenIds[childIndex].push_back(owner);
     }
 
-    children[0]->mTotalNumOfObjects = static_cast<uint32>(childrenIds[0].size());
-    children[1]->mTotalNumOfObjects = static_cast<uint32>(childrenIds[1].size());
+    children[0]->mTotalNumOfObjects = static_cast<uint32>(mChildrenObjects[0].mIds.size());
+    children[1]->mTotalNumOfObjects = static_cast<uint32>(mChildrenObjects[1].mIds.size());
 
     children[0]->mStartIndex = node.mStartIndex;
     children[1]->mStartIndex = node.mStartIndex + children[0]->mTotalNumOfObjects;
 
     for (uint32 childIndex = 0; childIndex < 2; childIndex++)
     {
-        uint32 idIndex = children[childIndex]->mStartIndex;
-        for (uint32 j = 0; j < children[childIndex]->mTotalNumOfObjects; j++, idIndex++)
+        uint32 index = children[childIndex]->mStartIndex;
+        for (uint32 j = 0; j < children[childIndex]->mTotalNumOfObjects; j++, index++)
         {
-            mIds[idIndex] = childrenIds[childIndex][j];
+            mObjects.CopyFrom(mChildrenObjects[childIndex], j, index);
         }
     }
 
@@ -315,7 +415,7 @@ void CE::BVH::Subdivide(Node& node)
     {
         UpdateNodeBounds(*children[i]);
 
-        if (children[i]->mTotalNumOfObjects > 2)
+        if (children[i]->mTotalNumOfObjects > sMaxNumOfObjectsInLeaf)
         {
             Subdivide(*children[i]);
         }
@@ -339,48 +439,15 @@ float CE::BVH::DetermineSplitPointCost(const Node& node, SplitPoint splitPoint)
     };
     uint32 amountOfObjects[2]{};
 
-    uint32 indexOfId = node.mStartIndex;
+    const uint32 end = node.mStartIndex + node.mTotalNumOfObjects;
 
-    const Registry& reg = mPhysics->GetWorld().GetRegistry();
-
-    for (uint32 i = 0; i < node.mNumOfAABBS; i++, indexOfId++)
-    {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedAABB& collider = reg.Get<TransformedAABBColliderComponent>(owner);
-
-        const glm::vec2 centre = collider.GetCentre();
-        const float posOnAxis = centre[splitPoint.mAxis];
-        const bool childIndex = posOnAxis < splitPoint.mPosition;
-
-        amountOfObjects[childIndex]++;
-        boxes[childIndex].CombineWith(collider);
-    }
-
-    for (uint32 i = 0; i < node.mNumOfCircles; i++, indexOfId++)
+    for (uint32 index = node.mStartIndex; index < end; index++)
     {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedDisk& collider = reg.Get<TransformedDiskColliderComponent>(owner);
-
-        const glm::vec2 centre = collider.GetCentre();
-        const float posOnAxis = centre[splitPoint.mAxis];
-        const bool childIndex = posOnAxis < splitPoint.mPosition;
-
-        amountOfObjects[childIndex]++;
-        boxes[childIndex].CombineWith(collider.GetBoundingBox());
-    }
-
-    const uint32 numOfPolygons = node.mTotalNumOfObjects - node.mNumOfAABBS - node.mNumOfCircles;
-    for (uint32 i = 0; i < numOfPolygons; i++, indexOfId++)
-    {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedPolygon& polygon = reg.Get<TransformedPolygonColliderComponent>(owner);
-
-        const glm::vec2 centre = polygon.GetBoundingBox().GetCentre();
-        const float posOnAxis = centre[splitPoint.mAxis];
+        const float posOnAxis = mObjects.GetCentre(index)[splitPoint.mAxis];
         const bool childIndex = posOnAxis < splitPoint.mPosition;
 
         amountOfObjects[childIndex]++;
-        boxes[childIndex].CombineWith(polygon.GetBoundingBox());
+        boxes[childIndex].CombineWith(mObjects.GetBoundingBox(index));
     }
 
     const float cost = amountOfObjects[0] * boxes[0].GetPerimeter() + amountOfObjects[1] * boxes[1].GetPerimeter();
@@ -391,27 +458,11 @@ CE::BVH::SplitPoint CE::BVH::DetermineSplitPos(const Node& node)
 {
     TransformedAABB centroidsBoundingBox = { glm::vec2{INFINITY}, glm::vec2{-INFINITY} };
 
-    const Registry& reg = mPhysics->GetWorld().GetRegistry();
-    uint32 indexOfId = node.mStartIndex;
-    for (uint32 i = 0; i < node.mNumOfAABBS; i++, indexOfId++)
-    {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedAABB& collider = reg.Get<TransformedAABBColliderComponent>(owner);
-
-        const glm::vec2 centre = collider.GetCentre();
-
-        centroidsBoundingBox.mMin.x = glm::min(centroidsBoundingBox.mMin.x, centre.x);
-        centroidsBoundingBox.mMin.y = glm::min(centroidsBoundingBox.mMin.y, centre.y);
-        centroidsBoundingBox.mMax.x = glm::max(centroidsBoundingBox.mMax.x, centre.x);
-        centroidsBoundingBox.mMax.y = glm::max(centroidsBoundingBox.mMax.y, centre.y);
-    }
+    const uint32 end = node.mStartIndex + node.mTotalNumOfObjects;
 
-    for (uint32 i = 0; i < node.mNumOfCircles; i++, indexOfId++)
+    for (uint32 index = node.mStartIndex; index < end; index++)
     {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedDisk& collider = reg.Get<TransformedDiskColliderComponent>(owner);
-
-        const glm::vec2 centre = collider.mCentre;
+        const glm::vec2 centre = mObjects.GetCentre(index);
 
         centroidsBoundingBox.mMin.x = glm::min(centroidsBoundingBox.mMin.x, centre.x);
         centroidsBoundingBox.mMin.y = glm::min(centroidsBoundingBox.mMin.y, centre.y);
@@ -419,19 +470,6 @@ CE::BVH::SplitPoint CE::BVH::DetermineSplitPos(const Node& node)
         centroidsBoundingBox.mMax.y = glm::max(centroidsBoundingBox.mMax.y, centre.y);
     }
 
-    const uint32 numOfPolygons = node.mTotalNumOfObjects - node.mNumOfAABBS - node.mNumOfCircles;
-    for (uint32 i = 0; i < numOfPolygons; i++, indexOfId++)
-    {
-        const entt::entity owner = mIds[indexOfId];
-        const TransformedPolygon& polygon = reg.Get<TransformedPolygonColliderComponent>(owner);
-
-        const glm::vec2 centre = polygon.mBoundingBox.GetCentre();
-        centroidsBoundingBox.mMin.x = glm::min(centroidsBoundingBox.mMin.x, centre.x);
-        centroidsBoundingBox.mMin.y = glm::min(centroidsBoundingBox.mMin.y, centre.y);
-        centroidsBoundingBox.mMax.x = glm::max(centroidsBoundingBox.mMax.x, centre.x);
-        centroidsBoundingBox.mMax.y = glm::max(centroidsBoundingBox.mMax.y, centre.y);
-    }
-
     const glm::vec2 extent = centroidsBoundingBox.mMax - centroidsBoundingBox.mMin;
 
     SplitPoint currentPoint{}, bestPoint{};
@@ -455,4 +493,340 @@ CE::BVH::SplitPoint CE::BVH::DetermineSplitPos(const Node& node)
     }
 
     return bestPoint;
-}
\ No newline at end of file
+}
+
+void CE::BVH::UpdateDynamicTree(const Colliders& colliders)
+{
+    const Registry& reg = mPhysics->GetWorld().GetRegistry();
+
+    mWasObjectFound.assign(mObjects.mIds.size(), false);
+
+    for (const entt::entity entity : colliders.mAABBs)
+    {
+        const TransformedAABB& aabb = reg.Get<TransformedAABBColliderComponent>(entity);
+        AddOrMoveDynamicObject(ObjectType::AABB, entity, aabb, aabb.GetCentre(), 0.0f);
+    }
+
+    for (const entt::entity entity : colliders.mDisks)
+    {
+        const TransformedDisk& circle = reg.Get<TransformedDiskColliderComponent>(entity);
+        AddOrMoveDynamicObject(ObjectType::Disk, entity, circle.GetBoundingBox(), circle.mCentre, circle.mRadius);
+    }
+
+    for (const entt::entity entity : colliders.mPolygons)
+    {
+        const TransformedPolygon& polygon = reg.Get<TransformedPolygonColliderComponent>(entity);
+        AddOrMoveDynamicObject(ObjectType::Polygon, entity, polygon.GetBoundingBox(), polygon.mBoundingBox.GetCentre(), 0.0f);
+    }
+
+    // Objects are removed by swapping them with the last object,
+    // which we have already visited when iterating backwards.
+    for (uint32 i = static_cast<uint32>(mWasObjectFound.size()); i-- > 0;)
+    {
+        if (!mWasObjectFound[i])
+        {
+            RemoveDynamicObject(i);
+        }
+    }
+
+    mEmpty = mObjects.mIds.empty();
+}
+
+void CE::BVH::AddOrMoveDynamicObject(const ObjectType type, const entt::entity owner, const TransformedAABB boundingBox, const glm::vec2 centre, const float radius)
+{
+    std::vector<uint32>& objectIndexOfEntity = mObjectIndexOfEntity[static_cast<size_t>(type)];
+    const size_t entityIndex = static_cast<size_t>(entt::to_entity(owner));
+
+    if (entityIndex >= objectIndexOfEntity.size())
+    {
+        objectIndexOfEntity.resize(entityIndex + 1, DynamicAABBTree::sNull);
+    }
+
+    uint32& objectIndex = objectIndexOfEntity[entityIndex];
+
+    // The index may belong to an entity that was destroyed, which had the same entity index
+    if (objectIndex != DynamicAABBTree::sNull
+        && mObjects.mIds[objectIndex] == owner)
+    {
+        mObjects.Set(objectIndex, boundingBox, centre, radius);
+        mTree.Move(mProxies[objectIndex], boundingBox);
+        mWasObjectFound[objectIndex] = true;
+        return;
+    }
+
+    objectIndex = static_cast<uint32>(mObjects.mIds.size());
+
+    mObjects.Add(owner, boundingBox, centre, radius);
+    mProxies.emplace_back(mTree.Insert(boundingBox, objectIndex));
+    mObjectTypes.emplace_back(type);
+
+    // Objects that are added after we started iterating
+    // are never considered for removal, this just keeps
+    // the vector the same size as the others.
+    mWasObjectFound.emplace_back(true);
+}
+
+void CE::BVH::RemoveDynamicObject(const uint32 index)
+{
+    mTree.Remove(mProxies[index]);
+
+    std::vector<uint32>& objectIndexOfEntity = mObjectIndexOfEntity[static_cast<size_t>(mObjectTypes[index])];
+    const size_t entityIndex = static_cast<size_t>(entt::to_entity(mObjects.mIds[index]));
+
+    if (objectIndexOfEntity[entityIndex] == index)
+    {
+        objectIndexOfEntity[entityIndex] = DynamicAABBTree::sNull;
+    }
+
+    const uint32 lastIndex = static_cast<uint32>(mObjects.mIds.size()) - 1;
+
+    if (index != lastIndex)
+    {
+        mObjects.CopyFrom(mObjects, lastIndex, index);
+        mProxies[index] = mProxies[lastIndex];
+        mObjectTypes[index] = mObjectTypes[lastIndex];
+        mWasObjectFound[index] = mWasObjectFound[lastIndex];
+
+        mTree.SetUserData(mProxies[index], index);
+        mObjectIndexOfEntity[static_cast<size_t>(mObjectTypes[index])][static_cast<size_t>(entt::to_entity(mObjects.mIds[index]))] = index;
+    }
+
+    mObjects.PopBack();
+    mProxies.pop_back();
+    mObjectTypes.pop_back();
+    mWasObjectFound.pop_back();
+}
+
+void CE::BVH::BuildGrid(const Colliders& colliders)
+{
+    const Registry& reg = mPhysics->GetWorld().GetRegistry();
+
+    // The objects are first gathered in the order we find them in,
+    // and then copied to mObjects in the order of the grid.
+    Objects& unsortedObjects = mUnsortedObjects;
+    unsortedObjects.Clear();
+    mUnsortedBoundingBoxes.clear();
+    mUnsortedObjectTypes.clear();
+
+    const auto addObject = [&](const ObjectType type, const entt::entity owner, const TransformedAABB boundingBox, const glm::vec2 centre, const float radius)
+        {
+            unsortedObjects.Add(owner, boundingBox, centre, radius);
+            mUnsortedBoundingBoxes.emplace_back(boundingBox);
+            mUnsortedObjectTypes.emplace_back(type);
+        };
+
+    const uint32 numOfObjects = static_cast<uint32>(colliders.mAABBs.size() + colliders.mDisks.size() + colliders.mPolygons.size());
+    unsortedObjects.Reserve(numOfObjects);
+    mUnsortedBoundingBoxes.reserve(numOfObjects);
+    mUnsortedObjectTypes.reserve(numOfObjects);
+
+    for (const entt::entity entity : colliders.mAABBs)
+    {
+        const TransformedAABB& aabb = reg.Get<TransformedAABBColliderComponent>(entity);
+        addObject(ObjectType::AABB, entity, aabb, aabb.GetCentre(), 0.0f);
+    }
+
+    for (const entt::entity entity : colliders.mDisks)
+    {
+        const TransformedDisk& circle = reg.Get<TransformedDiskColliderComponent>(entity);
+        addObject(ObjectType::Disk, entity, circle.GetBoundingBox(), circle.mCentre, circle.mRadius);
+    }
+
+    for (const entt::entity entity : colliders.mPolygons)
+    {
+        const TransformedPolygon& polygon = reg.Get<TransformedPolygonColliderComponent>(entity);
+        addObject(ObjectType::Polygon, entity, polygon.GetBoundingBox(), polygon.mBoundingBox.GetCentre(), 0.0f);
+    }
+
+    mGrid.Build(mUnsortedBoundingBoxes, mGridOrder);
+
+    mObjects.Clear();
+    mObjects.Reserve(static_cast<uint32>(mGridOrder.size()));
+    mObjectTypes.clear();
+
+    for (const uint32 unsortedIndex : mGridOrder)
+    {
+        mObjects.Append(unsortedObjects, unsortedIndex);
+        mObjectTypes.emplace_back(mUnsortedObjectTypes[unsortedIndex]);
+    }
+
+    mEmpty = mObjects.mIds.empty();
+
+    UpdateObjectIndexOfEntity();
+}
+
+void CE::BVH::UpdateObjectIndexOfEntity()
+{
+    for (std::vector<uint32>& objectIndexOfEntity : mObjectIndexOfEntity)
+    {
+        std::fill(objectIndexOfEntity.begin(), objectIndexOfEntity.end(), DynamicAABBTree::sNull);
+    }
+
+    const auto setObjectIndex = [this](const ObjectType type, const uint32 objectIndex)
+        {
+            std::vector<uint32>& objectIndexOfEntity = mObjectIndexOfEntity[static_cast<size_t>(type)];
+            const size_t entityIndex = static_cast<size_t>(entt::to_entity(mObjects.mIds[objectIndex]));
+
+            if (entityIndex >= objectIndexOfEntity.size())
+            {
+                objectIndexOfEntity.resize(entityIndex + 1, DynamicAABBTree::sNull);
+            }
+
+            objectIndexOfEntity[entityIndex] = objectIndex;
+        };
+
+    if (mBroadphase == Broadphase::SpatialHashGrid)
+    {
+        for (uint32 objectIndex = 0; objectIndex < static_cast<uint32>(mObjectTypes.size()); objectIndex++)
+        {
+            setObjectIndex(mObjectTypes[objectIndex], objectIndex);
+        }
+        return;
+    }
+
+    // The objects in each leaf are sorted by type. The padding
+    // at the end of mObjects is not part of any leaf.
+    for (const Node& node : mNodes)
+    {
+        uint32 objectIndex = node.mStartIndex;
+
+        for (uint32 i = 0; i < node.mTotalNumOfObjects; i++, objectIndex++)
+        {
+            const ObjectType type = i < node.mNumOfAABBS ? ObjectType::AABB :
+                i < node.mNumOfAABBS + node.mNumOfCircles ? ObjectType::Disk : ObjectType::Polygon;
+
+            setObjectIndex(type, objectIndex);
+        }
+    }
+}
+
+void CE::BVH::SortByMortonCode(Span<const glm::vec2> positions, std::vector<uint32>& order)
+{
+    TransformedAABB bounds{ glm::vec2{ INFINITY }, glm::vec2{ -INFINITY } };
+
+    for (const glm::vec2 position : positions)
+    {
+        bounds.CombineWith({ position, position });
+    }
+
+    // Inserts a zero between each of the lower 16 bits
+    const auto spreadBits = [](uint32 value)
+        {
+            value &= 0x0000FFFF;
+            value = (value | (value << 8)) & 0x00FF00FF;
+            value = (value | (value << 4)) & 0x0F0F0F0F;
+            value = (value | (value << 2)) & 0x33333333;
+            value = (value | (value << 1)) & 0x55555555;
+            return value;
+        };
+
+    const glm::vec2 scale = static_cast<float>(std::numeric_limits<uint16>::max()) / glm::max(bounds.GetSize(), glm::vec2{ std::numeric_limits<float>::min() });
+
+    // The upper 32 bits store the morton code, the lower bits the index
+    std::vector<uint64> keys{};
+    keys.reserve(positions.size());
+
+    for (uint32 i = 0; i < static_cast<uint32>(positions.size()); i++)
+    {
+        const glm::vec2 cell = (positions[i] - bounds.mMin) * scale;
+        const uint32 mortonCode = spreadBits(static_cast<uint32>(cell.x)) | (spreadBits(static_cast<uint32>(cell.y)) << 1);
+        keys.emplace_back((static_cast<uint64>(mortonCode) << 32) | i);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    order.resize(keys.size());
+
+    for (size_t i = 0; i < keys.size(); i++)
+    {
+        order[i] = static_cast<uint32>(keys[i]);
+    }
+}
+
+void CE::BVH::Objects::Clear()
+{
+    mIds.clear();
+    mMinX.clear();
+    mMinY.clear();
+    mMaxX.clear();
+    mMaxY.clear();
+    mCentreX.clear();
+    mCentreY.clear();
+    mRadius.clear();
+}
+
+void CE::BVH::Objects::Reserve(const uint32 capacity)
+{
+    mIds.reserve(capacity);
+    mMinX.reserve(capacity);
+    mMinY.reserve(capacity);
+    mMaxX.reserve(capacity);
+    mMaxY.reserve(capacity);
+    mCentreX.reserve(capacity);
+    mCentreY.reserve(capacity);
+    mRadius.reserve(capacity);
+}
+
+void CE::BVH::Objects::Add(const entt::entity owner, const TransformedAABB boundingBox, const glm::vec2 centre, const float radius)
+{
+    mIds.emplace_back(owner);
+    mMinX.emplace_back(boundingBox.mMin.x);
+    mMinY.emplace_back(boundingBox.mMin.y);
+    mMaxX.emplace_back(boundingBox.mMax.x);
+    mMaxY.emplace_back(boundingBox.mMax.y);
+    mCentreX.emplace_back(centre.x);
+    mCentreY.emplace_back(centre.y);
+    mRadius.emplace_back(radius);
+}
+
+void CE::BVH::Objects::Set(const uint32 index, const TransformedAABB boundingBox, const glm::vec2 centre, const float radius)
+{
+    mMinX[index] = boundingBox.mMin.x;
+    mMinY[index] = boundingBox.mMin.y;
+    mMaxX[index] = boundingBox.mMax.x;
+    mMaxY[index] = boundingBox.mMax.y;
+    mCentreX[index] = centre.x;
+    mCentreY[index] = centre.y;
+    mRadius[index] = radius;
+}
+
+void CE::BVH::Objects::SetInvalid(const uint32 index)
+{
+    Set(index, { glm::vec2{ Node::sLargeNum }, glm::vec2{ -Node::sLargeNum } }, {}, -Node::sLargeNum);
+}
+
+void CE::BVH::Objects::Append(const Objects& other, const uint32 otherIndex)
+{
+    mIds.emplace_back(other.mIds[otherIndex]);
+    mMinX.emplace_back(other.mMinX[otherIndex]);
+    mMinY.emplace_back(other.mMinY[otherIndex]);
+    mMaxX.emplace_back(other.mMaxX[otherIndex]);
+    mMaxY.emplace_back(other.mMaxY[otherIndex]);
+    mCentreX.emplace_back(other.mCentreX[otherIndex]);
+    mCentreY.emplace_back(other.mCentreY[otherIndex]);
+    mRadius.emplace_back(other.mRadius[otherIndex]);
+}
+
+void CE::BVH::Objects::CopyFrom(const Objects& other, const uint32 otherIndex, const uint32 index)
+{
+    mIds[index] = other.mIds[otherIndex];
+    mMinX[index] = other.mMinX[otherIndex];
+    mMinY[index] = other.mMinY[otherIndex];
+    mMaxX[index] = other.mMaxX[otherIndex];
+    mMaxY[index] = other.mMaxY[otherIndex];
+    mCentreX[index] = other.mCentreX[otherIndex];
+    mCentreY[index] = other.mCentreY[otherIndex];
+    mRadius[index] = other.mRadius[otherIndex];
+}
+
+void CE::BVH::Objects::PopBack()
+{
+    mIds.pop_back();
+    mMinX.pop_back();
+    mMinY.pop_back();
+    mMaxX.pop_back();
+    mMaxY.pop_back();
+    mCentreX.pop_back();
+    mCentreY.pop_back();
+    mRadius.pop_back();
+}
@@ -1,12 +1,149 @@
 #include "Precomp.h"
 #include "Utilities/Benchmark.h"
 
+#include <numeric>
+#include <unordered_set>
+
+#include "cereal/archives/json.hpp"
+
+#include "stb_image/stbi_image_write.h"
+
 #include "World/World.h"
+#include "World/Registry.h"
 #include "Assets/Level.h"
+#include "Assets/Texture.h"
+#include "Assets/Core/AssetLoadInfo.h"
 #include "Core/AssetManager.h"
+#include "Core/FileIO.h"
+#include "Meta/MetaManager.h"
+#include "Meta/MetaType.h"
+#include "Utilities/Profiler.h"
+#include "Utilities/Random.h"
+#include "Utilities/StringFunctions.h"
+#include "Utilities/view_istream.h"
+
+#ifdef PLATFORM_WINDOWS
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#include <Psapi.h>
+#pragma warning(pop)
+#else
+#include <fstream>
+#include <unistd.h>
+#endif // PLATFORM_WINDOWS
 
 using namespace std::chrono;
 
+namespace
+{
+    CE::DurationStatistics CalculateStatistics(std::vector<double>& durationsMs)
+    {
+        if (durationsMs.empty())
+        {
+            return {};
+        }
+
+        std::sort(durationsMs.begin(), durationsMs.end());
+
+        // Nearest-rank
+        const auto percentile = [&](const double fraction)
+            {
+                const size_t rank = static_cast<size_t>(std::ceil(fraction * static_cast<double>(durationsMs.size())));
+                return durationsMs[std::clamp<size_t>(rank, 1, durationsMs.size()) - 1];
+            };
+
+        CE::DurationStatistics statistics{};
+        statistics.mAverage = std::accumulate(durationsMs.begin(), durationsMs.end(), 0.0) / static_cast<double>(durationsMs.size());
+        statistics.mP50 = percentile(.5);
+        statistics.mP95 = percentile(.95);
+        statistics.mP99 = percentile(.99);
+        statistics.mMax = durationsMs.back();
+        return statistics;
+    }
+
+    // The memory currently in use by the process. Unlike the peak reported by the OS,
+    // this can be compared between levels that are benchmarked in the same process.
+    uint64 GetCurrentMemoryUsage()
+    {
+#ifdef PLATFORM_WINDOWS
+        PROCESS_MEMORY_COUNTERS counters{};
+
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return static_cast<uint64>(counters.WorkingSetSize);
+        }
+        return 0;
+#else
+        // The second value is the number of resident pages
+        std::ifstream statm{ "/proc/self/statm" };
+        uint64 numOfPages{}, numOfResidentPages{};
+
+        if (statm >> numOfPages >> numOfResidentPages)
+        {
+            return numOfResidentPages * static_cast<uint64>(sysconf(_SC_PAGESIZE));
+        }
+        return 0;
+#endif // PLATFORM_WINDOWS
+    }
+
+    std::optional<std::string_view> FindArgument(int argc, char* argv[], std::string_view key)
+    {
+        for (int i = 0; i < argc; i++)
+        {
+            const std::string_view argument = argv[i];
+
+            if (argument.size() > key.size()
+                && argument[key.size()] == '='
+                && argument.substr(0, key.size()) == key)
+            {
+                return argument.substr(key.size() + 1);
+            }
+        }
+
+        return std::nullopt;
+    }
+}
+
+namespace CE
+{
+    template<typename Archive>
+    void serialize(Archive& ar, DurationStatistics& value)
+    {
+        ar(cereal::make_nvp("average", value.mAverage),
+            cereal::make_nvp("p50", value.mP50),
+            cereal::make_nvp("p95", value.mP95),
+            cereal::make_nvp("p99", value.mP99),
+            cereal::make_nvp("max", value.mMax));
+    }
+
+    template<typename Archive>
+    void serialize(Archive& ar, SystemBenchmarkResult& value)
+    {
+        ar(cereal::make_nvp("name", value.mName),
+            cereal::make_nvp("timePerTickMs", value.mTimePerTick));
+    }
+
+    template<typename Archive>
+    void serialize(Archive& ar, LevelBenchmarkResult& value)
+    {
+        ar(cereal::make_nvp("level", value.mLevelName),
+            cereal::make_nvp("numOfTicks", value.mNumOfTicks),
+            cereal::make_nvp("seed", value.mSeed),
+            cereal::make_nvp("tickDurationMs", value.mTickDuration),
+            cereal::make_nvp("peakMemoryBytes", value.mPeakMemoryBytes),
+            cereal::make_nvp("maxNumOfEntities", value.mMaxNumOfEntities),
+            cereal::make_nvp("finalNumOfEntities", value.mFinalNumOfEntities),
+            cereal::make_nvp("systems", value.mSystems));
+    }
+}
+
 CE::BenchmarkResult CE::BenchMark(World& world, const BenchmarkParams params)
 {
     BenchmarkResult result{};
@@ -31,6 +168,7 @@ CE::BenchmarkResult CE::BenchMark(World& world, const BenchmarkParams params)
 
     while (now < endTime)
     {
+        PROFILE_FRAME_MARK();
         world.Tick(params.mTickStepSize);
 
         auto newNow = high_resolution_clock::now();
@@ -103,3 +241,461 @@ void CE::BenchmarkResult::ExportToCSV(std::ostream& ostream) const
     }
     ostream << std::endl;
 }
+
+CE::BenchmarkReport CE::RunBenchmarkSuite(const BenchmarkSuiteParams& params)
+{
+    BenchmarkReport report{};
+
+    for (const std::string& levelName : params.mLevelNames)
+    {
+        AssetHandle<Level> level = AssetManager::Get().TryGetAsset<Level>(levelName);
+
+        if (level == nullptr)
+        {
+            LOG(LogCore, Error, "Cannot benchmark {}, as it does not exist", levelName);
+            continue;
+        }
+
+        LOG(LogCore, Message, "Benchmarking {}", levelName);
+
+        // The memory used by this level is measured relative to what was in use before it was loaded
+        const uint64 memoryUsageBeforeLevel = GetCurrentMemoryUsage();
+        uint64 highestMemoryUsage = memoryUsageBeforeLevel;
+
+        // Seeding before creating the world makes the spawning deterministic as well
+        Random::SetSeed(params.mSeed);
+        World world = level->CreateWorld(true);
+        Registry& registry = world.GetRegistry();
+
+        for (uint32 i = 0; i < params.mNumOfWarmUpTicks; i++)
+        {
+            world.Tick(params.mTickStepSize);
+        }
+
+        registry.SetShouldMeasureSystems(true);
+        registry.ClearSystemMeasurements();
+
+        LevelBenchmarkResult& result = report.mLevels.emplace_back();
+        result.mLevelName = levelName;
+        result.mNumOfTicks = params.mNumOfTicks;
+        result.mSeed = params.mSeed;
+
+        std::vector<double> tickDurations{};
+        tickDurations.reserve(params.mNumOfTicks);
+
+        // Keyed by name, since systems may be added or removed between ticks
+        std::unordered_map<std::string, std::vector<double>> systemDurations{};
+        std::unordered_map<std::string, double> systemDurationsThisTick{};
+
+        for (uint32 i = 0; i < params.mNumOfTicks; i++)
+        {
+            PROFILE_FRAME_MARK();
+
+            const auto tickStart = high_resolution_clock::now();
+            world.Tick(params.mTickStepSize);
+            tickDurations.emplace_back(duration<double, std::milli>(high_resolution_clock::now() - tickStart).count());
+
+            highestMemoryUsage = std::max(highestMemoryUsage, GetCurrentMemoryUsage());
+
+            // Multiple systems of the same type are summed together
+            systemDurationsThisTick.clear();
+
+            for (const Registry::SystemMeasurement& measurement : registry.GetSystemMeasurements())
+            {
+                const MetaType* const systemType = MetaManager::Get().TryGetType(measurement.mSystemTypeId);
+                std::string name = systemType != nullptr ? systemType->GetName() : typeid(measurement.mSystem.get()).name();
+
+                systemDurationsThisTick[std::move(name)] += duration<double, std::milli>(measurement.mTimeSpentUpdating).count();
+            }
+
+            for (const auto& [name, durationThisTick] : systemDurationsThisTick)
+            {
+                systemDurations[name].emplace_back(durationThisTick);
+            }
+
+            registry.ClearSystemMeasurements();
+
+            result.mMaxNumOfEntities = std::max(result.mMaxNumOfEntities, static_cast<uint64>(registry.Storage<entt::entity>().in_use()));
+        }
+
+        result.mTickDuration = CalculateStatistics(tickDurations);
+
+        for (auto& [name, durations] : systemDurations)
+        {
+            SystemBenchmarkResult& systemResult = result.mSystems.emplace_back();
+            systemResult.mName = name;
+            systemResult.mTimePerTick = CalculateStatistics(durations);
+        }
+
+        std::sort(result.mSystems.begin(), result.mSystems.end(),
+            [](const SystemBenchmarkResult& lhs, const SystemBenchmarkResult& rhs)
+            {
+                return lhs.mTimePerTick.mAverage > rhs.mTimePerTick.mAverage;
+            });
+
+        result.mFinalNumOfEntities = registry.Storage<entt::entity>().in_use();
+        result.mPeakMemoryBytes = highestMemoryUsage - memoryUsageBeforeLevel;
+
+        LOG(LogCore, Message, "{} - Average (ms): {:.4}, p50: {:.4}, p95: {:.4}, p99: {:.4}, Max: {:.4}",
+            levelName,
+            result.mTickDuration.mAverage,
+            result.mTickDuration.mP50,
+            result.mTickDuration.mP95,
+            result.mTickDuration.mP99,
+            result.mTickDuration.mMax);
+    }
+
+    return report;
+}
+
+CE::TextureLoadBenchmarkResult CE::BenchmarkTextureLoading(const std::string_view levelName, const uint32 numOfRepetitions)
+{
+    TextureLoadBenchmarkResult result{};
+    result.mLevelName = levelName;
+
+    AssetManager& assetManager = AssetManager::Get();
+    AssetHandle<Level> level = assetManager.TryGetAsset<Level>(levelName);
+
+    if (level == nullptr)
+    {
+        LOG(LogCore, Error, "Cannot benchmark the texture loading of {}, as it does not exist", levelName);
+        return result;
+    }
+
+    std::unordered_set<std::string> texturesLoadedBefore{};
+
+    for (const WeakAssetHandle<Texture>& texture : assetManager.GetAllAssets<Texture>())
+    {
+        if (texture.IsLoaded())
+        {
+            texturesLoadedBefore.emplace(texture.GetMetaData().GetName());
+        }
+    }
+
+    {
+        [[maybe_unused]] const World world = level->CreateWorld(false);
+    }
+
+    std::vector<std::filesystem::path> files{};
+
+    // Encoded beforehand, we only want to measure the decoding
+    std::vector<std::string> pngFiles{};
+
+    for (const WeakAssetHandle<Texture>& texture : assetManager.GetAllAssets<Texture>())
+    {
+        if (!texture.IsLoaded()
+            || !texture.GetFileOfOrigin().has_value()
+            || texturesLoadedBefore.count(texture.GetMetaData().GetName()))
+        {
+            continue;
+        }
+
+        std::optional<AssetLoadInfo> loadInfo = AssetLoadInfo::LoadFromFile(*texture.GetFileOfOrigin());
+
+        if (!loadInfo.has_value())
+        {
+            continue;
+        }
+
+        const Texture loadedTexture{ *loadInfo };
+
+        if (!loadedTexture.WaitForPixels())
+        {
+            continue;
+        }
+
+        std::string& pngFile = pngFiles.emplace_back();
+
+        {
+            std::ostringstream metaData{};
+            AssetFileMetaData{ texture.GetMetaData().GetName(), texture.GetMetaData().GetClass(), 0 }.WriteMetaData(metaData);
+            pngFile = metaData.str();
+        }
+
+        const Span<const unsigned char> pixels = loadedTexture.GetPixels();
+        const int width = static_cast<int>(loadedTexture.GetWidth());
+        const int height = static_cast<int>(loadedTexture.GetHeight());
+
+        stbi_write_png_to_func([](void* context, void* data, int size)
+            {
+                static_cast<std::string*>(context)->append(static_cast<const char*>(data), size);
+            }, &pngFile, width, height, 4, pixels.data(), width * 4);
+
+        files.emplace_back(*texture.GetFileOfOrigin());
+    }
+
+    result.mNumOfTextures = static_cast<uint32>(files.size());
+
+    if (files.empty())
+    {
+        LOG(LogCore, Warning, "{} does not use any textures", levelName);
+        return result;
+    }
+
+    std::vector<double> loadDurations{};
+    std::vector<double> pngLoadDurations{};
+
+    // Stands in for the upload buffer. Copying the pixels makes both paths read every byte
+    // that would be uploaded; otherwise the stored textures would only map their file
+    // and read the header, while the PNGs are fully decoded.
+    std::vector<unsigned char> uploadBuffer{};
+
+    const auto copyToUploadBuffer = [&uploadBuffer](const Texture& texture)
+        {
+            if (texture.WaitForPixels())
+            {
+                const Span<const unsigned char> pixels = texture.GetPixelsOfAllMips();
+                uploadBuffer.assign(pixels.begin(), pixels.end());
+            }
+        };
+
+    const auto benchmarkStored = [&]
+        {
+            const auto start = high_resolution_clock::now();
+
+            for (const std::filesystem::path& file : files)
+            {
+                std::optional<AssetLoadInfo> loadInfo = AssetLoadInfo::LoadFromFile(file);
+
+                if (loadInfo.has_value())
+                {
+                    const Texture texture{ *loadInfo };
+                    copyToUploadBuffer(texture);
+                }
+            }
+
+            loadDurations.emplace_back(duration<double, std::milli>(high_resolution_clock::now() - start).count());
+        };
+
+    const auto benchmarkPNG = [&]
+        {
+            const auto start = high_resolution_clock::now();
+
+            for (const std::string& pngFile : pngFiles)
+            {
+                std::optional<AssetLoadInfo> loadInfo = AssetLoadInfo::LoadFromStream(std::make_unique<view_istream>(pngFile));
+
+                if (loadInfo.has_value())
+                {
+                    const Texture texture{ *loadInfo };
+                    copyToUploadBuffer(texture);
+                }
+            }
+
+            pngLoadDurations.emplace_back(duration<double, std::milli>(high_resolution_clock::now() - start).count());
+        };
+
+    // Both paths read from memory: the PNGs were encoded into memory, and the stored
+    // files were just read while encoding them, so they are in the file cache. The
+    // order alternates, so that neither path consistently benefits from running second.
+    for (uint32 repetition = 0; repetition < numOfRepetitions; repetition++)
+    {
+        if (repetition % 2 == 0)
+        {
+            benchmarkStored();
+            benchmarkPNG();
+        }
+        else
+        {
+            benchmarkPNG();
+            benchmarkStored();
+        }
+    }
+
+    result.mLoadDuration = CalculateStatistics(loadDurations);
+    result.mPNGLoadDuration = CalculateStatistics(pngLoadDurations);
+
+    LOG(LogCore, Message, "{} - Loading {} textures (ms), average: {:.4}, p50: {:.4}, max: {:.4}. As PNGs, average: {:.4}, p50: {:.4}, max: {:.4}",
+        levelName,
+        result.mNumOfTextures,
+        result.mLoadDuration.mAverage,
+        result.mLoadDuration.mP50,
+        result.mLoadDuration.mMax,
+        result.mPNGLoadDuration.mAverage,
+        result.mPNGLoadDuration.mP50,
+        result.mPNGLoadDuration.mMax);
+
+    return result;
+}
+
+void CE::BenchmarkReport::ExportToJSON(std::ostream& stream) const
+{
+    cereal::JSONOutputArchive archive{ stream };
+    archive(cereal::make_nvp("levels", mLevels));
+}
+
+std::optional<CE::BenchmarkReport> CE::BenchmarkReport::ImportFromJSON(std::istream& stream)
+{
+    BenchmarkReport report{};
+
+    try
+    {
+        cereal::JSONInputArchive archive{ stream };
+        archive(cereal::make_nvp("levels", report.mLevels));
+    }
+    catch (const std::exception& e)
+    {
+        LOG(LogCore, Error, "Failed to read benchmark report - {}", e.what());
+        return std::nullopt;
+    }
+
+    return report;
+}
+
+std::vector<CE::BenchmarkRegression> CE::FindRegressions(const BenchmarkReport& baseline, const BenchmarkReport& current, const BenchmarkThresholds& thresholds)
+{
+    std::vector<BenchmarkRegression> regressions{};
+
+    const auto compare = [&](const std::string& levelName, std::string_view metric, const double baselineValue, const double currentValue, const float thresholdPercentage, const double minIncrease)
+        {
+            if (currentValue > baselineValue * (1.0 + thresholdPercentage * .01)
+                && currentValue - baselineValue > minIncrease)
+            {
+                regressions.push_back({ levelName, std::string{ metric }, baselineValue, currentValue });
+            }
+        };
+
+    for (const LevelBenchmarkResult& currentLevel : current.mLevels)
+    {
+        const auto baselineLevel = std::find_if(baseline.mLevels.begin(), baseline.mLevels.end(),
+            [&](const LevelBenchmarkResult& level)
+            {
+                return level.mLevelName == currentLevel.mLevelName;
+            });
+
+        if (baselineLevel == baseline.mLevels.end())
+        {
+            LOG(LogCore, Warning, "{} is not in the baseline", currentLevel.mLevelName);
+            continue;
+        }
+
+        const std::string& levelName = currentLevel.mLevelName;
+
+        compare(levelName, "Tick duration p50 (ms)", baselineLevel->mTickDuration.mP50, currentLevel.mTickDuration.mP50, thresholds.mTickDurationPercentage, thresholds.mMinTimeIncreaseMs);
+        compare(levelName, "Tick duration p95 (ms)", baselineLevel->mTickDuration.mP95, currentLevel.mTickDuration.mP95, thresholds.mTickDurationPercentage, thresholds.mMinTimeIncreaseMs);
+        compare(levelName, "Tick duration p99 (ms)", baselineLevel->mTickDuration.mP99, currentLevel.mTickDuration.mP99, thresholds.mTickDurationPercentage, thresholds.mMinTimeIncreaseMs);
+        compare(levelName, "Peak memory (bytes)", static_cast<double>(baselineLevel->mPeakMemoryBytes), static_cast<double>(currentLevel.mPeakMemoryBytes), thresholds.mPeakMemoryPercentage, 0.0);
+
+        for (const SystemBenchmarkResult& currentSystem : currentLevel.mSystems)
+        {
+            const auto baselineSystem = std::find_if(baselineLevel->mSystems.begin(), baselineLevel->mSystems.end(),
+                [&](const SystemBenchmarkResult& system)
+                {
+                    return system.mName == currentSystem.mName;
+                });
+
+            if (baselineSystem != baselineLevel->mSystems.end())
+            {
+                compare(levelName, Format("{} average (ms)", currentSystem.mName), baselineSystem->mTimePerTick.mAverage, currentSystem.mTimePerTick.mAverage, thresholds.mSystemPercentage, thresholds.mMinTimeIncreaseMs);
+            }
+        }
+    }
+
+    return regressions;
+}
+
+uint32 CE::RunBenchmarksFromCommandLine(int argc, char* argv[])
+{
+    BenchmarkSuiteParams params{};
+    BenchmarkThresholds thresholds{};
+
+    if (const std::optional<std::string_view> levels = FindArgument(argc, argv, "levels"))
+    {
+        for (const std::string_view levelName : StringFunctions::SplitString(*levels, ","))
+        {
+            params.mLevelNames.emplace_back(levelName);
+        }
+    }
+    else
+    {
+        for (WeakAssetHandle<Level> level : AssetManager::Get().GetAllAssets<Level>())
+        {
+            params.mLevelNames.emplace_back(level.GetMetaData().GetName());
+        }
+    }
+
+    const auto parse = [&](std::string_view key, auto& value)
+        {
+            const std::optional<std::string_view> argument = FindArgument(argc, argv, key);
+
+            if (argument.has_value())
+            {
+                std::istringstream{ std::string{ *argument } } >> value;
+            }
+        };
+
+    parse("ticks", params.mNumOfTicks);
+    parse("warmup", params.mNumOfWarmUpTicks);
+    parse("seed", params.mSeed);
+    parse("tick_threshold", thresholds.mTickDurationPercentage);
+    parse("system_threshold", thresholds.mSystemPercentage);
+    parse("memory_threshold", thresholds.mPeakMemoryPercentage);
+    parse("min_time_increase", thresholds.mMinTimeIncreaseMs);
+
+    if (const std::optional<std::string_view> textureLoadLevels = FindArgument(argc, argv, "texture_load_levels"))
+    {
+        uint32 numOfRepetitions = 5;
+        parse("texture_load_repetitions", numOfRepetitions);
+
+        for (const std::string_view levelName : StringFunctions::SplitString(*textureLoadLevels, ","))
+        {
+            BenchmarkTextureLoading(levelName, numOfRepetitions);
+        }
+    }
+
+    const BenchmarkReport report = RunBenchmarkSuite(params);
+
+    std::string outputPath = FileIO::Get().GetPath(FileIO::Directory::Intermediate, "Benchmarks/BenchmarkReport.json");
+
+    if (const std::optional<std::string_view> output = FindArgument(argc, argv, "output"))
+    {
+        outputPath = *output;
+    }
+
+    if (const std::filesystem::path outputDirectory = std::filesystem::path{ outputPath }.parent_path();
+        !outputDirectory.empty())
+    {
+        std::filesystem::create_directories(outputDirectory);
+    }
+
+    {
+        std::ofstream outputFile{ outputPath };
+        report.ExportToJSON(outputFile);
+    }
+
+    LOG(LogCore, Message, "Benchmark report written to {}", outputPath);
+
+    const std::optional<std::string_view> baselinePath = FindArgument(argc, argv, "baseline");
+
+    if (!baselinePath.has_value())
+    {
+        return 0;
+    }
+
+    std::ifstream baselineFile{ std::string{ *baselinePath } };
+    const std::optional<BenchmarkReport> baseline = BenchmarkReport::ImportFromJSON(baselineFile);
+
+    if (!baseline.has_value())
+    {
+        LOG(LogCore, Error, "Could not compare against baseline {}", *baselinePath);
+        return 1;
+    }
+
+    const std::vector<BenchmarkRegression> regressions = FindRegressions(*baseline, report, thresholds);
+
+    for (const BenchmarkRegression& regression : regressions)
+    {
+        LOG(LogCore, Error, "Regression in {} - {}: {:.4} -> {:.4}",
+            regression.mLevelName,
+            regression.mMetric,
+            regression.mBaseline,
+            regression.mCurrent);
+    }
+
+    if (regressions.empty())
+    {
+        LOG(LogCore, Message, "No regressions compared to {}", *baselinePath);
+    }
+
+    return static_cast<uint32>(regressions.size());
+}
@@ -0,0 +1,305 @@
+#include "Precomp.h"
+#include "Utilities/DynamicAABBTree.h"
+
+namespace
+{
+	CE::TransformedAABB Combine(CE::TransformedAABB a, const CE::TransformedAABB& b)
+	{
+		a.CombineWith(b);
+		return a;
+	}
+
+	bool Contains(const CE::TransformedAABB& outer, const CE::TransformedAABB& inner)
+	{
+		return outer.mMin.x <= inner.mMin.x
+			&& outer.mMin.y <= inner.mMin.y
+			&& outer.mMax.x >= inner.mMax.x
+			&& outer.mMax.y >= inner.mMax.y;
+	}
+
+	CE::TransformedAABB Fatten(const CE::TransformedAABB& aabb, float margin)
+	{
+		return { aabb.mMin - glm::vec2{ margin }, aabb.mMax + glm::vec2{ margin } };
+	}
+}
+
+uint32 CE::DynamicAABBTree::Insert(const TransformedAABB boundingBox, const uint32 userData)
+{
+	const uint32 proxy = AllocateNode();
+
+	Node& leaf = mNodes[proxy];
+	leaf.mBoundingBox = Fatten(boundingBox, sFatMargin);
+	leaf.mUserData = userData;
+	leaf.mHeight = 0;
+
+	InsertLeaf(proxy);
+	return proxy;
+}
+
+void CE::DynamicAABBTree::Remove(const uint32 proxy)
+{
+	ASSERT(proxy < mNodes.size() && mNodes[proxy].IsLeaf());
+
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+}
+
+bool CE::DynamicAABBTree::Move(const uint32 proxy, const TransformedAABB boundingBox)
+{
+	ASSERT(proxy < mNodes.size() && mNodes[proxy].IsLeaf());
+
+	const TransformedAABB& fatBoundingBox = mNodes[proxy].mBoundingBox;
+
+	// We also reinsert objects that have become much smaller than their
+	// fattened bounding box, otherwise the tree would slowly degrade.
+	if (Contains(fatBoundingBox, boundingBox)
+		&& Contains(Fatten(boundingBox, sFatMargin * 4.0f), fatBoundingBox))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxy);
+	mNodes[proxy].mBoundingBox = Fatten(boundingBox, sFatMargin);
+	InsertLeaf(proxy);
+	return true;
+}
+
+void CE::DynamicAABBTree::Clear()
+{
+	mNodes.clear();
+	mRoot = sNull;
+	mFreeList = sNull;
+}
+
+uint32 CE::DynamicAABBTree::AllocateNode()
+{
+	if (mFreeList == sNull)
+	{
+		mNodes.emplace_back();
+		return static_cast<uint32>(mNodes.size() - 1);
+	}
+
+	const uint32 index = mFreeList;
+	mFreeList = mNodes[index].mParent;
+	mNodes[index] = {};
+	return index;
+}
+
+void CE::DynamicAABBTree::FreeNode(const uint32 index)
+{
+	mNodes[index] = {};
+	mNodes[index].mParent = mFreeList;
+	mFreeList = index;
+}
+
+void CE::DynamicAABBTree::InsertLeaf(const uint32 leaf)
+{
+	if (mRoot == sNull)
+	{
+		mRoot = leaf;
+		mNodes[leaf].mParent = sNull;
+		return;
+	}
+
+	// Find the best sibling by descending into the child
+	// whose bounding box would have to grow the least.
+	const TransformedAABB leafBoundingBox = mNodes[leaf].mBoundingBox;
+	uint32 index = mRoot;
+
+	while (!mNodes[index].IsLeaf())
+	{
+		const Node& node = mNodes[index];
+
+		const float perimeter = node.mBoundingBox.GetPerimeter();
+		const float combinedPerimeter = Combine(node.mBoundingBox, leafBoundingBox).GetPerimeter();
+
+		// The cost of creating a new parent for this node and the new leaf
+		const float cost = 2.0f * combinedPerimeter;
+
+		// The minimum cost of pushing the leaf further down the tree
+		const float inheritanceCost = 2.0f * (combinedPerimeter - perimeter);
+
+		const auto getCostOfDescending = [&](uint32 childIndex)
+			{
+				const Node& child = mNodes[childIndex];
+				const float newPerimeter = Combine(child.mBoundingBox, leafBoundingBox).GetPerimeter();
+
+				return child.IsLeaf() ?
+					newPerimeter + inheritanceCost :
+					newPerimeter - child.mBoundingBox.GetPerimeter() + inheritanceCost;
+			};
+
+		const float cost1 = getCostOfDescending(node.mChild1);
+		const float cost2 = getCostOfDescending(node.mChild2);
+
+		if (cost < cost1
+			&& cost < cost2)
+		{
+			break;
+		}
+
+		index = cost1 < cost2 ? node.mChild1 : node.mChild2;
+	}
+
+	const uint32 sibling = index;
+	const uint32 oldParent = mNodes[sibling].mParent;
+	const uint32 newParent = AllocateNode();
+
+	Node& parent = mNodes[newParent];
+	parent.mParent = oldParent;
+	parent.mBoundingBox = Combine(leafBoundingBox, mNodes[sibling].mBoundingBox);
+	parent.mHeight = mNodes[sibling].mHeight + 1;
+	parent.mChild1 = sibling;
+	parent.mChild2 = leaf;
+
+	mNodes[sibling].mParent = newParent;
+	mNodes[leaf].mParent = newParent;
+
+	if (oldParent == sNull)
+	{
+		mRoot = newParent;
+	}
+	else if (mNodes[oldParent].mChild1 == sibling)
+	{
+		mNodes[oldParent].mChild1 = newParent;
+	}
+	else
+	{
+		mNodes[oldParent].mChild2 = newParent;
+	}
+
+	Fixup(mNodes[leaf].mParent);
+}
+
+void CE::DynamicAABBTree::RemoveLeaf(const uint32 leaf)
+{
+	if (leaf == mRoot)
+	{
+		mRoot = sNull;
+		return;
+	}
+
+	const uint32 parent = mNodes[leaf].mParent;
+	const uint32 grandParent = mNodes[parent].mParent;
+	const uint32 sibling = mNodes[parent].mChild1 == leaf ? mNodes[parent].mChild2 : mNodes[parent].mChild1;
+
+	mNodes[sibling].mParent = grandParent;
+	FreeNode(parent);
+
+	if (grandParent == sNull)
+	{
+		mRoot = sibling;
+		return;
+	}
+
+	if (mNodes[grandParent].mChild1 == parent)
+	{
+		mNodes[grandParent].mChild1 = sibling;
+	}
+	else
+	{
+		mNodes[grandParent].mChild2 = sibling;
+	}
+
+	Fixup(grandParent);
+}
+
+void CE::DynamicAABBTree::Fixup(uint32 index)
+{
+	while (index != sNull)
+	{
+		index = Balance(index);
+
+		Node& node = mNodes[index];
+		const Node& child1 = mNodes[node.mChild1];
+		const Node& child2 = mNodes[node.mChild2];
+
+		node.mHeight = 1 + std::max(child1.mHeight, child2.mHeight);
+		node.mBoundingBox = Combine(child1.mBoundingBox, child2.mBoundingBox);
+
+		index = node.mParent;
+	}
+}
+
+uint32 CE::DynamicAABBTree::Balance(const uint32 iA)
+{
+	Node& a = mNodes[iA];
+
+	if (a.IsLeaf()
+		|| a.mHeight < 2)
+	{
+		return iA;
+	}
+
+	const uint32 iB = a.mChild1;
+	const uint32 iC = a.mChild2;
+	Node& b = mNodes[iB];
+	Node& c = mNodes[iC];
+
+	const int32 balance = c.mHeight - b.mHeight;
+
+	// Rotates 'up' up, taking the place of A. 'Other' is the child of A that stays.
+	const auto rotate = [&](const uint32 iUp, Node& up, Node& other, const bool upWasChild2) -> uint32
+		{
+			const uint32 iF = up.mChild1;
+			const uint32 iG = up.mChild2;
+			Node& f = mNodes[iF];
+			Node& g = mNodes[iG];
+
+			up.mChild1 = iA;
+			up.mParent = a.mParent;
+			a.mParent = iUp;
+
+			if (up.mParent == sNull)
+			{
+				mRoot = iUp;
+			}
+			else if (mNodes[up.mParent].mChild1 == iA)
+			{
+				mNodes[up.mParent].mChild1 = iUp;
+			}
+			else
+			{
+				mNodes[up.mParent].mChild2 = iUp;
+			}
+
+			// The taller grandchild stays with 'up', the shorter one moves to A
+			const bool keepF = f.mHeight > g.mHeight;
+			const uint32 iKept = keepF ? iF : iG;
+			const uint32 iMoved = keepF ? iG : iF;
+			Node& kept = keepF ? f : g;
+			Node& moved = keepF ? g : f;
+
+			up.mChild2 = iKept;
+
+			if (upWasChild2)
+			{
+				a.mChild2 = iMoved;
+			}
+			else
+			{
+				a.mChild1 = iMoved;
+			}
+			moved.mParent = iA;
+
+			a.mBoundingBox = Combine(other.mBoundingBox, moved.mBoundingBox);
+			up.mBoundingBox = Combine(a.mBoundingBox, kept.mBoundingBox);
+
+			a.mHeight = 1 + std::max(other.mHeight, moved.mHeight);
+			up.mHeight = 1 + std::max(a.mHeight, kept.mHeight);
+
+			return iUp;
+		};
+
+	if (balance > 1)
+	{
+		return rotate(iC, c, b, true);
+	}
+
+	if (balance < -1)
+	{
+		return rotate(iB, b, c, false);
+	}
+
+	return iA;
+}
@@ -13,7 +13,7 @@ std::optional<CE::BoundEvent> CE::TryGetEvent(const MetaType& fromType, const Ev
 	if (func != nullptr
 		&& func->GetProperties().Has(Internal::sIsEventProp))
 	{
-		return BoundEvent{ fromType, *func, func->GetProperties().Has(Internal::sIsEventStaticTag) };
+		return BoundEvent{ fromType, *func, func->GetProperties().Has(Internal::sIsEventStaticTag), Internal::TryGetEventThunk(fromType.GetTypeId(), base) };
 	}
 	return std::nullopt;
 }
@@ -46,6 +46,67 @@ namespace CE::Internal
 	}
 }
 
+namespace CE::Internal
+{
+	using EventThunkKey = std::pair<TypeId, const EventBase*>;
+
+	struct EventThunkKeyHasher
+	{
+		size_t operator()(const EventThunkKey& key) const
+		{
+			return std::hash<TypeId>{}(key.first) ^ (std::hash<const EventBase*>{}(key.second) << 1);
+		}
+	};
+
+	// Node based, so the thunks returned from TryGetEventThunk remain valid when more are registered
+	std::unordered_map<EventThunkKey, EventThunk, EventThunkKeyHasher>& GetEventThunksMutable()
+	{
+		static std::unordered_map<EventThunkKey, EventThunk, EventThunkKeyHasher> thunks{};
+		return thunks;
+	}
+}
+
+void CE::Internal::RegisterEventThunk(const TypeId typeId, const EventBase& event, EventThunk&& thunk)
+{
+	GetEventThunksMutable()[{ typeId, &event }] = std::move(thunk);
+}
+
+const CE::Internal::EventThunk* CE::Internal::TryGetEventThunk(const TypeId typeId, const EventBase& event)
+{
+	const auto& thunks = GetEventThunksMutable();
+	const auto it = thunks.find({ typeId, &event });
+	return it == thunks.end() ? nullptr : &it->second;
+}
+
+namespace CE::Internal
+{
+	std::vector<std::pair<const TickBatchEvent*, BoundTickBatch>>& GetTickBatchesMutable()
+	{
+		static std::vector<std::pair<const TickBatchEvent*, BoundTickBatch>> tickBatches{};
+		return tickBatches;
+	}
+}
+
+void CE::Internal::RegisterTickBatch(const TickBatchEvent& event, BoundTickBatch&& bound)
+{
+	GetTickBatchesMutable().emplace_back(&event, std::move(bound));
+}
+
+std::vector<CE::BoundTickBatch> CE::GetAllBoundTickBatches(const TickBatchEvent& event)
+{
+	std::vector<BoundTickBatch> bound{};
+
+	for (const auto& [boundToEvent, tickBatch] : Internal::GetTickBatchesMutable())
+	{
+		if (boundToEvent == &event)
+		{
+			bound.emplace_back(tickBatch);
+		}
+	}
+
+	return bound;
+}
+
 CE::Span<std::reference_wrapper<const CE::EventBase>> CE::GetAllEvents()
 {
 	return { Internal::GetEventsMutable() };
@@ -117,7 +178,7 @@ void CE::EventBase::Define(MetaFunc& metaFunc, const ScriptFunc& scriptFunc, con
 	// and it's owner, so we don't pass those.
 	const size_t numOfArgsToPass = metaFunc.GetParameters().size() - 2;
 
-	metaFunc.RedirectFunction([&scriptFunc, script, firstNode = scriptFunc.GetFirstNode().GetValue(), entry = scriptFunc.GetEntryNode().GetValue(), numOfArgsToPass]
+	metaFunc.RedirectFunction([&scriptFunc, script, &bytecode = VirtualMachine::Get().CompileScriptFunction(scriptFunc), numOfArgsToPass]
 		(MetaFunc::DynamicArgs args, MetaFunc::RVOBuffer rvoBuffer) -> FuncResult
 		{
 			World& world = *args[1].As<World>();
@@ -148,7 +209,7 @@ void CE::EventBase::Define(MetaFunc& metaFunc, const ScriptFunc& scriptFunc, con
 				new (&scriptArgs[i + 1])MetaAny(MakeRef(args[i + 3]));
 			}
 
-			FuncResult result = VirtualMachine::Get().ExecuteScriptFunction(Span<MetaAny>{ scriptArgs, numOfArgsToPass}, rvoBuffer, scriptFunc, firstNode, entry);
+			FuncResult result = VirtualMachine::Get().ExecuteScriptFunction(Span<MetaAny>{ scriptArgs, numOfArgsToPass}, rvoBuffer, scriptFunc, bytecode);
 
 			World::PopWorld();
 			return result;
@@ -0,0 +1,1041 @@
+#include "Precomp.h"
+#include "Utilities/FlowFieldEngine.h"
+
+#include "Components/TransformComponent.h"
+#include "Components/Pathfinding/SwarmingAgentTag.h"
+#include "Components/Pathfinding/SwarmingTargetComponent.h"
+#include "Utilities/BVH.h"
+#include "Utilities/DrawDebugHelpers.h"
+#include "World/Physics.h"
+#include "World/Registry.h"
+#include "World/World.h"
+
+namespace
+{
+	using namespace CE;
+
+	constexpr int sSectorWidth = FlowFieldEngine::sSectorWidth;
+	constexpr int sNumOfCellsPerSector = FlowFieldEngine::sNumOfCellsPerSector;
+	constexpr float sInf = std::numeric_limits<float>::infinity();
+
+	constexpr std::array<glm::ivec2, 8> sNeighbourOffsets
+	{
+		glm::ivec2{ -1, -1 }, glm::ivec2{ 0, -1 }, glm::ivec2{ 1, -1 },
+		glm::ivec2{ -1, 0 }, glm::ivec2{ 1, 0 },
+		glm::ivec2{ -1, 1 }, glm::ivec2{ 0, 1 }, glm::ivec2{ 1, 1 }
+	};
+
+	// The index into sNeighbourOffsets of an offset in the range [-1, 1]
+	int GetNeighbourIndex(const glm::ivec2 offset)
+	{
+		const int index = (offset.x + 1) + (offset.y + 1) * 3;
+		return index > 4 ? index - 1 : index;
+	}
+
+	float GetStepCost(const glm::ivec2 offset)
+	{
+		return offset.x != 0 && offset.y != 0 ? 1.41421357f : 1.0f;
+	}
+
+	int FloorDiv(const int value, const int divisor)
+	{
+		return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+	}
+
+	glm::ivec2 GetSectorOfCell(const glm::ivec2 cell)
+	{
+		return { FloorDiv(cell.x, sSectorWidth), FloorDiv(cell.y, sSectorWidth) };
+	}
+
+	int GetIndexInSector(const glm::ivec2 cell, const glm::ivec2 sector)
+	{
+		const glm::ivec2 local = cell - sector * sSectorWidth;
+		return local.x + local.y * sSectorWidth;
+	}
+
+	glm::vec2 GetCellCentre(const glm::ivec2 cell, const float cellSize)
+	{
+		return (glm::vec2{ cell } + glm::vec2{ .5f }) * cellSize;
+	}
+
+	uint64 MakeSectorKey(const glm::ivec2 sector)
+	{
+		return static_cast<uint64>(static_cast<uint32>(sector.x)) << 32 | static_cast<uint32>(sector.y);
+	}
+
+	glm::ivec2 GetSectorFromKey(const uint64 key)
+	{
+		return { static_cast<int32>(static_cast<uint32>(key >> 32)), static_cast<int32>(static_cast<uint32>(key)) };
+	}
+
+	int GetIndexInArea(const glm::ivec2 sector, const glm::ivec2 firstSector, const glm::ivec2 numOfSectors)
+	{
+		const glm::ivec2 local = sector - firstSector;
+
+		if (local.x < 0
+			|| local.y < 0
+			|| local.x >= numOfSectors.x
+			|| local.y >= numOfSectors.y)
+		{
+			return -1;
+		}
+
+		return local.x + local.y * numOfSectors.x;
+	}
+
+	glm::vec2 GetDirectionTowards(const glm::vec2 from, const glm::vec2 to)
+	{
+		const glm::vec2 delta = to - from;
+		return delta == glm::vec2{} ? glm::vec2{ 1.0f, 0.0f } : glm::normalize(delta);
+	}
+
+	uint64 MixHash(uint64 value)
+	{
+		value += 0x9e3779b97f4a7c15ull;
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+		return value ^ (value >> 31);
+	}
+
+	uint64 HashBoundingBox(const TransformedAABB& box)
+	{
+		std::array<uint32, 4> bits{};
+		memcpy(bits.data(), &box.mMin, sizeof(glm::vec2));
+		memcpy(bits.data() + 2, &box.mMax, sizeof(glm::vec2));
+		return MixHash(static_cast<uint64>(bits[0]) << 32 | bits[1]) ^ MixHash(static_cast<uint64>(bits[2]) << 32 | bits[3]);
+	}
+
+	// Independent of the order of the obstacles, as the BVH makes no guarantees about the order of its hits
+	uint64 HashObstacles(const Registry& registry, Span<const entt::entity> obstacles)
+	{
+		uint64 hash{};
+
+		for (const entt::entity obstacle : obstacles)
+		{
+			uint64 obstacleHash = MixHash(static_cast<uint64>(obstacle));
+
+			if (const TransformedAABBColliderComponent* aabb = registry.TryGet<TransformedAABBColliderComponent>(obstacle); aabb != nullptr)
+			{
+				obstacleHash ^= HashBoundingBox(aabb->GetBoundingBox());
+			}
+			if (const TransformedDiskColliderComponent* disk = registry.TryGet<TransformedDiskColliderComponent>(obstacle); disk != nullptr)
+			{
+				obstacleHash ^= MixHash(HashBoundingBox(disk->GetBoundingBox()));
+			}
+			if (const TransformedPolygonColliderComponent* polygon = registry.TryGet<TransformedPolygonColliderComponent>(obstacle); polygon != nullptr)
+			{
+				obstacleHash ^= MixHash(MixHash(HashBoundingBox(polygon->GetBoundingBox())));
+			}
+
+			hash += obstacleHash;
+		}
+
+		return hash;
+	}
+}
+
+CE::FlowFieldEngine::~FlowFieldEngine()
+{
+	if (mJob.IsValid())
+	{
+		mJob.Wait();
+	}
+}
+
+uint32 CE::FlowFieldEngine::GetSizeClass(const float agentRadius)
+{
+	if (!(agentRadius > sSmallestCellSize))
+	{
+		return 0;
+	}
+
+	const int sizeClass = static_cast<int>(std::floor(std::log2(agentRadius / sSmallestCellSize)));
+	return static_cast<uint32>(std::clamp(sizeClass, 0, static_cast<int>(sNumOfSizeClasses) - 1));
+}
+
+float CE::FlowFieldEngine::GetCellSize(const uint32 sizeClass)
+{
+	return sSmallestCellSize * static_cast<float>(1u << sizeClass);
+}
+
+std::optional<glm::vec2> CE::FlowFieldEngine::Field::Sample(const glm::vec2 position) const
+{
+	const glm::vec2 positionInCells = position / mCellSize - glm::vec2{ .5f };
+	const glm::vec2 flooredPosition = glm::floor(positionInCells);
+	const glm::ivec2 cell{ flooredPosition };
+	const glm::vec2 weight = positionInCells - flooredPosition;
+
+	const std::optional<glm::vec2> sampleX0Y0 = GetCellDirection(cell);
+
+	if (!sampleX0Y0.has_value())
+	{
+		return std::nullopt;
+	}
+
+	// Some bilinear interpolation
+	const glm::vec2 sampleX1Y0 = GetCellDirection(cell + glm::ivec2{ 1, 0 }).value_or(*sampleX0Y0);
+	const glm::vec2 sampleX0Y1 = GetCellDirection(cell + glm::ivec2{ 0, 1 }).value_or(*sampleX0Y0);
+	const glm::vec2 sampleX1Y1 = GetCellDirection(cell + glm::ivec2{ 1, 1 }).value_or(*sampleX0Y0);
+
+	return glm::mix(
+		glm::mix(*sampleX0Y0, sampleX1Y0, weight.x),
+		glm::mix(sampleX0Y1, sampleX1Y1, weight.x),
+		weight.y);
+}
+
+void CE::FlowFieldEngine::Field::DebugDraw(const World& world) const
+{
+	for (int sectorY = 0; sectorY < mNumOfSectors.y; sectorY++)
+	{
+		for (int sectorX = 0; sectorX < mNumOfSectors.x; sectorX++)
+		{
+			const int sectorIndex = sectorX + sectorY * mNumOfSectors.x;
+			const std::shared_ptr<const SectorDirections>& directions = mSectors[sectorIndex];
+
+			if (directions == nullptr)
+			{
+				continue;
+			}
+
+			const glm::ivec2 firstCell = (mFirstSector + glm::ivec2{ sectorX, sectorY }) * sSectorWidth;
+			const glm::vec4 colour = mIsUpToDate[sectorIndex] ? glm::vec4{ 1.0f, 0.0f, 0.0f, 1.0f } : glm::vec4{ 1.0f, .5f, 0.0f, 1.0f };
+
+			for (int i = 0; i < sNumOfCellsPerSector; i++)
+			{
+				const glm::vec2 pos = GetCellCentre(firstCell + glm::ivec2{ i % sSectorWidth, i / sSectorWidth }, mCellSize);
+				DrawDebugLine(world, DebugCategory::AINavigation, pos, pos + (*directions)[i] * mCellSize * .75f, colour);
+			}
+		}
+	}
+}
+
+std::optional<glm::vec2> CE::FlowFieldEngine::Field::GetCellDirection(const glm::ivec2 cell) const
+{
+	const glm::ivec2 sector = GetSectorOfCell(cell);
+	const int sectorIndex = GetSectorIndex(sector);
+
+	if (sectorIndex < 0)
+	{
+		return std::nullopt;
+	}
+
+	if (!mIsUpToDate[sectorIndex])
+	{
+		mIsRequested[sectorIndex].store(true, std::memory_order_relaxed);
+	}
+
+	const std::shared_ptr<const SectorDirections>& directions = mSectors[sectorIndex];
+
+	if (directions == nullptr)
+	{
+		return std::nullopt;
+	}
+
+	return (*directions)[GetIndexInSector(cell, sector)];
+}
+
+int CE::FlowFieldEngine::Field::GetSectorIndex(const glm::ivec2 sector) const
+{
+	return GetIndexInArea(sector, mFirstSector, mNumOfSectors);
+}
+
+void CE::FlowFieldEngine::Update(World& world, const float dt)
+{
+	mShouldCheckObstacles |= mObstacleCheckCooldown.IsReady(dt);
+
+	if (mJob.IsValid())
+	{
+		if (!mJob.IsFinished())
+		{
+			return;
+		}
+
+		mJob = {};
+	}
+
+	Registry& registry = world.GetRegistry();
+
+	PublishFields(registry);
+	SyncTargets(registry);
+	UpdateObstacles(world, std::exchange(mShouldCheckObstacles, false));
+
+	if (mTargets.empty())
+	{
+		return;
+	}
+
+	mJob = JobSystem::Get().Schedule(
+		[this]
+		{
+			JobSystem::Get().ParallelFor(0, static_cast<uint32>(mTargets.size()),
+				[this](uint32 i)
+				{
+					UpdateTarget(*mTargets[i]);
+				});
+		});
+}
+
+void CE::FlowFieldEngine::PublishFields(Registry& registry)
+{
+	for (const std::unique_ptr<TargetState>& target : mTargets)
+	{
+		if (target->mPendingField == nullptr)
+		{
+			continue;
+		}
+
+		target->mPublishedField = std::move(target->mPendingField);
+
+		SwarmingTargetComponent* const component = registry.Valid(target->mOwner) ? registry.TryGet<SwarmingTargetComponent>(target->mOwner) : nullptr;
+
+		if (component != nullptr)
+		{
+			component->mFlowFields[target->mSizeClass] = target->mPublishedField;
+		}
+	}
+}
+
+void CE::FlowFieldEngine::SyncTargets(Registry& registry)
+{
+	std::array<bool, sNumOfSizeClasses> isSizeClassUsed{};
+
+	for (auto [entity, disk] : registry.View<SwarmingAgentTag, TransformedDiskColliderComponent>().each())
+	{
+		isSizeClassUsed[GetSizeClass(disk.mRadius)] = true;
+	}
+
+	// Forget the targets that no longer exist, and the size classes no agent uses
+	mTargets.erase(std::remove_if(mTargets.begin(), mTargets.end(),
+		[&](const std::unique_ptr<TargetState>& target)
+		{
+			SwarmingTargetComponent* const component = registry.Valid(target->mOwner) ? registry.TryGet<SwarmingTargetComponent>(target->mOwner) : nullptr;
+
+			if (component != nullptr
+				&& registry.HasComponent<TransformComponent>(target->mOwner)
+				&& isSizeClassUsed[target->mSizeClass])
+			{
+				return false;
+			}
+
+			if (component != nullptr)
+			{
+				component->mFlowFields[target->mSizeClass] = nullptr;
+			}
+			return true;
+		}), mTargets.end());
+
+	for (auto [entity, swarmingTarget, transform] : registry.View<SwarmingTargetComponent, TransformComponent>().each())
+	{
+		for (uint32 sizeClass = 0; sizeClass < sNumOfSizeClasses; sizeClass++)
+		{
+			if (!isSizeClassUsed[sizeClass])
+			{
+				continue;
+			}
+
+			auto existing = std::find_if(mTargets.begin(), mTargets.end(),
+				[entity = entity, sizeClass](const std::unique_ptr<TargetState>& target)
+				{
+					return target->mOwner == entity && target->mSizeClass == sizeClass;
+				});
+
+			if (existing == mTargets.end())
+			{
+				std::unique_ptr<TargetState> newTarget = std::make_unique<TargetState>();
+				newTarget->mOwner = entity;
+				newTarget->mSizeClass = sizeClass;
+				newTarget->mCellSize = GetCellSize(sizeClass);
+				existing = mTargets.emplace(mTargets.end(), std::move(newTarget));
+			}
+
+			TargetState& target = **existing;
+
+			const glm::ivec2 goalCell{ glm::floor(transform.GetWorldPosition2D() / target.mCellSize) };
+			const int radiusInCells = std::max(static_cast<int>(std::ceil(swarmingTarget.mDesiredRadius / target.mCellSize)), 1);
+			const glm::ivec2 firstSector = GetSectorOfCell(goalCell - glm::ivec2{ radiusInCells });
+			const glm::ivec2 numOfSectors = GetSectorOfCell(goalCell + glm::ivec2{ radiusInCells }) - firstSector + glm::ivec2{ 1 };
+
+			if (goalCell != target.mGoalCell
+				|| firstSector != target.mFirstSector
+				|| numOfSectors != target.mNumOfSectors
+				|| swarmingTarget.mNumberOfSmoothingSteps != target.mNumOfSmoothingSteps)
+			{
+				target.mGoalCell = goalCell;
+				target.mFirstSector = firstSector;
+				target.mNumOfSectors = numOfSectors;
+				target.mNumOfSmoothingSteps = swarmingTarget.mNumberOfSmoothingSteps;
+				target.mNeedsNewGeneration = true;
+			}
+		}
+	}
+}
+
+void CE::FlowFieldEngine::UpdateObstacles(const World& world, const bool shouldCheckExistingSectors)
+{
+	for (Layer& layer : mLayers)
+	{
+		for (auto& [key, sector] : layer.mSectors)
+		{
+			sector.mIsUsed = false;
+		}
+	}
+
+	for (const std::unique_ptr<TargetState>& target : mTargets)
+	{
+		Layer& layer = mLayers[target->mSizeClass];
+
+		for (int y = 0; y < target->mNumOfSectors.y; y++)
+		{
+			for (int x = 0; x < target->mNumOfSectors.x; x++)
+			{
+				layer.mSectors[MakeSectorKey(target->mFirstSector + glm::ivec2{ x, y })].mIsUsed = true;
+			}
+		}
+	}
+
+	std::vector<glm::ivec2> sectorsToCheck{};
+	std::vector<TransformedAABB> boundingBoxesToCheck{};
+	std::vector<std::pair<uint32, ObstacleSector*>> obstacleSectorsToCheck{};
+
+	for (uint32 sizeClass = 0; sizeClass < sNumOfSizeClasses; sizeClass++)
+	{
+		Layer& layer = mLayers[sizeClass];
+		const float sectorSize = GetCellSize(sizeClass) * static_cast<float>(sSectorWidth);
+
+		for (auto it = layer.mSectors.begin(); it != layer.mSectors.end();)
+		{
+			if (!it->second.mIsUsed)
+			{
+				it = layer.mSectors.erase(it);
+				continue;
+			}
+
+			if (it->second.mIsNew
+				|| shouldCheckExistingSectors)
+			{
+				const glm::ivec2 sector = GetSectorFromKey(it->first);
+				sectorsToCheck.emplace_back(sector);
+				boundingBoxesToCheck.emplace_back(TransformedAABB{ glm::vec2{ sector } * sectorSize, glm::vec2{ sector + glm::ivec2{ 1 } } * sectorSize });
+				obstacleSectorsToCheck.emplace_back(sizeClass, &it->second);
+			}
+
+			++it;
+		}
+	}
+
+	if (!sectorsToCheck.empty())
+	{
+		const BVH& bvh = world.GetPhysics().GetBVHs()[static_cast<int>(CollisionLayer::StaticObstacles)];
+
+		std::vector<std::vector<entt::entity>> obstacles{};
+		bvh.QueryAllHits<TransformedAABB>(boundingBoxesToCheck, obstacles);
+
+		std::array<std::vector<glm::ivec2>, sNumOfSizeClasses> sectorsToRasterize{};
+		std::array<std::vector<ObstacleSector*>, sNumOfSizeClasses> obstacleSectorsToRasterize{};
+
+		const auto setIsBlocked = [this](uint32 sizeClass, ObstacleSector& sector, const char* isBlocked)
+			{
+				if (!sector.mIsNew
+					&& std::equal(sector.mIsBlocked.begin(), sector.mIsBlocked.end(), isBlocked))
+				{
+					return;
+				}
+
+				sector.mIsBlocked.assign(isBlocked, isBlocked + sNumOfCellsPerSector);
+
+				if (!sector.mIsNew)
+				{
+					sector.mLastChangedVersion = ++mLayers[sizeClass].mVersion;
+				}
+				sector.mIsNew = false;
+			};
+
+		static constexpr std::array<char, sNumOfCellsPerSector> allOpen{};
+
+		for (size_t i = 0; i < sectorsToCheck.size(); i++)
+		{
+			auto [sizeClass, sector] = obstacleSectorsToCheck[i];
+			const uint64 signature = HashObstacles(world.GetRegistry(), obstacles[i]);
+
+			if (!sector->mIsNew
+				&& signature == sector->mSignature)
+			{
+				continue;
+			}
+			sector->mSignature = signature;
+
+			if (obstacles[i].empty())
+			{
+				setIsBlocked(sizeClass, *sector, allOpen.data());
+				continue;
+			}
+
+			sectorsToRasterize[sizeClass].emplace_back(sectorsToCheck[i]);
+			obstacleSectorsToRasterize[sizeClass].emplace_back(sector);
+		}
+
+		for (uint32 sizeClass = 0; sizeClass < sNumOfSizeClasses; sizeClass++)
+		{
+			if (sectorsToRasterize[sizeClass].empty())
+			{
+				continue;
+			}
+
+			const std::vector<char> isBlocked = RasterizeObstacles(world, GetCellSize(sizeClass), sectorsToRasterize[sizeClass]);
+
+			for (size_t i = 0; i < obstacleSectorsToRasterize[sizeClass].size(); i++)
+			{
+				setIsBlocked(sizeClass, *obstacleSectorsToRasterize[sizeClass][i], isBlocked.data() + i * sNumOfCellsPerSector);
+			}
+		}
+	}
+
+	// Invalidate the fields that cover a sector whose obstacles changed
+	for (const std::unique_ptr<TargetState>& target : mTargets)
+	{
+		const Layer& layer = mLayers[target->mSizeClass];
+		uint32 newestVersion = target->mObstacleVersionSeen;
+
+		for (int y = 0; y < target->mNumOfSectors.y; y++)
+		{
+			for (int x = 0; x < target->mNumOfSectors.x; x++)
+			{
+				const ObstacleSector& sector = layer.mSectors.at(MakeSectorKey(target->mFirstSector + glm::ivec2{ x, y }));
+				newestVersion = std::max(newestVersion, sector.mLastChangedVersion);
+			}
+		}
+
+		if (newestVersion != target->mObstacleVersionSeen)
+		{
+			target->mObstacleVersionSeen = newestVersion;
+			target->mNeedsNewGeneration = true;
+		}
+	}
+}
+
+std::vector<char> CE::FlowFieldEngine::RasterizeObstacles(const World& world, const float cellSize, Span<const glm::ivec2> sectors)
+{
+	const BVH& bvh = world.GetPhysics().GetBVHs()[static_cast<int>(CollisionLayer::StaticObstacles)];
+
+	std::vector<char> isBlocked(sectors.size() * sNumOfCellsPerSector);
+
+	struct BoundingBox
+	{
+		glm::ivec2 mStart{};
+		glm::ivec2 mEnd{};
+		uint32 mSectorIndex{};
+	};
+
+	std::vector<BoundingBox> boxesToCheck{};
+	std::vector<BoundingBox> nextBoxesToCheck{};
+	std::vector<TransformedAABB> worldBoundingBoxes{};
+	std::vector<char> isTaken{};
+
+	for (uint32 i = 0; i < sectors.size(); i++)
+	{
+		const glm::ivec2 firstCell = sectors[i] * sSectorWidth;
+		boxesToCheck.emplace_back(BoundingBox{ firstCell, firstCell + glm::ivec2{ sSectorWidth }, i });
+	}
+
+	// All the boxes of the same size are checked at once
+	while (!boxesToCheck.empty())
+	{
+		worldBoundingBoxes.clear();
+
+		for (const BoundingBox& box : boxesToCheck)
+		{
+			worldBoundingBoxes.emplace_back(TransformedAABB{ glm::vec2{ box.mStart } * cellSize, glm::vec2{ box.mEnd } * cellSize });
+		}
+
+		isTaken.resize(boxesToCheck.size());
+		bvh.QueryAnyHit<TransformedAABB>(worldBoundingBoxes, isTaken);
+
+		nextBoxesToCheck.clear();
+
+		for (size_t i = 0; i < boxesToCheck.size(); i++)
+		{
+			if (!isTaken[i])
+			{
+				continue;
+			}
+
+			const BoundingBox& box = boxesToCheck[i];
+
+			if (box.mStart + glm::ivec2{ 1 } == box.mEnd)
+			{
+				isBlocked[box.mSectorIndex * sNumOfCellsPerSector + GetIndexInSector(box.mStart, sectors[box.mSectorIndex])] = true;
+				continue;
+			}
+
+			// Split and recurse
+			const glm::ivec2 size = box.mEnd - box.mStart;
+
+			BoundingBox children[2]{ box, box };
+
+			const bool indexToChange = size.y > size.x;
+			const int size1 = size[indexToChange] / 2;
+
+			children[0].mEnd[indexToChange] = box.mStart[indexToChange] + size1;
+			children[1].mStart[indexToChange] = children[0].mEnd[indexToChange];
+
+			nextBoxesToCheck.emplace_back(children[0]);
+			nextBoxesToCheck.emplace_back(children[1]);
+		}
+
+		std::swap(boxesToCheck, nextBoxesToCheck);
+	}
+
+	return isBlocked;
+}
+
+void CE::FlowFieldEngine::UpdateTarget(TargetState& target) const
+{
+	bool hasChanged{};
+
+	if (target.mNeedsNewGeneration)
+	{
+		target.mNeedsNewGeneration = false;
+		hasChanged = true;
+
+		for (auto it = target.mSectors.begin(); it != target.mSectors.end();)
+		{
+			if (GetIndexInArea(GetSectorFromKey(it->first), target.mFirstSector, target.mNumOfSectors) < 0)
+			{
+				it = target.mSectors.erase(it);
+				continue;
+			}
+
+			// The old directions remain available to the agents until the sector is computed again
+			SectorState& sector = it->second;
+
+			if (!sector.mIntegration.empty())
+			{
+				std::swap(sector.mIntegration, sector.mPreviousIntegration);
+				sector.mIntegration.clear();
+			}
+			sector.mIsUpToDate = false;
+
+			++it;
+		}
+
+		ComputeCoarseCosts(target);
+	}
+
+	const glm::ivec2 goalSector = GetSectorOfCell(target.mGoalCell);
+	const auto isUpToDate = [&target](glm::ivec2 sector)
+		{
+			const auto it = target.mSectors.find(MakeSectorKey(sector));
+			return it != target.mSectors.end() && it->second.mIsUpToDate;
+		};
+
+	if (!isUpToDate(goalSector))
+	{
+		ComputeSector(target, goalSector);
+		hasChanged = true;
+	}
+
+	if (target.mPublishedField != nullptr)
+	{
+		const Field& published = *target.mPublishedField;
+
+		for (int i = 0; i < published.mNumOfSectors.x * published.mNumOfSectors.y; i++)
+		{
+			if (!published.mIsRequested[i].exchange(false, std::memory_order_relaxed))
+			{
+				continue;
+			}
+
+			const glm::ivec2 sector = published.mFirstSector + glm::ivec2{ i % published.mNumOfSectors.x, i / published.mNumOfSectors.x };
+
+			if (!isUpToDate(sector)
+				&& ComputeSector(target, sector) != nullptr)
+			{
+				hasChanged = true;
+			}
+		}
+	}
+
+	if (!hasChanged)
+	{
+		return;
+	}
+
+	std::shared_ptr<Field> field = std::make_shared<Field>();
+	const int numOfSectors = target.mNumOfSectors.x * target.mNumOfSectors.y;
+
+	field->mCellSize = target.mCellSize;
+	field->mFirstSector = target.mFirstSector;
+	field->mNumOfSectors = target.mNumOfSectors;
+	field->mSectors.resize(numOfSectors);
+	field->mIsUpToDate.resize(numOfSectors);
+	field->mIsRequested = std::make_unique<std::atomic<bool>[]>(numOfSectors);
+
+	for (const auto& [key, sector] : target.mSectors)
+	{
+		const int index = GetIndexInArea(GetSectorFromKey(key), target.mFirstSector, target.mNumOfSectors);
+		field->mSectors[index] = sector.mDirections;
+		field->mIsUpToDate[index] = sector.mIsUpToDate;
+	}
+
+	target.mPendingField = std::move(field);
+}
+
+void CE::FlowFieldEngine::ComputeCoarseCosts(TargetState& target) const
+{
+	target.mCoarseCosts.assign(target.mNumOfSectors.x * target.mNumOfSectors.y, sInf);
+
+	const int goalIndex = GetIndexInArea(GetSectorOfCell(target.mGoalCell), target.mFirstSector, target.mNumOfSectors);
+	ASSERT(goalIndex >= 0);
+
+	std::vector<std::pair<float, int>>& openList = target.mCoarseOpenList;
+	openList.clear();
+
+	// std::greater turns the heap into a min heap
+	const std::greater<std::pair<float, int>> compare{};
+
+	target.mCoarseCosts[goalIndex] = 0.0f;
+	openList.emplace_back(0.0f, goalIndex);
+
+	while (!openList.empty())
+	{
+		std::pop_heap(openList.begin(), openList.end(), compare);
+		const auto [cost, index] = openList.back();
+		openList.pop_back();
+
+		if (cost > target.mCoarseCosts[index])
+		{
+			continue;
+		}
+
+		const glm::ivec2 sector = target.mFirstSector + glm::ivec2{ index % target.mNumOfSectors.x, index / target.mNumOfSectors.x };
+
+		for (const glm::ivec2 offset : { glm::ivec2{ -1, 0 }, glm::ivec2{ 1, 0 }, glm::ivec2{ 0, -1 }, glm::ivec2{ 0, 1 } })
+		{
+			const glm::ivec2 nbr = sector + offset;
+			const int nbrIndex = GetIndexInArea(nbr, target.mFirstSector, target.mNumOfSectors);
+
+			if (nbrIndex < 0)
+			{
+				continue;
+			}
+
+			const float nbrCost = cost + static_cast<float>(sSectorWidth);
+
+			// Searching outwards from the goal, so agents would cross from the neighbour to this sector
+			if (nbrCost < target.mCoarseCosts[nbrIndex]
+				&& CanCrossBetween(target.mSizeClass, nbr, sector))
+			{
+				target.mCoarseCosts[nbrIndex] = nbrCost;
+				openList.emplace_back(nbrCost, nbrIndex);
+				std::push_heap(openList.begin(), openList.end(), compare);
+			}
+		}
+	}
+}
+
+CE::FlowFieldEngine::SectorState* CE::FlowFieldEngine::ComputeSector(TargetState& target, const glm::ivec2 sector) const
+{
+	const int areaIndex = GetIndexInArea(sector, target.mFirstSector, target.mNumOfSectors);
+
+	if (areaIndex < 0)
+	{
+		return nullptr;
+	}
+
+	// References to elements of an unordered_map remain valid when other elements are inserted
+	SectorState& state = target.mSectors[MakeSectorKey(sector)];
+
+	if (state.mIsUpToDate)
+	{
+		return &state;
+	}
+
+	const float coarseCost = target.mCoarseCosts[areaIndex];
+
+	// The sectors closer to the goal have to be computed first, as the integration field is seeded from them.
+	// Their coarse cost is lower than ours, so this never loops back to this sector.
+	std::array<const SectorState*, 8> dependencies{};
+
+	if (coarseCost != sInf)
+	{
+		for (size_t i = 0; i < sNeighbourOffsets.size(); i++)
+		{
+			const glm::ivec2 nbr = sector + sNeighbourOffsets[i];
+			const int nbrIndex = GetIndexInArea(nbr, target.mFirstSector, target.mNumOfSectors);
+
+			if (nbrIndex >= 0
+				&& target.mCoarseCosts[nbrIndex] < coarseCost)
+			{
+				dependencies[i] = ComputeSector(target, nbr);
+			}
+		}
+	}
+
+	const char* isBlocked = FindBlockedCells(target.mSizeClass, sector);
+	ASSERT(isBlocked != nullptr);
+
+	std::vector<float>& integration = state.mIntegration;
+	integration.assign(sNumOfCellsPerSector, sInf);
+
+	// Works functionally the same as a queue
+	std::vector<int>& openCells = target.mOpenCells;
+	openCells.clear();
+
+	const glm::ivec2 firstCell = sector * sSectorWidth;
+
+	if (GetSectorOfCell(target.mGoalCell) == sector)
+	{
+		const int goalIndex = GetIndexInSector(target.mGoalCell, sector);
+		integration[goalIndex] = 0.0f;
+		openCells.emplace_back(goalIndex);
+	}
+
+	// Seed the cells along the edges from the sectors closer to the goal
+	for (int i = 0; i < sNumOfCellsPerSector; i++)
+	{
+		const glm::ivec2 local{ i % sSectorWidth, i / sSectorWidth };
+
+		if (isBlocked[i]
+			|| (local.x != 0 && local.y != 0 && local.x != sSectorWidth - 1 && local.y != sSectorWidth - 1))
+		{
+			continue;
+		}
+
+		float lowestDist = integration[i];
+
+		for (const glm::ivec2 offset : sNeighbourOffsets)
+		{
+			const glm::ivec2 nbrCell = firstCell + local + offset;
+			const glm::ivec2 nbrSector = GetSectorOfCell(nbrCell);
+
+			if (nbrSector == sector)
+			{
+				continue;
+			}
+
+			const SectorState* const dependency = dependencies[GetNeighbourIndex(nbrSector - sector)];
+
+			if (dependency != nullptr)
+			{
+				lowestDist = std::min(lowestDist, dependency->mIntegration[GetIndexInSector(nbrCell, nbrSector)] + GetStepCost(offset));
+			}
+		}
+
+		if (lowestDist < integration[i])
+		{
+			integration[i] = lowestDist;
+			openCells.emplace_back(i);
+		}
+	}
+
+	uint32 openCurrentIndex = 0;
+
+	while (openCurrentIndex < openCells.size())
+	{
+		const int current = openCells[openCurrentIndex];
+		openCurrentIndex++;
+
+		// Pop_front in bulk
+		if (openCurrentIndex >= 1024)
+		{
+			openCells.erase(openCells.begin(), openCells.begin() + openCurrentIndex);
+			openCurrentIndex = 0;
+		}
+
+		const float currentDist = integration[current];
+		const glm::ivec2 local{ current % sSectorWidth, current / sSectorWidth };
+
+		for (const glm::ivec2 offset : sNeighbourOffsets)
+		{
+			const glm::ivec2 nbr = local + offset;
+
+			if (nbr.x < 0
+				|| nbr.y < 0
+				|| nbr.x >= sSectorWidth
+				|| nbr.y >= sSectorWidth)
+			{
+				continue;
+			}
+
+			const int nbrIndex = nbr.x + nbr.y * sSectorWidth;
+
+			if (isBlocked[nbrIndex])
+			{
+				continue;
+			}
+
+			const float nbrDist = currentDist + GetStepCost(offset);
+
+			if (nbrDist < integration[nbrIndex])
+			{
+				integration[nbrIndex] = nbrDist;
+				openCells.emplace_back(nbrIndex);
+			}
+		}
+	}
+
+	if (state.mRevision == 0
+		|| integration != state.mPreviousIntegration)
+	{
+		state.mRevision = target.mNextRevision++;
+	}
+
+	std::array<uint32, 9> revisions{ state.mRevision };
+
+	for (size_t i = 0; i < dependencies.size(); i++)
+	{
+		revisions[i + 1] = dependencies[i] == nullptr ? 0 : dependencies[i]->mRevision;
+	}
+
+	// Reuse the directions if nothing they were computed from has changed
+	if (state.mDirections == nullptr
+		|| revisions != state.mRevisionsOfDirections)
+	{
+		ComputeDirections(target, sector, state, dependencies);
+		state.mRevisionsOfDirections = revisions;
+	}
+
+	state.mIsUpToDate = true;
+	return &state;
+}
+
+void CE::FlowFieldEngine::ComputeDirections(const TargetState& target,
+	const glm::ivec2 sector,
+	SectorState& state,
+	const std::array<const SectorState*, 8>& dependencies)
+{
+	std::shared_ptr<SectorDirections> directions = std::make_shared<SectorDirections>();
+
+	const glm::ivec2 firstCell = sector * sSectorWidth;
+	const glm::vec2 goalPosition = GetCellCentre(target.mGoalCell, target.mCellSize);
+
+	for (int i = 0; i < sNumOfCellsPerSector; i++)
+	{
+		const glm::ivec2 cell = firstCell + glm::ivec2{ i % sSectorWidth, i / sSectorWidth };
+
+		// A floodfill does not cover enclosed areas.
+		// Those cells point directly to the target
+		glm::vec2 direction = GetDirectionTowards(GetCellCentre(cell, target.mCellSize), goalPosition);
+
+		if (cell != target.mGoalCell)
+		{
+			float lowestDist = sInf;
+
+			// Blocked cells also point towards their lowest neighbour, which pushes agents out of obstacles
+			for (const glm::ivec2 offset : sNeighbourOffsets)
+			{
+				const glm::ivec2 nbrCell = cell + offset;
+				const glm::ivec2 nbrSector = GetSectorOfCell(nbrCell);
+				float dist = sInf;
+
+				if (nbrSector == sector)
+				{
+					dist = state.mIntegration[GetIndexInSector(nbrCell, sector)];
+				}
+				else if (const SectorState* const dependency = dependencies[GetNeighbourIndex(nbrSector - sector)]; dependency != nullptr)
+				{
+					dist = dependency->mIntegration[GetIndexInSector(nbrCell, nbrSector)];
+				}
+
+				if (dist < lowestDist)
+				{
+					lowestDist = dist;
+					direction = glm::normalize(glm::vec2{ offset });
+				}
+			}
+		}
+
+		(*directions)[i] = direction;
+	}
+
+	if (target.mNumOfSmoothingSteps > 0)
+	{
+		SectorDirections smoothedDirections = *directions;
+
+		for (int step = 0; step < target.mNumOfSmoothingSteps; step++)
+		{
+			for (int i = 0; i < sNumOfCellsPerSector; i++)
+			{
+				const glm::ivec2 local{ i % sSectorWidth, i / sSectorWidth };
+				glm::vec2 total = (*directions)[i] * 2.0f;
+
+				for (const glm::ivec2 offset : sNeighbourOffsets)
+				{
+					const glm::ivec2 nbr = local + offset;
+
+					// Sectors are smoothed independently, so they can be reused independently
+					if (nbr.x < 0
+						|| nbr.y < 0
+						|| nbr.x >= sSectorWidth
+						|| nbr.y >= sSectorWidth)
+					{
+						total += (*directions)[i];
+						continue;
+					}
+
+					total += (*directions)[nbr.x + nbr.y * sSectorWidth];
+				}
+
+				const glm::vec2 average = total * (1.0f / 10.0f);
+				const float averageLength2 = glm::length2(average);
+
+				if (averageLength2 == 0.0f)
+				{
+					continue;
+				}
+
+				smoothedDirections[i] = average / glm::sqrt(averageLength2);
+			}
+
+			std::swap(*directions, smoothedDirections);
+		}
+	}
+
+	state.mDirections = std::move(directions);
+}
+
+bool CE::FlowFieldEngine::CanCrossBetween(const uint32 sizeClass, const glm::ivec2 fromSector, const glm::ivec2 toSector) const
+{
+	const char* const fromBlocked = FindBlockedCells(sizeClass, fromSector);
+	const char* const toBlocked = FindBlockedCells(sizeClass, toSector);
+
+	if (fromBlocked == nullptr
+		|| toBlocked == nullptr)
+	{
+		return false;
+	}
+
+	const glm::ivec2 direction = toSector - fromSector;
+
+	for (int i = 0; i < sSectorWidth; i++)
+	{
+		glm::ivec2 fromLocal{};
+		glm::ivec2 toLocal{};
+
+		if (direction.x != 0)
+		{
+			fromLocal = { direction.x > 0 ? sSectorWidth - 1 : 0, i };
+			toLocal = { direction.x > 0 ? 0 : sSectorWidth - 1, i };
+		}
+		else
+		{
+			fromLocal = { i, direction.y > 0 ? sSectorWidth - 1 : 0 };
+			toLocal = { i, direction.y > 0 ? 0 : sSectorWidth - 1 };
+		}
+
+		if (!fromBlocked[fromLocal.x + fromLocal.y * sSectorWidth]
+			&& !toBlocked[toLocal.x + toLocal.y * sSectorWidth])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+const char* CE::FlowFieldEngine::FindBlockedCells(const uint32 sizeClass, const glm::ivec2 sector) const
+{
+	const std::unordered_map<uint64, ObstacleSector>& sectors = mLayers[sizeClass].mSectors;
+	const auto it = sectors.find(MakeSectorKey(sector));
+	return it == sectors.end() || it->second.mIsBlocked.empty() ? nullptr : it->second.mIsBlocked.data();
+}
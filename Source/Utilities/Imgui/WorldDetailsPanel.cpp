@@ -372,7 +372,7 @@ void CE::WorldDetails::Display(World& world, std::vector<entt::entity>& selected
 
 		if (transform != nullptr)
 		{
-			transform->UpdateCachedWorldMatrix();
+			transform->MarkWorldDirty();
 		}
 	}
 }
\ No newline at end of file
@@ -582,14 +582,14 @@ std::string CE::Internal::CopyToClipBoard(const World& world, const std::vector<
 	BinaryGSONObject object = Archiver::Serialize(world, selectedEntities, true);
 	reg.RemoveComponents<WasRootCopyTag>(selectedEntities.begin(), selectedEntities.end());
 
-	std::ostringstream strStream{};
+	std::string binary{};
 
-	object.SaveToBinary(strStream);
+	object.SaveToBinary(binary);
 
 	// Clipboards work with c strings,
 	// since our binary data might contain a
 	// \0 character, we convert it to HEX first
-	const std::string clipBoardData = std::string{ sCopiedEntitiesId } + StringFunctions::BinaryToHex(strStream.str());
+	const std::string clipBoardData = std::string{ sCopiedEntitiesId } + StringFunctions::BinaryToHex(binary);
 	ImGui::SetClipboardText(clipBoardData.c_str());
 	return clipBoardData;
 }
@@ -614,9 +614,9 @@ void CE::Internal::PasteClipBoard(World& world, std::vector<entt::entity>& selec
 
 	{
 		const std::string binaryCopiedEntities = StringFunctions::HexToBinary(clipBoardData.substr(sCopiedEntitiesId.size()));
-		view_istream stream{ binaryCopiedEntities };
+		BinaryReader reader{ binaryCopiedEntities };
 
-		if (!object.LoadFromBinary(stream))
+		if (!object.LoadFromBinary(reader))
 		{
 			LOG(LogWorld, Error, "Trying to paste entities, but the provided string was unexpectedly invalid");
 			return;
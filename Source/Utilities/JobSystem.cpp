@@ -0,0 +1,334 @@
+#include "Precomp.h"
+#include "Utilities/JobSystem.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include "Utilities/Profiler.h"
+
+namespace CE::Internal
+{
+	struct Job
+	{
+		enum class State : uint8
+		{
+			WaitingOnDependencies,
+			Queued,
+			Running,
+			Finished
+		};
+
+		Job(std::function<void()>&& work, uint32 numOfDependencies) :
+			mWork(std::move(work)),
+			mNumOfUnfinishedDependencies(numOfDependencies)
+		{
+		}
+
+		// Only one thread may execute the job
+		bool TryClaim()
+		{
+			State expected = State::Queued;
+			return mState.compare_exchange_strong(expected, State::Running);
+		}
+
+		std::function<void()> mWork{};
+		std::atomic<uint32> mNumOfUnfinishedDependencies{};
+		std::atomic<State> mState{ State::WaitingOnDependencies };
+		std::atomic<bool> mIsCancelled{};
+
+		std::mutex mMutex{};
+		std::condition_variable mFinishedCondition{};
+		std::vector<std::shared_ptr<Job>> mContinuations{};
+
+		// The dependencies that had not finished when this job was scheduled,
+		// so that JobHandle::Wait can execute them. Cleared once this job has finished.
+		std::vector<std::shared_ptr<Job>> mDependencies{};
+	};
+}
+
+namespace
+{
+	constexpr uint32 sNotAWorker = std::numeric_limits<uint32>::max();
+	thread_local uint32 sWorkerIndex = sNotAWorker;
+}
+
+CE::JobSystem& CE::JobSystem::Get()
+{
+	static JobSystem jobSystem{};
+	return jobSystem;
+}
+
+CE::JobSystem::JobSystem()
+{
+	// The thread that schedules the work usually
+	// participates, so we leave one core for it.
+	const uint32 numOfWorkers = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+	// One for each worker, and one shared queue
+	// for jobs scheduled from other threads.
+	for (uint32 i = 0; i <= numOfWorkers; i++)
+	{
+		mQueues.emplace_back(std::make_unique<Queue>());
+	}
+
+	for (uint32 i = 0; i < numOfWorkers; i++)
+	{
+		mWorkers.emplace_back(
+			[this, i]
+			{
+				RunWorkerThread(i);
+			});
+	}
+}
+
+CE::JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard lock{ mParkMutex };
+		mShouldStopWorking = true;
+	}
+	mParkCondition.notify_all();
+
+	for (std::thread& worker : mWorkers)
+	{
+		worker.join();
+	}
+}
+
+CE::JobHandle CE::JobSystem::Schedule(std::function<void()>&& work, Span<const JobHandle> dependencies)
+{
+	// The extra dependency prevents the job from being queued
+	// while we are still registering it with its dependencies.
+	std::shared_ptr<Internal::Job> job = std::make_shared<Internal::Job>(std::move(work), static_cast<uint32>(dependencies.size()) + 1);
+
+	for (const JobHandle& dependency : dependencies)
+	{
+		if (!dependency.IsValid())
+		{
+			--job->mNumOfUnfinishedDependencies;
+			continue;
+		}
+
+		std::lock_guard lock{ dependency.mJob->mMutex };
+
+		if (dependency.mJob->mState == Internal::Job::State::Finished)
+		{
+			--job->mNumOfUnfinishedDependencies;
+		}
+		else
+		{
+			dependency.mJob->mContinuations.emplace_back(job);
+			job->mDependencies.emplace_back(dependency.mJob);
+		}
+	}
+
+	if (--job->mNumOfUnfinishedDependencies == 0)
+	{
+		Enqueue(job);
+	}
+
+	return job;
+}
+
+uint32 CE::JobSystem::GetBatchSize(uint32 numOfItems, uint32 minBatchSize) const
+{
+	const uint32 desiredNumOfBatches = GetNumOfThreads() * sNumOfBatchesPerThread;
+	return std::max({ minBatchSize, (numOfItems + desiredNumOfBatches - 1) / desiredNumOfBatches, 1u });
+}
+
+bool CE::JobSystem::IsWorkerThread() const
+{
+	return sWorkerIndex != sNotAWorker;
+}
+
+void CE::JobSystem::RunWorkerThread(uint32 workerIndex)
+{
+	sWorkerIndex = workerIndex;
+	PROFILE_THREAD_NAME(Format("Worker {}", workerIndex));
+
+	while (true)
+	{
+		if (TryExecuteOne())
+		{
+			continue;
+		}
+
+		std::unique_lock lock{ mParkMutex };
+		mParkCondition.wait(lock,
+			[this]
+			{
+				return mNumOfQueuedJobs > 0 || mShouldStopWorking;
+			});
+
+		if (mShouldStopWorking)
+		{
+			return;
+		}
+	}
+}
+
+void CE::JobSystem::Enqueue(std::shared_ptr<Internal::Job> job)
+{
+	job->mState = Internal::Job::State::Queued;
+
+	Queue& queue = *mQueues[IsWorkerThread() ? sWorkerIndex : mQueues.size() - 1];
+
+	{
+		std::lock_guard lock{ queue.mMutex };
+		queue.mJobs.emplace_back(std::move(job));
+	}
+
+	++mNumOfQueuedJobs;
+
+	// Locking ensures a worker cannot miss the notification between
+	// checking mNumOfQueuedJobs and starting to wait.
+	{
+		std::lock_guard lock{ mParkMutex };
+	}
+	mParkCondition.notify_one();
+}
+
+bool CE::JobSystem::TryExecuteOne()
+{
+	const uint32 numOfQueues = static_cast<uint32>(mQueues.size());
+	const uint32 ownQueue = IsWorkerThread() ? sWorkerIndex : numOfQueues - 1;
+
+	for (uint32 i = 0; i < numOfQueues; i++)
+	{
+		const uint32 queueIndex = (ownQueue + i) % numOfQueues;
+		Queue& queue = *mQueues[queueIndex];
+
+		std::shared_ptr<Internal::Job> job{};
+
+		{
+			std::lock_guard lock{ queue.mMutex };
+
+			if (queue.mJobs.empty())
+			{
+				continue;
+			}
+
+			// Workers take the most recent job from their own queue, as
+			// that is most likely to still be in cache. The oldest jobs are stolen.
+			if (queueIndex == sWorkerIndex)
+			{
+				job = std::move(queue.mJobs.back());
+				queue.mJobs.pop_back();
+			}
+			else
+			{
+				job = std::move(queue.mJobs.front());
+				queue.mJobs.pop_front();
+			}
+		}
+
+		--mNumOfQueuedJobs;
+
+		// Someone could've executed it already through JobHandle::Wait
+		if (job->TryClaim())
+		{
+			Execute(*job);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void CE::JobSystem::Execute(Internal::Job& job)
+{
+	if (!job.mIsCancelled)
+	{
+		job.mWork();
+	}
+
+	// Releases anything the workload captured
+	job.mWork = nullptr;
+
+	std::vector<std::shared_ptr<Internal::Job>> continuations{};
+
+	{
+		std::lock_guard lock{ job.mMutex };
+		job.mState = Internal::Job::State::Finished;
+		continuations.swap(job.mContinuations);
+		job.mDependencies.clear();
+	}
+	job.mFinishedCondition.notify_all();
+
+	for (std::shared_ptr<Internal::Job>& continuation : continuations)
+	{
+		if (--continuation->mNumOfUnfinishedDependencies == 0)
+		{
+			Get().Enqueue(std::move(continuation));
+		}
+	}
+}
+
+bool CE::JobHandle::IsFinished() const
+{
+	return mJob == nullptr || mJob->mState == Internal::Job::State::Finished;
+}
+
+void CE::JobHandle::Wait() const
+{
+	if (mJob == nullptr)
+	{
+		return;
+	}
+
+	// Only the awaited job and its dependencies are executed on the calling thread. Picking
+	// up unrelated jobs could keep the caller busy long after the awaited job has finished.
+	while (!IsFinished())
+	{
+		if (mJob->TryClaim())
+		{
+			JobSystem::Execute(*mJob);
+			return;
+		}
+
+		std::vector<std::shared_ptr<Internal::Job>> dependencies{};
+
+		{
+			std::lock_guard lock{ mJob->mMutex };
+
+			if (mJob->mState == Internal::Job::State::WaitingOnDependencies)
+			{
+				dependencies = mJob->mDependencies;
+			}
+		}
+
+		bool wasAnyDependencyUnfinished{};
+
+		for (std::shared_ptr<Internal::Job>& dependency : dependencies)
+		{
+			const JobHandle handle{ std::move(dependency) };
+			wasAnyDependencyUnfinished |= !handle.IsFinished();
+			handle.Wait();
+		}
+
+		// The job is queued by the thread that finished the last dependency, try to claim it again
+		if (wasAnyDependencyUnfinished)
+		{
+			continue;
+		}
+
+		// Another thread is executing the job, or is about to queue it. The time-out
+		// makes sure we can claim the job ourselves if it was queued in the meantime.
+		std::unique_lock lock{ mJob->mMutex };
+		mJob->mFinishedCondition.wait_for(lock, std::chrono::microseconds{ 200 },
+			[this]
+			{
+				return mJob->mState == Internal::Job::State::Finished;
+			});
+	}
+}
+
+void CE::JobHandle::Cancel() const
+{
+	if (mJob != nullptr)
+	{
+		mJob->mIsCancelled = true;
+	}
+}
@@ -0,0 +1,180 @@
+#include "Precomp.h"
+#include "Utilities/MemoryMappedFile.h"
+
+#ifdef PLATFORM_WINDOWS
+#pragma warning(push)
+#pragma warning(disable : 4005)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <Windows.h>
+#pragma warning(pop)
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // PLATFORM_WINDOWS
+
+CE::MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept :
+	mData(std::exchange(other.mData, nullptr)),
+	mSize(std::exchange(other.mSize, 0))
+#ifdef PLATFORM_WINDOWS
+	, mFileHandle(std::exchange(other.mFileHandle, nullptr)),
+	mMappingHandle(std::exchange(other.mMappingHandle, nullptr))
+#endif // PLATFORM_WINDOWS
+{
+}
+
+CE::MemoryMappedFile::~MemoryMappedFile()
+{
+	Unmap();
+}
+
+CE::MemoryMappedFile& CE::MemoryMappedFile::operator=(MemoryMappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Unmap();
+		mData = std::exchange(other.mData, nullptr);
+		mSize = std::exchange(other.mSize, 0);
+#ifdef PLATFORM_WINDOWS
+		mFileHandle = std::exchange(other.mFileHandle, nullptr);
+		mMappingHandle = std::exchange(other.mMappingHandle, nullptr);
+#endif // PLATFORM_WINDOWS
+	}
+	return *this;
+}
+
+void CE::MemoryMappedFile::Prefetch() const
+{
+	// Reading a single byte from each page is enough to make the operating system load it
+	static constexpr size_t pageSize = 4096;
+
+	const volatile std::byte* const bytes = static_cast<const volatile std::byte*>(mData);
+	std::byte checksum{};
+
+	for (size_t i = 0; i < mSize; i += pageSize)
+	{
+		checksum ^= bytes[i];
+	}
+
+	static_cast<void>(checksum);
+}
+
+#ifdef PLATFORM_WINDOWS
+
+std::optional<CE::MemoryMappedFile> CE::MemoryMappedFile::Map(const std::filesystem::path& path)
+{
+	MemoryMappedFile file{};
+
+	// Write access is not shared, as the mapped bytes must not change while they are read.
+	// Sharing delete access still allows the file to be renamed or deleted while it is mapped.
+	const HANDLE fileHandle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+
+	if (fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return std::nullopt;
+	}
+	file.mFileHandle = fileHandle;
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(fileHandle, &size)
+		|| size.QuadPart <= 0)
+	{
+		return std::nullopt;
+	}
+	file.mSize = static_cast<size_t>(size.QuadPart);
+
+	const HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (mappingHandle == nullptr)
+	{
+		return std::nullopt;
+	}
+	file.mMappingHandle = mappingHandle;
+
+	file.mData = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+	if (file.mData == nullptr)
+	{
+		return std::nullopt;
+	}
+
+	return file;
+}
+
+void CE::MemoryMappedFile::Unmap()
+{
+	if (mData != nullptr)
+	{
+		UnmapViewOfFile(mData);
+		mData = nullptr;
+	}
+
+	if (mMappingHandle != nullptr)
+	{
+		CloseHandle(mMappingHandle);
+		mMappingHandle = nullptr;
+	}
+
+	if (mFileHandle != nullptr)
+	{
+		CloseHandle(mFileHandle);
+		mFileHandle = nullptr;
+	}
+
+	mSize = 0;
+}
+
+#else
+
+std::optional<CE::MemoryMappedFile> CE::MemoryMappedFile::Map(const std::filesystem::path& path)
+{
+	const int fileDescriptor = open(path.c_str(), O_RDONLY);
+
+	if (fileDescriptor == -1)
+	{
+		return std::nullopt;
+	}
+
+	struct stat fileStat{};
+
+	if (fstat(fileDescriptor, &fileStat) != 0
+		|| fileStat.st_size <= 0)
+	{
+		close(fileDescriptor);
+		return std::nullopt;
+	}
+
+	void* const data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	// The mapping keeps its own reference to the file
+	close(fileDescriptor);
+
+	if (data == MAP_FAILED)
+	{
+		return std::nullopt;
+	}
+
+	MemoryMappedFile file{};
+	file.mData = data;
+	file.mSize = static_cast<size_t>(fileStat.st_size);
+	return file;
+}
+
+void CE::MemoryMappedFile::Unmap()
+{
+	if (mData != nullptr)
+	{
+		munmap(const_cast<void*>(mData), mSize);
+		mData = nullptr;
+	}
+
+	mSize = 0;
+}
+
+#endif // PLATFORM_WINDOWS
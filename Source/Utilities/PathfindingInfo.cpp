@@ -1,196 +1,368 @@
 #include "Precomp.h"
 #include "Utilities/PathfindingInfo.h"
 
-#include <queue>
-#include <unordered_map>
-
 #include "World/World.h"
 #include "Utilities/DrawDebugHelpers.h"
 
 using namespace CE;
 
-Pathfinding::Edge::Edge(const float cost, Node* toNode) : mCost(cost), mToNode(toNode)
+Pathfinding::SearchContext& Pathfinding::SearchContext::GetForThisThread()
 {
+	static thread_local SearchContext context{};
+	return context;
 }
 
-float Pathfinding::Edge::GetCost() const
+void Pathfinding::SearchContext::BeginSearch(const uint32 numOfNodes)
 {
-	return mCost;
-}
+	if (mStates.size() < numOfNodes)
+	{
+		mStates.resize(numOfNodes);
+	}
 
-Pathfinding::Node* Pathfinding::Edge::GetToNode() const
-{
-	return mToNode;
+	mHeap.clear();
+
+	// Generation 0 is never used, as that is what the states are initialized with
+	if (++mGeneration == 0)
+	{
+		for (NodeState& state : mStates)
+		{
+			state.mOpenGeneration = 0;
+			state.mClosedGeneration = 0;
+		}
+		mGeneration = 1;
+	}
 }
 
-Pathfinding::Node::Node(const int id, glm::vec2 position) : mId(id), mPosition(position)
+Pathfinding::NodeId Pathfinding::Graph::AddNode(const glm::vec2 position)
 {
+	mPositions.emplace_back(position);
+	return static_cast<NodeId>(mPositions.size() - 1);
 }
 
-void Pathfinding::Node::AddEdge(Node* toNode, float cost, const bool biDirectional)
+void Pathfinding::Graph::AddEdge(const NodeId fromNode, const NodeId toNode, float cost, const bool biDirectional)
 {
+	ASSERT(fromNode < GetNumOfNodes() && toNode < GetNumOfNodes());
+
 	if (cost < 0)
 	{
-		cost = sqrt(powf(toNode->mPosition.x - mPosition.x, 2) +
-			powf(toNode->mPosition.y - mPosition.y, 2));
+		cost = glm::distance(mPositions[fromNode], mPositions[toNode]);
 	}
 
-	const Edge newEdge = {cost, toNode};
-	mConnectingEdges.push_back(newEdge);
+	mPendingEdges.emplace_back(PendingEdge{ fromNode, Edge{ toNode, cost } });
 
 	if (biDirectional)
 	{
-		const auto otherNode = Edge(newEdge.GetCost(), this);
-		newEdge.GetToNode()->mConnectingEdges.push_back(otherNode);
+		mPendingEdges.emplace_back(PendingEdge{ toNode, Edge{ fromNode, cost } });
 	}
 }
 
-const std::vector<Pathfinding::Edge>& Pathfinding::Node::GetConnectingEdges() const
+void Pathfinding::Graph::Build()
 {
-	return mConnectingEdges;
-}
+	const uint32 numOfNodes = GetNumOfNodes();
 
-glm::vec2 Pathfinding::Node::GetPosition() const
-{
-	return mPosition;
-}
+	// Edges that were already built are added again, so Build can be called more than once
+	for (NodeId node = 0; node + 1 < mFirstEdge.size(); node++)
+	{
+		for (uint32 i = mFirstEdge[node]; i < mFirstEdge[node + 1]; i++)
+		{
+			mPendingEdges.emplace_back(PendingEdge{ node, mEdges[i] });
+		}
+	}
 
-int Pathfinding::Node::GetId() const
-{
-	return mId;
-}
+	// Counting sort on the node the edges leave from, which keeps the order in which edges were added
+	mFirstEdge.assign(numOfNodes + 1, 0);
 
-Pathfinding::Graph::Graph(const std::vector<Node>& nodes) : mNodes(nodes)
-{
-}
+	for (const PendingEdge& pending : mPendingEdges)
+	{
+		++mFirstEdge[pending.mFromNode + 1];
+	}
 
-void Pathfinding::Graph::AddNode(const float x, const float y)
-{
-	const Node nodeToAdd = {static_cast<int>(mNodes.size()), {x, y}};
-	mNodes.push_back(nodeToAdd);
+	for (uint32 i = 0; i < numOfNodes; i++)
+	{
+		mFirstEdge[i + 1] += mFirstEdge[i];
+	}
+
+	mEdges.resize(mPendingEdges.size());
+
+	std::vector<uint32> nextEdge(mFirstEdge.begin(), mFirstEdge.end() - 1);
+
+	for (const PendingEdge& pending : mPendingEdges)
+	{
+		mEdges[nextEdge[pending.mFromNode]++] = pending.mEdge;
+	}
+
+	mPendingEdges.clear();
+	mPendingEdges.shrink_to_fit();
 }
 
-std::vector<const Pathfinding::Node*> Pathfinding::Graph::AStarSearch(
-	const Node* startNode, const Node* endNode) const
+Span<const Pathfinding::Edge> Pathfinding::Graph::GetConnectingEdges(const NodeId node) const
 {
-	struct OpenListItem
+	ASSERT_LOG(mPendingEdges.empty(), "Graph::Build was not called after adding edges");
+
+	if (node + 1 >= mFirstEdge.size())
 	{
-		int mId;
-		int mCameFromId{ -1 };
-		float mG{};
-		float mH{};
-	};
+		return {};
+	}
+
+	return { mEdges.data() + mFirstEdge[node], mFirstEdge[node + 1] - mFirstEdge[node] };
+}
 
-	// Static, so we can reuse the buffer
-	static std::vector<OpenListItem> openStorage{};
-	openStorage.clear();
-	openStorage.resize(mNodes.size());
+bool Pathfinding::Graph::AStarSearch(const NodeId startNode,
+	const NodeId endNode,
+	SearchContext& context,
+	std::vector<NodeId>& outPath) const
+{
+	outPath.clear();
 
-	for (int i = 0; i < static_cast<int>(openStorage.size()); i++)
+	if (startNode >= GetNumOfNodes()
+		|| endNode >= GetNumOfNodes())
 	{
-		openStorage[i].mId = i;
+		return false;
 	}
 
-	const auto compareNodes = [](int lhsId, int rhsId)
+	context.BeginSearch(GetNumOfNodes());
+	const uint32 generation = context.mGeneration;
+	std::vector<SearchContext::NodeState>& states = context.mStates;
+	std::vector<SearchContext::OpenListItem>& heap = context.mHeap;
+
+	const auto compareItems = [](const SearchContext::OpenListItem& lhs, const SearchContext::OpenListItem& rhs)
 		{
-			const OpenListItem& lhs = openStorage[lhsId];
-			const OpenListItem& rhs = openStorage[rhsId];
-			return lhs.mG + lhs.mH > rhs.mG + rhs.mH;
+			return lhs.mF > rhs.mF;
 		};
 
-	// Initialize an empty vector to store the resulting path
-	static std::vector<const Node*> nodePath = {};
-	nodePath.clear();
-
-	// Create the OpenListItem for the start node and add it to the map and priority queue
-	OpenListItem& startOpenListItem = openStorage[startNode->GetId()];
-	startOpenListItem.mH = Heuristic(*startNode, *endNode);
+	SearchContext::NodeState& startState = states[startNode];
+	startState.mOpenGeneration = generation;
+	startState.mCameFrom = sInvalidNodeId;
+	startState.mG = 0.0f;
 
-	// Static, so we can reuse the buffer
-	static std::vector<uint32> heap{};
-	heap.clear();
-	heap.reserve(mNodes.size());
-	heap.emplace_back(startOpenListItem.mId);
-	std::push_heap(heap.begin(), heap.end(), compareNodes);
+	heap.emplace_back(SearchContext::OpenListItem{ Heuristic(startNode, endNode), startNode });
 
 	while (!heap.empty())
 	{
 		// Get the node with the lowest F (H + G) from the priority queue
-		const OpenListItem& current = openStorage[heap.front()];
-
-		std::pop_heap(heap.begin(), heap.end(), compareNodes);
+		std::pop_heap(heap.begin(), heap.end(), compareItems);
+		const NodeId current = heap.back().mNode;
 		heap.pop_back();
 
-		// If the current node is the end node, construct the path and return it
-		if (current.mId == endNode->GetId())
+		SearchContext::NodeState& currentState = states[current];
+
+		// A node can be in the heap more than once if a better path to it was found later on
+		if (currentState.mClosedGeneration == generation)
 		{
-			const OpenListItem* pastItem = &current;
+			continue;
+		}
+		currentState.mClosedGeneration = generation;
 
-			while(true)
+		// If the current node is the end node, construct the path and return it
+		if (current == endNode)
+		{
+			for (NodeId node = current; node != sInvalidNodeId; node = states[node].mCameFrom)
 			{
-				nodePath.emplace_back(&mNodes[pastItem->mId]);
-
-				if (pastItem->mCameFromId == -1)
-				{
-					break;
-				}
-				pastItem = &openStorage[pastItem->mCameFromId];
+				outPath.emplace_back(node);
 			}
 
-			std::reverse(nodePath.begin(), nodePath.end());
-			return nodePath;
+			std::reverse(outPath.begin(), outPath.end());
+			return true;
 		}
 
 		// Explore neighbouring nodes
-		for (const Edge& edge : mNodes[current.mId].GetConnectingEdges())
+		for (const Edge& edge : GetConnectingEdges(current))
 		{
-			const int toNodeId = edge.GetToNode()->GetId();
-			OpenListItem& neighbour = openStorage[toNodeId];
+			SearchContext::NodeState& neighbour = states[edge.mToNode];
 
-			if (neighbour.mCameFromId != -1
-				|| &neighbour == &startOpenListItem)
+			if (neighbour.mClosedGeneration == generation)
 			{
-				// Skip visited nodes
 				continue;
 			}
 
 			// Calculate the new G (cost from start node to the current node)
-			const auto newG = current.mG + edge.GetCost();
+			const float newG = currentState.mG + edge.mCost;
 
 			// Update node information if this is a better path
-			if (newG < neighbour.mG || neighbour.mG == 0.0f)
+			if (neighbour.mOpenGeneration != generation
+				|| newG < neighbour.mG)
 			{
+				neighbour.mOpenGeneration = generation;
 				neighbour.mG = newG;
-				neighbour.mH = Heuristic(mNodes[neighbour.mId], *endNode);
-				neighbour.mCameFromId = current.mId;
+				neighbour.mCameFrom = current;
 
-				heap.emplace_back(toNodeId);
-				std::push_heap(heap.begin(), heap.end(), compareNodes);
+				heap.emplace_back(SearchContext::OpenListItem{ newG + Heuristic(edge.mToNode, endNode), edge.mToNode });
+				std::push_heap(heap.begin(), heap.end(), compareItems);
 			}
 		}
 	}
-	return nodePath;
+
+	return false;
 }
 
-float Pathfinding::Graph::Heuristic(const Node& currentNode, const Node& endNode) const
+float Pathfinding::Graph::Heuristic(const NodeId currentNode, const NodeId endNode) const
 {
-	return glm::distance(endNode.GetPosition(), currentNode.GetPosition());
+	return glm::distance(mPositions[endNode], mPositions[currentNode]);
 }
 
 void Pathfinding::Graph::DebugDrawAStarGraph(const World& world) const
 {
-	for (const auto& n : mNodes)
+	for (NodeId node = 0; node < GetNumOfNodes(); node++)
 	{
-		DrawDebugCircle(world, DebugCategory::Gameplay, glm::vec3{n.GetPosition().x, 0, n.GetPosition().y},
+		const glm::vec2 position = mPositions[node];
+
+		DrawDebugCircle(world, DebugCategory::Gameplay, glm::vec3{position.x, 0, position.y},
 		                0.2f,
 		                {1.f, 0.f, 0.f, 1.f});
-		for (const auto& m : n.GetConnectingEdges())
+		for (const Edge& edge : GetConnectingEdges(node))
 		{
-			DrawDebugLine(world, DebugCategory::Gameplay, glm::vec3{n.GetPosition().x, 0, n.GetPosition().y},
-			              glm::vec3{
-				              m.GetToNode()->GetPosition().x, 0, m.GetToNode()->GetPosition().y
-			              }, {0.f, 1.f, 0.f, 1.f});
+			const glm::vec2 toPosition = mPositions[edge.mToNode];
+
+			DrawDebugLine(world, DebugCategory::Gameplay, glm::vec3{position.x, 0, position.y},
+			              glm::vec3{toPosition.x, 0, toPosition.y}, {0.f, 1.f, 0.f, 1.f});
 		}
 	}
 }
 
+Pathfinding::PathCache::PathCache(const uint32 capacity) :
+	mCapacity(capacity)
+{
+	mEntryIndices.reserve(capacity);
+}
+
+Pathfinding::PathCache::PathCache(PathCache&& other) noexcept
+{
+	*this = std::move(other);
+}
+
+Pathfinding::PathCache& Pathfinding::PathCache::operator=(PathCache&& other) noexcept
+{
+	if (this == &other)
+	{
+		return *this;
+	}
+
+	std::scoped_lock lock{ mMutex, other.mMutex };
+
+	mEntries = std::move(other.mEntries);
+	mEntryIndices = std::move(other.mEntryIndices);
+	mMostRecentlyUsed = std::exchange(other.mMostRecentlyUsed, sNone);
+	mLeastRecentlyUsed = std::exchange(other.mLeastRecentlyUsed, sNone);
+	mCapacity = other.mCapacity;
+
+	other.mEntries.clear();
+	other.mEntryIndices.clear();
+
+	return *this;
+}
+
+bool Pathfinding::PathCache::TryGet(const NodeId startNode, const NodeId endNode, std::vector<glm::vec2>& outPath)
+{
+	std::lock_guard lock{ mMutex };
+
+	const auto it = mEntryIndices.find(MakeKey(startNode, endNode));
+
+	if (it == mEntryIndices.end())
+	{
+		return false;
+	}
+
+	MoveToFront(it->second);
+
+	const std::vector<glm::vec2>& path = mEntries[it->second].mPath;
+	outPath.assign(path.begin(), path.end());
+	return true;
+}
+
+void Pathfinding::PathCache::Add(const NodeId startNode, const NodeId endNode, const Span<const glm::vec2> path)
+{
+	if (mCapacity == 0)
+	{
+		return;
+	}
+
+	std::lock_guard lock{ mMutex };
+
+	const uint64 key = MakeKey(startNode, endNode);
+	uint32 entryIndex{};
+
+	if (const auto existing = mEntryIndices.find(key); existing != mEntryIndices.end())
+	{
+		entryIndex = existing->second;
+	}
+	else if (mEntries.size() < mCapacity)
+	{
+		entryIndex = static_cast<uint32>(mEntries.size());
+		mEntries.emplace_back();
+		mEntryIndices.emplace(key, entryIndex);
+	}
+	else
+	{
+		// Reuse the least recently used entry, including its buffer
+		entryIndex = mLeastRecentlyUsed;
+		mEntryIndices.erase(mEntries[entryIndex].mKey);
+		mEntryIndices.emplace(key, entryIndex);
+	}
+
+	Entry& entry = mEntries[entryIndex];
+	entry.mKey = key;
+	entry.mPath.assign(path.begin(), path.end());
+
+	MoveToFront(entryIndex);
+}
+
+void Pathfinding::PathCache::Clear()
+{
+	std::lock_guard lock{ mMutex };
+
+	mEntries.clear();
+	mEntryIndices.clear();
+	mMostRecentlyUsed = sNone;
+	mLeastRecentlyUsed = sNone;
+}
+
+void Pathfinding::PathCache::MoveToFront(const uint32 entryIndex)
+{
+	if (mMostRecentlyUsed == entryIndex)
+	{
+		return;
+	}
+
+	Unlink(entryIndex);
+
+	Entry& entry = mEntries[entryIndex];
+	entry.mPrev = sNone;
+	entry.mNext = mMostRecentlyUsed;
+
+	if (mMostRecentlyUsed != sNone)
+	{
+		mEntries[mMostRecentlyUsed].mPrev = entryIndex;
+	}
+	mMostRecentlyUsed = entryIndex;
+
+	if (mLeastRecentlyUsed == sNone)
+	{
+		mLeastRecentlyUsed = entryIndex;
+	}
+}
+
+void Pathfinding::PathCache::Unlink(const uint32 entryIndex)
+{
+	Entry& entry = mEntries[entryIndex];
+
+	if (entry.mPrev != sNone)
+	{
+		mEntries[entry.mPrev].mNext = entry.mNext;
+	}
+	else if (mMostRecentlyUsed == entryIndex)
+	{
+		mMostRecentlyUsed = entry.mNext;
+	}
+
+	if (entry.mNext != sNone)
+	{
+		mEntries[entry.mNext].mPrev = entry.mPrev;
+	}
+	else if (mLeastRecentlyUsed == entryIndex)
+	{
+		mLeastRecentlyUsed = entry.mPrev;
+	}
+
+	entry.mPrev = sNone;
+	entry.mNext = sNone;
+}
@@ -0,0 +1,243 @@
+#include "Precomp.h"
+#include "Utilities/Profiler.h"
+
+#ifdef PROFILING_ENABLED
+#include <map>
+
+#include "Utilities/StringFunctions.h"
+
+CE::Profiler& CE::Profiler::Get()
+{
+	static Profiler profiler{};
+	return profiler;
+}
+
+void CE::Profiler::BeginCapture()
+{
+	std::lock_guard lock{ mMutex };
+
+	DrainThreadBuffers(true);
+	mCapturedEvents.clear();
+	mNumOfDroppedEvents = 0;
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : mThreadBuffers)
+	{
+		buffer->mNumOfDroppedEvents.store(0, std::memory_order_relaxed);
+	}
+
+	mCaptureStart = Now();
+	mIsCapturing.store(true, std::memory_order_relaxed);
+}
+
+void CE::Profiler::EndCapture()
+{
+	std::lock_guard lock{ mMutex };
+
+	mIsCapturing.store(false, std::memory_order_relaxed);
+	DrainThreadBuffers(false);
+}
+
+bool CE::Profiler::HasCapture() const
+{
+	std::lock_guard lock{ mMutex };
+	return !mCapturedEvents.empty();
+}
+
+void CE::Profiler::SetThreadName(const std::string_view name)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+
+	std::lock_guard lock{ mMutex };
+	buffer.mName = name;
+}
+
+void CE::Profiler::MarkFrame()
+{
+	if (!IsCapturing())
+	{
+		return;
+	}
+
+	Record({ "Frame", Now(), 0, EventType::Frame });
+
+	std::lock_guard lock{ mMutex };
+	DrainThreadBuffers(false);
+}
+
+void CE::Profiler::SetCounter(const std::string_view name, const int64 value)
+{
+	if (IsCapturing())
+	{
+		Record({ name, Now(), value, EventType::Counter });
+	}
+}
+
+void CE::Profiler::AddToCounter(const std::string_view name, const int64 amount)
+{
+	if (IsCapturing())
+	{
+		Record({ name, Now(), amount, EventType::CounterIncrement });
+	}
+}
+
+void CE::Profiler::Record(const Event& event)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+
+	const uint64 writeIndex = buffer.mWriteIndex.load(std::memory_order_relaxed);
+
+	if (writeIndex - buffer.mReadIndex.load(std::memory_order_acquire) >= sRingBufferSize)
+	{
+		buffer.mNumOfDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	buffer.mEvents[writeIndex & (sRingBufferSize - 1)] = event;
+	buffer.mWriteIndex.store(writeIndex + 1, std::memory_order_release);
+}
+
+CE::Profiler::ThreadBuffer& CE::Profiler::GetThreadBuffer()
+{
+	thread_local ThreadBuffer* threadBuffer{};
+
+	if (threadBuffer == nullptr)
+	{
+		std::lock_guard lock{ mMutex };
+		threadBuffer = mThreadBuffers.emplace_back(std::make_unique<ThreadBuffer>()).get();
+	}
+
+	return *threadBuffer;
+}
+
+void CE::Profiler::DrainThreadBuffers(const bool shouldDiscard)
+{
+	for (uint32 threadIndex = 0; threadIndex < static_cast<uint32>(mThreadBuffers.size()); threadIndex++)
+	{
+		ThreadBuffer& buffer = *mThreadBuffers[threadIndex];
+
+		const uint64 readIndex = buffer.mReadIndex.load(std::memory_order_relaxed);
+		const uint64 writeIndex = buffer.mWriteIndex.load(std::memory_order_acquire);
+
+		if (!shouldDiscard)
+		{
+			for (uint64 i = readIndex; i < writeIndex; i++)
+			{
+				if (mCapturedEvents.size() >= sMaxNumOfCapturedEvents)
+				{
+					mNumOfDroppedEvents += writeIndex - i;
+					break;
+				}
+
+				mCapturedEvents.push_back({ buffer.mEvents[i & (sRingBufferSize - 1)], threadIndex });
+			}
+		}
+
+		buffer.mReadIndex.store(writeIndex, std::memory_order_release);
+	}
+}
+
+void CE::Profiler::ExportChromeTrace(std::ostream& stream) const
+{
+	std::lock_guard lock{ mMutex };
+
+	const auto toMicroseconds = [this](const int64 time)
+		{
+			return static_cast<double>(time - mCaptureStart) * 1e-3;
+		};
+
+	stream << "{\"traceEvents\":[";
+	bool isFirst = true;
+
+	const auto beginEvent = [&]() -> std::ostream&
+		{
+			stream << (isFirst ? "\n" : ",\n");
+			isFirst = false;
+			return stream;
+		};
+
+	uint64 numOfDroppedEvents = mNumOfDroppedEvents;
+
+	for (uint32 threadIndex = 0; threadIndex < static_cast<uint32>(mThreadBuffers.size()); threadIndex++)
+	{
+		const ThreadBuffer& buffer = *mThreadBuffers[threadIndex];
+		numOfDroppedEvents += buffer.mNumOfDroppedEvents.load(std::memory_order_relaxed);
+
+		if (buffer.mName.empty())
+		{
+			continue;
+		}
+
+		beginEvent() << Format("{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":{},\"args\":{{\"name\":", threadIndex);
+		StringFunctions::WriteEscapedJSONString(stream, buffer.mName);
+		stream << "}}";
+	}
+
+	std::vector<int64> frameTimes{};
+
+	for (const CapturedEvent& captured : mCapturedEvents)
+	{
+		if (captured.mEvent.mType == EventType::Frame)
+		{
+			frameTimes.emplace_back(captured.mEvent.mTime);
+		}
+	}
+
+	std::sort(frameTimes.begin(), frameTimes.end());
+
+	// The increments are summed over each frame, the first 'frame' is everything before the first frame marker
+	std::map<std::string_view, std::vector<int64>> incrementsPerFrame{};
+
+	for (const CapturedEvent& captured : mCapturedEvents)
+	{
+		const Event& event = captured.mEvent;
+
+		switch (event.mType)
+		{
+		case EventType::Zone:
+			beginEvent() << "{\"name\":";
+			StringFunctions::WriteEscapedJSONString(stream, event.mName);
+			stream << Format(",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,\"tid\":{}}}",
+				toMicroseconds(event.mTime),
+				static_cast<double>(event.mValue) * 1e-3,
+				captured.mThread);
+			break;
+		case EventType::Counter:
+			beginEvent() << "{\"name\":";
+			StringFunctions::WriteEscapedJSONString(stream, event.mName);
+			stream << Format(",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":0,\"args\":{{\"value\":{}}}}}",
+				toMicroseconds(event.mTime),
+				event.mValue);
+			break;
+		case EventType::CounterIncrement:
+		{
+			std::vector<int64>& increments = incrementsPerFrame[event.mName];
+			increments.resize(frameTimes.size() + 1);
+
+			const size_t frame = std::upper_bound(frameTimes.begin(), frameTimes.end(), event.mTime) - frameTimes.begin();
+			increments[frame] += event.mValue;
+			break;
+		}
+		case EventType::Frame:
+			beginEvent() << Format("{{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":{:.3f},\"pid\":0,\"tid\":{}}}",
+				toMicroseconds(event.mTime),
+				captured.mThread);
+			break;
+		}
+	}
+
+	for (const auto& [name, increments] : incrementsPerFrame)
+	{
+		for (size_t frame = 0; frame < increments.size(); frame++)
+		{
+			beginEvent() << "{\"name\":";
+			StringFunctions::WriteEscapedJSONString(stream, name);
+			stream << Format(",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":0,\"args\":{{\"value\":{}}}}}",
+				frame == 0 ? 0.0 : toMicroseconds(frameTimes[frame - 1]),
+				increments[frame]);
+		}
+	}
+
+	stream << Format("\n],\"displayTimeUnit\":\"ns\",\"otherData\":{{\"droppedEvents\":{}}}}}\n", numOfDroppedEvents);
+}
+
+#endif // PROFILING_ENABLED
@@ -41,6 +41,41 @@ uint32 CE::Random::CreateSeed(glm::vec2 position)
 	return static_cast<uint32>(noise * static_cast<float>(std::numeric_limits<uint32>::max()));
 }
 
+void CE::Random::SetSeed(const uint32 seed)
+{
+	sSeed.store(seed, std::memory_order_relaxed);
+	sEngineSeedVersion = sSeedVersion.fetch_add(1, std::memory_order_acq_rel) + 1;
+	sEngine.seed(seed);
+}
+
+namespace
+{
+	// SplitMix64, so that neighbouring streams do not produce similar sequences
+	uint64 MixBits(uint64 value)
+	{
+		value += 0x9e3779b97f4a7c15ull;
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+		return value ^ (value >> 31);
+	}
+}
+
+void CE::Random::SelectStream(const uint64 stream)
+{
+	// Also makes sure GetEngine does not reseed us with the seed of this thread
+	sEngineSeedVersion = sSeedVersion.load(std::memory_order_acquire);
+	sStream = stream;
+
+	const uint64 mixed = MixBits((static_cast<uint64>(sSeed.load(std::memory_order_relaxed)) << 32) ^ stream);
+	sEngine.seed(static_cast<uint32>(mixed ^ (mixed >> 32)));
+}
+
+uint64 CE::Random::DeriveStream(const uint64 stream, const uint32 index)
+{
+	// Mixed first, so that the derived streams do not overlap with the streams the registry selects
+	return MixBits(stream) + index;
+}
+
 CE::MetaType CE::Random::Reflect()
 {
     MetaType type{ MetaType::T<Random>{}, "Random" };
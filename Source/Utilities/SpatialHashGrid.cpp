@@ -0,0 +1,103 @@
+#include "Precomp.h"
+#include "Utilities/SpatialHashGrid.h"
+
+void CE::SpatialHashGrid::Build(Span<const TransformedAABB> boundingBoxes, std::vector<uint32>& order)
+{
+	Clear();
+
+	const uint32 numOfObjects = static_cast<uint32>(boundingBoxes.size());
+	order.resize(numOfObjects);
+
+	if (numOfObjects == 0)
+	{
+		return;
+	}
+
+	// The cells are as wide as the average object
+	float totalExtent{};
+
+	for (const TransformedAABB& boundingBox : boundingBoxes)
+	{
+		const glm::vec2 size = boundingBox.GetSize();
+		totalExtent += std::max(size.x, size.y);
+	}
+
+	mCellSize = std::max(totalExtent / static_cast<float>(numOfObjects), sMinCellSize);
+
+	const float maxHalfExtent = mCellSize * sMaxHalfExtentInCells;
+
+	// Twice as many buckets as objects keeps the chance that two cells share a bucket low
+	uint32 numOfBuckets = 1;
+
+	while (numOfBuckets < numOfObjects * 2)
+	{
+		numOfBuckets <<= 1;
+	}
+
+	mBucketMask = numOfBuckets - 1;
+	mBucketStart.assign(numOfBuckets + 1, 0);
+
+	static constexpr uint32 oversized = std::numeric_limits<uint32>::max();
+
+	mBucketOfObject.resize(numOfObjects);
+	mCellOfObject.resize(numOfObjects);
+
+	for (uint32 i = 0; i < numOfObjects; i++)
+	{
+		const TransformedAABB& boundingBox = boundingBoxes[i];
+		const glm::vec2 size = boundingBox.GetSize();
+		const float halfExtent = std::max(size.x, size.y) * .5f;
+
+		if (!(halfExtent <= maxHalfExtent))
+		{
+			mBucketOfObject[i] = oversized;
+			mOversizedBoundingBoxes.emplace_back(boundingBox);
+			continue;
+		}
+
+		mMaxHalfExtent = std::max(mMaxHalfExtent, halfExtent);
+
+		const glm::ivec2 cell{ glm::floor(boundingBox.GetCentre() / mCellSize) };
+		const uint32 bucket = GetBucket(cell);
+
+		mCellOfObject[i] = cell;
+		mBucketOfObject[i] = bucket;
+		mBucketStart[bucket + 1]++;
+	}
+
+	for (uint32 i = 0; i < numOfBuckets; i++)
+	{
+		mBucketStart[i + 1] += mBucketStart[i];
+	}
+
+	mNumOfBinnedObjects = mBucketStart[numOfBuckets];
+	mCells.resize(mNumOfBinnedObjects);
+
+	mNextInBucket.assign(mBucketStart.begin(), mBucketStart.end() - 1);
+	uint32 nextOversized = mNumOfBinnedObjects;
+
+	for (uint32 i = 0; i < numOfObjects; i++)
+	{
+		const uint32 bucket = mBucketOfObject[i];
+
+		if (bucket == oversized)
+		{
+			order[nextOversized++] = i;
+			continue;
+		}
+
+		const uint32 index = mNextInBucket[bucket]++;
+		order[index] = i;
+		mCells[index] = mCellOfObject[i];
+	}
+}
+
+void CE::SpatialHashGrid::Clear()
+{
+	mMaxHalfExtent = 0.0f;
+	mBucketStart.clear();
+	mBucketMask = 0;
+	mCells.clear();
+	mNumOfBinnedObjects = 0;
+	mOversizedBoundingBoxes.clear();
+}
@@ -191,3 +191,30 @@ std::string CE::StringFunctions::CreateUniqueName(std::string_view desiredName,
 	availName.append(Format("({})", ++prevNumber));
 	return isNameAvailable(availName) ? availName : CreateUniqueName(availName, isNameAvailable);
 }
+
+void CE::StringFunctions::WriteEscapedJSONString(std::ostream& stream, const std::string_view str)
+{
+	stream << '"';
+
+	for (const char c : str)
+	{
+		switch (c)
+		{
+		case '"': stream << "\\\""; break;
+		case '\\': stream << "\\\\"; break;
+		case '\n': stream << "\\n"; break;
+		case '\t': stream << "\\t"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				stream << ' ';
+			}
+			else
+			{
+				stream << c;
+			}
+		}
+	}
+
+	stream << '"';
+}
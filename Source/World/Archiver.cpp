@@ -15,7 +15,8 @@
 
 namespace CE
 {
-	static void DeserializeStorage(Registry& registry, const BinaryGSONObject& serializedStorage, const std::unordered_map<entt::entity, entt::entity>& idRemappings);
+	template<typename ObjectT>
+	static void DeserializeStorage(Registry& registry, const ObjectT& serializedStorage, const std::unordered_map<entt::entity, entt::entity>& idRemappings);
 
 	struct ComponentClassSerializeArg
 	{
@@ -36,9 +37,22 @@ namespace CE
 
 std::vector<entt::entity> CE::Archiver::Deserialize(World& world, const BinaryGSONObject& serializedWorld)
 {
+	return DeserializeInternal(world, serializedWorld);
+}
+
+std::vector<entt::entity> CE::Archiver::Deserialize(World& world, const BinaryGSONView::Object& serializedWorld)
+{
+	return DeserializeInternal(world, serializedWorld);
+}
+
+template<typename ObjectT>
+std::vector<entt::entity> CE::Archiver::DeserializeInternal(World& world, const ObjectT& serializedWorld)
+{
+	using MemberT = std::decay_t<decltype(serializedWorld.GetGSONMembers()[0])>;
+
 	Registry& reg = world.GetRegistry();
 
-	const BinaryGSONMember* serializedEntities = serializedWorld.TryGetGSONMember("entities");
+	const MemberT* serializedEntities = serializedWorld.TryGetGSONMember("entities");
 
 	if (serializedEntities == nullptr)
 	{
@@ -64,13 +78,13 @@ std::vector<entt::entity> CE::Archiver::Deserialize(World& world, const BinaryGS
 	// We need to be able to retrieve each entity's prefab of origin while
 	// deserializing, as it influences what is considered to be
 	// a 'default' value.
-	const BinaryGSONObject* serializedPrefabFactoryOfOrigin = serializedWorld.TryGetGSONObject(MetaManager::Get().GetType<PrefabOriginComponent>().GetName());
+	const ObjectT* serializedPrefabFactoryOfOrigin = serializedWorld.TryGetGSONObject(MetaManager::Get().GetType<PrefabOriginComponent>().GetName());
 	if (serializedPrefabFactoryOfOrigin != nullptr)
 	{
 		DeserializeStorage(reg, *serializedPrefabFactoryOfOrigin, idRemappings);
 	}
 
-	for (const BinaryGSONObject& serializedStorage : serializedWorld.GetChildren())
+	for (const ObjectT& serializedStorage : serializedWorld.GetChildren())
 	{
 		if (&serializedStorage == serializedPrefabFactoryOfOrigin)
 		{
@@ -82,20 +96,23 @@ std::vector<entt::entity> CE::Archiver::Deserialize(World& world, const BinaryGS
 
 	// Due to legacy reasons,
 	// we never serialized the world matrix.
-	// So we have to update them here
+	// So we have to mark them as out of date here
 	for (const auto [entity, transform] : reg.View<TransformComponent>().each())
 	{
 		if (transform.IsOrphan())
 		{
-			transform.UpdateCachedWorldMatrix();
+			transform.MarkWorldDirty();
 		}
 	}
 
 	return entities;
 }
 
-void CE::DeserializeStorage(Registry& registry, const BinaryGSONObject& serializedStorage, const std::unordered_map<entt::entity, entt::entity>& idRemappings)
+template<typename ObjectT>
+void CE::DeserializeStorage(Registry& registry, const ObjectT& serializedStorage, const std::unordered_map<entt::entity, entt::entity>& idRemappings)
 {
+	using MemberT = std::decay_t<decltype(serializedStorage.GetGSONMembers()[0])>;
+
 	const MetaType* const componentClass = MetaManager::Get().TryGetType(serializedStorage.GetName());
 
 	if (componentClass == nullptr)
@@ -128,9 +145,13 @@ void CE::DeserializeStorage(Registry& registry, const BinaryGSONObject& serializ
 
 	const size_t storageInitialSize = registry.Storage(componentClass->GetTypeId()) == nullptr ? 0u : registry.Storage(componentClass->GetTypeId())->size();
 
-	for (const BinaryGSONObject& serializedComponent : serializedStorage.GetChildren())
+	// The deserialize functions take a BinaryGSONMember. When reading from a view, the data is
+	// copied into this member first, which only allocates when a value is larger than any before it.
+	[[maybe_unused]] BinaryGSONMember scratchMember{};
+
+	for (const ObjectT& serializedComponent : serializedStorage.GetChildren())
 	{
-		const std::vector<BinaryGSONMember>& serializedProperties = serializedComponent.GetGSONMembers();
+		const auto& serializedProperties = serializedComponent.GetGSONMembers();
 		const entt::entity owner = remapId(*reinterpret_cast<const entt::entity*>(serializedComponent.GetName().data()));
 
 		if (!registry.Valid(owner))
@@ -173,7 +194,7 @@ void CE::DeserializeStorage(Registry& registry, const BinaryGSONObject& serializ
 			component = registry.AddComponent(*componentClass, owner);
 		}
 
-		for (const BinaryGSONMember& serializedProperty : serializedProperties)
+		for (const MemberT& serializedProperty : serializedProperties)
 		{
 			const MetaField* const field = componentClass->TryGetField(*reinterpret_cast<const Name::HashType*>(serializedProperty.GetName().data()));
 
@@ -203,7 +224,16 @@ void CE::DeserializeStorage(Registry& registry, const BinaryGSONObject& serializ
 				continue;
 			}
 
-			func->InvokeUncheckedUnpacked(serializedProperty, fieldValue);
+			if constexpr (std::is_same_v<MemberT, BinaryGSONMember>)
+			{
+				func->InvokeUncheckedUnpacked(serializedProperty, fieldValue);
+			}
+			else
+			{
+				scratchMember.SetName(serializedProperty.GetName());
+				scratchMember.SetData(serializedProperty.GetData());
+				func->InvokeUncheckedUnpacked(scratchMember, fieldValue);
+			}
 
 			if (memberType.GetTypeId() == MakeTypeId<entt::entity>())
 			{
@@ -222,14 +252,14 @@ void CE::DeserializeStorage(Registry& registry, const BinaryGSONObject& serializ
 		return;
 	}
 
-	for (const BinaryGSONObject& serializedComponent : serializedStorage.GetChildren())
+	for (const ObjectT& serializedComponent : serializedStorage.GetChildren())
 	{
 		if (serializedComponent.GetChildren().empty())
 		{
 			continue;
 		}
 
-		const BinaryGSONObject& additionalSerializedData = serializedComponent.GetChildren()[0];
+		const ObjectT& additionalSerializedData = serializedComponent.GetChildren()[0];
 		const entt::entity owner = remapId(FromBinary<entt::entity>(serializedComponent.GetName()));
 
 		TransformComponent* transform = registry.TryGet<TransformComponent>(owner);
@@ -24,29 +24,15 @@ CE::Span<const CE::BoundEvent> CE::EventManager::GetBoundEvents(const EventBase&
 	return boundEvents->second;
 }
 
-void CE::EventManager::InvokeEventForAllComponentsOnEntityImpl(const EventBase& eventBase, entt::entity entity,
-                                                               MetaFunc::DynamicArgs args, Span<TypeForm> argForms)
+std::optional<void*> CE::EventManager::TryGetComponentForEvent(const BoundEvent& boundEvent, const entt::entity entity) const
 {
-	for (const BoundEvent& boundEvent : GetBoundEvents(eventBase))
+	const entt::sparse_set* const storage = mWorld.get().GetRegistry().Storage(boundEvent.mType.get().GetTypeId());
+
+	if (storage == nullptr
+		|| !storage->contains(entity))
 	{
-		entt::sparse_set* const storage = mWorld.get().GetRegistry().Storage(boundEvent.mType.get().GetTypeId());
-
-		if (storage == nullptr
-			|| !storage->contains(entity))
-		{
-			continue;
-		}
-
-		const MetaFunc& func = boundEvent.mFunc.get();
-
-		if (boundEvent.mIsStatic)
-		{
-			func.InvokeUnchecked({ args.data() + 1, args.size() - 1 }, { argForms.data() + 1, argForms.size() - 1 });
-		}
-		else
-		{
-			args[0].AssignFromAnyOfDifferentType({ boundEvent.mType, storage->value(entity), false });
-			func.InvokeUnchecked(args, argForms);
-		}
+		return std::nullopt;
 	}
+
+	return boundEvent.mIsStatic ? nullptr : const_cast<void*>(storage->value(entity));
 }
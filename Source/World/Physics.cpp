@@ -68,23 +68,59 @@ void CE::Physics::RebuildBVHs(bool forceRebuild)
 	UpdateTransformedColliders<AABBColliderComponent, TransformedAABBColliderComponent>(mWorld, wereItemsAddedToLayer);
 	UpdateTransformedColliders<PolygonColliderComponent, TransformedPolygonColliderComponent>(mWorld, wereItemsAddedToLayer);
 
+	GatherCollidersPerLayer();
+
 	for (int i = 0; i < static_cast<int>(CollisionLayer::NUM_OF_LAYERS); i++)
 	{
-		BVH& bvh = mWorld.get().GetPhysics().GetBVHs()[i];
+		BVH& bvh = mBVHs[i];
+		const BVH::Colliders& colliders = mCollidersPerLayer[i];
 
+		// Dynamic trees and grids update their objects during Refit
 		if (forceRebuild
-			|| wereItemsAddedToLayer[i]
-			|| bvh.GetAmountRefitted() > 10'000.f)
+			|| (!bvh.IsDynamic()
+				&& (wereItemsAddedToLayer[i] || bvh.GetAmountRefitted() > 10'000.f)))
 		{
-			bvh.Build();
+			bvh.Build(colliders);
 		}
 		else
 		{
-			bvh.Refit();
+			bvh.Refit(colliders);
 		}
 	}
 }
 
+void CE::Physics::GatherCollidersPerLayer()
+{
+	for (BVH::Colliders& colliders : mCollidersPerLayer)
+	{
+		colliders.Clear();
+	}
+
+	const Registry& reg = mWorld.get().GetRegistry();
+
+	const auto aabbView = reg.View<PhysicsBody2DComponent, TransformedAABBColliderComponent>();
+	const auto circlesView = reg.View<PhysicsBody2DComponent, TransformedDiskColliderComponent>();
+	const auto polygonView = reg.View<PhysicsBody2DComponent, TransformedPolygonColliderComponent>();
+
+	for (const entt::entity entity : aabbView)
+	{
+		const CollisionLayer layer = aabbView.get<PhysicsBody2DComponent>(entity).mRules.mLayer;
+		mCollidersPerLayer[static_cast<size_t>(layer)].mAABBs.emplace_back(entity);
+	}
+
+	for (const entt::entity entity : circlesView)
+	{
+		const CollisionLayer layer = circlesView.get<PhysicsBody2DComponent>(entity).mRules.mLayer;
+		mCollidersPerLayer[static_cast<size_t>(layer)].mDisks.emplace_back(entity);
+	}
+
+	for (const entt::entity entity : polygonView)
+	{
+		const CollisionLayer layer = polygonView.get<PhysicsBody2DComponent>(entity).mRules.mLayer;
+		mCollidersPerLayer[static_cast<size_t>(layer)].mPolygons.emplace_back(entity);
+	}
+}
+
 template <typename Collider, typename TransformedCollider>
 void CE::Physics::UpdateTransformedColliders(World& world, std::array<bool, static_cast<size_t>(CollisionLayer::NUM_OF_LAYERS)>& wereItemsAddedToLayer)
 {
@@ -5,6 +5,7 @@
 
 #include "Assets/Script.h"
 #include "World/World.h"
+#include "Utilities/Profiler.h"
 #include "Assets/Prefabs/ComponentFactory.h"
 #include "Assets/Prefabs/Prefab.h"
 #include "Assets/Prefabs/PrefabEntityFactory.h"
@@ -17,6 +18,8 @@
 #include "Meta/MetaAny.h"
 #include "Meta/MetaTools.h"
 #include "Scripting/ScriptTools.h"
+#include "Utilities/JobSystem.h"
+#include "Utilities/Random.h"
 #include "Utilities/Reflect/ReflectComponentType.h"
 #include "World/EventManager.h"
 
@@ -106,7 +109,7 @@ CE::Registry::Registry(World& world) :
 				}
 				auto newSystem = MakeUnique<System>(std::move(childConstructResult.GetReturnValue()));
 
-				AddSystem(std::move(newSystem));
+				AddSystem(std::move(newSystem), child.GetTypeId());
 				
 				registerChildren(child);
 			}
@@ -129,17 +132,151 @@ void CE::Registry::BeginPlay()
 
 void CE::Registry::UpdateSystems(float dt)
 {
+	PROFILE_FUNCTION();
+
 	const std::vector<SingleTick> ticksToCall = GetSortedSystemsToUpdate(dt);
+
+	for (auto batchBegin = ticksToCall.begin(); batchBegin != ticksToCall.end();)
+	{
+		const auto batchEnd = std::find_if(batchBegin + 1, ticksToCall.end(),
+			[&](const SingleTick& tick)
+			{
+				return !tick.IsInSameBatchAs(*batchBegin);
+			});
+
+		UpdateBatch({ &*batchBegin, static_cast<size_t>(batchEnd - batchBegin) });
+		batchBegin = batchEnd;
+	}
+}
+
+void CE::Registry::UpdateBatch(Span<const SingleTick> batch)
+{
 	World& world = GetWorld();
 
-	for (const SingleTick& tick : ticksToCall)
+	if (batch.size() == 1)
+	{
+		UpdateSystem(batch[0]);
+		return;
+	}
+
+	// Each system is placed in the first wave after the last wave
+	// that contains a system it conflicts with. This ensures systems
+	// that cannot run in parallel are still executed in the same order.
+	uint32* const waveIndices = static_cast<uint32*>(ENGINE_ALLOCA(sizeof(uint32) * batch.size()));
+	uint32 numOfWaves{};
+
+	for (size_t i = 0; i < batch.size(); i++)
+	{
+		waveIndices[i] = 0;
+
+		for (size_t j = 0; j < i; j++)
+		{
+			if (!batch[i].CanBeExecutedInParallelWith(batch[j]))
+			{
+				waveIndices[i] = std::max(waveIndices[i], waveIndices[j] + 1);
+			}
+		}
+
+		numOfWaves = std::max(numOfWaves, waveIndices[i] + 1);
+	}
+
+	std::vector<const SingleTick*> wave{};
+
+	for (uint32 waveIndex = 0; waveIndex < numOfWaves; waveIndex++)
+	{
+		wave.clear();
+
+		for (size_t i = 0; i < batch.size(); i++)
+		{
+			if (waveIndices[i] == waveIndex)
+			{
+				wave.emplace_back(&batch[i]);
+			}
+		}
+
+		if (wave.size() == 1)
+		{
+			UpdateSystem(*wave[0]);
+			continue;
+		}
+
+		for (const SingleTick* tick : wave)
+		{
+			tick->mSystem.get().mTraits.mComponentAccess->CreateStorages(*this);
+		}
+
+		// Reading a transform may update its world matrix. Doing so up front
+		// means the systems in this wave will not have to wait on each other.
+		TransformComponent::UpdateWorldTransforms(*this);
+
+		JobSystem::Get().ParallelFor(0, static_cast<uint32>(wave.size()),
+			[this, &world, &wave](uint32 i)
+			{
+				// Each thread has their own world stack
+				World::PushWorld(world);
+				UpdateSystem(*wave[i]);
+				World::PopWorld();
+			});
+	}
+}
+
+void CE::Registry::UpdateSystem(const SingleTick& tick)
+{
+	InternalSystem& system = tick.mSystem;
+	PROFILE_SCOPE(typeid(*system.mSystem).name());
+
+	// The thread this system is executed on differs between runs
+	Random::SelectStream((static_cast<uint64>(system.mRandomStream) << 32) | system.mNumOfSteps++);
+
+	if (!mShouldMeasureSystems)
+	{
+		system.mSystem->Update(GetWorld(), tick.mDeltaTime);
+		return;
+	}
+
+	const auto start = std::chrono::high_resolution_clock::now();
+	system.mSystem->Update(GetWorld(), tick.mDeltaTime);
+	system.mTimeSpentUpdating += std::chrono::high_resolution_clock::now() - start;
+	system.mNumOfUpdates++;
+}
+
+std::vector<CE::Registry::SystemMeasurement> CE::Registry::GetSystemMeasurements() const
+{
+	std::vector<SystemMeasurement> measurements{};
+	measurements.reserve(mFixedTickSystems.size() + mNonFixedSystems.size());
+
+	for (const FixedTickSystem& fixedTickSystem : mFixedTickSystems)
+	{
+		measurements.push_back({ *fixedTickSystem.mSystem, fixedTickSystem.mSystemTypeId, fixedTickSystem.mTimeSpentUpdating, fixedTickSystem.mNumOfUpdates });
+	}
+
+	for (const InternalSystem& internalSystem : mNonFixedSystems)
+	{
+		measurements.push_back({ *internalSystem.mSystem, internalSystem.mSystemTypeId, internalSystem.mTimeSpentUpdating, internalSystem.mNumOfUpdates });
+	}
+
+	return measurements;
+}
+
+void CE::Registry::ClearSystemMeasurements()
+{
+	for (FixedTickSystem& fixedTickSystem : mFixedTickSystems)
+	{
+		fixedTickSystem.mTimeSpentUpdating = {};
+		fixedTickSystem.mNumOfUpdates = 0;
+	}
+
+	for (InternalSystem& internalSystem : mNonFixedSystems)
 	{
-		tick.mSystem.get().Update(world, tick.mDeltaTime);
+		internalSystem.mTimeSpentUpdating = {};
+		internalSystem.mNumOfUpdates = 0;
 	}
 }
 
 void CE::Registry::RenderSystems() const
 {
+	PROFILE_FUNCTION();
+
 	if (CameraComponent::GetSelected(mWorld) == entt::null)
 	{
 		LOG(LogTemp, Message, "No camera to render to");
@@ -215,7 +352,7 @@ entt::entity CE::Registry::CreateFromPrefab(const Prefab& prefab,
 			}
 		}
 
-		transform->UpdateCachedWorldMatrix();
+		transform->MarkWorldDirty();
 	}
 
 	// We wait with calling BeginPlay until all the
@@ -660,7 +797,9 @@ std::vector<CE::Registry::SingleTick> CE::Registry::GetSortedSystemsToUpdate(con
 
 		for (const SortableFixedTick& sortableFixedTick : ticksToSort)
 		{
-			returnValue.emplace_back(*sortableFixedTick.mFixedTicksystem.get().mSystem, *sortableFixedTick.mFixedTicksystem.get().mTraits.mFixedTickInterval);
+			returnValue.emplace_back(sortableFixedTick.mFixedTicksystem.get(), 
+				*sortableFixedTick.mFixedTicksystem.get().mTraits.mFixedTickInterval,
+				sortableFixedTick.mTimeOfNextStep);
 		}
 	}
 
@@ -668,24 +807,73 @@ std::vector<CE::Registry::SingleTick> CE::Registry::GetSortedSystemsToUpdate(con
 	{
 		if (canEverTick(internalSystem.mTraits))
 		{
-			returnValue.emplace_back(*internalSystem.mSystem, dt);
+			returnValue.emplace_back(internalSystem, dt);
 		}
 	}
 
 	return returnValue;
 }
 
-void CE::Registry::AddSystem(std::unique_ptr<System, InPlaceDeleter<System, true>> system)
+bool CE::Registry::SingleTick::IsInSameBatchAs(const SingleTick& other) const
+{
+	return mSystem.get().mTraits.mPriority == other.mSystem.get().mTraits.mPriority
+		&& mTimeOfFixedStep == other.mTimeOfFixedStep;
+}
+
+bool CE::Registry::SingleTick::CanBeExecutedInParallelWith(const SingleTick& other) const
+{
+	const std::optional<SystemComponentAccess>& access = mSystem.get().mTraits.mComponentAccess;
+	const std::optional<SystemComponentAccess>& otherAccess = other.mSystem.get().mTraits.mComponentAccess;
+
+	return access.has_value()
+		&& otherAccess.has_value()
+		&& !access->FindConflict(*otherAccess).has_value();
+}
+
+void CE::Registry::AddSystem(std::unique_ptr<System, InPlaceDeleter<System, true>> system, const TypeId systemTypeId)
 {
 	SystemStaticTraits staticTraits = system->GetStaticTraits();
 
+	if (staticTraits.mComponentAccess.has_value())
+	{
+		const auto reportConflicts = [&](const InternalSystem& other)
+			{
+				if (other.mTraits.mPriority != staticTraits.mPriority
+					|| other.mTraits.mFixedTickInterval != staticTraits.mFixedTickInterval
+					|| !other.mTraits.mComponentAccess.has_value())
+				{
+					return;
+				}
+
+				const std::optional<TypeId> conflict = staticTraits.mComponentAccess->FindConflict(*other.mTraits.mComponentAccess);
+
+				if (!conflict.has_value())
+				{
+					return;
+				}
+
+				[[maybe_unused]] const MetaType* const conflictingType = MetaManager::Get().TryGetType(*conflict);
+
+				LOG(LogWorld, Verbose, "{} and {} have the same priority, but will not be executed in parallel, as they both access {} and atleast one of them writes to it.",
+					typeid(*system).name(),
+					typeid(*other.mSystem).name(),
+					conflictingType == nullptr ? std::to_string(*conflict) : conflictingType->GetName());
+			};
+
+		std::for_each(mFixedTickSystems.begin(), mFixedTickSystems.end(), reportConflicts);
+		std::for_each(mNonFixedSystems.begin(), mNonFixedSystems.end(), reportConflicts);
+	}
+
+	const uint32 randomStream = static_cast<uint32>(mFixedTickSystems.size() + mNonFixedSystems.size());
+
 	if (staticTraits.mFixedTickInterval.has_value())
 	{
-		mFixedTickSystems.emplace_back(std::move(system), staticTraits, GetWorld().GetCurrentTimeScaled());
+		mFixedTickSystems.emplace_back(std::move(system), systemTypeId, staticTraits, GetWorld().GetCurrentTimeScaled()).mRandomStream = randomStream;
 	}
 	else
 	{
-		InternalSystem newInternal{ std::move(system), staticTraits };
+		InternalSystem newInternal{ std::move(system), systemTypeId, staticTraits };
+		newInternal.mRandomStream = randomStream;
 
 		const auto whereToInsert = std::lower_bound(mNonFixedSystems.begin(), mNonFixedSystems.end(), newInternal,
 		                                            [](const InternalSystem& sl, const InternalSystem& sr)
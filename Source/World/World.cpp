@@ -7,8 +7,10 @@
 #include "Core/Device.h"
 #include "Components/ComponentFilter.h"
 #include "Components/NameComponent.h"
+#include "Components/TransformComponent.h"
 #include "Meta/MetaProps.h"
 #include "World/Registry.h"
+#include "Utilities/Profiler.h"
 #include "World/WorldViewport.h"
 #include "World/Physics.h"
 #include "Meta/ReflectedTypes/STD/ReflectVector.h"
@@ -90,12 +92,17 @@ CE::World& CE::World::operator=(World&& other) noexcept
 
 void CE::World::Tick(const float unscaledDeltaTime)
 {
+	PROFILE_FUNCTION();
 	PushWorld(*this);
 
 	mTime.Step(unscaledDeltaTime);
 
 	GetRegistry().UpdateSystems(unscaledDeltaTime);
 	GetRegistry().RemovedDestroyed();
+	PROFILE_COUNTER("Entities", GetRegistry().Storage<entt::entity>().in_use());
+
+	// Everything that moved this frame is updated in one pass, before it is rendered
+	TransformComponent::UpdateWorldTransforms(GetRegistry());
 
 	if (GetNextLevel() != nullptr)
 	{